@@ -128,6 +128,32 @@
  */
 #define OS_INTEGER_RTOS_IDLE_STACK_SIZE_BYTES
 
+/**
+ * @brief Include the timer daemon thread.
+ * @details
+ * Timers created with the `execution::daemon` attribute
+ * do not call their functions from the clock interrupt; the
+ * interrupt only moves them to a pending list, and the daemon
+ * thread calls the functions in batches, in thread context.
+ *
+ * @par Default
+ * Disable. All timer functions run in the clock interrupt.
+ */
+#define OS_INCLUDE_RTOS_TIMER_DAEMON
+
+/**
+ * @brief Define the **timer** daemon thread stack size.
+ */
+#define OS_INTEGER_RTOS_TIMER_DAEMON_STACK_SIZE_BYTES
+
+/**
+ * @brief Define the **timer** daemon thread priority.
+ *
+ * @par Default
+ *  `thread::priority::high`.
+ */
+#define OS_INTEGER_RTOS_TIMER_DAEMON_PRIORITY
+
 /**
  * @brief Include statistics to count thread CPU cycles.
  * @details
@@ -173,6 +199,52 @@
  */
 #define OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES
 
+/**
+ * @brief Include statistics to compute the recent CPU load.
+ * @details
+ * Add support to compute, for each thread, for the idle thread and
+ * for the interrupt handlers, the percentage of time spent during
+ * the last complete window.
+ *
+ * The windows are counted by `os_systick_handler()`; the threads
+ * are updated when switched, and the interrupts that define
+ * an `interrupts::accounted_section`.
+ *
+ * Requires @ref OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES.
+ *
+ * @see os::rtos::scheduler::statistics::cpu_load()
+ * @see os::rtos::thread::statistics::cpu_load()
+ *
+ * @par Default
+ * Disable. Do not include CPU load statistics.
+ */
+#define OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD
+
+/**
+ * @brief Define the length of the CPU load window, in ticks.
+ *
+ * @par Default
+ * One second (@ref OS_INTEGER_SYSTICK_FREQUENCY_HZ ticks).
+ */
+#define OS_INTEGER_RTOS_STATISTICS_CPU_LOAD_WINDOW_TICKS
+
+/**
+ * @brief Include support for periodic thread releases.
+ * @details
+ * Add `this_thread::set_period()` and `this_thread::wait_next_period()`,
+ * which release the thread at absolute time stamps, exactly one
+ * period apart, and count the missed deadlines and the release
+ * latencies.
+ *
+ * The RAM overhead is about 48 bytes for each thread.
+ *
+ * @see os::rtos::thread::periodic
+ *
+ * @par Default
+ * Disable. Do not include periodic releases.
+ */
+#define OS_INCLUDE_RTOS_THREAD_PERIODIC
+
 /**
  * @brief Add a user defined storage to each thread.
  */
@@ -319,6 +391,51 @@
  */
 #define OS_INTEGER_SEMIHOSTING_MAX_OPEN_FILES (20)
 
+/**
+ * @brief Buffer the semihosting file reads and writes.
+ * @details
+ * Each semihosting call is a debug trap, which, with a debugger
+ * attached, may take milliseconds. With this option, each open
+ * file has a buffer (@ref OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES);
+ * writes are passed to the host when the buffer is full, and on
+ * `close()`, `fsync()`, `lseek()`, `fstat()` and exit, and reads
+ * ask the host for a full buffer at once.
+ *
+ * @see OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE
+ */
+#define OS_USE_SEMIHOSTING_BUFFERS
+
+/**
+ * @brief Define the size of the semihosting file buffers.
+ * @details
+ * There is one buffer for each entry in the open files array
+ * (@ref OS_INTEGER_SEMIHOSTING_MAX_OPEN_FILES).
+ *
+ * @par Default
+ *  128.
+ */
+#define OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES (128)
+
+/**
+ * @brief Flush the semihosting terminal buffers at the end of each line.
+ * @details
+ * Without this option, the output to STDOUT/STDERR is displayed
+ * only when the buffer is full, or when the application exits.
+ *
+ * @par Default
+ *  False (flush only when the buffer is full).
+ */
+#define OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE (true)
+
+/**
+ * @brief Replace the semihosting traps with calls to a test function.
+ * @details
+ * For host tests; `call_host()` calls `os_semihosting_call_host()`,
+ * which must be defined by the test, to emulate the host and
+ * count the calls.
+ */
+#define OS_USE_SEMIHOSTING_MOCK
+
 /**
  * @brief Include definitions for the standard POSIX system calls.
  * @todo update after POSIX I/O is updated.
@@ -331,6 +448,27 @@
  */
 #define OS_INCLUDE_NEWLIB_POSIX_FUNCTIONS
 
+/**
+ * @brief Use the POSIX I/O layer for the system calls.
+ * @details
+ * The `__posix_*()` I/O functions translate file descriptors to
+ * the devices, files and sockets of the `os::posix` I/O layer.
+ * Devices are opened by name, as `/dev/<name>`.
+ *
+ * Cannot be used together with @ref OS_USE_SEMIHOSTING_SYSCALLS.
+ */
+#define OS_USE_POSIX_IO_SYSCALLS
+
+/**
+ * @brief Define the maximum number of POSIX I/O open files.
+ * @details
+ * The size of the static array of file descriptors.
+ *
+ * @par Default
+ *  16.
+ */
+#define OS_INTEGER_POSIX_IO_MAX_OPEN_FILES (16)
+
 /**
  * @}
  */
@@ -354,6 +492,99 @@
  */
 #define OS_INTEGER_DIRENT_NAME_MAX  (256)
 
+/**
+ * @brief Include the heap allocation profiler.
+ * @details
+ * Account all allocations done via `estd::malloc()` and
+ * `operator new` per call site, with counts, live bytes and peak bytes.
+ *
+ * The RAM overhead is a small header for each allocation and
+ * a fixed size table (@ref OS_INTEGER_LIBC_MALLOC_PROFILER_SITES).
+ *
+ * @see os::diag::malloc_profiler::dump()
+ *
+ * @par Default
+ * Disable. Do not include the profiler.
+ */
+#define OS_INCLUDE_LIBC_MALLOC_PROFILER
+
+/**
+ * @brief Define the number of call sites tracked by the profiler.
+ * @details
+ * Must be a power of 2. Allocations from sites that do not fit
+ * in the table are accounted to a separate overflow entry.
+ *
+ * @par Default
+ *  64.
+ */
+#define OS_INTEGER_LIBC_MALLOC_PROFILER_SITES (64)
+
+/**
+ * @brief Define the size of the `estd::thread` function object buffer.
+ * @details
+ * The function object (the callable with its bound arguments) is
+ * stored in the same block as the system thread and its stack.
+ * Larger objects require a separate allocation.
+ *
+ * @par Default
+ *  4 pointers.
+ */
+#define OS_INTEGER_ESTD_THREAD_FUNCTION_OBJECT_SIZE_BYTES (4 * sizeof(void*))
+
+/**
+ * @brief Define the number of shared states in the futures pool.
+ * @details
+ * The states shared by promises and futures are allocated from
+ * a static pool; when exhausted, states are allocated from the
+ * default memory resource.
+ *
+ * @par Default
+ *  8.
+ */
+#define OS_INTEGER_ESTD_FUTURE_STATE_POOL_SIZE (8)
+
+/**
+ * @brief Define the space for the value in the futures pool blocks.
+ * @details
+ * Each block holds the common part of the state, plus this many
+ * bytes for the value and, for `async()`, the function object.
+ *
+ * @par Default
+ *  8 pointers.
+ */
+#define OS_INTEGER_ESTD_FUTURE_STATE_PAYLOAD_SIZE_BYTES (8 * sizeof(void*))
+
+/**
+ * @brief Define the number of threads in the `async()` pool.
+ * @details
+ * The default thread pool is created on the first call
+ * to `async()`, unless another pool was set with
+ * `os::estd::set_default_thread_pool()`.
+ *
+ * @par Default
+ *  2.
+ */
+#define OS_INTEGER_ESTD_ASYNC_THREADS (2)
+
+/**
+ * @brief Define the number of functions queued to the `async()` pool.
+ * @details
+ * When the queue is full, `async()` blocks until a pool
+ * thread becomes free.
+ *
+ * @par Default
+ *  8.
+ */
+#define OS_INTEGER_ESTD_ASYNC_QUEUE_SIZE (8)
+
+/**
+ * @brief Define the stack size of the `async()` pool threads.
+ *
+ * @par Default
+ *  The port default stack size.
+ */
+#define OS_INTEGER_ESTD_ASYNC_STACK_SIZE_BYTES (os::rtos::port::stack::default_size_bytes)
+
 /**
  * @}
  */
@@ -409,6 +640,24 @@
  */
 #define OS_USE_RTOS_PORT_TIMER
 
+/**
+ * @brief Use a hardware compare match for the high resolution clock.
+ * @details
+ * The port must implement `port::clock_highres::compare()`, to
+ * program a compare match interrupt for a given `hrclock` time
+ * stamp, and call `os_hrclock_compare_handler()` from the
+ * interrupt handler.
+ *
+ * Sleeps and timers using `hrclock` are then expired at the
+ * exact cycle, not at the next SysTick, and `hrclock.steady_now()`
+ * includes the cycles elapsed since the last SysTick.
+ * Timeouts of other objects waiting on `hrclock` are still
+ * checked on each tick.
+ *
+ * The default is to check `hrclock` time stamps only on SysTick.
+ */
+#define OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE
+
 /**
  * @}
  */
@@ -496,6 +745,68 @@
  */
 #define OS_USE_TRACE_SEGGER_RTT
 
+/**
+ * @brief Store trace messages as binary records, formatted on the host.
+ * @details
+ * Instead of rendering the text with `vsnprintf()` and writing it
+ * synchronously, `trace::printf()` and the related functions store
+ * only the address of the format string and the raw arguments in a
+ * ring buffer (os::trace::binary); this reduces the cost of a trace
+ * call to the time needed to copy a few words.
+ *
+ * The records are passed to the selected trace channel by
+ * os::trace::binary::drain(), or read by the debugger from
+ * the `os_trace_binary_ring` structure, and are decoded with
+ * `scripts/trace-binary-decode.py`, using the application ELF.
+ *
+ * @note The format strings must be literals, since only their
+ * addresses are stored.
+ *
+ * @see OS_INTEGER_TRACE_BINARY_RING_WORDS
+ * @see OS_INTEGER_TRACE_BINARY_RECORD_WORDS
+ */
+#define OS_USE_TRACE_BINARY
+
+/**
+ * @brief Format trace messages with the in-tree formatter.
+ * @details
+ * Use os::diag::vsnprintf() instead of the library `vsnprintf()`
+ * in `trace::vprintf()`. The in-tree formatter is faster, does not
+ * allocate, does not use the newlib reentrancy structures and
+ * uses a small, fixed, amount of stack, but supports floating
+ * point values only in fixed notation.
+ */
+#define OS_USE_TRACE_LIGHT_FORMAT
+
+/**
+ * @brief Buffer trace messages and write them from a background thread.
+ * @details
+ * `trace::printf()`, `trace::puts()` and `trace::putchar()` store each
+ * message as a single record in a ring buffer, without blocking, and
+ * a low priority thread passes the records to the selected trace
+ * channel. Any thread or interrupt can write, and messages written
+ * concurrently are never mixed.
+ *
+ * When the buffer is full, records are dropped (see os::trace::async).
+ *
+ * @see OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES
+ * @see OS_INTEGER_TRACE_ASYNC_STACK_SIZE_BYTES
+ * @see OS_BOOL_TRACE_ASYNC_OVERWRITE
+ */
+#define OS_USE_TRACE_ASYNC
+
+/**
+ * @brief When the asynchronous trace buffer is full, discard old records.
+ * @details
+ * By default the new records are discarded; with this option the
+ * oldest records not yet written are discarded instead. The policy
+ * can also be changed at run time with os::trace::async::policy().
+ *
+ * @par Default
+ *  False (the new records are dropped).
+ */
+#define OS_BOOL_TRACE_ASYNC_OVERWRITE (true)
+
 /**
  * @brief Enable trace messages for RTOS clocks functions.
  */
@@ -598,6 +909,85 @@
  */
 #define OS_INTEGER_TRACE_SEMIHOSTING_BUFF_ARRAY_SIZE (16)
 
+/**
+ * @brief Define the size of the binary trace ring buffer.
+ * @details
+ * The size is given in 32-bit words and must be a power of 2.
+ * When the ring is full, new records are dropped and counted.
+ *
+ * @par Default
+ *  256.
+ */
+#define OS_INTEGER_TRACE_BINARY_RING_WORDS (256)
+
+/**
+ * @brief Define the maximum size of a binary trace record.
+ * @details
+ * The size is given in 32-bit words, including the header and
+ * the format address. Records are assembled on the stack,
+ * and the arguments that do not fit are discarded.
+ *
+ * @par Default
+ *  16.
+ */
+#define OS_INTEGER_TRACE_BINARY_RECORD_WORDS (16)
+
+/**
+ * @brief Define the size of the asynchronous trace buffer.
+ * @details
+ * The size is given in bytes and must be a power of 2. Each record
+ * uses 4 more bytes, and is padded to a multiple of 4.
+ *
+ * @par Default
+ *  1024.
+ */
+#define OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES (1024)
+
+/**
+ * @brief Define the stack size of the trace flusher thread.
+ * @details
+ * The thread only calls the trace channel `write()`.
+ *
+ * @par Default
+ *  The port default stack size.
+ */
+#define OS_INTEGER_TRACE_ASYNC_STACK_SIZE_BYTES (1024)
+
+/**
+ * @brief Define the highest log level compiled in.
+ * @details
+ * The `OS_LOG_*()` macros for higher (less severe) levels expand
+ * to nothing. One of `OS_LOG_LEVEL_NONE`, `OS_LOG_LEVEL_ERROR`,
+ * `OS_LOG_LEVEL_WARNING`, `OS_LOG_LEVEL_INFO`, `OS_LOG_LEVEL_DEBUG`
+ * or `OS_LOG_LEVEL_VERBOSE` (see `<cmsis-plus/diag/trace-log.h>`).
+ *
+ * @par Default
+ *  `OS_LOG_LEVEL_INFO`.
+ */
+#define OS_INTEGER_TRACE_LOG_LEVEL (OS_LOG_LEVEL_INFO)
+
+/**
+ * @brief Define the log categories compiled in.
+ * @details
+ * The OR-ed `OS_LOG_CATEGORY_*` bits; messages for other categories
+ * are removed at compile time.
+ *
+ * @par Default
+ *  `OS_LOG_CATEGORY_ALL`.
+ */
+#define OS_INTEGER_TRACE_LOG_CATEGORIES (OS_LOG_CATEGORY_ALL)
+
+/**
+ * @brief Define the initial run time log mask.
+ * @details
+ * The level and category bits checked at run time; can be changed
+ * with the functions in os::trace::log.
+ *
+ * @par Default
+ *  All categories, all compiled in levels.
+ */
+#define OS_INTEGER_TRACE_LOG_MASK (0xFFFFFF1F)
+
 /**
  * @}
  */
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_ARM_SEMIHOSTING_BUFFER_H_
+#define CMSIS_PLUS_ARM_SEMIHOSTING_BUFFER_H_
+
+// ----------------------------------------------------------------------------
+
+#if defined(__cplusplus)
+
+#include <cmsis-plus/os-app-config.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+// ----------------------------------------------------------------------------
+
+#if !defined(OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES)
+#define OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES (128)
+#endif
+
+#if !defined(OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE)
+#define OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE (false)
+#endif
+
+namespace os
+{
+  namespace semihosting
+  {
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Write-back and read-ahead buffer for a semihosting file.
+     * @details
+     * Each semihosting call is a debug trap, which, with a debugger
+     * attached, costs milliseconds; to reduce their number, writes
+     * are accumulated and passed to the host in large chunks, and
+     * reads ask the host for a full buffer at once.
+     *
+     * The buffer is either in write mode or in read mode; changing
+     * direction flushes it. Pending writes are passed to the host
+     * when the buffer is full, on flush() (called on `close()`,
+     * `fsync()`, `lseek()`, `fstat()` and exit) and, for terminals,
+     * optionally on each new line
+     * (@ref OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE).
+     *
+     * Write errors are reported by the call that passes the data
+     * to the host, which may be a later call; the bytes not written
+     * are kept, and are passed again to the host by the next flush().
+     *
+     * The buffer is not thread safe; the callers must serialise
+     * the accesses (the semihosting system calls lock the scheduler).
+     */
+    class file_buffer
+    {
+    public:
+
+      file_buffer () = default;
+
+      file_buffer (const file_buffer&) = delete;
+      file_buffer (file_buffer&&) = delete;
+      file_buffer&
+      operator= (const file_buffer&) = delete;
+      file_buffer&
+      operator= (file_buffer&&) = delete;
+
+      ~file_buffer () = default;
+
+      /**
+       * @brief Associate the buffer with a newly opened host file.
+       * @param [in] handle The host file handle.
+       * @param [in] tty True if the file is a terminal.
+       * @par Returns
+       *  Nothing.
+       */
+      void
+      reset (int handle, bool tty);
+
+      /**
+       * @brief Write bytes via the buffer.
+       * @param [in] buf Pointer to the bytes.
+       * @param [in] nbyte Number of bytes.
+       * @return The number of bytes accepted, or -1 with `errno` set.
+       */
+      ssize_t
+      write (const void* buf, std::size_t nbyte);
+
+      /**
+       * @brief Read bytes via the buffer.
+       * @param [out] buf Pointer to the destination.
+       * @param [in] nbyte Number of bytes.
+       * @return The number of bytes read, 0 at end of file,
+       *  or -1 with `errno` set.
+       */
+      ssize_t
+      read (void* buf, std::size_t nbyte);
+
+      /**
+       * @brief Pass pending writes to the host and drop read-ahead data.
+       * @par Parameters
+       *  None.
+       * @retval 0 The host file position is the logical position.
+       * @retval -1 Error, with `errno` set; the pending writes not
+       *  accepted by the host are kept.
+       */
+      int
+      flush (void);
+
+      /**
+       * @brief Update the host position after an explicit seek.
+       * @param [in] pos The new position.
+       * @par Returns
+       *  Nothing.
+       */
+      void
+      position (int pos);
+
+    protected:
+
+      ssize_t
+      host_write_ (const void* buf, std::size_t nbyte);
+
+      ssize_t
+      host_read_ (void* buf, std::size_t nbyte);
+
+    protected:
+
+      enum class mode : uint8_t
+      {
+        idle = 0, writing = 1, reading = 2
+      };
+
+      int handle_ = -1;
+      // Position of the host file, to seek back when read-ahead
+      // data is dropped.
+      int host_pos_ = 0;
+      // Writing: bytes pending; reading: bytes available.
+      uint16_t count_ = 0;
+      // Reading: index of the next byte.
+      uint16_t index_ = 0;
+      mode mode_ = mode::idle;
+      bool tty_ = false;
+
+      uint8_t data_[OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES];
+    };
+
+  // --------------------------------------------------------------------------
+  } /* namespace semihosting */
+} /* namespace os */
+
+#endif /* defined(__cplusplus) */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_ARM_SEMIHOSTING_BUFFER_H_ */
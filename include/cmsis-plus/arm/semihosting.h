@@ -94,6 +94,26 @@ enum OperationNumber
 #define AngelSWITestFaultOpCode (0xB658)
 #endif
 
+#if defined(OS_USE_SEMIHOSTING_MOCK)
+
+// For host tests, the traps are replaced by calls to a function
+// defined by the test, which can emulate the host and count the calls.
+
+#if defined(__cplusplus)
+extern "C"
+#endif
+int
+os_semihosting_call_host (int reason, void* arg);
+
+static inline int
+__attribute__ ((always_inline))
+call_host (int reason, void* arg)
+{
+  return os_semihosting_call_host (reason, arg);
+}
+
+#else
+
 static inline int
 __attribute__ ((always_inline))
 call_host (int reason, void* arg)
@@ -124,6 +144,8 @@ call_host (int reason, void* arg)
   return value;
 }
 
+#endif /* defined(OS_USE_SEMIHOSTING_MOCK) */
+
 // ----------------------------------------------------------------------------
 
 // Function used in _exit() to return the status code as Angel exception.
@@ -131,7 +153,7 @@ static inline void
 __attribute__ ((always_inline,noreturn))
 report_exception (int reason)
 {
-  call_host (SEMIHOSTING_ReportException, (void*) reason);
+  call_host (SEMIHOSTING_ReportException, (void*) (__INTPTR_TYPE__) reason);
 
   for (;;)
     ;
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DIAG_FORMAT_H_
+#define CMSIS_PLUS_DIAG_FORMAT_H_
+
+// ----------------------------------------------------------------------------
+
+#if defined(__cplusplus)
+
+#include <cstddef>
+#include <cstdarg>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace diag
+  {
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Format a string into a buffer, without newlib.
+     * @param [out] buf Pointer to the output buffer.
+     * @param [in] size Size of the buffer, including the terminator.
+     * @param [in] format A null terminated string with the format.
+     * @param [in] args A variable arguments list.
+     * @return The number of characters that would have been written
+     *  if the buffer were large enough, without the terminator.
+     *
+     * @ingroup cmsis-plus-diag
+     * @details
+     * A small replacement for `vsnprintf()`, intended for trace
+     * messages: it does not allocate memory, does not use
+     * the reentrancy structures, is not recursive and uses a
+     * small, fixed, amount of stack.
+     *
+     * The supported conversions are those used by the system:
+     * `%d`, `%i`, `%u`, `%o`, `%x`, `%X`, `%c`, `%s`, `%p`
+     * and `%%`, with the `-`, `+`, space, `0` and `#` flags,
+     * width and precision (including `*`) and all the integer
+     * length modifiers.
+     *
+     * Floating point values are displayed in fixed notation
+     * (`%e`, `%g` and `%a` are treated like `%f`), with at most
+     * 9 decimals; values that do not fit in 64 bits are displayed
+     * as `inf`. The last decimal is rounded half to even after
+     * scaling, so values close to a tie, like 0.35 with `%.1f`,
+     * may be rounded differently than by `printf()`.
+     * `%n` is not supported.
+     */
+    int
+    vsnprintf (char* buf, std::size_t size, const char* format,
+               std::va_list args);
+
+    /**
+     * @brief Format a string into a buffer, without newlib.
+     * @param [out] buf Pointer to the output buffer.
+     * @param [in] size Size of the buffer, including the terminator.
+     * @param [in] format A null terminated string with the format.
+     * @return The number of characters that would have been written
+     *  if the buffer were large enough, without the terminator.
+     *
+     * @ingroup cmsis-plus-diag
+     */
+    int
+    snprintf (char* buf, std::size_t size, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+
+  // --------------------------------------------------------------------------
+  } /* namespace diag */
+} /* namespace os */
+
+#endif /* defined(__cplusplus) */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DIAG_FORMAT_H_ */
@@ -0,0 +1,254 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DIAG_MALLOC_PROFILER_H_
+#define CMSIS_PLUS_DIAG_MALLOC_PROFILER_H_
+
+// ----------------------------------------------------------------------------
+
+#if defined(__cplusplus)
+
+#include <cmsis-plus/os-app-config.h>
+#include <cmsis-plus/iso/malloc.h>
+
+#include <cstdint>
+#include <cstddef>
+
+// ----------------------------------------------------------------------------
+
+#if !defined(OS_INTEGER_LIBC_MALLOC_PROFILER_SITES)
+#define OS_INTEGER_LIBC_MALLOC_PROFILER_SITES (64)
+#endif
+
+namespace os
+{
+  /**
+   * @brief Diagnostics namespace.
+   * @ingroup cmsis-plus-diag
+   */
+  namespace diag
+  {
+    /**
+     * @brief Heap allocation profiler.
+     * @ingroup cmsis-plus-diag
+     * @details
+     * When `OS_INCLUDE_LIBC_MALLOC_PROFILER` is defined, all allocations
+     * done via `estd::malloc()`, `estd::aligned_alloc()` and the
+     * `operator new` family are accounted per call site (the
+     * return address of the allocating function, or an explicit tag),
+     * in a fixed size hash table.
+     *
+     * Each allocation is prefixed by a small header, which remembers
+     * the site and the size, so deallocations are accounted to the
+     * same site, without searching.
+     *
+     * The overhead is a hash and a few additions per call, done
+     * inside the scheduler critical section already used by the
+     * allocator, so it is cheap enough to be left enabled in long
+     * running tests.
+     *
+     * The results can be retrieved with sites() or printed
+     * with dump(); the output can be converted to function names
+     * on the host with `scripts/malloc-profiler-symbolize.py`.
+     */
+    namespace malloc_profiler
+    {
+      /**
+       * @brief Allocation statistics for a call site.
+       */
+      typedef struct site_statistics_s
+      {
+        /**
+         * @brief Address of the call site, or pointer to the tag.
+         * @details
+         * `nullptr` for the entry that accounts allocations
+         * for which no free slot was available.
+         */
+        const void* site;
+
+        /**
+         * @brief Number of successful allocations.
+         */
+        uint32_t allocs;
+
+        /**
+         * @brief Number of deallocations.
+         */
+        uint32_t frees;
+
+        /**
+         * @brief Number of bytes currently allocated.
+         */
+        std::size_t live_bytes;
+
+        /**
+         * @brief Maximum number of bytes allocated at any time.
+         */
+        std::size_t peak_bytes;
+
+      } site_statistics_t;
+
+      /**
+       * @brief Get a snapshot of the per site statistics.
+       * @param [out] buf Pointer to array of statistics.
+       * @param [in] count Number of elements in the array.
+       * @return The number of sites copied.
+       */
+      std::size_t
+      sites (site_statistics_t* buf, std::size_t count);
+
+      /**
+       * @brief Get the system wide statistics.
+       * @par Parameters
+       *  None.
+       * @return The accumulated statistics for all sites.
+       */
+      site_statistics_t
+      totals (void);
+
+      /**
+       * @brief Get the number of allocations without a site slot.
+       * @par Parameters
+       *  None.
+       * @return The number of allocations accounted to the overflow entry.
+       */
+      uint32_t
+      dropped (void);
+
+      /**
+       * @brief Get the number of invalid deallocations.
+       * @par Parameters
+       *  None.
+       * @return The number of pointers passed to `free()` or `delete`
+       *  that were not allocated by the profiler, usually double
+       *  frees; these blocks are not released.
+       */
+      uint32_t
+      invalid_frees (void);
+
+      /**
+       * @brief Clear the counters.
+       * @details
+       * The number of allocations, deallocations and invalid
+       * deallocations are cleared, and the peak values are reset
+       * to the current live values.
+       * Live allocations remain associated with their sites.
+       * @par Parameters
+       *  None.
+       * @par Returns
+       *  Nothing.
+       */
+      void
+      reset (void);
+
+      /**
+       * @brief Print the statistics on the trace device.
+       * @details
+       * The output is intended to be processed by
+       * `scripts/malloc-profiler-symbolize.py`.
+       * @par Parameters
+       *  None.
+       * @par Returns
+       *  Nothing.
+       */
+      void
+      dump (void);
+
+      /**
+       * @brief Allocate a memory block accounted to a tag.
+       * @param [in] size Number of bytes to allocate.
+       * @param [in] tag Null terminated string, usually a literal.
+       * @return Pointer to memory block or `nullptr`.
+       * @details
+       * Useful to group allocations done from multiple places,
+       * or done via generic wrappers. Release with `estd::free()`.
+       */
+      inline void*
+      malloc (std::size_t size, const char* tag) noexcept
+      {
+        return estd::internal::malloc (size, tag);
+      }
+
+      /**
+       * @cond ignore
+       */
+
+      namespace internal
+      {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+        /**
+         * @brief Header stored immediately before each user block.
+         */
+        typedef struct header_s
+        {
+          // The address returned by the C allocator.
+          void* block;
+          // The requested size, in bytes.
+          uint32_t size;
+          // The index in the sites table.
+          uint16_t index;
+          // Used to validate the header.
+          uint16_t magic;
+        } header_t;
+
+#pragma GCC diagnostic pop
+
+        // The space before a block with the default alignment.
+        constexpr std::size_t header_size = (sizeof(header_t)
+            + alignof(std::max_align_t) - 1)
+            & ~(alignof(std::max_align_t) - 1);
+
+        // Called with the scheduler locked.
+        void*
+        allocate (std::size_t size, std::size_t alignment, const void* site);
+
+        // Called with the scheduler locked.
+        void
+        deallocate (void* ptr);
+
+        // For tests; write, in the `header_size` bytes before `ptr`,
+        // the header of a block as left by deallocate(), so a second
+        // free() can be checked without touching released memory.
+        void
+        mark_freed (void* ptr, std::size_t size);
+      } /* namespace internal */
+
+    /**
+     * @endcond
+     */
+
+    } /* namespace malloc_profiler */
+  } /* namespace diag */
+} /* namespace os */
+
+#endif /* defined(__cplusplus) */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DIAG_MALLOC_PROFILER_H_ */
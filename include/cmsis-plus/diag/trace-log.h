@@ -0,0 +1,351 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DIAG_TRACE_LOG_H_
+#define CMSIS_PLUS_DIAG_TRACE_LOG_H_
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/diag/trace.h>
+
+/**
+ * @file trace-log.h
+ * @brief Levelled and categorised trace messages.
+ * @ingroup cmsis-plus-diag
+ * @details
+ * The macros `OS_LOG_ERROR()`, `OS_LOG_WARNING()`, `OS_LOG_INFO()`,
+ * `OS_LOG_DEBUG()` and `OS_LOG_VERBOSE()` take a category and
+ * a printf() format with arguments, and forward them to
+ * `trace_printf()`, prefixed by a level tag.
+ *
+ * Messages are filtered in two steps:
+ * - at compile time, levels above `OS_INTEGER_TRACE_LOG_LEVEL` expand
+ *   to nothing, and categories not in `OS_INTEGER_TRACE_LOG_CATEGORIES`
+ *   are removed as dead code, so neither the call nor the format
+ *   string get into the application;
+ * - at run time, the remaining messages are checked against a
+ *   single mask (`os_trace_log_mask`), with one bit for each level
+ *   and one bit for each category, in a single comparison.
+ *
+ * When `TRACE` is not defined, all macros expand to nothing.
+ */
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @name Log levels
+ * @{
+ */
+#define OS_LOG_LEVEL_NONE       (0)
+#define OS_LOG_LEVEL_ERROR      (1)
+#define OS_LOG_LEVEL_WARNING    (2)
+#define OS_LOG_LEVEL_INFO       (3)
+#define OS_LOG_LEVEL_DEBUG      (4)
+#define OS_LOG_LEVEL_VERBOSE    (5)
+/**
+ * @}
+ */
+
+/**
+ * @name Log categories
+ * @details
+ * The lower 8 bits of the mask are reserved for the levels.
+ * @{
+ */
+#define OS_LOG_CATEGORY_APP     (1UL << 8)
+#define OS_LOG_CATEGORY_RTOS    (1UL << 9)
+#define OS_LOG_CATEGORY_CLOCKS  (1UL << 10)
+#define OS_LOG_CATEGORY_SYNC    (1UL << 11)
+#define OS_LOG_CATEGORY_MEMORY  (1UL << 12)
+#define OS_LOG_CATEGORY_LIBC    (1UL << 13)
+#define OS_LOG_CATEGORY_DRIVERS (1UL << 14)
+#define OS_LOG_CATEGORY_USB     (1UL << 15)
+/**
+ * @brief Application defined categories, n = 0...15.
+ */
+#define OS_LOG_CATEGORY_USER(n) (1UL << (16 + (n)))
+#define OS_LOG_CATEGORY_ALL     (0xFFFFFF00UL)
+/**
+ * @}
+ */
+
+/**
+ * @brief The mask bit for a level.
+ */
+#define OS_LOG_LEVEL_BIT(level) (1UL << ((level) - 1))
+
+/**
+ * @brief The mask bits for a level and all lower (more severe) levels.
+ */
+#define OS_LOG_LEVELS_UPTO(level) ((1UL << (level)) - 1)
+
+#if !defined(OS_INTEGER_TRACE_LOG_LEVEL)
+#define OS_INTEGER_TRACE_LOG_LEVEL (OS_LOG_LEVEL_INFO)
+#endif
+
+#if !defined(OS_INTEGER_TRACE_LOG_CATEGORIES)
+#define OS_INTEGER_TRACE_LOG_CATEGORIES (OS_LOG_CATEGORY_ALL)
+#endif
+
+#if defined(TRACE)
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+  /**
+   * @brief The run time filter.
+   * @details
+   * One bit for each level (`OS_LOG_LEVEL_BIT()`), and one bit
+   * for each category. A message is displayed only if both its
+   * level bit and its category bit are set.
+   */
+  extern uint32_t os_trace_log_mask;
+
+#if defined(__cplusplus)
+}
+#endif
+
+/**
+ * @cond ignore
+ */
+
+// Both the level bit and the category bit are constants, so the
+// run time check is one load, one mask and one branch; categories
+// excluded at compile time fold to `if (0)` and are removed.
+#define OS_LOG_(level, tag, category, format, ...) \
+  do \
+    { \
+      if (((category) & (OS_INTEGER_TRACE_LOG_CATEGORIES)) != 0 \
+          && (os_trace_log_mask & (OS_LOG_LEVEL_BIT(level) | (category))) \
+              == (OS_LOG_LEVEL_BIT(level) | (category))) \
+        { \
+          trace_printf (tag format, ##__VA_ARGS__); \
+        } \
+    } \
+  while (0)
+
+/**
+ * @endcond
+ */
+
+#endif /* defined(TRACE) */
+
+#if defined(TRACE) && (OS_INTEGER_TRACE_LOG_LEVEL >= OS_LOG_LEVEL_ERROR)
+#define OS_LOG_ERROR(category, format, ...) \
+  OS_LOG_ (OS_LOG_LEVEL_ERROR, "E/", category, format, ##__VA_ARGS__)
+#else
+#define OS_LOG_ERROR(category, format, ...) do { } while (0)
+#endif
+
+#if defined(TRACE) && (OS_INTEGER_TRACE_LOG_LEVEL >= OS_LOG_LEVEL_WARNING)
+#define OS_LOG_WARNING(category, format, ...) \
+  OS_LOG_ (OS_LOG_LEVEL_WARNING, "W/", category, format, ##__VA_ARGS__)
+#else
+#define OS_LOG_WARNING(category, format, ...) do { } while (0)
+#endif
+
+#if defined(TRACE) && (OS_INTEGER_TRACE_LOG_LEVEL >= OS_LOG_LEVEL_INFO)
+#define OS_LOG_INFO(category, format, ...) \
+  OS_LOG_ (OS_LOG_LEVEL_INFO, "I/", category, format, ##__VA_ARGS__)
+#else
+#define OS_LOG_INFO(category, format, ...) do { } while (0)
+#endif
+
+#if defined(TRACE) && (OS_INTEGER_TRACE_LOG_LEVEL >= OS_LOG_LEVEL_DEBUG)
+#define OS_LOG_DEBUG(category, format, ...) \
+  OS_LOG_ (OS_LOG_LEVEL_DEBUG, "D/", category, format, ##__VA_ARGS__)
+#else
+#define OS_LOG_DEBUG(category, format, ...) do { } while (0)
+#endif
+
+#if defined(TRACE) && (OS_INTEGER_TRACE_LOG_LEVEL >= OS_LOG_LEVEL_VERBOSE)
+#define OS_LOG_VERBOSE(category, format, ...) \
+  OS_LOG_ (OS_LOG_LEVEL_VERBOSE, "V/", category, format, ##__VA_ARGS__)
+#else
+#define OS_LOG_VERBOSE(category, format, ...) do { } while (0)
+#endif
+
+// ----------------------------------------------------------------------------
+
+#if defined(__cplusplus)
+
+namespace os
+{
+  namespace trace
+  {
+    /**
+     * @brief Run time control of the levelled trace messages.
+     * @ingroup cmsis-plus-diag
+     * @details
+     * The changes are not atomic; the mask is intended to be
+     * configured from a single thread.
+     */
+    namespace log
+    {
+      /**
+       * @brief Get the run time mask.
+       * @par Parameters
+       *  None.
+       * @return The level and category bits.
+       */
+      uint32_t
+      mask (void);
+
+      /**
+       * @brief Set the run time mask.
+       * @param [in] m The level and category bits.
+       * @return The previous mask.
+       */
+      uint32_t
+      mask (uint32_t m);
+
+      /**
+       * @brief Display the messages up to the given level.
+       * @param [in] lvl One of the `OS_LOG_LEVEL_*` values.
+       * @return The previous mask.
+       */
+      uint32_t
+      level (uint32_t lvl);
+
+      /**
+       * @brief Enable categories.
+       * @param [in] categories The OR-ed `OS_LOG_CATEGORY_*` bits.
+       * @return The previous mask.
+       */
+      uint32_t
+      enable (uint32_t categories);
+
+      /**
+       * @brief Disable categories.
+       * @param [in] categories The OR-ed `OS_LOG_CATEGORY_*` bits.
+       * @return The previous mask.
+       */
+      uint32_t
+      disable (uint32_t categories);
+
+    } /* namespace log */
+  } /* namespace trace */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace trace
+  {
+    namespace log
+    {
+#if defined(TRACE)
+
+      inline uint32_t
+      mask (void)
+      {
+        return os_trace_log_mask;
+      }
+
+      inline uint32_t
+      mask (uint32_t m)
+      {
+        uint32_t tmp = os_trace_log_mask;
+        os_trace_log_mask = m;
+        return tmp;
+      }
+
+      inline uint32_t
+      level (uint32_t lvl)
+      {
+        uint32_t tmp = os_trace_log_mask;
+        os_trace_log_mask = (tmp & OS_LOG_CATEGORY_ALL)
+            | static_cast<uint32_t> (OS_LOG_LEVELS_UPTO(lvl));
+        return tmp;
+      }
+
+      inline uint32_t
+      enable (uint32_t categories)
+      {
+        uint32_t tmp = os_trace_log_mask;
+        os_trace_log_mask = tmp | (categories & OS_LOG_CATEGORY_ALL);
+        return tmp;
+      }
+
+      inline uint32_t
+      disable (uint32_t categories)
+      {
+        uint32_t tmp = os_trace_log_mask;
+        os_trace_log_mask = tmp & ~(categories & OS_LOG_CATEGORY_ALL);
+        return tmp;
+      }
+
+#else
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+      inline uint32_t __attribute__((always_inline))
+      mask (void)
+      {
+        return 0;
+      }
+
+      inline uint32_t __attribute__((always_inline))
+      mask (uint32_t m)
+      {
+        return 0;
+      }
+
+      inline uint32_t __attribute__((always_inline))
+      level (uint32_t lvl)
+      {
+        return 0;
+      }
+
+      inline uint32_t __attribute__((always_inline))
+      enable (uint32_t categories)
+      {
+        return 0;
+      }
+
+      inline uint32_t __attribute__((always_inline))
+      disable (uint32_t categories)
+      {
+        return 0;
+      }
+
+#pragma GCC diagnostic pop
+
+#endif /* defined(TRACE) */
+    } /* namespace log */
+  } /* namespace trace */
+} /* namespace os */
+
+#endif /* defined(__cplusplus) */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DIAG_TRACE_LOG_H_ */
@@ -35,6 +35,8 @@
 #include <cstddef>
 #include <cstdarg>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
 #else
 #include <stdint.h>
 #include <stdarg.h>
@@ -43,6 +45,16 @@
 
 #include <sys/types.h>
 
+#if defined(TRACE)
+#include <cmsis-plus/os-app-config.h>
+#endif
+
+#if defined(OS_USE_TRACE_BINARY)
+#if !defined(OS_INTEGER_TRACE_BINARY_RECORD_WORDS)
+#define OS_INTEGER_TRACE_BINARY_RECORD_WORDS (16)
+#endif
+#endif
+
 #if defined(__cplusplus)
 
 // To be effective, <stdio.h> must be included *before* this patch.
@@ -98,6 +110,11 @@ namespace os
    *
    * Trace support is enabled by adding the `TRACE` macro definition.
    *
+   * With `OS_USE_TRACE_BINARY`, the messages are not formatted on the
+   * target, but stored as binary records (see os::trace::binary).
+   * With `OS_USE_TRACE_ASYNC`, the messages are buffered and
+   * written by a background thread (see os::trace::async).
+   *
    * When `TRACE` is not defined, all functions are inlined to empty bodies.
    * This has the advantage that the trace calls do not need to be
    * conditionally compiled with
@@ -188,9 +205,377 @@ namespace os
       trace_dbg_bkpt ();
     }
 
+#if defined(OS_USE_TRACE_BINARY)
+
+    /**
+     * @brief Deferred formatting (binary) trace records.
+     * @details
+     * Instead of formatting the message on the target, only the
+     * address of the format string and the raw values of the
+     * arguments are stored, as a binary record, in a static ring
+     * buffer; the text is rendered later, on the host, by
+     * `scripts/trace-binary-decode.py`, which reads the format
+     * strings from the application ELF.
+     *
+     * Each record is a sequence of 32-bit words:
+     * - a header, with @ref marker in the upper half and the total
+     *   number of words (header included) in the lower half;
+     * - the address of the format string;
+     * - one word for each argument up to 32-bits, two words
+     *   (in memory order) for 64-bit arguments and for `double`;
+     * - for `%s`, a word with the string length, followed by the
+     *   characters, padded to a word boundary (strings are copied,
+     *   since they might not survive until the record is decoded).
+     *
+     * Records are either drained to the trace channel with drain(),
+     * or read directly from the `os_trace_binary_ring` structure
+     * by the debugger.
+     */
+    namespace binary
+    {
+      /**
+       * @brief Marker stored in the upper half of the record header.
+       */
+      constexpr uint32_t marker = 0xB1A50000;
+
+      /**
+       * @brief Mask to extract the marker from a record header.
+       */
+      constexpr uint32_t marker_mask = 0xFFFF0000;
+
+      /**
+       * @brief Assemble a binary record on the stack.
+       * @details
+       * The record is built in a local array and copied to
+       * the ring buffer by commit(), so the ring is locked only
+       * for the time needed to copy a few words. If the
+       * arguments do not fit, the record is truncated.
+       */
+      class packer
+      {
+      public:
+
+        explicit
+        packer (const char* format);
+
+        packer (const packer&) = delete;
+        packer (packer&&) = delete;
+        packer&
+        operator= (const packer&) = delete;
+        packer&
+        operator= (packer&&) = delete;
+
+        ~packer () = default;
+
+        void
+        put (uint32_t word);
+
+        void
+        put (uint64_t dword);
+
+        void
+        put (double value);
+
+        void
+        put (const void* ptr);
+
+        void
+        put (const char* str);
+
+        void
+        put (char* str);
+
+        template<typename T>
+          typename std::enable_if<
+              (std::is_integral<T>::value || std::is_enum<T>::value)
+                  && (sizeof(T) <= sizeof(uint32_t))>::type
+          put (T value);
+
+        template<typename T>
+          typename std::enable_if<
+              (std::is_integral<T>::value || std::is_enum<T>::value)
+                  && (sizeof(T) > sizeof(uint32_t))>::type
+          put (T value);
+
+        /**
+         * @brief Copy the record to the ring buffer.
+         * @return The number of bytes stored, or -1 if the ring is full.
+         */
+        int
+        commit (void);
+
+      protected:
+
+        std::size_t count_;
+        uint32_t words_[OS_INTEGER_TRACE_BINARY_RECORD_WORDS];
+      };
+
+      /**
+       * @brief Store a binary record, without formatting.
+       * @param [in] format A null terminated string with the format;
+       *  it must be a literal, the host reads it from the ELF.
+       * @param [in] args The arguments, as for printf().
+       * @return The number of bytes stored, or -1 if the ring is full.
+       *
+       * @details
+       * The argument types are known at compile time, so the
+       * format string is not even parsed on the target.
+       */
+      template<typename ... Args_T>
+        int
+        log (const char* format, Args_T ... args);
+
+      /**
+       * @brief Store a binary record from a variable arguments list.
+       * @param [in] format A null terminated string with the format.
+       * @param [in] args A variable arguments list.
+       * @return The number of bytes stored, or -1 if the ring is full.
+       *
+       * @details
+       * Since a `va_list` carries no types, the conversions in the
+       * format are parsed to extract the arguments; this is slower
+       * than log(), but still does not render any text.
+       */
+      int
+      vlog (const char* format, std::va_list args);
+
+      /**
+       * @brief Type of functions receiving the drained records.
+       * @details
+       * Same as write(): return the number of bytes accepted,
+       * which may be less than requested, or -1 if error.
+       */
+      using writer_t = ssize_t (*) (const void* buf, std::size_t nbyte);
+
+      /**
+       * @brief Write the completed records to the trace channel.
+       * @par Parameters
+       *  None.
+       * @return The number of bytes written.
+       *
+       * @details
+       * Should be called from a low priority thread, or when the
+       * application is idle. The records are passed to write()
+       * as they are, so the channel must be binary safe.
+       */
+      std::size_t
+      drain (void);
+
+      /**
+       * @brief Write the completed records with the given function.
+       * @param [in] writer The function writing the bytes, for
+       *  example to a file or to a USB serial port.
+       * @return The number of bytes written.
+       *
+       * @details
+       * Stops when all records were written, or when the writer
+       * accepts no more bytes; the rest are written by the next call.
+       */
+      std::size_t
+      drain (writer_t writer);
+
+      /**
+       * @brief Get the number of records dropped since startup.
+       * @par Parameters
+       *  None.
+       * @return The number of records that did not fit in the ring.
+       */
+      uint32_t
+      dropped (void);
+
+    } /* namespace binary */
+
+#endif /* defined(OS_USE_TRACE_BINARY) */
+
+#if defined(OS_USE_TRACE_ASYNC)
+
+    /**
+     * @brief Asynchronous trace output.
+     * @details
+     * The messages are stored as whole records in a ring buffer,
+     * without blocking, and a low priority thread passes them
+     * to the trace channel (`write()`). Any thread or interrupt
+     * may write; records are never mixed, even when written
+     * concurrently.
+     *
+     * With `OS_USE_TRACE_ASYNC`, `trace::printf()`, `trace::puts()`
+     * and `trace::putchar()` use this buffer; `trace::write()`
+     * remains a direct, synchronous, access to the channel.
+     */
+    namespace async
+    {
+      /**
+       * @brief What to do when the ring buffer is full.
+       */
+      enum class overflow : uint8_t
+      {
+        /**
+         * @brief Discard the new record.
+         */
+        drop = 0,
+
+        /**
+         * @brief Discard the oldest records not yet flushed.
+         */
+        overwrite = 1
+      };
+
+      /**
+       * @brief Store a record in the ring buffer.
+       * @param [in] buf Pointer to the bytes.
+       * @param [in] nbyte Number of bytes.
+       * @param [in] suffix Optional bytes to append to the same
+       *  record (like a line terminator); may be `nullptr`.
+       * @param [in] suffix_nbyte Number of suffix bytes.
+       * @return The number of bytes stored, or -1 if the record
+       *  was dropped.
+       */
+      ssize_t
+      write (const void* buf, std::size_t nbyte, const void* suffix = nullptr,
+             std::size_t suffix_nbyte = 0);
+
+      /**
+       * @brief Pass the stored records to the trace channel.
+       * @par Parameters
+       *  None.
+       * @return The number of bytes written.
+       */
+      std::size_t
+      flush (void);
+
+      /**
+       * @brief Get the number of records dropped since startup.
+       * @par Parameters
+       *  None.
+       * @return The number of discarded records, new or old.
+       */
+      uint32_t
+      dropped (void);
+
+      /**
+       * @brief Get the overflow policy.
+       * @par Parameters
+       *  None.
+       * @return The current policy.
+       */
+      overflow
+      policy (void);
+
+      /**
+       * @brief Set the overflow policy.
+       * @param [in] p The new policy.
+       * @return The previous policy.
+       */
+      overflow
+      policy (overflow p);
+
+    } /* namespace async */
+
+#endif /* defined(OS_USE_TRACE_ASYNC) */
+
   } /* namespace trace */
 } /* namespace os */
 
+#if defined(OS_USE_TRACE_BINARY)
+
+namespace os
+{
+  namespace trace
+  {
+    namespace binary
+    {
+      // ======================================================================
+
+      inline
+      packer::packer (const char* format) :
+          count_ (1)
+      {
+        put (static_cast<const void*> (format));
+      }
+
+      inline void
+      packer::put (uint32_t word)
+      {
+        if (count_ < OS_INTEGER_TRACE_BINARY_RECORD_WORDS)
+          {
+            words_[count_++] = word;
+          }
+      }
+
+      inline void
+      packer::put (uint64_t dword)
+      {
+        uint32_t w[2];
+        std::memcpy (w, &dword, sizeof(w));
+        put (w[0]);
+        put (w[1]);
+      }
+
+      inline void
+      packer::put (double value)
+      {
+        uint64_t dword;
+        std::memcpy (&dword, &value, sizeof(dword));
+        put (dword);
+      }
+
+      inline void
+      packer::put (const void* ptr)
+      {
+        if (sizeof(ptr) > sizeof(uint32_t))
+          {
+            put (static_cast<uint64_t> (reinterpret_cast<uintptr_t> (ptr)));
+          }
+        else
+          {
+            put (static_cast<uint32_t> (reinterpret_cast<uintptr_t> (ptr)));
+          }
+      }
+
+      inline void
+      packer::put (char* str)
+      {
+        put (static_cast<const char*> (str));
+      }
+
+      template<typename T>
+        inline typename std::enable_if<
+            (std::is_integral<T>::value || std::is_enum<T>::value)
+                && (sizeof(T) <= sizeof(uint32_t))>::type
+        packer::put (T value)
+        {
+          // Default argument promotions, as done for printf().
+          put (static_cast<uint32_t> (static_cast<int32_t> (value)));
+        }
+
+      template<typename T>
+        inline typename std::enable_if<
+            (std::is_integral<T>::value || std::is_enum<T>::value)
+                && (sizeof(T) > sizeof(uint32_t))>::type
+        packer::put (T value)
+        {
+          put (static_cast<uint64_t> (value));
+        }
+
+      template<typename ... Args_T>
+        inline int
+        log (const char* format, Args_T ... args)
+        {
+          packer p
+            { format };
+          // Expand the arguments in order (C++11 has no fold expressions).
+          int expand[] =
+            { 0, (p.put (args), 0)... };
+          (void) expand;
+          return p.commit ();
+        }
+
+    } /* namespace binary */
+  } /* namespace trace */
+} /* namespace os */
+
+#endif /* defined(OS_USE_TRACE_BINARY) */
+
 #endif /* defined(__cplusplus) */
 
 #if defined(__cplusplus)
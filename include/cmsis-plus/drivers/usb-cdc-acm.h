@@ -0,0 +1,365 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DRIVERS_USB_CDC_ACM_H_
+#define CMSIS_PLUS_DRIVERS_USB_CDC_ACM_H_
+
+// ----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+
+#include <cmsis-plus/drivers/serial.h>
+#include <cmsis-plus/drivers/usb-device-queue.h>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace device
+      {
+        namespace cdc
+        {
+          // ----- CDC PSTN class specific requests -----
+
+          constexpr uint8_t SET_LINE_CODING = 0x20;
+          constexpr uint8_t GET_LINE_CODING = 0x21;
+          constexpr uint8_t SET_CONTROL_LINE_STATE = 0x22;
+          constexpr uint8_t SEND_BREAK = 0x23;
+
+          // bmRequestType, without the direction bit:
+          // class request, addressed to an interface.
+          constexpr uint8_t REQUEST_TYPE_CLASS_INTERFACE = 0x21;
+
+          // SET_CONTROL_LINE_STATE bits.
+          constexpr uint16_t CONTROL_LINE_DTR = (1U << 0);
+          constexpr uint16_t CONTROL_LINE_RTS = (1U << 1);
+
+          constexpr std::size_t LINE_CODING_SIZE = 7;
+
+          /**
+           * @brief Line coding, as set by the host.
+           */
+          struct Line_coding
+          {
+            // Data terminal rate, in bits per second.
+            uint32_t dte_rate;
+            // 0 = 1 stop bit, 1 = 1.5 stop bits, 2 = 2 stop bits.
+            uint8_t char_format;
+            // 0 = none, 1 = odd, 2 = even, 3 = mark, 4 = space.
+            uint8_t parity_type;
+            // 5, 6, 7, 8 or 16.
+            uint8_t data_bits;
+          };
+
+        } /* namespace cdc */
+
+        // ==================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+        /**
+         * @brief CDC-ACM (virtual COM port) function.
+         * @details
+         * Implements the data interface of a CDC Abstract Control
+         * Model function on a pair of bulk endpoints, and presents
+         * it to the application as a `driver::Serial`, so it can be
+         * used directly, or below a `posix::buffered_serial`.
+         *
+         * Two OUT packets and up to two IN transfers are kept
+         * pending on the endpoints, via endpoint queues, so the
+         * bus is not idle while a transfer is processed.
+         *
+         * The received packets are copied into the user receive
+         * buffer, if a receive is active, or into the receive ring;
+         * when the ring is full, the packets are held in the OUT
+         * buffers, and the host is NAKed until there is room.
+         *
+         * The bytes sent are copied into the transmit ring, which
+         * is sent by IN transfers directly from the ring; a transfer
+         * that ends on a packet boundary, with no more bytes to send,
+         * is followed by a zero length packet.
+         *
+         * The enumeration is not handled here; the device core
+         * must call set_configured() when the host selects or
+         * resets the configuration, and forward the class requests
+         * to control_request() and, after the data stage of the
+         * host to device requests, to control_data().
+         *
+         * The first `2 * packet_size` bytes of the receive buffer
+         * are used for the OUT packets, and the rest for the ring.
+         * The memory pool must have at least 4 blocks.
+         */
+        class Cdc_acm : public Serial
+        {
+        public:
+
+          // ----------------------------------------------------------------
+
+          Cdc_acm (Transfer_queues& queues, endpoint_t ep_in,
+                   endpoint_t ep_out, packet_size_t packet_size,
+                   rtos::memory_pool& pool, uint8_t* rx_buffer,
+                   std::size_t rx_size, uint8_t* tx_buffer,
+                   std::size_t tx_size) noexcept;
+
+          Cdc_acm (const Cdc_acm&) = delete;
+
+          Cdc_acm (Cdc_acm&&) = delete;
+
+          Cdc_acm&
+          operator= (const Cdc_acm&) = delete;
+
+          Cdc_acm&
+          operator= (Cdc_acm&&) = delete;
+
+          virtual
+          ~Cdc_acm () noexcept;
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Enable or disable the data endpoints.
+           * @param [in]   configured  true when the host selected a
+           *  configuration with this function, false on reset or
+           *  when the configuration is cleared.
+           * @return      Execution status.
+           * @details
+           * Both rings are emptied; a send or receive in progress
+           * continues after the function is configured again.
+           */
+          return_t
+          set_configured (bool configured) noexcept;
+
+          bool
+          is_configured (void) const noexcept;
+
+          /**
+           * @brief       Process a class request.
+           * @param [in]   setup  The 8 bytes SETUP packet.
+           * @param [out]  data  The buffer for the data stage.
+           * @param [out]  length  The length of the data stage.
+           * @retval true The request was accepted; the core must
+           *  perform the data stage, if length is not zero, and
+           *  the status stage.
+           * @retval false Unknown request; the core should stall
+           *  the control endpoint.
+           */
+          bool
+          control_request (const uint8_t* setup, uint8_t*& data,
+                           std::size_t& length) noexcept;
+
+          /**
+           * @brief       Complete a host to device class request.
+           * @param [in]   setup  The SETUP packet of the request.
+           * @details
+           * Called after the data stage was received in the
+           * buffer returned by control_request().
+           */
+          void
+          control_data (const uint8_t* setup) noexcept;
+
+          /**
+           * @brief       Get the line coding set by the host.
+           */
+          const cdc::Line_coding&
+          get_line_coding (void) const noexcept;
+
+          // ----------------------------------------------------------------
+
+        protected:
+
+          virtual const Version&
+          do_get_version (void) noexcept override;
+
+          virtual const serial::Capabilities&
+          do_get_capabilities (void) noexcept override;
+
+          virtual return_t
+          do_power (Power state) noexcept override;
+
+          virtual return_t
+          do_send (const void* data, std::size_t num) noexcept override;
+
+          virtual return_t
+          do_receive (void* data, std::size_t num) noexcept override;
+
+          virtual return_t
+          do_transfer (const void* data_out, void* data_in, std::size_t num)
+              noexcept override;
+
+          virtual std::size_t
+          do_get_tx_count (void) noexcept override;
+
+          virtual std::size_t
+          do_get_rx_count (void) noexcept override;
+
+          virtual return_t
+          do_configure (serial::config_t cfg, serial::config_arg_t arg)
+              noexcept override;
+
+          virtual return_t
+          do_control (serial::control_t ctrl) noexcept override;
+
+          virtual serial::Status&
+          do_get_status (void) noexcept override;
+
+          virtual return_t
+          do_control_modem_line (serial::Modem_control ctrl) noexcept override;
+
+          virtual serial::Modem_status&
+          do_get_modem_status (void) noexcept override;
+
+          // ----------------------------------------------------------------
+
+        private:
+
+          static void
+          signal_out (const void* object, endpoint_t ep_addr,
+                      std::size_t count, return_t status);
+
+          static void
+          signal_in (const void* object, endpoint_t ep_addr,
+                     std::size_t count, return_t status);
+
+          void
+          reset_ (void) noexcept;
+
+          std::size_t
+          rx_deliver_ (const uint8_t* data, std::size_t num) noexcept;
+
+          void
+          rx_flush_ (void) noexcept;
+
+          void
+          tx_fill_ (void) noexcept;
+
+          void
+          tx_start_ (void) noexcept;
+
+          return_t
+          tx_submit_ (uint8_t* data, std::size_t num) noexcept;
+
+          void
+          flush_events_ (void) noexcept;
+
+          uint8_t*
+          out_packet_ (std::size_t index) const noexcept;
+
+          Device& device_;
+
+          Endpoint_queue in_queue_;
+          Endpoint_queue out_queue_;
+
+          serial::Capabilities capa_;
+
+          cdc::Line_coding line_coding_;
+          uint8_t line_coding_buffer_[cdc::LINE_CODING_SIZE];
+
+          packet_size_t packet_size_;
+
+          // The OUT packets, followed by the receive ring.
+          uint8_t* rx_buffer_;
+          uint8_t* rx_ring_;
+          std::size_t rx_size_;
+          std::size_t rx_head_ = 0;
+          std::size_t rx_tail_ = 0;
+          std::size_t rx_level_ = 0;
+
+          // The oldest OUT packet, and how many completed packets
+          // are waiting for room; the others are pending.
+          std::size_t out_first_ = 0;
+          std::size_t out_held_ = 0;
+          std::size_t out_length_[2];
+          std::size_t out_offset_[2];
+
+          // The user receive.
+          uint8_t* rx_data_ = nullptr;
+          std::size_t rx_num_ = 0;
+          std::size_t rx_count_ = 0;
+
+          uint8_t* tx_ring_;
+          std::size_t tx_size_;
+          std::size_t tx_tail_ = 0;
+          std::size_t tx_level_ = 0;
+          // Bytes from the tail already given to IN transfers.
+          std::size_t tx_queued_ = 0;
+
+          // Lengths of the IN transfers, in order.
+          std::size_t in_first_ = 0;
+          std::size_t in_flight_ = 0;
+          std::size_t in_length_[2];
+
+          // The user send.
+          const uint8_t* tx_data_ = nullptr;
+          std::size_t tx_num_ = 0;
+          std::size_t tx_count_ = 0;
+
+          // Events to signal when leaving the critical section.
+          event_t events_ = 0;
+
+          bool configured_ = false;
+          bool tx_enabled_ = false;
+          bool rx_enabled_ = false;
+        };
+
+#pragma GCC diagnostic pop
+
+        // ------------------------------------------------------------------
+
+        inline bool
+        Cdc_acm::is_configured (void) const noexcept
+        {
+          return configured_;
+        }
+
+        inline const cdc::Line_coding&
+        Cdc_acm::get_line_coding (void) const noexcept
+        {
+          return line_coding_;
+        }
+
+        inline uint8_t*
+        Cdc_acm::out_packet_ (std::size_t index) const noexcept
+        {
+          return rx_buffer_ + index * packet_size_;
+        }
+
+      } /* namespace device */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+#endif /* __cplusplus */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DRIVERS_USB_CDC_ACM_H_ */
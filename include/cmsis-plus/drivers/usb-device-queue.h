@@ -0,0 +1,361 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DRIVERS_USB_DEVICE_QUEUE_H_
+#define CMSIS_PLUS_DRIVERS_USB_DEVICE_QUEUE_H_
+
+// ----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+
+#include <cmsis-plus/drivers/usb-device.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace device
+      {
+        // ==================================================================
+
+        /**
+         * @brief Scatter-gather segment.
+         */
+        struct Segment
+        {
+          uint8_t* data;
+          std::size_t num;
+        };
+
+        /**
+         * @brief Transfer completion callback.
+         * @details
+         * Called from the endpoint interrupt, with the number of bytes
+         * transferred and `RETURN_OK`, or `ERROR` if the transfer
+         * failed or was aborted. New transfers may be submitted
+         * from the callback.
+         */
+        typedef void
+        (*signal_transfer_t) (const void* object, endpoint_t ep_addr,
+                              std::size_t count, return_t status);
+
+        class Endpoint_queue;
+
+        // ==================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+        /**
+         * @brief Transfer request descriptor.
+         * @details
+         * Allocated by the queue from a memory pool, with blocks
+         * of at least `sizeof(Transfer_request)` bytes, and freed
+         * before the completion callback is invoked.
+         */
+        class Transfer_request
+        {
+        public:
+
+          // Either an array of segments, or the inline one.
+          const Segment* segments;
+          std::size_t segments_count;
+          Segment single;
+
+          // Current segment and total bytes transferred.
+          std::size_t index;
+          std::size_t count;
+
+          signal_transfer_t cb_func;
+          const void* cb_object;
+
+          Transfer_request* next;
+        };
+
+        // ==================================================================
+
+        /**
+         * @brief Endpoint transfer queues of a device.
+         * @details
+         * Takes over the device endpoint callback and routes the
+         * events to the queue of each endpoint. The events of the
+         * endpoints without a queue (like the control endpoint)
+         * are forwarded to the callback registered here.
+         */
+        class Transfer_queues
+        {
+        public:
+
+          // ----------------------------------------------------------------
+
+          Transfer_queues (Device& device) noexcept;
+
+          Transfer_queues (const Transfer_queues&) = delete;
+
+          Transfer_queues (Transfer_queues&&) = delete;
+
+          Transfer_queues&
+          operator= (const Transfer_queues&) = delete;
+
+          Transfer_queues&
+          operator= (Transfer_queues&&) = delete;
+
+          ~Transfer_queues () noexcept;
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Register the callback for the other endpoints.
+           * @param [in]   cb_func  Pointer to function.
+           * @param [in] cb_object Pointer to object passed to the function.
+           */
+          void
+          register_endpoint_callback (signal_endpoint_event_t cb_func,
+                                      const void* cb_object = nullptr) noexcept;
+
+          Device&
+          get_device (void) noexcept;
+
+          // ----------------------------------------------------------------
+
+        private:
+
+          friend class Endpoint_queue;
+
+          static void
+          signal_endpoint_event (const void* object, endpoint_t ep_addr,
+                                 event_t event);
+
+          Endpoint_queue*&
+          slot (endpoint_t ep_addr) noexcept;
+
+          Device& device_;
+
+          // Indexed by direction (0 = OUT, 1 = IN) and number.
+          Endpoint_queue* queues_[2][ENDPOINT_NUMBER_MASK + 1];
+
+          signal_endpoint_event_t cb_endpoint_func_;
+          const void* cb_endpoint_object_;
+        };
+
+        // ==================================================================
+
+        /**
+         * @brief Endpoint transfer queue.
+         * @details
+         * Keeps several transfers pending on an endpoint; when one
+         * completes, the next one is started from the endpoint
+         * interrupt, before invoking the completion callback, so
+         * the endpoint is not left idle between transfers.
+         *
+         * A transfer may be split in several segments (scatter-gather),
+         * each started as a separate driver transfer. Since a short
+         * packet ends the transfer on the bus, every segment except
+         * the last one must be a multiple of the endpoint maximum
+         * packet size. On OUT endpoints a short packet ends the
+         * transfer. A zero length transfer on an IN endpoint sends
+         * a zero-length packet.
+         *
+         * @par Example
+         *
+         * @code{.cpp}
+         * os::rtos::memory_pool_static<usb::device::Transfer_request, 8> pool;
+         *
+         * usb::device::Transfer_queues queues { usbd };
+         * usb::device::Endpoint_queue bulk_in { queues, 0x81, pool };
+         *
+         * bulk_in.submit (buf1, sizeof(buf1), done_cb, nullptr);
+         * bulk_in.submit (buf2, sizeof(buf2), done_cb, nullptr);
+         * @endcode
+         */
+        class Endpoint_queue
+        {
+        public:
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Construct an endpoint queue.
+           * @param [in]   queues  The transfer queues of the device.
+           * @param [in]   ep_addr  Endpoint address.
+           * @param [in]   pool  Pool for the request descriptors.
+           * @param [in]   packet_size  Endpoint maximum packet size,
+           *  used to check the scatter-gather segments, or 0.
+           */
+          Endpoint_queue (Transfer_queues& queues, endpoint_t ep_addr,
+                          rtos::memory_pool& pool,
+                          packet_size_t packet_size = 0) noexcept;
+
+          Endpoint_queue (const Endpoint_queue&) = delete;
+
+          Endpoint_queue (Endpoint_queue&&) = delete;
+
+          Endpoint_queue&
+          operator= (const Endpoint_queue&) = delete;
+
+          Endpoint_queue&
+          operator= (Endpoint_queue&&) = delete;
+
+          ~Endpoint_queue () noexcept;
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Queue a transfer.
+           * @param [in]   data  Pointer to the buffer.
+           * @param [in]   num  Number of bytes to transfer.
+           * @param [in]   cb_func  Completion callback (optional).
+           * @param [in]   cb_object  Pointer passed to the callback.
+           * @retval RETURN_OK The transfer was queued.
+           * @retval ERROR_BUSY No more request descriptors.
+           * @retval ERROR The transfer could not be started.
+           * @details
+           * Can be invoked from interrupts.
+           */
+          return_t
+          submit (uint8_t* data, std::size_t num,
+                  signal_transfer_t cb_func = nullptr,
+                  const void* cb_object = nullptr) noexcept;
+
+          /**
+           * @brief       Queue a scatter-gather transfer.
+           * @param [in]   segments  Array of segments, that must be
+           *  valid until the transfer completes.
+           * @param [in]   count  Number of segments.
+           * @param [in]   cb_func  Completion callback (optional).
+           * @param [in]   cb_object  Pointer passed to the callback.
+           * @retval RETURN_OK The transfer was queued.
+           * @retval ERROR_PARAMETER No segments, or, if the packet
+           *  size is known, a segment other than the last one is not
+           *  a multiple of it.
+           * @retval ERROR_BUSY No more request descriptors.
+           * @retval ERROR The transfer could not be started.
+           * @details
+           * All segments except the last one must be a multiple of
+           * the endpoint maximum packet size.
+           */
+          return_t
+          submit (const Segment* segments, std::size_t count,
+                  signal_transfer_t cb_func = nullptr,
+                  const void* cb_object = nullptr) noexcept;
+
+          /**
+           * @brief       Abort all the queued transfers.
+           * @details
+           * The callbacks are invoked with `ERROR`.
+           */
+          void
+          abort (void) noexcept;
+
+          /**
+           * @brief       Get the number of queued transfers,
+           *  including the active one.
+           */
+          std::size_t
+          pending (void) const noexcept;
+
+          endpoint_t
+          get_address (void) const noexcept;
+
+          // ----------------------------------------------------------------
+
+        private:
+
+          friend class Transfer_queues;
+
+          void
+          signal_event (void) noexcept;
+
+          return_t
+          enqueue (Transfer_request* req) noexcept;
+
+          return_t
+          start (void) noexcept;
+
+          Transfer_request*
+          fail_head (void) noexcept;
+
+          void
+          complete (Transfer_request* req, return_t status) noexcept;
+
+          Transfer_queues& queues_;
+          rtos::memory_pool& pool_;
+
+          Transfer_request* head_ = nullptr;
+          Transfer_request* tail_ = nullptr;
+          std::size_t pending_ = 0;
+
+          endpoint_t ep_addr_;
+          packet_size_t packet_size_;
+          bool active_ = false;
+        };
+
+#pragma GCC diagnostic pop
+
+        // ------------------------------------------------------------------
+
+        inline Device&
+        Transfer_queues::get_device (void) noexcept
+        {
+          return device_;
+        }
+
+        inline Endpoint_queue*&
+        Transfer_queues::slot (endpoint_t ep_addr) noexcept
+        {
+          return queues_[((ep_addr & ENDPOINT_DIRECTION_MASK) != 0) ? 1 : 0][ep_addr
+              & ENDPOINT_NUMBER_MASK];
+        }
+
+        inline std::size_t
+        Endpoint_queue::pending (void) const noexcept
+        {
+          return pending_;
+        }
+
+        inline endpoint_t
+        Endpoint_queue::get_address (void) const noexcept
+        {
+          return ep_addr_;
+        }
+
+      } /* namespace device */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+#endif /* __cplusplus */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DRIVERS_USB_DEVICE_QUEUE_H_ */
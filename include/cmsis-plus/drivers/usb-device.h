@@ -332,6 +332,20 @@ namespace os
         return_t
         transfer (endpoint_t ep_addr, uint8_t* data, std::size_t num) noexcept;
 
+        /**
+         * @brief       Send a zero-length packet on an IN endpoint.
+         * @param [in]   ep_addr  Endpoint Address
+         *                - ep_addr.0..3: Address
+         *                - ep_addr.7:    Direction
+         * @return      Execution status.
+         * @details
+         * Used to terminate an IN transfer whose length is a multiple
+         * of the maximum packet size; `transfer()` ignores zero
+         * length requests.
+         */
+        return_t
+        transfer_zero_length (endpoint_t ep_addr) noexcept;
+
         /**
          * @brief       Get result of USB Endpoint transfer.
          * @param [in]   ep_addr  Endpoint Address
@@ -0,0 +1,371 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_DRIVERS_USB_HOST_QUEUE_H_
+#define CMSIS_PLUS_DRIVERS_USB_HOST_QUEUE_H_
+
+// ----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+
+#include <cmsis-plus/drivers/usb-host.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace host
+      {
+        class Urb;
+        class Pipe_queue;
+
+        /**
+         * @brief Request completion callback.
+         * @details
+         * Called from the thread that dispatches the completions.
+         * The request may be submitted again from the callback.
+         */
+        typedef void
+        (*signal_urb_t) (const void* object, Urb& urb);
+
+        // ==================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+        /**
+         * @brief USB request block.
+         * @details
+         * Describes one pipe transfer; the object belongs to the
+         * caller and must remain valid until the completion
+         * callback is invoked.
+         */
+        class Urb
+        {
+        public:
+
+          // ----- Set by the caller -----
+
+          // Packet token and data toggle (PACKET_xxx).
+          uint32_t packet;
+          uint8_t* data;
+          // Zero sends or expects a zero length packet.
+          std::size_t num;
+
+          signal_urb_t cb_func;
+          const void* cb_object;
+
+          // ----- Set on completion -----
+
+          // Bytes transferred.
+          std::size_t count;
+          // The last pipe event (Pipe_event).
+          event_t event;
+          // RETURN_OK, or ERROR if failed or aborted.
+          return_t status;
+
+        private:
+
+          friend class Pipe_queue;
+          friend class Pipe_queues;
+
+          Pipe_queue* queue_;
+          Urb* next_;
+        };
+
+        // ==================================================================
+
+        /**
+         * @brief Pipe request queues of a host.
+         * @details
+         * Takes over the host pipe callback and routes the events
+         * to the queue of each pipe; the events of the pipes
+         * without a queue are forwarded to the callback registered
+         * here.
+         *
+         * The completed requests are collected in interrupt context
+         * and their callbacks are invoked later, in the thread that
+         * calls dispatch(), usually a thread dedicated to the USB
+         * stack.
+         */
+        class Pipe_queues
+        {
+        public:
+
+          // ----------------------------------------------------------------
+
+          Pipe_queues (Host& host) noexcept;
+
+          Pipe_queues (const Pipe_queues&) = delete;
+
+          Pipe_queues (Pipe_queues&&) = delete;
+
+          Pipe_queues&
+          operator= (const Pipe_queues&) = delete;
+
+          Pipe_queues&
+          operator= (Pipe_queues&&) = delete;
+
+          ~Pipe_queues () noexcept;
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Register the callback for the other pipes.
+           * @param [in]   cb_func  Pointer to function.
+           * @param [in] cb_object Pointer to object passed to the function.
+           */
+          void
+          register_pipe_callback (signal_pipe_event_t cb_func,
+                                  const void* cb_object = nullptr) noexcept;
+
+          /**
+           * @brief       Wait for completed requests and invoke
+           *  their callbacks.
+           * @return      The number of callbacks invoked.
+           */
+          std::size_t
+          dispatch (void) noexcept;
+
+          /**
+           * @brief       Invoke the callbacks of the requests
+           *  completed so far, without waiting.
+           * @return      The number of callbacks invoked.
+           */
+          std::size_t
+          try_dispatch (void) noexcept;
+
+          /**
+           * @brief       Wait, with timeout, for completed requests
+           *  and invoke their callbacks.
+           * @param [in]   timeout  Timeout to wait, in clock units.
+           * @return      The number of callbacks invoked, 0 on timeout.
+           */
+          std::size_t
+          timed_dispatch (rtos::clock::duration_t timeout) noexcept;
+
+          Host&
+          get_host (void) noexcept;
+
+          // ----------------------------------------------------------------
+
+        private:
+
+          friend class Pipe_queue;
+
+          static void
+          signal_pipe_event (const void* object, pipe_t pipe, event_t event);
+
+          void
+          done_ (Urb* urb) noexcept;
+
+          Host& host_;
+
+          // The pipes with queues.
+          Pipe_queue* queues_ = nullptr;
+
+          // The completed requests, in order.
+          Urb* done_head_ = nullptr;
+          Urb* done_tail_ = nullptr;
+
+          rtos::semaphore_binary done_semaphore_
+            { "usbh-done", 0 };
+
+          signal_pipe_event_t cb_pipe_func_ = nullptr;
+          const void* cb_pipe_object_ = nullptr;
+        };
+
+        // ==================================================================
+
+        /**
+         * @brief Pipe request queue.
+         * @details
+         * Keeps several requests pending on a pipe; when one
+         * completes, the next one is started from the interrupt,
+         * so the pipe is not idle while the completion is
+         * processed. Together with the queues of the other pipes,
+         * this keeps several transfers in flight on the bus.
+         *
+         * A request that fails (stall, bus error) halts the queue;
+         * the next requests stay queued until restart(), usually
+         * after the pipe was reset, or abort().
+         *
+         * @par Example
+         *
+         * @code{.cpp}
+         * usb::host::Pipe_queues queues { usbh };
+         * usb::host::Pipe_queue bulk_in { queues, pipe };
+         *
+         * for (auto& urb : urbs)
+         *   {
+         *     urb.packet = usb::host::PACKET_IN;
+         *     urb.data = buffer (urb);
+         *     urb.num = 512;
+         *     urb.cb_func = read_done;
+         *     bulk_in.submit (urb);
+         *   }
+         *
+         * for (;;)
+         *   {
+         *     queues.dispatch ();
+         *   }
+         * @endcode
+         */
+        class Pipe_queue
+        {
+        public:
+
+          // ----------------------------------------------------------------
+
+          Pipe_queue (Pipe_queues& queues, pipe_t pipe) noexcept;
+
+          Pipe_queue (const Pipe_queue&) = delete;
+
+          Pipe_queue (Pipe_queue&&) = delete;
+
+          Pipe_queue&
+          operator= (const Pipe_queue&) = delete;
+
+          Pipe_queue&
+          operator= (Pipe_queue&&) = delete;
+
+          ~Pipe_queue () noexcept;
+
+          // ----------------------------------------------------------------
+
+          /**
+           * @brief       Queue a request.
+           * @param [in]   urb  The request.
+           * @retval RETURN_OK The request was queued.
+           * @retval ERROR The request could not be started.
+           * @details
+           * Can be invoked from interrupts.
+           */
+          return_t
+          submit (Urb& urb) noexcept;
+
+          /**
+           * @brief       Abort all the queued requests.
+           * @details
+           * The requests complete with `ERROR`; their callbacks
+           * are invoked by the dispatcher, as usual.
+           */
+          void
+          abort (void) noexcept;
+
+          /**
+           * @brief       Resume a halted queue.
+           * @return      Execution status.
+           */
+          return_t
+          restart (void) noexcept;
+
+          bool
+          is_halted (void) const noexcept;
+
+          /**
+           * @brief       Get the number of queued requests,
+           *  including the active one.
+           */
+          std::size_t
+          pending (void) const noexcept;
+
+          pipe_t
+          get_pipe (void) const noexcept;
+
+          // ----------------------------------------------------------------
+
+        private:
+
+          friend class Pipe_queues;
+
+          void
+          signal_event (event_t event) noexcept;
+
+          return_t
+          start_ (void) noexcept;
+
+          Urb*
+          pop_ (void) noexcept;
+
+          Pipe_queues& queues_;
+          pipe_t pipe_;
+
+          Urb* head_ = nullptr;
+          Urb* tail_ = nullptr;
+          std::size_t pending_ = 0;
+
+          Pipe_queue* next_ = nullptr;
+
+          bool active_ = false;
+          bool halted_ = false;
+        };
+
+#pragma GCC diagnostic pop
+
+        // ------------------------------------------------------------------
+
+        inline Host&
+        Pipe_queues::get_host (void) noexcept
+        {
+          return host_;
+        }
+
+        inline bool
+        Pipe_queue::is_halted (void) const noexcept
+        {
+          return halted_;
+        }
+
+        inline std::size_t
+        Pipe_queue::pending (void) const noexcept
+        {
+          return pending_;
+        }
+
+        inline pipe_t
+        Pipe_queue::get_pipe (void) const noexcept
+        {
+          return pipe_;
+        }
+
+      } /* namespace host */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+#endif /* __cplusplus */
+
+// ----------------------------------------------------------------------------
+
+#endif /* CMSIS_PLUS_DRIVERS_USB_HOST_QUEUE_H_ */
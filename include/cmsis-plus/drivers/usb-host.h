@@ -195,6 +195,36 @@ namespace os
           bus_err = (1UL << 6)
         };
 
+        // ==================================================================
+        // ----- USB Host Pipe Transfer Packets -----
+
+        // For compatibility with ARM CMSIS, these values should be
+        // exactly the same.
+
+        constexpr uint32_t PACKET_TOKEN_Pos = 0;
+        constexpr uint32_t PACKET_TOKEN_Msk = (0x0FUL << PACKET_TOKEN_Pos);
+
+        ///< SETUP Packet
+        constexpr uint32_t PACKET_SETUP = (0x01UL << PACKET_TOKEN_Pos);
+
+        ///< OUT Packet
+        constexpr uint32_t PACKET_OUT = (0x02UL << PACKET_TOKEN_Pos);
+
+        ///< IN Packet
+        constexpr uint32_t PACKET_IN = (0x03UL << PACKET_TOKEN_Pos);
+
+        ///< PING Packet
+        constexpr uint32_t PACKET_PING = (0x04UL << PACKET_TOKEN_Pos);
+
+        constexpr uint32_t PACKET_DATA_Pos = 4;
+        constexpr uint32_t PACKET_DATA_Msk = (0x0FUL << PACKET_DATA_Pos);
+
+        ///< DATA0 PID
+        constexpr uint32_t PACKET_DATA0 = (0x01UL << PACKET_DATA_Pos);
+
+        ///< DATA1 PID
+        constexpr uint32_t PACKET_DATA1 = (0x02UL << PACKET_DATA_Pos);
+
         // ------------------------------------------------------------------
 
         typedef void
@@ -289,6 +319,19 @@ namespace os
         transfer (pipe_t pipe, uint32_t packet, uint8_t* data, std::size_t num)
             noexcept;
 
+        /**
+         * @brief       Transfer a zero-length packet.
+         * @param [in]   pipe  Pipe handle.
+         * @param [in]   packet  Packet information.
+         * @return      Execution status.
+         * @details
+         * Used for the status stage of the control transfers and
+         * to terminate OUT transfers; `transfer()` ignores zero
+         * length requests.
+         */
+        return_t
+        transfer_zero_length (pipe_t pipe, uint32_t packet) noexcept;
+
         std::size_t
         get_transfer_count (pipe_t pipe) noexcept;
 
@@ -47,6 +47,28 @@ namespace os
     void
     free (void *ptr) noexcept;
 
+    void*
+    aligned_alloc (std::size_t alignment, std::size_t size) noexcept;
+
+    /**
+     * @cond ignore
+     */
+
+    namespace internal
+    {
+      // The site is used only when the allocation profiler is enabled.
+      void*
+      malloc (std::size_t size, const void* site) noexcept;
+
+      void*
+      aligned_alloc (std::size_t alignment, std::size_t size,
+                     const void* site) noexcept;
+    } /* namespace internal */
+
+    /**
+     * @endcond
+     */
+
   /**
    * @}
    */
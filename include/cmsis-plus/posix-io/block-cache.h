@@ -0,0 +1,260 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_BLOCK_CACHE_H_
+#define CMSIS_PLUS_POSIX_IO_BLOCK_CACHE_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/block-device.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Block cache.
+     * @headerfile block-cache.h <cmsis-plus/posix-io/block-cache.h>
+     * @details
+     * A fixed number of block buffers (lines), allocated from a
+     * memory resource, between the file systems and a block device.
+     *
+     * - when all lines are in use, the least recently used one
+     *   is reused;
+     * - modified lines are written to the device only when reused,
+     *   or by `sync()` (write-back);
+     * - when consecutive blocks are accessed, the next blocks are
+     *   read in advance, in clean lines (read-ahead).
+     *
+     * The cache is not thread safe; the file systems serialise the
+     * accesses.
+     */
+    class block_cache
+    {
+    public:
+
+      using blknum_t = block_device::blknum_t;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      /**
+       * @brief Construct a block cache.
+       * @param [in] device The cached block device.
+       * @param [in] lines Number of block buffers; must not be zero.
+       * @param [in] read_ahead Number of blocks read in advance; 0 to
+       *  disable.
+       * @param [in] resource The memory resource for the buffers.
+       */
+      block_cache (block_device& device, std::size_t lines,
+                   std::size_t read_ahead = 1,
+                   rtos::memory::memory_resource* resource =
+                       rtos::memory::get_default_resource ());
+
+      block_cache (const block_cache&) = delete;
+      block_cache (block_cache&&) = delete;
+      block_cache&
+      operator= (const block_cache&) = delete;
+      block_cache&
+      operator= (block_cache&&) = delete;
+
+      ~block_cache () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      /**
+       * @brief Get a block for reading.
+       * @param [in] blknum Block number.
+       * @return Pointer to the cached content, valid until the next
+       *  call, or `nullptr` with `errno` set.
+       */
+      const void*
+      read (blknum_t blknum);
+
+      /**
+       * @brief Get a block for writing.
+       * @param [in] blknum Block number.
+       * @param [in] overwrite The entire block will be written, so
+       *  the content is not read from the device.
+       * @return Pointer to the cached content, valid until the next
+       *  call, or `nullptr` with `errno` set.
+       */
+      void*
+      modify (blknum_t blknum, bool overwrite = false);
+
+      /**
+       * @brief Discard a block, without writing it.
+       * @param [in] blknum Block number.
+       * @details
+       * Used when the file system frees the block.
+       */
+      void
+      invalidate (blknum_t blknum);
+
+      /**
+       * @brief Write all modified blocks and sync the device.
+       * @retval 0 All blocks were written.
+       * @retval -1 Error, with `errno` set.
+       */
+      int
+      sync (void);
+
+      std::size_t
+      block_size (void) const;
+
+      block_device&
+      device (void);
+
+      std::size_t
+      hits (void) const;
+
+      std::size_t
+      misses (void) const;
+
+      /**
+       * @}
+       */
+
+    private:
+
+      /**
+       * @cond ignore
+       */
+
+      struct line
+      {
+        line* prev;
+        line* next;
+        uint8_t* data;
+        blknum_t blknum;
+        bool dirty;
+      };
+
+      line*
+      find_ (blknum_t blknum);
+
+      line*
+      get_ (blknum_t blknum, bool fill);
+
+      void
+      touch_ (line* ln);
+
+      int
+      write_back_ (line* ln);
+
+      void
+      read_ahead_ (blknum_t blknum);
+
+      block_device& device_;
+      rtos::memory::memory_resource* resource_;
+
+      line* lines_;
+      uint8_t* buffers_;
+      std::size_t lines_count_;
+      std::size_t read_ahead_count_;
+
+      // Most and least recently used lines.
+      line* mru_ = nullptr;
+      line* lru_ = nullptr;
+
+      blknum_t last_blknum_ = block_device::no_block;
+
+      std::size_t hits_ = 0;
+      std::size_t misses_ = 0;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline std::size_t
+    block_cache::block_size (void) const
+    {
+      return device_.block_size ();
+    }
+
+    inline block_device&
+    block_cache::device (void)
+    {
+      return device_;
+    }
+
+    inline std::size_t
+    block_cache::hits (void) const
+    {
+      return hits_;
+    }
+
+    inline std::size_t
+    block_cache::misses (void) const
+    {
+      return misses_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_BLOCK_CACHE_H_ */
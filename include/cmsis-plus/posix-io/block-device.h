@@ -0,0 +1,261 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_BLOCK_DEVICE_H_
+#define CMSIS_PLUS_POSIX_IO_BLOCK_DEVICE_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/rtos/os-memory.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Base block device class.
+     * @headerfile block-device.h <cmsis-plus/posix-io/block-device.h>
+     * @details
+     * The storage used by the file systems, accessed in fixed size
+     * blocks; usually behind a `block_cache`.
+     *
+     * The functions return 0, or -1 with `errno` set.
+     */
+    class block_device
+    {
+    public:
+
+      using blknum_t = uint32_t;
+
+      static constexpr blknum_t no_block = 0xFFFFFFFF;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      block_device (std::size_t block_size_bytes, blknum_t num_blocks);
+
+      block_device (const block_device&) = delete;
+      block_device (block_device&&) = delete;
+      block_device&
+      operator= (const block_device&) = delete;
+      block_device&
+      operator= (block_device&&) = delete;
+
+      virtual
+      ~block_device () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      /**
+       * @brief Read consecutive blocks.
+       * @param [out] buf Buffer of at least `count * block_size()` bytes.
+       * @param [in] blknum First block number.
+       * @param [in] count Number of blocks.
+       * @retval 0 The blocks were read.
+       * @retval -1 Error, with `errno` set (EINVAL if out of range).
+       */
+      int
+      read_block (void* buf, blknum_t blknum, std::size_t count = 1);
+
+      int
+      write_block (const void* buf, blknum_t blknum, std::size_t count = 1);
+
+      int
+      sync (void);
+
+      std::size_t
+      block_size (void) const;
+
+      blknum_t
+      num_blocks (void) const;
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual int
+      do_read_block (void* buf, blknum_t blknum, std::size_t count) = 0;
+
+      virtual int
+      do_write_block (const void* buf, blknum_t blknum, std::size_t count) = 0;
+
+      virtual int
+      do_sync (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @cond ignore
+       */
+
+      std::size_t block_size_;
+      blknum_t num_blocks_;
+
+      /**
+       * @endcond
+       */
+    };
+
+    // ========================================================================
+
+    /**
+     * @brief Block device in RAM.
+     * @headerfile block-device.h <cmsis-plus/posix-io/block-device.h>
+     * @details
+     * The storage is allocated from a memory resource, when the
+     * object is constructed.
+     */
+    class block_device_ram : public block_device
+    {
+    public:
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      block_device_ram (std::size_t block_size_bytes, blknum_t num_blocks,
+                        rtos::memory::memory_resource* resource =
+                            rtos::memory::get_default_resource ());
+
+      block_device_ram (const block_device_ram&) = delete;
+      block_device_ram (block_device_ram&&) = delete;
+      block_device_ram&
+      operator= (const block_device_ram&) = delete;
+      block_device_ram&
+      operator= (block_device_ram&&) = delete;
+
+      virtual
+      ~block_device_ram () noexcept;
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual int
+      do_read_block (void* buf, blknum_t blknum, std::size_t count) override;
+
+      virtual int
+      do_write_block (const void* buf, blknum_t blknum, std::size_t count)
+          override;
+
+      /**
+       * @}
+       */
+
+    private:
+
+      /**
+       * @cond ignore
+       */
+
+      rtos::memory::memory_resource* resource_;
+      uint8_t* storage_;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline std::size_t
+    block_device::block_size (void) const
+    {
+      return block_size_;
+    }
+
+    inline block_device::blknum_t
+    block_device::num_blocks (void) const
+    {
+      return num_blocks_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_BLOCK_DEVICE_H_ */
@@ -0,0 +1,337 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_BUFFERED_SERIAL_H_
+#define CMSIS_PLUS_POSIX_IO_BUFFERED_SERIAL_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/drivers/serial.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Buffered serial device.
+     * @headerfile buffered-serial.h <cmsis-plus/posix-io/buffered-serial.h>
+     * @details
+     * Interrupt driven character device, on top of an asynchronous
+     * `driver::Serial`, with blocking, timed and non blocking
+     * `read()`/`write()`.
+     *
+     * The receive buffer is split in two halves; the driver
+     * receives directly in one half while the application reads
+     * from the other, and the next reception is started from the
+     * completion callback, as soon as a half is free. Bytes already
+     * received in the active half are available to read before the
+     * half is complete.
+     *
+     * The transmit buffer is a ring; the driver sends the
+     * contiguous bytes directly from the buffer, while the
+     * application adds more data, and the next transfer is started
+     * from the completion callback. There are no per byte
+     * interrupts and no intermediate copies, so the buffers are
+     * suitable for DMA.
+     *
+     * `read()` returns the available bytes, at least one;
+     * `write()` returns after all bytes were queued. With
+     * `O_NONBLOCK`, both return what can be done immediately,
+     * or fail with `EAGAIN`.
+     *
+     * The driver events must be forwarded to the driver
+     * `signal_event()`; the device registers its own callback
+     * when opened.
+     *
+     * @par Example
+     *
+     * @code{.cpp}
+     * extern "C" void
+     * usart1_cb (uint32_t event);
+     *
+     * os::driver::Usart_wrapper usart1 { &Driver_USART1, usart1_cb };
+     *
+     * void
+     * usart1_cb (uint32_t event)
+     * {
+     *   usart1.signal_event (event);
+     * }
+     *
+     * static uint8_t rx_buf[256];
+     * static uint8_t tx_buf[256];
+     *
+     * os::posix::buffered_serial ttys1
+     *   { "ttyS1", usart1, rx_buf, sizeof(rx_buf), tx_buf, sizeof(tx_buf) };
+     *
+     * int
+     * os_main (int argc, char* argv[])
+     * {
+     *   int fd = open ("/dev/ttyS1", O_RDWR);
+     *   ...
+     * }
+     * @endcode
+     *
+     * @note Without the driver `rx_timeout` event, readers waiting
+     * for bytes in the active half check the received count every
+     * clock tick; `poll()` is notified only on events.
+     *
+     * @warning Only one thread should read and only one thread
+     * should write at a time.
+     */
+    class buffered_serial : public device
+    {
+    public:
+
+      static constexpr driver::serial::config_t default_config =
+          driver::serial::MODE_ASYNCHRONOUS | driver::serial::DATA_BITS_8
+              | driver::serial::PARITY_NONE | driver::serial::STOP_BITS_1
+              | driver::serial::FLOW_CONTROL_NONE;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      buffered_serial (const char* name, driver::Serial& driver,
+                       void* rx_buffer, std::size_t rx_size, void* tx_buffer,
+                       std::size_t tx_size, driver::serial::config_t config =
+                           default_config,
+                       driver::serial::config_arg_t baudrate = 115200);
+
+      buffered_serial (const buffered_serial&) = delete;
+      buffered_serial (buffered_serial&&) = delete;
+      buffered_serial&
+      operator= (const buffered_serial&) = delete;
+      buffered_serial&
+      operator= (buffered_serial&&) = delete;
+
+      virtual
+      ~buffered_serial () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      /**
+       * @brief Read with a timeout.
+       * @param buf Pointer to the destination buffer.
+       * @param nbyte Maximum number of bytes to read.
+       * @param timeout Timeout to wait for the first byte, in
+       * clock ticks.
+       * @return The number of bytes read, or -1 with `errno` set to
+       * `ETIMEDOUT` if no byte was received in time.
+       */
+      ssize_t
+      timed_read (void* buf, std::size_t nbyte,
+                  rtos::clock::duration_t timeout);
+
+      /**
+       * @brief Write with a timeout.
+       * @param buf Pointer to the source buffer.
+       * @param nbyte Number of bytes to write.
+       * @param timeout Timeout to queue all bytes, in clock ticks.
+       * @return The number of bytes queued, less than `nbyte`
+       * if the timeout expired, or -1 with `errno` set to
+       * `ETIMEDOUT` if none was queued.
+       */
+      ssize_t
+      timed_write (const void* buf, std::size_t nbyte,
+                   rtos::clock::duration_t timeout);
+
+      /**
+       * @brief Wait until all the queued bytes were sent.
+       * @retval 0 All bytes were sent.
+       * @retval -1 Error; `errno` is set.
+       */
+      int
+      drain (void);
+
+      driver::Serial&
+      get_driver (void);
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual int
+      do_vopen (const char* path, int oflag, std::va_list args) override;
+
+      virtual int
+      do_close (void) override;
+
+      virtual ssize_t
+      do_read (void* buf, std::size_t nbyte) override;
+
+      virtual ssize_t
+      do_write (const void* buf, std::size_t nbyte) override;
+
+      virtual int
+      do_vfcntl (int cmd, std::va_list args) override;
+
+      virtual int
+      do_isatty (void) override;
+
+      virtual int
+      do_poll (int events) override;
+
+      /**
+       * @}
+       */
+
+    private:
+
+      /**
+       * @cond ignore
+       */
+
+      static void
+      signal_event (const void* object, driver::event_t event);
+
+      void
+      handle_event_ (driver::event_t event);
+
+      ssize_t
+      read_ (void* buf, std::size_t nbyte, bool forever,
+             rtos::clock::duration_t timeout);
+
+      ssize_t
+      write_ (const void* buf, std::size_t nbyte, bool forever,
+              rtos::clock::duration_t timeout);
+
+      std::size_t
+      rx_available_ (void);
+
+      void
+      start_rx_ (void);
+
+      void
+      start_tx_ (void);
+
+      driver::Serial& driver_;
+
+      driver::serial::config_t config_;
+      driver::serial::config_arg_t baudrate_;
+
+      uint8_t* rx_buffer_;
+      // Half of the receive buffer.
+      std::size_t rx_chunk_;
+      // Where the next reception starts.
+      std::size_t rx_head_ = 0;
+      // Where the next read starts.
+      std::size_t rx_tail_ = 0;
+      // Unread bytes in the completed halves.
+      std::size_t rx_level_ = 0;
+      // Bytes already read from the active half.
+      std::size_t rx_taken_ = 0;
+
+      uint8_t* tx_buffer_;
+      std::size_t tx_size_;
+      // Where the next write starts.
+      std::size_t tx_head_ = 0;
+      // Where the next transmission starts.
+      std::size_t tx_tail_ = 0;
+      // Queued bytes, including those being sent.
+      std::size_t tx_level_ = 0;
+      // Bytes being sent by the driver.
+      std::size_t tx_sending_ = 0;
+
+      rtos::semaphore_binary rx_semaphore_
+        { "rx", 0 };
+      rtos::semaphore_binary tx_semaphore_
+        { "tx", 0 };
+
+      int oflag_ = 0;
+
+      bool rx_active_ = false;
+      bool rx_timeout_event_ = false;
+      bool rx_error_ = false;
+      bool tx_error_ = false;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline driver::Serial&
+    buffered_serial::get_driver (void)
+    {
+      return driver_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_BUFFERED_SERIAL_H_ */
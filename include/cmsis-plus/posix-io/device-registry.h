@@ -0,0 +1,98 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_DEVICE_REGISTRY_H_
+#define CMSIS_PLUS_POSIX_IO_DEVICE_REGISTRY_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/device.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+    /**
+     * @brief Registry of named devices.
+     * @headerfile device-registry.h <cmsis-plus/posix-io/device-registry.h>
+     * @details
+     * The devices link themselves into an intrusive list when
+     * constructed, so there are no dynamic allocations and no
+     * size limit; the list is searched only by `open()`.
+     */
+    class device_registry
+    {
+    public:
+
+      device_registry () = delete;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      static void
+      link (device* dev);
+
+      static void
+      unlink (device* dev);
+
+      /**
+       * @brief Find a device by path.
+       * @param [in] path Device path, like `/dev/name`.
+       * @return Pointer to the device, or `nullptr` if the path
+       *  does not start with the device prefix or no such device
+       *  was registered.
+       */
+      static device*
+      identify_device (const char* path);
+
+      /**
+       * @}
+       */
+
+    private:
+
+      static device* head_;
+    };
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_DEVICE_REGISTRY_H_ */
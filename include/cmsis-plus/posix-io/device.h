@@ -0,0 +1,203 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_DEVICE_H_
+#define CMSIS_PLUS_POSIX_IO_DEVICE_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/io.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    class device_registry;
+
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Base device class.
+     * @headerfile device.h <cmsis-plus/posix-io/device.h>
+     * @details
+     * Devices are statically allocated objects, which link themselves
+     * into the device registry when constructed, and are
+     * identified by name (`/dev/<name>`) when opened.
+     *
+     * A device is an I/O object by itself, so it can be opened
+     * only once; a second `open()` fails with EBUSY.
+     */
+    class device : public io
+    {
+    public:
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      device (const char* name);
+
+      device (const device&) = delete;
+      device (device&&) = delete;
+      device&
+      operator= (const device&) = delete;
+      device&
+      operator= (device&&) = delete;
+
+      virtual
+      ~device () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      int
+      open (const char* path = nullptr, int oflag = 0, ...);
+
+      int
+      vopen (const char* path, int oflag, std::va_list args);
+
+      int
+      ioctl (int request, ...);
+
+      int
+      vioctl (int request, std::va_list args);
+
+      bool
+      is_opened (void) const;
+
+      bool
+      match_name (const char* name) const;
+
+      const char*
+      name (void) const;
+
+      static const char*
+      device_prefix (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual int
+      do_vopen (const char* path, int oflag, std::va_list args) = 0;
+
+      virtual int
+      do_vioctl (int request, std::va_list args);
+
+      virtual void
+      do_release (void) override final;
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @cond ignore
+       */
+
+      friend class device_registry;
+
+      const char* name_;
+
+      // Intrusive list of registered devices.
+      device* next_ = nullptr;
+
+      bool is_opened_ = false;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline const char*
+    device::name (void) const
+    {
+      return name_;
+    }
+
+    inline bool
+    device::is_opened (void) const
+    {
+      return is_opened_;
+    }
+
+    inline const char*
+    device::device_prefix (void)
+    {
+      return "/dev/";
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_DEVICE_H_ */
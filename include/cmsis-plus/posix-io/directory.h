@@ -0,0 +1,176 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_DIRECTORY_H_
+#define CMSIS_PLUS_POSIX_IO_DIRECTORY_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix/dirent.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    class file_system;
+
+    // ========================================================================
+
+    /**
+     * @brief Base directory class.
+     * @headerfile directory.h <cmsis-plus/posix-io/directory.h>
+     * @details
+     * Directories are created by the file systems when opened,
+     * and released by `close()`; the C API casts them to `DIR*`.
+     */
+    class directory
+    {
+    public:
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      directory (class file_system& fs);
+
+      directory (const directory&) = delete;
+      directory (directory&&) = delete;
+      directory&
+      operator= (const directory&) = delete;
+      directory&
+      operator= (directory&&) = delete;
+
+      virtual
+      ~directory () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      /**
+       * @brief Read the next entry.
+       * @return Pointer to an entry, valid until the next call, or
+       *  `nullptr` at the end (with `errno` unchanged) or on error.
+       */
+      struct dirent*
+      read (void);
+
+      void
+      rewind (void);
+
+      /**
+       * @brief Close the directory.
+       * @details
+       * The object is released and must no longer be used.
+       */
+      int
+      close (void);
+
+      class file_system&
+      get_file_system (void) const;
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual struct dirent*
+      do_read (void) = 0;
+
+      virtual void
+      do_rewind (void) = 0;
+
+      // Called by close(), to free the object.
+      virtual void
+      do_release (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @cond ignore
+       */
+
+      class file_system* file_system_;
+
+      struct dirent dir_entry_;
+
+      /**
+       * @endcond
+       */
+    };
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline class file_system&
+    directory::get_file_system (void) const
+    {
+      return *file_system_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_DIRECTORY_H_ */
@@ -0,0 +1,167 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_FILE_DESCRIPTORS_MANAGER_H_
+#define CMSIS_PLUS_POSIX_IO_FILE_DESCRIPTORS_MANAGER_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/os-app-config.h>
+
+#include <cmsis-plus/posix-io/io.h>
+
+// ----------------------------------------------------------------------------
+
+#if !defined(OS_INTEGER_POSIX_IO_MAX_OPEN_FILES)
+#define OS_INTEGER_POSIX_IO_MAX_OPEN_FILES (16)
+#endif
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    class socket;
+
+    // ========================================================================
+
+    /**
+     * @brief File descriptors manager.
+     * @headerfile file-descriptors-manager.h <cmsis-plus/posix-io/file-descriptors-manager.h>
+     * @details
+     * File descriptors are indices in a static array of pointers
+     * to I/O objects, so translating a descriptor is a bounds
+     * check and an array access. The array size is
+     * @ref OS_INTEGER_POSIX_IO_MAX_OPEN_FILES.
+     */
+    class file_descriptors_manager
+    {
+    public:
+
+      file_descriptors_manager () = delete;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      static constexpr std::size_t
+      size (void);
+
+      static bool
+      valid (int fildes);
+
+      /**
+       * @brief Get the I/O object associated with a file descriptor.
+       * @param [in] fildes File descriptor.
+       * @return Pointer to the object, or `nullptr` if the
+       *  descriptor is not valid or not allocated.
+       */
+      static io*
+      get_io (int fildes);
+
+      static socket*
+      get_socket (int fildes);
+
+      /**
+       * @brief Allocate the lowest unused file descriptor.
+       * @param [in] pio Pointer to the I/O object.
+       * @return The file descriptor, or -1 with `errno` set
+       *  to EMFILE if the table is full.
+       */
+      static int
+      alloc (io* pio);
+
+      /**
+       * @brief Allocate a given file descriptor.
+       * @param [in] fildes File descriptor, usually 0, 1 or 2.
+       * @param [in] pio Pointer to the I/O object.
+       * @return The file descriptor, or -1 with `errno` set
+       *  to EBADF if the descriptor is not valid or is in use.
+       */
+      static int
+      assign (int fildes, io* pio);
+
+      static int
+      free (int fildes);
+
+      /**
+       * @}
+       */
+
+    private:
+
+      static io* descriptors_array_[OS_INTEGER_POSIX_IO_MAX_OPEN_FILES];
+    };
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    constexpr std::size_t
+    file_descriptors_manager::size (void)
+    {
+      return OS_INTEGER_POSIX_IO_MAX_OPEN_FILES;
+    }
+
+    inline bool
+    file_descriptors_manager::valid (int fildes)
+    {
+      // A single unsigned comparison also rejects negative values.
+      return static_cast<std::size_t> (fildes) < size ();
+    }
+
+    inline io*
+    file_descriptors_manager::get_io (int fildes)
+    {
+      if (!valid (fildes))
+        {
+          return nullptr;
+        }
+      return descriptors_array_[fildes];
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_FILE_DESCRIPTORS_MANAGER_H_ */
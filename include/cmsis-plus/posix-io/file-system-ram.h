@@ -0,0 +1,274 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_RAM_H_
+#define CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_RAM_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/file-system.h>
+#include <cmsis-plus/posix-io/block-cache.h>
+#include <cmsis-plus/rtos/os.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief RAM file system.
+     * @headerfile file-system-ram.h <cmsis-plus/posix-io/file-system-ram.h>
+     * @details
+     * Directories and files, with the metadata (names, sizes, block
+     * maps) allocated from a memory resource, and the content stored
+     * in the blocks of a block device, accessed via a block cache.
+     *
+     * Usually the device is a `block_device_ram`, but any block
+     * device can be used, in which case the content is lost
+     * when the file system is destroyed.
+     *
+     * Files may be sparse; unwritten blocks read as zeros and
+     * use no storage. Files and directories removed while still
+     * open are freed when closed.
+     *
+     * @par Example
+     *
+     * @code{.cpp}
+     * os::posix::block_device_ram ramdisk { 512, 64 };
+     * os::posix::block_cache cache { ramdisk, 8 };
+     * os::posix::file_system_ram ramfs { cache };
+     *
+     * int
+     * os_main (int argc, char* argv[])
+     * {
+     *   ramfs.mount ("/ram");
+     *
+     *   int fd = open ("/ram/log.txt", O_CREAT | O_WRONLY, 0644);
+     *   ...
+     * }
+     * @endcode
+     */
+    class file_system_ram : public file_system
+    {
+    public:
+
+      using blknum_t = block_device::blknum_t;
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      file_system_ram (block_cache& cache,
+                       rtos::memory::memory_resource* resource =
+                           rtos::memory::get_default_resource ());
+
+      file_system_ram (const file_system_ram&) = delete;
+      file_system_ram (file_system_ram&&) = delete;
+      file_system_ram&
+      operator= (const file_system_ram&) = delete;
+      file_system_ram&
+      operator= (file_system_ram&&) = delete;
+
+      virtual
+      ~file_system_ram () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      std::size_t
+      free_blocks (void) const;
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual file*
+      do_vopen (const char* path, int oflag, std::va_list args) override;
+
+      virtual directory*
+      do_opendir (const char* path) override;
+
+      virtual int
+      do_mkdir (const char* path, mode_t mode) override;
+
+      virtual int
+      do_rmdir (const char* path) override;
+
+      virtual int
+      do_unlink (const char* path) override;
+
+      virtual int
+      do_rename (const char* existing, const char* _new) override;
+
+      virtual int
+      do_stat (const char* path, struct stat* buf) override;
+
+      virtual int
+      do_truncate (const char* path, off_t length) override;
+
+      virtual int
+      do_chmod (const char* path, mode_t mode) override;
+
+      virtual int
+      do_utime (const char* path, const struct utimbuf* times) override;
+
+      virtual int
+      do_sync (void) override;
+
+      /**
+       * @}
+       */
+
+    private:
+
+      /**
+       * @cond ignore
+       */
+
+      struct node;
+      class file_ram;
+      class directory_ram;
+
+      node*
+      lookup_ (const char* path, const char** name = nullptr,
+               std::size_t* name_length = nullptr);
+
+      node*
+      find_child_ (node* dir, const char* name, std::size_t name_length);
+
+      node*
+      create_node_ (node* parent, const char* name, std::size_t name_length,
+                    mode_t mode);
+
+      void
+      detach_node_ (node* n);
+
+      void
+      release_node_ (node* n);
+
+      void
+      destroy_node_ (node* n);
+
+      void
+      destroy_tree_ (node* n);
+
+      int
+      remove_ (node* n);
+
+      int
+      reserve_blocks_ (node* n, std::size_t count);
+
+      int
+      resize_ (node* n, off_t length);
+
+      ssize_t
+      read_ (node* n, off_t offset, void* buf, std::size_t nbyte);
+
+      ssize_t
+      write_ (node* n, off_t offset, const void* buf, std::size_t nbyte);
+
+      blknum_t
+      alloc_block_ (void);
+
+      void
+      free_block_ (blknum_t blknum);
+
+      void
+      fill_stat_ (node* n, struct stat* buf);
+
+      block_cache& cache_;
+      rtos::memory::memory_resource* resource_;
+
+      rtos::mutex mutex_
+        { "ramfs" };
+
+      node* root_ = nullptr;
+
+      uint32_t* bitmap_ = nullptr;
+      std::size_t free_blocks_ = 0;
+      blknum_t next_free_ = 0;
+
+      ino_t next_ino_ = 1;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline std::size_t
+    file_system_ram::free_blocks (void) const
+    {
+      return free_blocks_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_RAM_H_ */
@@ -0,0 +1,264 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_H_
+#define CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix/utime.h>
+
+#include <cstdarg>
+
+#include <sys/stat.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    class file;
+    class directory;
+
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Base file system class.
+     * @headerfile file-system.h <cmsis-plus/posix-io/file-system.h>
+     * @details
+     * File systems are mounted on a path (like `/` or `/ram`); the
+     * paths below it are passed to the implementation relative to
+     * the mount point, always starting with `/`. When mount points
+     * overlap, the longest one is used.
+     *
+     * The functions have the POSIX names and return values
+     * (-1 and `errno` on error).
+     */
+    class file_system
+    {
+    public:
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      file_system ();
+
+      file_system (const file_system&) = delete;
+      file_system (file_system&&) = delete;
+      file_system&
+      operator= (const file_system&) = delete;
+      file_system&
+      operator= (file_system&&) = delete;
+
+      virtual
+      ~file_system () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      /**
+       * @brief Mount the file system.
+       * @param [in] path Absolute path; the string must persist while
+       *  the file system is mounted.
+       * @retval 0 The file system was mounted.
+       * @retval -1 Error, with `errno` set (EBUSY if already mounted
+       *  or the path is in use).
+       */
+      int
+      mount (const char* path);
+
+      int
+      umount (void);
+
+      const char*
+      mount_path (void) const;
+
+      file*
+      open (const char* path, int oflag, ...);
+
+      file*
+      vopen (const char* path, int oflag, std::va_list args);
+
+      directory*
+      opendir (const char* path);
+
+      int
+      mkdir (const char* path, mode_t mode);
+
+      int
+      rmdir (const char* path);
+
+      int
+      unlink (const char* path);
+
+      int
+      rename (const char* existing, const char* _new);
+
+      int
+      stat (const char* path, struct stat* buf);
+
+      int
+      truncate (const char* path, off_t length);
+
+      int
+      chmod (const char* path, mode_t mode);
+
+      int
+      utime (const char* path, const struct utimbuf* times);
+
+      int
+      sync (void);
+
+      /**
+       * @brief Find the file system of a path.
+       * @param [in,out] path Absolute path; on return it points to
+       *  the part relative to the mount point.
+       * @return Pointer to the file system, or `nullptr`.
+       */
+      static file_system*
+      identify_file_system (const char** path);
+
+      static void
+      sync_all (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      virtual file*
+      do_vopen (const char* path, int oflag, std::va_list args) = 0;
+
+      // The defaults fail with ENOSYS.
+
+      virtual directory*
+      do_opendir (const char* path);
+
+      virtual int
+      do_mkdir (const char* path, mode_t mode);
+
+      virtual int
+      do_rmdir (const char* path);
+
+      virtual int
+      do_unlink (const char* path);
+
+      virtual int
+      do_rename (const char* existing, const char* _new);
+
+      virtual int
+      do_stat (const char* path, struct stat* buf);
+
+      virtual int
+      do_truncate (const char* path, off_t length);
+
+      virtual int
+      do_chmod (const char* path, mode_t mode);
+
+      virtual int
+      do_utime (const char* path, const struct utimbuf* times);
+
+      virtual int
+      do_sync (void);
+
+      /**
+       * @}
+       */
+
+    private:
+
+      /**
+       * @cond ignore
+       */
+
+      const char* mount_path_ = nullptr;
+      std::size_t mount_path_length_ = 0;
+
+      // Intrusive list of mounted file systems.
+      file_system* next_ = nullptr;
+
+      static file_system* head_;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline const char*
+    file_system::mount_path (void) const
+    {
+      return mount_path_;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_FILE_SYSTEM_H_ */
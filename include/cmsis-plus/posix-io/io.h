@@ -0,0 +1,327 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_IO_H_
+#define CMSIS_PLUS_POSIX_IO_IO_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix/sys/uio.h>
+#include <cmsis-plus/posix/sys/select.h>
+#include <cmsis-plus/posix/poll.h>
+
+#include <cstddef>
+#include <cstdarg>
+
+#include <sys/stat.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    class io;
+
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Open a device or a file.
+     * @param [in] path Path; devices are named `/dev/<name>`.
+     * @param [in] oflag Flags, as for POSIX `open()`.
+     * @return Pointer to the opened object, also allocated a file
+     *  descriptor, or `nullptr` with `errno` set.
+     */
+    io*
+    open (const char* path, int oflag, ...);
+
+    io*
+    vopen (const char* path, int oflag, std::va_list args);
+
+    /**
+     * @brief Wait for events on a set of file descriptors.
+     * @param [in,out] fds Array of descriptors and events.
+     * @param [in] nfds Number of elements in the array.
+     * @param [in] timeout Timeout in milliseconds; -1 for no timeout.
+     * @return The number of descriptors with events, 0 on timeout,
+     *  or -1 with `errno` set.
+     */
+    int
+    poll (struct pollfd fds[], nfds_t nfds, int timeout);
+
+    int
+    select (int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds,
+            struct timeval* timeout);
+
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    /**
+     * @brief Base I/O class.
+     * @headerfile io.h <cmsis-plus/posix-io/io.h>
+     * @details
+     * The common ancestor of devices, files and sockets. The public
+     * functions have the POSIX names and return values (-1 and `errno`
+     * on error); they forward to the protected `do_*()` virtual
+     * functions, which the derived classes implement.
+     *
+     * Vectored I/O is passed to `do_readv()`/`do_writev()` as is;
+     * the defaults process the segments one by one with `do_read()`/
+     * `do_write()`, directly in the user buffers, and drivers able
+     * to do scatter-gather transfers should override them.
+     */
+    class io
+    {
+    public:
+
+      using type_t = unsigned int;
+
+      enum type
+        : type_t
+          {
+            unknown = 0,
+        not_set = 1 << 0,
+        device = 1 << 1,
+        file = 1 << 2,
+        socket = 1 << 3
+      };
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      io (type_t t) noexcept;
+
+      io (const io&) = delete;
+      io (io&&) = delete;
+      io&
+      operator= (const io&) = delete;
+      io&
+      operator= (io&&) = delete;
+
+      virtual
+      ~io () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      int
+      close (void);
+
+      ssize_t
+      read (void* buf, std::size_t nbyte);
+
+      ssize_t
+      write (const void* buf, std::size_t nbyte);
+
+      ssize_t
+      readv (const struct iovec* iov, int iovcnt);
+
+      ssize_t
+      writev (const struct iovec* iov, int iovcnt);
+
+      int
+      fcntl (int cmd, ...);
+
+      int
+      vfcntl (int cmd, std::va_list args);
+
+      int
+      isatty (void);
+
+      int
+      fstat (struct stat* buf);
+
+      /**
+       * @brief Get the ready events, without blocking.
+       * @param [in] events The requested events (`POLLIN`, `POLLOUT`...).
+       * @return The requested events which are ready, plus
+       *  `POLLERR` and `POLLHUP`, which are always reported.
+       */
+      int
+      poll (int events);
+
+      /**
+       * @brief Wake up the threads waiting in `poll()`/`select()`.
+       * @details
+       * Called by the drivers when the object may have become
+       * readable or writable, usually from the completion callbacks.
+       * Can be called from interrupt handlers.
+       */
+      void
+      notify_poll (void);
+
+      // ----------------------------------------------------------------------
+      // Support functions.
+
+      type_t
+      get_type (void) const;
+
+      /**
+       * @brief Get the file descriptor.
+       * @return The file descriptor, or `no_file_descriptor`
+       *  if the object is not opened.
+       */
+      int
+      file_descriptor (void) const;
+
+      // Called by the file descriptors manager.
+      void
+      file_descriptor (int fildes);
+
+      void
+      clear_file_descriptor (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      // Implementations; the defaults fail with ENOSYS.
+
+      virtual int
+      do_close (void);
+
+      virtual ssize_t
+      do_read (void* buf, std::size_t nbyte);
+
+      virtual ssize_t
+      do_write (const void* buf, std::size_t nbyte);
+
+      virtual ssize_t
+      do_readv (const struct iovec* iov, int iovcnt);
+
+      virtual ssize_t
+      do_writev (const struct iovec* iov, int iovcnt);
+
+      virtual int
+      do_vfcntl (int cmd, std::va_list args);
+
+      virtual int
+      do_isatty (void);
+
+      virtual int
+      do_fstat (struct stat* buf);
+
+      // The default reports the object as always readable and
+      // writable, like regular files.
+      virtual int
+      do_poll (int events);
+
+      // Called after close(), to free the resources allocated
+      // by open(), if any.
+      virtual void
+      do_release (void);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @cond ignore
+       */
+
+      type_t type_;
+
+      int file_descriptor_ = no_file_descriptor;
+
+      /**
+       * @endcond
+       */
+    };
+
+#pragma GCC diagnostic pop
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline io::type_t
+    io::get_type (void) const
+    {
+      return type_;
+    }
+
+    inline int
+    io::file_descriptor (void) const
+    {
+      return file_descriptor_;
+    }
+
+    inline void
+    io::file_descriptor (int fildes)
+    {
+      file_descriptor_ = fildes;
+    }
+
+    inline void
+    io::clear_file_descriptor (void)
+    {
+      file_descriptor_ = no_file_descriptor;
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_IO_H_ */
@@ -0,0 +1,216 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CMSIS_PLUS_POSIX_IO_SOCKET_H_
+#define CMSIS_PLUS_POSIX_IO_SOCKET_H_
+
+#if defined(__cplusplus)
+
+// ----------------------------------------------------------------------------
+
+#include <cmsis-plus/posix-io/io.h>
+#include <cmsis-plus/posix/sys/socket.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ========================================================================
+
+    /**
+     * @brief Base socket class.
+     * @headerfile socket.h <cmsis-plus/posix-io/socket.h>
+     * @details
+     * Sockets are created by the network stack; in addition to
+     * the functions below, they support the common I/O functions
+     * (`read()`, `write()`, `readv()`, `writev()`, `close()`).
+     */
+    class socket : public io
+    {
+    public:
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Constructors & Destructor
+       * @{
+       */
+
+      socket ();
+
+      socket (const socket&) = delete;
+      socket (socket&&) = delete;
+      socket&
+      operator= (const socket&) = delete;
+      socket&
+      operator= (socket&&) = delete;
+
+      virtual
+      ~socket () noexcept;
+
+      /**
+       * @}
+       */
+
+      // ----------------------------------------------------------------------
+
+      /**
+       * @name Public Member Functions
+       * @{
+       */
+
+      socket*
+      accept (struct sockaddr* address, socklen_t* address_len);
+
+      int
+      bind (const struct sockaddr* address, socklen_t address_len);
+
+      int
+      connect (const struct sockaddr* address, socklen_t address_len);
+
+      int
+      getpeername (struct sockaddr* address, socklen_t* address_len);
+
+      int
+      getsockname (struct sockaddr* address, socklen_t* address_len);
+
+      int
+      getsockopt (int level, int option_name, void* option_value,
+                  socklen_t* option_len);
+
+      int
+      listen (int backlog);
+
+      ssize_t
+      recv (void* buffer, std::size_t length, int flags);
+
+      ssize_t
+      recvfrom (void* buffer, std::size_t length, int flags,
+                struct sockaddr* address, socklen_t* address_len);
+
+      ssize_t
+      send (const void* buffer, std::size_t length, int flags);
+
+      ssize_t
+      sendto (const void* message, std::size_t length, int flags,
+              const struct sockaddr* dest_addr, socklen_t dest_len);
+
+      int
+      setsockopt (int level, int option_name, const void* option_value,
+                  socklen_t option_len);
+
+      int
+      shutdown (int how);
+
+      /**
+       * @}
+       */
+
+    protected:
+
+      /**
+       * @name Private Member Functions
+       * @{
+       */
+
+      // Implementations; the defaults fail with ENOSYS.
+
+      virtual socket*
+      do_accept (struct sockaddr* address, socklen_t* address_len);
+
+      virtual int
+      do_bind (const struct sockaddr* address, socklen_t address_len);
+
+      virtual int
+      do_connect (const struct sockaddr* address, socklen_t address_len);
+
+      virtual int
+      do_getpeername (struct sockaddr* address, socklen_t* address_len);
+
+      virtual int
+      do_getsockname (struct sockaddr* address, socklen_t* address_len);
+
+      virtual int
+      do_getsockopt (int level, int option_name, void* option_value,
+                     socklen_t* option_len);
+
+      virtual int
+      do_listen (int backlog);
+
+      virtual ssize_t
+      do_recvfrom (void* buffer, std::size_t length, int flags,
+                   struct sockaddr* address, socklen_t* address_len);
+
+      virtual ssize_t
+      do_sendto (const void* message, std::size_t length, int flags,
+                 const struct sockaddr* dest_addr, socklen_t dest_len);
+
+      virtual int
+      do_setsockopt (int level, int option_name, const void* option_value,
+                     socklen_t option_len);
+
+      virtual int
+      do_shutdown (int how);
+
+      /**
+       * @}
+       */
+    };
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ===== Inline & template implementations ====================================
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    inline ssize_t
+    socket::recv (void* buffer, std::size_t length, int flags)
+    {
+      return recvfrom (buffer, length, flags, nullptr, nullptr);
+    }
+
+    inline ssize_t
+    socket::send (const void* buffer, std::size_t length, int flags)
+    {
+      return sendto (buffer, length, flags, nullptr, 0);
+    }
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* __cplusplus */
+
+#endif /* CMSIS_PLUS_POSIX_IO_SOCKET_H_ */
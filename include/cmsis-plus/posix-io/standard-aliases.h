@@ -119,6 +119,9 @@ extern "C"
   __attribute__((weak, alias ("__posix_opendir")))
   opendir (const char* dirname);
 
+  int __attribute__((weak, alias ("__posix_poll")))
+  poll (struct pollfd fds[], nfds_t nfds, int timeout);
+
   int __attribute__((weak, alias ("__posix_raise")))
   raise (int sig);
 
@@ -132,6 +135,9 @@ extern "C"
   int __attribute__((weak, alias ("__posix_readdir_r")))
   readdir_r (DIR* dirp, struct dirent* entry, struct dirent** result);
 
+  ssize_t __attribute__((weak, alias ("__posix_readv")))
+  readv (int fildes, const struct iovec* iov, int iovcnt);
+
   ssize_t __attribute__((weak, alias ("__posix_readlink")))
   readlink (const char* path, char* buf, size_t bufsize);
 
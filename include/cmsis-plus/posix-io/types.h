@@ -25,6 +25,7 @@
 
 #include <cmsis-plus/posix/dirent.h>
 #include <cmsis-plus/posix/sys/socket.h>
+#include <cmsis-plus/posix/poll.h>
 
 // ----------------------------------------------------------------------------
 
@@ -39,6 +40,8 @@ namespace os
 
     constexpr fileDescriptor_t noFileDescriptor = -1;
 
+    constexpr int no_file_descriptor = -1;
+
   } /* namespace posix */
 } /* namespace os */
 
@@ -179,6 +182,9 @@ extern "C"
   __attribute__((weak))
   __posix_opendir (const char* dirname);
 
+  int __attribute__((weak))
+  __posix_poll (struct pollfd fds[], nfds_t nfds, int timeout);
+
   int __attribute__((weak))
   __posix_raise (int sig);
 
@@ -192,6 +198,9 @@ extern "C"
   int __attribute__((weak))
   __posix_readdir_r (DIR* dirp, struct dirent* entry, struct dirent** result);
 
+  ssize_t __attribute__((weak))
+  __posix_readv (int fildes, const struct iovec* iov, int iovcnt);
+
   ssize_t __attribute__((weak))
   __posix_readlink (const char* path, char* buf, size_t bufsize);
 
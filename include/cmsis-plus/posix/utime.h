@@ -31,10 +31,11 @@
 // ----------------------------------------------------------------------------
 
 #if !defined(__ARM_EABI__)
-#include <sys/select.h>
+#include <utime.h>
 #else
 
 #include <sys/types.h>
+#include <sys/utime.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -1425,6 +1425,31 @@ namespace os
         void
         link (timestamp_node& node);
 
+        /**
+         * @brief Align a time stamp to an existing one, if possible.
+         * @param [in] timestamp The earliest acceptable time stamp.
+         * @param [in] slack How late the time stamp may be.
+         * @return The earliest time stamp already in the list that
+         *  falls in the tolerance window, or the original time stamp.
+         * @details
+         * Nodes sharing the same time stamp are processed by the
+         * same clock interrupt, so aligning them reduces the
+         * number of wake-ups.
+         * Must be called in a critical section.
+         */
+        port::clock::timestamp_t
+        coalesce (port::clock::timestamp_t timestamp,
+                  port::clock::duration_t slack);
+
+        /**
+         * @brief Get the number of coalesced time stamps.
+         * @par Parameters
+         *  None.
+         * @return The number of time stamps aligned to existing ones.
+         */
+        uint32_t
+        coalesced_count (void) const;
+
         /**
          * @brief Get list head.
          * @par Parameters
@@ -1446,6 +1471,18 @@ namespace os
         /**
          * @}
          */
+
+      protected:
+
+        /**
+         * @cond ignore
+         */
+
+        uint32_t coalesced_count_ = 0;
+
+        /**
+         * @endcond
+         */
       };
 
       // ======================================================================
@@ -2088,6 +2125,12 @@ namespace os
         return static_cast<volatile timestamp_node*> (double_list::head ());
       }
 
+      inline uint32_t
+      clock_timestamps_list::coalesced_count (void) const
+      {
+        return coalesced_count_;
+      }
+
       // ======================================================================
 
       /**
@@ -236,6 +236,26 @@ extern "C"
   os_statistics_duration_t
   os_sched_stat_get_cpu_cycles (void);
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+  /**
+   * @brief Get the system CPU load.
+   * @return The time not spent in the idle thread during the
+   *  last window, in hundredths of percent (0-10000).
+   */
+  uint32_t
+  os_sched_stat_get_cpu_load (void);
+
+  /**
+   * @brief Get the interrupts CPU load.
+   * @return The time spent in accounted interrupt handlers
+   *  during the last window, in hundredths of percent (0-10000).
+   */
+  uint32_t
+  os_sched_stat_get_interrupts_load (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
   /**
@@ -426,6 +446,36 @@ extern "C"
   os_flags_mask_t
   os_this_thread_flags_get (os_flags_mask_t mask, os_flags_mode_t mode);
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+  /**
+   * @brief Start periodic releases of the current thread.
+   * @param [in] period The release period, in clock units
+   *  (ticks or seconds).
+   * @param [in] skip_overruns If `true`, release points missed
+   *  because of an overrun are skipped.
+   * @retval os_ok The period was set.
+   * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+   * @retval EINVAL The period is zero.
+   */
+  os_result_t
+  os_this_thread_set_period (os_clock_duration_t period, bool skip_overruns);
+
+  /**
+   * @brief Wait for the next periodic release.
+   * @par Parameters
+   *  None
+   * @retval os_ok The thread was released on time.
+   * @retval ETIMEDOUT One or more release points were missed.
+   * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+   * @retval EINVAL The period was not set.
+   * @retval EINTR The operation was interrupted.
+   */
+  os_result_t
+  os_this_thread_wait_next_period (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
   /**
    * @}
    */
@@ -682,6 +732,38 @@ extern "C"
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+  /**
+   * @brief Get the thread CPU load.
+   * @return The time spent in the thread during the last
+   *  window, in hundredths of percent (0-10000).
+   */
+  uint32_t
+  os_thread_stat_get_cpu_load (os_thread_t* thread);
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+  /**
+   * @brief Get the number of missed periodic deadlines.
+   * @return A long integer with the number of release points
+   * that passed before the thread waited for them.
+   */
+  os_statistics_counter_t
+  os_thread_stat_get_overruns (os_thread_t* thread);
+
+  /**
+   * @brief Get the largest periodic release latency.
+   * @return The largest delay from a release point to the
+   * thread resuming, in clock units.
+   */
+  os_clock_duration_t
+  os_thread_stat_get_jitter_max (os_thread_t* thread);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
   /**
    * @}
    */
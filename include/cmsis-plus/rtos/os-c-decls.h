@@ -90,6 +90,7 @@ extern "C"
   typedef struct os_internal_clock_timestamps_list_s
   {
     os_internal_double_list_links_t links;
+    uint32_t coalesced_count;
   } os_internal_clock_timestamps_list_t;
 
   /**
@@ -470,6 +471,12 @@ extern "C"
     os_statistics_duration_t cpu_cycles;
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+    os_statistics_duration_t window_cycles;
+    os_statistics_duration_t last_window_cycles;
+    uint32_t window;
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
     /**
      * @endcond
      */
@@ -478,6 +485,39 @@ extern "C"
 
 #endif
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+  /**
+   * @brief Thread periodic releases.
+   * @headerfile os-c-api.h <cmsis-plus/rtos/os-c-api.h>
+   * @details
+   * The members of this structure are hidden and should not
+   * be accessed directly, but through associated functions.
+   *
+   * @see os::rtos::thread::periodic
+   */
+  typedef struct os_thread_periodic_s
+  {
+    /**
+     * @cond ignore
+     */
+
+    os_clock_duration_t period;
+    os_clock_timestamp_t next_release;
+    os_statistics_counter_t releases;
+    os_statistics_counter_t overruns;
+    os_statistics_duration_t jitter_total;
+    os_clock_duration_t jitter_max;
+    bool skip_overruns;
+
+    /**
+     * @endcond
+     */
+
+  } os_thread_periodic_t;
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
   /**
    * @brief Thread attributes.
    * @headerfile os-c-api.h <cmsis-plus/rtos/os-c-api.h>
@@ -584,6 +624,10 @@ extern "C"
     os_thread_statistics_t statistics;
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES) */
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+    os_thread_periodic_t periodic;
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
 #if defined(OS_USE_RTOS_PORT_SCHEDULER)
     os_thread_port_data_t port;
 #endif
@@ -632,6 +676,7 @@ extern "C"
     os_internal_clock_timestamps_list_t steady_list;
     os_clock_duration_t sleep_count;
     os_clock_timestamp_t steady_count;
+    uint32_t steady_seq;
 
     /**
      * @endcond
@@ -674,6 +719,15 @@ extern "C"
     os_timer_periodic = 1 //
   };
 
+  /**
+   * @brief An enumeration with the timer execution contexts.
+   */
+  enum
+  {
+    os_timer_execution_interrupt = 0, //
+    os_timer_execution_daemon = 1 //
+  };
+
   /**
    * @brief Type of timer function arguments.
    * @details
@@ -709,6 +763,13 @@ extern "C"
    */
   typedef uint8_t os_timer_state_t;
 
+  /**
+   * @brief Type of variables holding timer execution contexts.
+   *
+   * @see os::rtos::timer::execution_t
+   */
+  typedef uint8_t os_timer_execution_t;
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpadded"
 
@@ -733,6 +794,16 @@ extern "C"
      */
     os_timer_type_t tm_type;
 
+    /**
+     * @brief Timer execution context.
+     */
+    os_timer_execution_t tm_execution;
+
+    /**
+     * @brief Timer slack, in clock units.
+     */
+    os_clock_duration_t tm_slack;
+
   } os_timer_attr_t;
 
   /**
@@ -763,12 +834,15 @@ extern "C"
     void* clock;
     os_internal_clock_timer_node_t clock_node;
     os_clock_duration_t period;
+    os_clock_timestamp_t expiry;
+    os_clock_duration_t slack;
 #endif
 #if defined(OS_USE_RTOS_PORT_TIMER)
     os_timer_port_data_t port_;
 #endif
     os_timer_type_t type;
     os_timer_state_t state;
+    os_timer_execution_t execution;
 
     /**
      * @endcond
@@ -1427,6 +1501,16 @@ extern "C"
   void
   os_rtc_handler (void);
 
+#if defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE)
+
+  /**
+   * @brief High resolution clock compare match interrupt handler.
+   */
+  void
+  os_hrclock_compare_handler (void);
+
+#endif /* defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE) */
+
 /**
  * @}
  */
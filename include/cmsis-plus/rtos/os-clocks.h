@@ -174,19 +174,21 @@ namespace os
        *  None
        * @return The clock current timestamp (time units from startup).
        */
-      timestamp_t
+      virtual timestamp_t
       steady_now (void);
 
       /**
        * @brief Sleep for a relative duration.
        * @param [in] duration The number of clock units
        *  (ticks or seconds) to sleep.
+       * @param [in] slack The number of clock units the wake-up
+       *  may be delayed, to share it with other timeouts.
        * @retval ETIMEDOUT The sleep lasted the entire duration.
        * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
        * @retval EINTR The sleep was interrupted.
        */
       result_t
-      sleep_for (duration_t duration);
+      sleep_for (duration_t duration, duration_t slack = 0);
 
       /**
        * @brief Sleep until an absolute timestamp.
@@ -230,6 +232,16 @@ namespace os
       virtual offset_t
       offset (offset_t value);
 
+      /**
+       * @brief Get the number of coalesced wake-ups.
+       * @par Parameters
+       *  None
+       * @return The number of sleeps and timers that shared the
+       *  wake-up of an already scheduled timeout.
+       */
+      uint32_t
+      coalesced_count (void) const;
+
       internal::clock_timestamps_list&
       steady_list (void);
 
@@ -239,6 +251,16 @@ namespace os
       void
       internal_check_timestamps (void);
 
+      /**
+       * @brief Reprogram the next clock event.
+       * @details
+       * Called in an interrupts critical section, after a new time
+       * stamp was linked to the steady list. The default does
+       * nothing, since the list is checked on every tick.
+       */
+      virtual void
+      internal_schedule_next (void);
+
       /**
        * @endcond
        */
@@ -264,6 +286,42 @@ namespace os
       internal_wait_until_ (timestamp_t timestamp,
                             internal::clock_timestamps_list& list);
 
+      /**
+       * @brief Start reading the clock counters.
+       * @par Parameters
+       *  None
+       * @return The sequence number to be passed to
+       *  internal_retry_read_().
+       */
+      uint32_t
+      internal_begin_read_ (void) const;
+
+      /**
+       * @brief Check if the counters changed while reading them.
+       * @param [in] seq The sequence number returned by
+       *  internal_begin_read_().
+       * @retval true The values read are inconsistent, read again.
+       * @retval false The values read are consistent.
+       */
+      bool
+      internal_retry_read_ (uint32_t seq) const;
+
+      /**
+       * @brief Start updating the clock counters.
+       * @details
+       * Must be called in an interrupts critical section.
+       */
+      void
+      internal_begin_write_ (void);
+
+      /**
+       * @brief Done updating the clock counters.
+       * @details
+       * Must be called in an interrupts critical section.
+       */
+      void
+      internal_end_write_ (void);
+
       /**
        * @endcond
        */
@@ -286,6 +344,11 @@ namespace os
        */
       timestamp_t volatile steady_count_ = 0;
 
+      /**
+       * @brief Sequence number, odd while the counters are updated.
+       */
+      uint32_t volatile steady_seq_ = 0;
+
       /**
        * @endcond
        */
@@ -732,6 +795,25 @@ namespace os
       void
       internal_increment_count (void);
 
+#if defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE)
+
+      /**
+       * @brief Tell the current time since startup.
+       * @par Parameters
+       *  None
+       * @return The number of SysTick input clocks since startup.
+       */
+      virtual timestamp_t
+      steady_now (void) override;
+
+      virtual void
+      internal_schedule_next (void) override;
+
+      void
+      internal_check_compare (void);
+
+#endif /* defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE) */
+
       /**
        * @}
        */
@@ -788,12 +870,56 @@ namespace os
       return steady_list_;
     }
 
+    inline uint32_t
+    clock::coalesced_count (void) const
+    {
+      return steady_list_.coalesced_count ();
+    }
+
     inline void
     __attribute__((always_inline))
     clock::internal_increment_count (void)
     {
+      internal_begin_write_ ();
       // Increment the systick count by 1.
       ++steady_count_;
+      internal_end_write_ ();
+    }
+
+    /*
+     * The counters are updated only in interrupts critical sections,
+     * so on a single core the readers either see an even sequence
+     * number, or are themselves interrupts that cannot use the
+     * RTOS. Volatile accesses are not reordered by the compiler,
+     * so no other barriers are needed.
+     */
+
+    inline uint32_t
+    __attribute__((always_inline))
+    clock::internal_begin_read_ (void) const
+    {
+      return steady_seq_;
+    }
+
+    inline bool
+    __attribute__((always_inline))
+    clock::internal_retry_read_ (uint32_t seq) const
+    {
+      return ((seq & 1) != 0) || (seq != steady_seq_);
+    }
+
+    inline void
+    __attribute__((always_inline))
+    clock::internal_begin_write_ (void)
+    {
+      steady_seq_ = steady_seq_ + 1;
+    }
+
+    inline void
+    __attribute__((always_inline))
+    clock::internal_end_write_ (void)
+    {
+      steady_seq_ = steady_seq_ + 1;
     }
 
     inline void
@@ -865,8 +991,10 @@ namespace os
     __attribute__((always_inline))
     clock_highres::internal_increment_count (void)
     {
+      internal_begin_write_ ();
       // Increment the highres count by SysTick divisor.
       steady_count_ += port::clock_highres::cycles_per_tick ();
+      internal_end_write_ ();
     }
 
     inline uint32_t
@@ -805,6 +805,24 @@ namespace os
 
         static uint32_t
         input_clock_frequency_hz (void);
+
+#if defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE)
+
+        /**
+         * @brief Program the compare match interrupt.
+         * @param [in] timestamp The `hrclock` time stamp, in cycles.
+         * @details
+         * When the high resolution counter reaches the time stamp,
+         * the port must call `os_hrclock_compare_handler()`.
+         * If the time stamp is already in the past, the interrupt
+         * must be triggered as soon as possible.
+         * A new call replaces the previous compare value.
+         * It is always called in an interrupts critical section.
+         */
+        static void
+        compare (clock::timestamp_t timestamp);
+
+#endif /* defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE) */
       };
 
     } /* namespace port */
@@ -910,6 +928,23 @@ extern "C"
 #define OS_INTEGER_RTOS_IDLE_STACK_SIZE_BYTES               (os::rtos::port::stack::default_size_bytes)
 #endif
 
+#if !defined(OS_INTEGER_RTOS_TIMER_DAEMON_STACK_SIZE_BYTES)
+#define OS_INTEGER_RTOS_TIMER_DAEMON_STACK_SIZE_BYTES       (os::rtos::port::stack::default_size_bytes)
+#endif
+
+#if !defined(OS_INTEGER_RTOS_TIMER_DAEMON_PRIORITY)
+#define OS_INTEGER_RTOS_TIMER_DAEMON_PRIORITY               (os::rtos::thread::priority::high)
+#endif
+
+#if !defined(OS_INTEGER_RTOS_STATISTICS_CPU_LOAD_WINDOW_TICKS)
+#define OS_INTEGER_RTOS_STATISTICS_CPU_LOAD_WINDOW_TICKS    (OS_INTEGER_SYSTICK_FREQUENCY_HZ)
+#endif
+
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) \
+  && !defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES)
+#error "OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD requires OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES"
+#endif
+
 #if !defined(OS_BOOL_RTOS_SCHEDULER_PREEMPTIVE)
 #define OS_BOOL_RTOS_SCHEDULER_PREEMPTIVE                   (true)
 #endif
@@ -52,8 +52,50 @@ namespace os
   {
     namespace memory
     {
+      namespace internal
+      {
+        /**
+         * @brief Allocate storage with an extended alignment.
+         * @param [in] bytes Size of the storage, in bytes.
+         * @param [in] alignment Power of two, larger than
+         * `alignof(std::max_align_t)`.
+         * @return Pointer to aligned storage; never `nullptr`.
+         */
+        void*
+        allocate_aligned (std::size_t bytes, std::size_t alignment);
+
+        /**
+         * @brief Deallocate storage with an extended alignment.
+         * @param [in] p Pointer returned by allocate_aligned().
+         * @param [in] alignment The alignment used for allocation.
+         * @par Returns
+         *  Nothing.
+         */
+        void
+        deallocate_aligned (void* p, std::size_t alignment) noexcept;
+      } /* namespace internal */
+
       // ======================================================================
 
+      /**
+       * @brief Standard allocator based on the RTOS system default
+       * memory manager.
+       * @details
+       * If `T` has an extended alignment (for example
+       * `std::aligned_storage<32, 32>::type`), the storage
+       * is allocated aligned accordingly. This is the recommended
+       * way to get DMA or cache line aligned stacks, pools and queues.
+       *
+       * @par Example
+       *
+       * @code{.cpp}
+       * using aligned_allocator = os::rtos::memory::new_delete_allocator<
+       *     std::aligned_storage<32, 32>::type>;
+       *
+       * // Both the pool storage and each block are 32-bytes aligned.
+       * memory_pool_allocated<aligned_allocator> mp { 8, 100 };
+       * @endcode
+       */
       template<typename T>
         class new_delete_allocator
         {
@@ -221,6 +263,12 @@ namespace os
         inline typename new_delete_allocator<T>::value_type*
         new_delete_allocator<T>::allocate (std::size_t n)
         {
+          if (alignof(value_type) > alignof(std::max_align_t))
+            {
+              return static_cast<value_type*> (internal::allocate_aligned (
+                  n * sizeof(value_type), alignof(value_type)));
+            }
+
           return static_cast<value_type*> (::operator new (
               n * sizeof(value_type)));
         }
@@ -230,6 +278,12 @@ namespace os
         new_delete_allocator<T>::deallocate (
             value_type* p, std::size_t n __attribute__((unused))) noexcept
         {
+          if (alignof(value_type) > alignof(std::max_align_t))
+            {
+              internal::deallocate_aligned (p, alignof(value_type));
+              return;
+            }
+
           ::operator delete (p);
         }
 
@@ -1022,6 +1022,10 @@ namespace os
      * the storage is dynamically allocated using the RTOS specific allocator
      * (`rtos::memory::allocator`).
      *
+     * If the allocator value type has an extended alignment,
+     * the block size is rounded up to a multiple of it, so that
+     * all blocks have the same alignment as the storage.
+     *
      * @warning Cannot be invoked from Interrupt Service Routines.
      */
     template<typename Allocator>
@@ -1044,6 +1048,16 @@ namespace os
           {
             allocator_ = &allocator;
 
+            using element_type = typename allocator_type::value_type;
+            if (alignof(element_type) > alignof(std::max_align_t))
+              {
+                // For extended alignments (like DMA or cache lines),
+                // pad blocks so that all of them remain aligned,
+                // not only the first one.
+                block_size_bytes = ((block_size_bytes + sizeof(element_type)
+                    - 1) / sizeof(element_type)) * sizeof(element_type);
+              }
+
             // If no user storage was provided via attributes,
             // allocate it dynamically via the allocator.
             allocated_pool_size_elements_ = (compute_allocated_size_bytes<
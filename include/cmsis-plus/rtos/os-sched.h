@@ -469,6 +469,78 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+        /**
+         * @brief Get the system CPU load.
+         * @par Parameters
+         *  None
+         * @return The time not spent in the idle thread during the
+         *  last window, in hundredths of percent (0-10000).
+         */
+        uint32_t
+        cpu_load (void);
+
+        /**
+         * @brief Get the idle thread CPU load.
+         * @par Parameters
+         *  None
+         * @return The time spent in the idle thread during the
+         *  last window, in hundredths of percent (0-10000).
+         */
+        uint32_t
+        idle_load (void);
+
+        /**
+         * @brief Get the interrupts CPU load.
+         * @par Parameters
+         *  None
+         * @return The time spent in accounted interrupt handlers
+         *  during the last window, in hundredths of percent (0-10000).
+         *  This time is not included in the threads loads.
+         */
+        uint32_t
+        interrupts_load (void);
+
+        /**
+         * @brief Get the length of the last window.
+         * @par Parameters
+         *  None
+         * @return The number of high resolution clock cycles.
+         */
+        rtos::statistics::duration_t
+        window_cycles (void);
+
+        /**
+         * @cond ignore
+         */
+
+        uint32_t
+        internal_load (rtos::statistics::duration_t cycles);
+
+        void
+        internal_roll_window (void);
+
+        void
+        internal_interrupt_enter (void);
+
+        void
+        internal_interrupt_exit (void);
+
+        extern uint32_t volatile window_;
+        extern clock::timestamp_t window_start_;
+        extern rtos::statistics::duration_t window_cycles_;
+        extern rtos::statistics::duration_t interrupts_cycles_;
+        extern rtos::statistics::duration_t interrupts_last_cycles_;
+        extern clock::timestamp_t interrupts_timestamp_;
+        extern uint32_t interrupts_nesting_;
+
+      /**
+       * @endcond
+       */
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
       } /* namespace statistics */
     } /* namespace scheduler */
 
@@ -798,6 +870,62 @@ namespace os
 
       };
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+      // ======================================================================
+
+      /**
+       * @brief Interrupt handler load accounting [RAII](https://en.wikipedia.org/wiki/Resource_Acquisition_Is_Initialization) helper.
+       * @headerfile os.h <cmsis-plus/rtos/os.h>
+       * @details
+       * Define it at the beginning of an interrupt handler, to
+       * have its duration included in
+       * scheduler::statistics::interrupts_load().
+       * Nested handlers are accounted only once.
+       */
+      class accounted_section
+      {
+      public:
+
+        /**
+         * @name Constructors & Destructor
+         * @{
+         */
+
+        /**
+         * @brief Start accounting the interrupt handler.
+         * @par Parameters
+         *  None
+         */
+        accounted_section ();
+
+        /**
+         * @cond ignore
+         */
+
+        accounted_section (const accounted_section&) = delete;
+        accounted_section (accounted_section&&) = delete;
+        accounted_section&
+        operator= (const accounted_section&) = delete;
+        accounted_section&
+        operator= (accounted_section&&) = delete;
+
+        /**
+         * @endcond
+         */
+
+        /**
+         * @brief Stop accounting the interrupt handler.
+         */
+        ~accounted_section ();
+
+        /**
+         * @}
+         */
+      };
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
     } /* namespace interrupts */
   } /* namespace rtos */
 } /* namespace os */
@@ -1063,6 +1191,34 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+        /**
+         * @details
+         * The system load is the complement of the idle thread load;
+         * it includes the interrupts.
+         *
+         * @note Can be invoked from Interrupt Service Routines.
+         */
+        inline uint32_t
+        cpu_load (void)
+        {
+          return 10000 - idle_load ();
+        }
+
+        /**
+         * @details
+         *
+         * @note Can be invoked from Interrupt Service Routines.
+         */
+        inline rtos::statistics::duration_t
+        window_cycles (void)
+        {
+          return window_cycles_;
+        }
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
       } /* namespace statistics */
 
     } /* namespace scheduler */
@@ -1248,6 +1404,36 @@ namespace os
         critical_section::exit (state_);
       }
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+      // ======================================================================
+
+      /**
+       * @details
+       *
+       * @note Can be invoked only from Interrupt Service Routines.
+       */
+      inline
+      __attribute__((always_inline))
+      accounted_section::accounted_section ()
+      {
+        scheduler::statistics::internal_interrupt_enter ();
+      }
+
+      /**
+       * @details
+       *
+       * @note Can be invoked only from Interrupt Service Routines.
+       */
+      inline
+      __attribute__((always_inline))
+      accounted_section::~accounted_section ()
+      {
+        scheduler::statistics::internal_interrupt_exit ();
+      }
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
     // ========================================================================
     }
 
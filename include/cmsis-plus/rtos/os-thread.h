@@ -204,6 +204,37 @@ namespace os
       flags_get (flags::mask_t mask,
                  flags::mode_t mode = flags::mode::all | flags::mode::clear);
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      /**
+       * @brief Start periodic releases of the current thread.
+       * @param [in] period The release period, in clock units
+       *  (ticks or seconds).
+       * @param [in] skip_overruns If `true`, release points missed
+       *  because of an overrun are skipped; otherwise the thread is
+       *  released immediately, to catch up.
+       * @retval result::ok The period was set.
+       * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+       * @retval EINVAL The period is zero.
+       */
+      result_t
+      set_period (clock::duration_t period, bool skip_overruns = false);
+
+      /**
+       * @brief Wait for the next periodic release.
+       * @par Parameters
+       *  None
+       * @retval result::ok The thread was released on time.
+       * @retval ETIMEDOUT One or more release points were missed.
+       * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+       * @retval EINVAL The period was not set.
+       * @retval EINTR The operation was interrupted.
+       */
+      result_t
+      wait_next_period (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       /**
        * @brief Implementation of the library `__errno()` function.
        * @return Pointer to thread specific `errno`.
@@ -919,6 +950,20 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+        /**
+         * @brief Get the thread CPU load.
+         * @par Parameters
+         *  None
+         * @return The time spent in the thread during the last
+         *  window, in hundredths of percent (0-10000).
+         */
+        uint32_t
+        cpu_load (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
         /**
          * @}
          */
@@ -932,6 +977,16 @@ namespace os
         friend void
         rtos::scheduler::internal_switch_threads (void);
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+        friend void
+        rtos::scheduler::statistics::internal_roll_window (void);
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+#if defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES)
+        void
+        internal_add_cycles_ (rtos::statistics::duration_t delta);
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
+
 #if defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES)
         rtos::statistics::counter_t context_switches_ = 0;
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES) */
@@ -940,6 +995,13 @@ namespace os
         rtos::statistics::duration_t cpu_cycles_ = 0;
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+        // Cycles in the current window and in the previous one.
+        rtos::statistics::duration_t window_cycles_ = 0;
+        rtos::statistics::duration_t last_window_cycles_ = 0;
+        uint32_t window_ = 0;
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
         /**
          * @endcond
          */
@@ -948,6 +1010,130 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES) || defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      /**
+       * @brief Thread periodic releases.
+       * @headerfile os.h <cmsis-plus/rtos/os.h>
+       * @ingroup cmsis-plus-rtos-thread
+       * @details
+       * The release points are absolute, each one exactly one
+       * period after the previous, so the execution time and the
+       * wake-up latency do not accumulate as drift.
+       */
+      class periodic
+      {
+      public:
+        /**
+         * @name Constructors & Destructor
+         * @{
+         */
+
+        /**
+         * @brief Construct a thread periodic object instance.
+         * @par Parameters
+         *  None
+         */
+        periodic () = default;
+
+        /**
+         * @cond ignore
+         */
+
+        periodic (const periodic&) = delete;
+        periodic (periodic&&) = delete;
+        periodic&
+        operator= (const periodic&) = delete;
+        periodic&
+        operator= (periodic&&) = delete;
+
+        /**
+         * @endcond
+         */
+
+        /**
+         * @brief Destruct the thread periodic object instance.
+         */
+        ~periodic () = default;
+
+        /**
+         * @}
+         */
+
+      public:
+
+        /**
+         * @name Public Member Functions
+         * @{
+         */
+
+        /**
+         * @brief Get the release period.
+         * @return The period in clock units, or 0 if not set.
+         */
+        clock::duration_t
+        period (void) const;
+
+        /**
+         * @brief Get the number of releases.
+         * @return A long integer with the number of returns from
+         *  wait_next_period().
+         */
+        rtos::statistics::counter_t
+        releases (void) const;
+
+        /**
+         * @brief Get the number of missed deadlines.
+         * @return A long integer with the number of release points
+         *  that passed before the thread waited for them.
+         */
+        rtos::statistics::counter_t
+        overruns (void) const;
+
+        /**
+         * @brief Get the largest release latency.
+         * @return The largest delay from a release point to the
+         *  thread resuming, in clock units.
+         */
+        clock::duration_t
+        jitter_max (void) const;
+
+        /**
+         * @brief Get the accumulated release latency.
+         * @return The sum of all delays from the release points to
+         *  the thread resuming, in clock units.
+         */
+        rtos::statistics::duration_t
+        jitter_total (void) const;
+
+        /**
+         * @}
+         */
+
+      protected:
+
+        /**
+         * @cond ignore
+         */
+
+        friend class rtos::thread;
+
+        clock::duration_t period_ = 0;
+        clock::timestamp_t next_release_ = 0;
+        rtos::statistics::counter_t releases_ = 0;
+        rtos::statistics::counter_t overruns_ = 0;
+        rtos::statistics::duration_t jitter_total_ = 0;
+        clock::duration_t jitter_max_ = 0;
+        bool skip_overruns_ = false;
+
+        /**
+         * @endcond
+         */
+
+      };
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
 #pragma GCC diagnostic pop
 
       /**
@@ -1234,6 +1420,19 @@ namespace os
 
 #endif
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      /**
+       * @brief Get the thread periodic releases.
+       * @par Parameters
+       *  None
+       * @return A reference to the periodic object instance.
+       */
+      class thread::periodic&
+      periodic (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       /**
        * @}
        */
@@ -1275,6 +1474,16 @@ namespace os
       friend flags::mask_t
       this_thread::flags_get (flags::mask_t mask, flags::mode_t mode);
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      friend result_t
+      this_thread::set_period (clock::duration_t period, bool skip_overruns);
+
+      friend result_t
+      this_thread::wait_next_period (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       friend int*
       this_thread::__errno (void);
 
@@ -1300,6 +1509,11 @@ namespace os
       friend void
       scheduler::internal_switch_threads (void);
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+      friend void
+      scheduler::statistics::internal_roll_window (void);
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
       friend void
       port::scheduler::reschedule (void);
 
@@ -1476,6 +1690,34 @@ namespace os
       flags::mask_t
       internal_flags_get_ (flags::mask_t mask, flags::mode_t mode);
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      /**
+       * @brief Start periodic releases.
+       * @param [in] period The release period, in clock units.
+       * @param [in] skip_overruns Skip the missed release points.
+       * @retval result::ok The period was set.
+       * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+       * @retval EINVAL The period is zero.
+       */
+      result_t
+      internal_set_period_ (clock::duration_t period, bool skip_overruns);
+
+      /**
+       * @brief Wait for the next periodic release.
+       * @par Parameters
+       *  None
+       * @retval result::ok The thread was released on time.
+       * @retval ETIMEDOUT One or more release points were missed.
+       * @retval EPERM Cannot be invoked from an Interrupt Service Routines.
+       * @retval EINVAL The period was not set.
+       * @retval EINTR The operation was interrupted.
+       */
+      result_t
+      internal_wait_next_period_ (void);
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       /**
        * @brief The actual destructor, also called from exit() and kill().
        * @par Parameters
@@ -1617,6 +1859,12 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES) */
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      class periodic periodic_;
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       // Add other internal data
 
       // Implementation
@@ -1957,6 +2205,58 @@ namespace os
         return this_thread::thread ().internal_flags_get_ (mask, mode);
       }
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+      /**
+       * @details
+       * The first release point is one period after this call.
+       * The thread timeout clock is used, and all statistics are
+       * cleared.
+       *
+       * @par Example
+       *
+       * @code{.cpp}
+       * this_thread::set_period (10); // 10 ticks.
+       * for (;;)
+       *   {
+       *     this_thread::wait_next_period ();
+       *     // Do the periodic work.
+       *   }
+       * @endcode
+       *
+       * @warning Cannot be invoked from Interrupt Service Routines.
+       */
+      inline result_t
+      set_period (clock::duration_t period, bool skip_overruns)
+      {
+        return this_thread::thread ().internal_set_period_ (period,
+                                                            skip_overruns);
+      }
+
+      /**
+       * @details
+       * Advance the release point by exactly one period and sleep
+       * until it is reached.
+       *
+       * If the release point already passed, the deadline was
+       * missed; the thread is either released immediately, or,
+       * if the overruns are skipped, at the first release point
+       * still in the future. A release reached exactly on time
+       * is not an overrun.
+       *
+       * If the sleep is interrupted, the release point is not
+       * advanced and the next call waits for the same one.
+       *
+       * @warning Cannot be invoked from Interrupt Service Routines.
+       */
+      inline result_t
+      wait_next_period (void)
+      {
+        return this_thread::thread ().internal_wait_next_period_ ();
+      }
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
       /**
        * @details
        *
@@ -2247,6 +2547,33 @@ namespace os
       return cpu_cycles_;
     }
 
+    /**
+     * @details
+     * If the thread did not run since the window changed, the
+     * current window cycles are moved to the previous window
+     * (or dropped, if more windows passed).
+     *
+     * Must be called in an interrupts critical section.
+     */
+    inline void
+    __attribute__((always_inline))
+    thread::statistics::internal_add_cycles_ (
+        rtos::statistics::duration_t delta)
+    {
+      cpu_cycles_ += delta;
+
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+      uint32_t window = scheduler::statistics::window_;
+      if (window_ != window)
+        {
+          last_window_cycles_ = (window_ + 1 == window) ? window_cycles_ : 0;
+          window_cycles_ = 0;
+          window_ = window;
+        }
+      window_cycles_ += delta;
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+    }
+
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
     // ========================================================================
@@ -2374,6 +2701,55 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES) */
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+    /**
+     * @details
+     *
+     * @note Can be invoked from Interrupt Service Routines.
+     */
+    inline class thread::periodic&
+    thread::periodic (void)
+    {
+      return periodic_;
+    }
+
+    inline clock::duration_t
+    thread::periodic::period (void) const
+    {
+      return period_;
+    }
+
+    inline rtos::statistics::counter_t
+    thread::periodic::releases (void) const
+    {
+      return releases_;
+    }
+
+    inline rtos::statistics::counter_t
+    thread::periodic::overruns (void) const
+    {
+      return overruns_;
+    }
+
+    inline clock::duration_t
+    thread::periodic::jitter_max (void) const
+    {
+      return jitter_max_;
+    }
+
+    /**
+     * @details
+     * Divide by releases() to get the average latency.
+     */
+    inline rtos::statistics::duration_t
+    thread::periodic::jitter_total (void) const
+    {
+      return jitter_total_;
+    }
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
 #if defined(OS_INCLUDE_RTOS_THREAD_PUBLIC_FLAGS_CLEAR)
 
     inline result_t
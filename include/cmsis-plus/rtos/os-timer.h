@@ -41,6 +41,23 @@
 
 // ----------------------------------------------------------------------------
 
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON)
+
+/**
+ * @cond ignore
+ */
+
+void*
+os_timer_daemon (void* args);
+
+/**
+ * @endcond
+ */
+
+#endif
+
+// ----------------------------------------------------------------------------
+
 namespace os
 {
   namespace rtos
@@ -98,6 +115,33 @@ namespace os
         };
       };
 
+      /**
+       * @brief Type of of variables holding timer execution contexts.
+       * @ingroup cmsis-plus-rtos-timer
+       */
+      using execution_t = uint8_t;
+
+      /**
+       * @brief Timer execution contexts.
+       * @ingroup cmsis-plus-rtos-timer
+       */
+      struct execution
+      {
+        enum
+          : execution_t
+            {
+              /**
+               * @brief Run the function in the clock interrupt.
+               */
+              interrupt = 0,
+
+              /**
+               * @brief Run the function in the timer daemon thread.
+               */
+              daemon = 1      //
+        };
+      };
+
       /**
        * @brief Type of of variables holding timer states.
        * @ingroup cmsis-plus-rtos-timer
@@ -195,6 +239,25 @@ namespace os
          */
         type_t tm_type = run::once;
 
+        /**
+         * @brief Timer execution context attribute.
+         * @details
+         * Functions of timers with `execution::daemon` are called
+         * by the timer daemon thread, not in the clock interrupt.
+         * Requires @ref OS_INCLUDE_RTOS_TIMER_DAEMON, otherwise
+         * ignored.
+         */
+        execution_t tm_execution = execution::interrupt;
+
+        /**
+         * @brief Timer slack attribute.
+         * @details
+         * The number of clock units the timer may be delayed, to
+         * share the wake-up with other timeouts expiring in the
+         * same window. Periodic timers do not accumulate the delay.
+         */
+        clock::duration_t tm_slack = 0;
+
         // Add more attributes.
 
         /**
@@ -373,6 +436,11 @@ namespace os
 
       friend class internal::timer_node;
 
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON)
+      friend void*
+      ::os_timer_daemon (void* args);
+#endif
+
       /**
        * @endcond
        */
@@ -397,6 +465,9 @@ namespace os
       void
       internal_interrupt_service_routine (void);
 
+      void
+      internal_rearm_ (void);
+
 #endif
 
       /**
@@ -426,6 +497,9 @@ namespace os
       internal::timer_node timer_node_
         { 0, *this };
       clock::duration_t period_ = 0;
+      // The nominal expiry time, without the slack.
+      clock::timestamp_t expiry_ = 0;
+      clock::duration_t slack_ = 0;
 #endif
 
 #if defined(OS_USE_RTOS_PORT_TIMER)
@@ -435,6 +509,7 @@ namespace os
 
       type_t type_ = run::once;
       state_t state_ = state::undefined;
+      execution_t execution_ = execution::interrupt;
 
       // Add more internal data.
 
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# This file is part of the µOS++ distribution.
+#   (https://github.com/micro-os-plus)
+# Copyright (c) 2016 Liviu Ionescu.
+#
+# Permission is hereby granted, free of charge, to any person
+# obtaining a copy of this software and associated documentation
+# files (the "Software"), to deal in the Software without
+# restriction, including without limitation the rights to use,
+# copy, modify, merge, publish, distribute, sublicense, and/or
+# sell copies of the Software, and to permit persons to whom
+# the Software is furnished to do so, subject to the following
+# conditions:
+#
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+# OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+# HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+# WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+# OTHER DEALINGS IN THE SOFTWARE.
+#
+
+"""
+Symbolize the output of os::diag::malloc_profiler::dump().
+
+Usage:
+  malloc-profiler-symbolize.py [--addr2line PROG] [--sort KEY] app.elf [log]
+
+The log (default stdin) may contain other trace lines; only the
+lines between 'malloc-profiler begin' and 'malloc-profiler end'
+are processed. Call sites are resolved to function, file and line
+with addr2line; sites that point to strings (tags passed to
+malloc_profiler::malloc()) are displayed as the string itself.
+"""
+
+import argparse
+import re
+import struct
+import subprocess
+import sys
+
+SITE_RE = re.compile(
+    r'site\s+(?:0x)?([0-9a-fA-F]+|\(nil\))\s+allocs\s+(\d+)\s+frees\s+(\d+)'
+    r'\s+live\s+(\d+)\s+peak\s+(\d+)')
+
+
+def read_sections(elf_path):
+    """Return a list of (addr, size, file offset) of the loaded sections."""
+    with open(elf_path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF':
+        return data, []
+    is64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x3A)
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        base = shoff + i * shentsize
+        if is64:
+            _, sh_type, _, addr, offset, size = struct.unpack_from(
+                endian + 'IIQQQQ', data, base)
+        else:
+            _, sh_type, _, addr, offset, size = struct.unpack_from(
+                endian + 'IIIIII', data, base)
+        # SHT_PROGBITS only; .bss has no content.
+        if sh_type == 1 and addr != 0:
+            sections.append((addr, size, offset))
+    return data, sections
+
+
+def read_string(data, sections, addr):
+    """Return the printable string at addr, or None."""
+    for start, size, offset in sections:
+        if start <= addr < start + size:
+            pos = offset + (addr - start)
+            end = data.find(b'\0', pos, offset + size)
+            if end <= pos:
+                return None
+            raw = data[pos:end]
+            if len(raw) < 64 and all(32 <= b < 127 for b in raw):
+                return raw.decode('ascii')
+            return None
+    return None
+
+
+def symbolize(addr2line, elf_path, addrs):
+    if not addrs:
+        return {}
+    cmd = [addr2line, '-f', '-C', '-e', elf_path] + ['%x' % a for a in addrs]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, check=True,
+                         universal_newlines=True).stdout.splitlines()
+    result = {}
+    for i, a in enumerate(addrs):
+        func = out[2 * i] if 2 * i < len(out) else '??'
+        loc = out[2 * i + 1] if 2 * i + 1 < len(out) else '??:0'
+        result[a] = (func, loc)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line')
+    parser.add_argument('--sort', default='peak',
+                        choices=['peak', 'live', 'allocs', 'site'])
+    parser.add_argument('elf')
+    parser.add_argument('log', nargs='?')
+    args = parser.parse_args()
+
+    log = open(args.log) if args.log else sys.stdin
+    rows = []
+    total = None
+    inside = False
+    for line in log:
+        if 'malloc-profiler begin' in line:
+            inside, rows = True, []
+            continue
+        if 'malloc-profiler end' in line:
+            inside = False
+            continue
+        if not inside:
+            continue
+        m = SITE_RE.search(line)
+        if m:
+            site = 0 if m.group(1) == '(nil)' else int(m.group(1), 16)
+            rows.append((site,) + tuple(int(m.group(i)) for i in range(2, 6)))
+        elif line.startswith('total'):
+            total = line.strip()
+
+    data, sections = read_sections(args.elf)
+    # Return addresses point after the call; step back to the call insn.
+    code_addrs = sorted({r[0] - 1 for r in rows if r[0] != 0
+                         and read_string(data, sections, r[0]) is None})
+    symbols = symbolize(args.addr2line, args.elf, code_addrs)
+
+    key = {'peak': 4, 'live': 3, 'allocs': 1, 'site': 0}[args.sort]
+    rows.sort(key=lambda r: r[key], reverse=(args.sort != 'site'))
+
+    print('%10s %8s %8s %10s %10s  %s' % ('site', 'allocs', 'frees', 'live',
+                                          'peak', 'where'))
+    for site, allocs, frees, live, peak in rows:
+        if site == 0:
+            where = '(overflow, table full)'
+        else:
+            tag = read_string(data, sections, site)
+            if tag is not None:
+                where = '"%s"' % tag
+            else:
+                func, loc = symbols.get(site - 1, ('??', '??:0'))
+                where = '%s at %s' % (func, loc)
+        print('%10x %8d %8d %10d %10d  %s' % (site, allocs, frees, live, peak,
+                                              where))
+    if total:
+        print(total)
+
+
+if __name__ == '__main__':
+    main()
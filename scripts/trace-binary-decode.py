@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+#
+# This file is part of the µOS++ distribution.
+#   (https://github.com/micro-os-plus)
+# Copyright (c) 2016 Liviu Ionescu.
+#
+# Permission is hereby granted, free of charge, to any person
+# obtaining a copy of this software and associated documentation
+# files (the "Software"), to deal in the Software without
+# restriction, including without limitation the rights to use,
+# copy, modify, merge, publish, distribute, sublicense, and/or
+# sell copies of the Software, and to permit persons to whom
+# the Software is furnished to do so, subject to the following
+# conditions:
+#
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+# OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+# HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+# WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+# OTHER DEALINGS IN THE SOFTWARE.
+#
+
+"""
+Decode the records written by os::trace::binary (OS_USE_TRACE_BINARY).
+
+Usage:
+  trace-binary-decode.py [--ring] app.elf [dump]
+
+The dump (default stdin) is either the raw byte stream written by
+os::trace::binary::drain() to the trace channel, or, with --ring, a
+memory dump of the os_trace_binary_ring structure. The format strings
+are read from the ELF, at the addresses stored in the records, and
+rendered with the arguments that follow them.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MARKER = 0xB1A50000
+MARKER_MASK = 0xFFFF0000
+RING_MAGIC = MARKER | 0x5247
+
+CONV_RE = re.compile(
+    r'%([-+ #0\']*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diuoxXcspnfFeEgGaA%])')
+
+
+def read_sections(elf_path):
+    """Return the ELF content, its endianness and the loaded sections."""
+    with open(elf_path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF':
+        sys.exit('%s: not an ELF file' % elf_path)
+    is64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x3A)
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        base = shoff + i * shentsize
+        if is64:
+            _, sh_type, _, addr, offset, size = struct.unpack_from(
+                endian + 'IIQQQQ', data, base)
+        else:
+            _, sh_type, _, addr, offset, size = struct.unpack_from(
+                endian + 'IIIIII', data, base)
+        # SHT_PROGBITS only; .bss has no content.
+        if sh_type == 1 and addr != 0:
+            sections.append((addr, size, offset))
+    return data, endian, is64, sections
+
+
+def read_string(data, sections, addr):
+    """Return the null terminated string at addr, or None."""
+    for start, size, offset in sections:
+        if start <= addr < start + size:
+            pos = offset + (addr - start)
+            end = data.find(b'\0', pos, offset + size)
+            if end < pos:
+                return None
+            return data[pos:end].decode('utf-8', 'replace')
+    return None
+
+
+class Args:
+    """Consume the argument words of one record."""
+
+    def __init__(self, words, endian):
+        self.words = words
+        self.endian = endian
+        self.pos = 0
+
+    def word(self):
+        if self.pos >= len(self.words):
+            raise IndexError('record truncated')
+        w = self.words[self.pos]
+        self.pos += 1
+        return w
+
+    def dword(self):
+        # Stored in memory order.
+        lo, hi = self.word(), self.word()
+        raw = struct.pack(self.endian + 'II', lo, hi)
+        return struct.unpack(self.endian + 'Q', raw)[0]
+
+    def double(self):
+        raw = struct.pack(self.endian + 'Q', self.dword())
+        return struct.unpack(self.endian + 'd', raw)[0]
+
+    def string(self):
+        length = self.word()
+        n = (length + 3) // 4
+        raw = b''.join(struct.pack(self.endian + 'I', self.word())
+                       for _ in range(n))
+        return raw[:length].decode('utf-8', 'replace')
+
+
+def signed(value, bits):
+    if value & (1 << (bits - 1)):
+        return value - (1 << bits)
+    return value
+
+
+def render(fmt, args, long_size, ptr_size):
+    """Render the C format with the arguments stored in the record."""
+
+    def convert(m):
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(signed(args.word(), 32))
+        if prec == '*':
+            prec = str(signed(args.word(), 32))
+        spec = '%' + flags.replace('\'', '') + (width or '')
+        if prec is not None:
+            spec += '.' + prec
+
+        size = 4
+        if length == 'l':
+            size = long_size
+        elif length in ('ll', 'j'):
+            size = 8
+        elif length in ('z', 't'):
+            size = ptr_size
+
+        if conv in 'diuoxX':
+            value = args.dword() if size > 4 else args.word()
+            bits = 64 if size > 4 else 32
+            if length == 'hh':
+                value, bits = value & 0xFF, 8
+            elif length == 'h':
+                value, bits = value & 0xFFFF, 16
+            if conv in 'di':
+                return (spec + 'd') % signed(value, bits)
+            return (spec + ('d' if conv == 'u' else conv)) % value
+        if conv == 'c':
+            return (spec + 'c') % (args.word() & 0xFF)
+        if conv == 's':
+            return (spec + 's') % args.string()
+        if conv in 'pn':
+            value = args.dword() if ptr_size > 4 else args.word()
+            return '0x%x' % value if conv == 'p' else ''
+        # Floating point, always stored as double.
+        value = args.double()
+        if conv == 'a' or conv == 'A':
+            text = float.hex(value)
+            return text.upper() if conv == 'A' else text
+        return (spec + conv) % value
+
+    return CONV_RE.sub(convert, fmt)
+
+
+def records(words):
+    """Yield the word lists of the complete records."""
+    i = 0
+    while i < len(words):
+        header = words[i]
+        n = header & 0xFFFF
+        if (header & MARKER_MASK) != MARKER or n < 2:
+            # Resynchronise on the next header.
+            i += 1
+            continue
+        if i + n > len(words):
+            break
+        yield words[i + 1:i + n]
+        i += n
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--ring', action='store_true',
+                        help='the dump is the os_trace_binary_ring structure')
+    parser.add_argument('elf')
+    parser.add_argument('dump', nargs='?')
+    args = parser.parse_args()
+
+    data, endian, is64, sections = read_sections(args.elf)
+    long_size = ptr_size = 8 if is64 else 4
+
+    raw = (open(args.dump, 'rb') if args.dump else sys.stdin.buffer).read()
+    words = list(struct.unpack_from(endian + '%dI' % (len(raw) // 4), raw))
+
+    if args.ring:
+        magic, size, head, tail, dropped = words[:5]
+        if magic != RING_MAGIC:
+            sys.exit('not an os_trace_binary_ring dump')
+        buffer = words[5:5 + size]
+        words = [buffer[(tail + i) % size]
+                 for i in range((head - tail) & 0xFFFFFFFF)]
+        if dropped:
+            sys.stderr.write('%d records dropped\n' % dropped)
+
+    for rec in records(words):
+        if is64:
+            addr = rec[0] | (rec[1] << 32) if endian == '<' else \
+                (rec[0] << 32) | rec[1]
+            rest = rec[2:]
+        else:
+            addr, rest = rec[0], rec[1:]
+        fmt = read_string(data, sections, addr)
+        if fmt is None:
+            sys.stdout.write('<unknown format 0x%x>\n' % addr)
+            continue
+        try:
+            sys.stdout.write(render(fmt, Args(rest, endian), long_size,
+                                    ptr_size))
+        except IndexError:
+            sys.stdout.write('<truncated> %s\n' % fmt.rstrip('\n'))
+
+
+if __name__ == '__main__':
+    main()
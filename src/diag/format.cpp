@@ -0,0 +1,640 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/diag/format.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace diag
+  {
+    /**
+     * @cond ignore
+     */
+
+    namespace
+    {
+      // Accumulate the output, counting also the characters
+      // that do not fit, as vsnprintf() does.
+      class sink
+      {
+      public:
+
+        sink (char* buf, std::size_t size) :
+            buf_ (buf), //
+            size_ (size), //
+            count_ (0)
+        {
+          ;
+        }
+
+        void
+        put (char c)
+        {
+          if (count_ + 1 < size_)
+            {
+              buf_[count_] = c;
+            }
+          ++count_;
+        }
+
+        void
+        put (const char* s, std::size_t n)
+        {
+          if (count_ + 1 < size_)
+            {
+              std::size_t room = size_ - 1 - count_;
+              std::memcpy (buf_ + count_, s, n < room ? n : room);
+            }
+          count_ += n;
+        }
+
+        void
+        fill (char c, int n)
+        {
+          for (; n > 0; --n)
+            {
+              put (c);
+            }
+        }
+
+        int
+        finish (void)
+        {
+          if (size_ > 0)
+            {
+              buf_[count_ < size_ ? count_ : size_ - 1] = '\0';
+            }
+          return static_cast<int> (count_);
+        }
+
+      private:
+
+        char* buf_;
+        std::size_t size_;
+        std::size_t count_;
+      };
+
+      struct spec
+      {
+        bool left;
+        bool zero;
+        bool alt;
+        char sign; // '+', ' ' or '\0'
+        int width;
+        int precision; // -1 if not given
+      };
+
+      // Enough for the 22 octal digits of a 64-bit value.
+      constexpr std::size_t digits_size = 24;
+
+      // Convert to digits, right aligned in `end`; return the start.
+      char*
+      to_digits (char* end, uint64_t value, unsigned int base, bool upper)
+      {
+        const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        char* p = end;
+        if (base == 10)
+          {
+            // Use 32-bit divisions when possible, they are
+            // much faster than the 64-bit library calls.
+            while (value > UINT32_MAX)
+              {
+                *--p = digits[value % 10];
+                value /= 10;
+              }
+            uint32_t v = static_cast<uint32_t> (value);
+            while (v != 0)
+              {
+                *--p = digits[v % 10];
+                v /= 10;
+              }
+          }
+        else
+          {
+            unsigned int shift = (base == 16) ? 4 : 3;
+            while (value != 0)
+              {
+                *--p = digits[value & (base - 1)];
+                value >>= shift;
+              }
+          }
+        return p;
+      }
+
+      // Output the sign/prefix, the leading zeros and the digits,
+      // padded to the field width.
+      void
+      put_padded (sink& out, const spec& s, const char* prefix, int nprefix,
+                  int zeros, const char* body, int nbody, bool zero_pad)
+      {
+        int pad = s.width - (nprefix + zeros + nbody);
+        if (!s.left && !zero_pad)
+          {
+            out.fill (' ', pad);
+          }
+        out.put (prefix, static_cast<std::size_t> (nprefix));
+        if (!s.left && zero_pad)
+          {
+            out.fill ('0', pad);
+          }
+        out.fill ('0', zeros);
+        out.put (body, static_cast<std::size_t> (nbody));
+        if (s.left)
+          {
+            out.fill (' ', pad);
+          }
+      }
+
+      void
+      put_integer (sink& out, const spec& s, uint64_t value, bool negative,
+                   unsigned int base, bool upper)
+      {
+        char buf[digits_size];
+        char* end = buf + sizeof(buf);
+        char* begin = to_digits (end, value, base, upper);
+        int ndigits = static_cast<int> (end - begin);
+
+        // Leading zeros, from the precision.
+        int zeros = 0;
+        if (s.precision >= 0)
+          {
+            if (s.precision > ndigits)
+              {
+                zeros = s.precision - ndigits;
+              }
+          }
+        else if (ndigits == 0)
+          {
+            zeros = 1; // The value 0 with the default precision.
+          }
+
+        char prefix[2];
+        int nprefix = 0;
+        if (negative)
+          {
+            prefix[nprefix++] = '-';
+          }
+        else if (s.sign != '\0' && base == 10)
+          {
+            prefix[nprefix++] = s.sign;
+          }
+        if (s.alt && value != 0)
+          {
+            if (base == 16)
+              {
+                prefix[nprefix++] = '0';
+                prefix[nprefix++] = upper ? 'X' : 'x';
+              }
+          }
+        if (s.alt && base == 8 && zeros == 0)
+          {
+            // The first digit must be zero, even for the value 0.
+            zeros = 1;
+          }
+
+        put_padded (out, s, prefix, nprefix, zeros, begin, ndigits,
+                    s.zero && s.precision < 0);
+      }
+
+      void
+      put_string (sink& out, const spec& s, const char* str, std::size_t len)
+      {
+        int pad = s.width - static_cast<int> (len);
+        if (!s.left)
+          {
+            out.fill (' ', pad);
+          }
+        out.put (str, len);
+        if (s.left)
+          {
+            out.fill (' ', pad);
+          }
+      }
+
+      void
+      put_double (sink& out, const spec& s, double value)
+      {
+        char sign[1];
+        int nsign = 0;
+        // Also for -0.0, as printf() does.
+        if (std::signbit (value))
+          {
+            value = -value;
+            sign[nsign++] = '-';
+          }
+        else if (s.sign != '\0')
+          {
+            sign[nsign++] = s.sign;
+          }
+
+        if (__builtin_isnan (value))
+          {
+            put_padded (out, s, sign, nsign, 0, "nan", 3, false);
+            return;
+          }
+
+        int precision = (s.precision < 0) ? 6 : s.precision;
+        if (precision > 9)
+          {
+            precision = 9;
+          }
+        uint32_t scale = 1;
+        for (int i = 0; i < precision; ++i)
+          {
+            scale *= 10;
+          }
+
+        if (!(value < 18446744073709551616.0))
+          {
+            put_padded (out, s, sign, nsign, 0, "inf", 3, false);
+            return;
+          }
+        uint64_t integral = static_cast<uint64_t> (value);
+        double scaled = (value - static_cast<double> (integral)) * scale;
+        uint32_t fraction = static_cast<uint32_t> (scaled);
+
+        // Round to the requested number of decimals, ties to even.
+        double rest = scaled - fraction;
+        bool odd = (precision > 0) ? ((fraction & 1) != 0) : ((integral & 1) != 0);
+        if (rest > 0.5 || (!(rest < 0.5) && odd))
+          {
+            if (++fraction >= scale)
+              {
+                fraction = 0;
+                ++integral;
+              }
+          }
+
+        // The digits, the point and the decimals, built right to left.
+        char buf[digits_size + 12];
+        char* end = buf + sizeof(buf);
+        char* begin = end;
+        if (precision > 0)
+          {
+            begin = to_digits (end, fraction, 10, false);
+            while (end - begin < precision)
+              {
+                *--begin = '0';
+              }
+          }
+        if (precision > 0 || s.alt)
+          {
+            *--begin = '.';
+          }
+        char* point = begin;
+        begin = to_digits (begin, integral, 10, false);
+        if (begin == point)
+          {
+            *--begin = '0';
+          }
+
+        put_padded (out, s, sign, nsign, 0, begin,
+                    static_cast<int> (end - begin), s.zero);
+      }
+    }
+
+    /**
+     * @endcond
+     */
+
+    // ------------------------------------------------------------------------
+
+    int
+    vsnprintf (char* buf, std::size_t size, const char* format,
+               std::va_list args)
+    {
+      sink out
+        { buf, size };
+
+      const char* f = format;
+      while (*f != '\0')
+        {
+          // Copy the literal text in one step.
+          const char* p = f;
+          while (*p != '\0' && *p != '%')
+            {
+              ++p;
+            }
+          if (p != f)
+            {
+              out.put (f, static_cast<std::size_t> (p - f));
+              f = p;
+            }
+          if (*f == '\0')
+            {
+              break;
+            }
+
+          const char* conversion = f++;
+          spec s
+            { false, false, false, '\0', 0, -1 };
+
+          // Flags.
+          for (;; ++f)
+            {
+              if (*f == '-')
+                {
+                  s.left = true;
+                }
+              else if (*f == '0')
+                {
+                  s.zero = true;
+                }
+              else if (*f == '#')
+                {
+                  s.alt = true;
+                }
+              else if (*f == '+')
+                {
+                  s.sign = '+';
+                }
+              else if (*f == ' ')
+                {
+                  if (s.sign == '\0')
+                    {
+                      s.sign = ' ';
+                    }
+                }
+              else
+                {
+                  break;
+                }
+            }
+
+          // Width.
+          if (*f == '*')
+            {
+              s.width = va_arg(args, int);
+              if (s.width < 0)
+                {
+                  s.left = true;
+                  s.width = -s.width;
+                }
+              ++f;
+            }
+          else
+            {
+              while (*f >= '0' && *f <= '9')
+                {
+                  s.width = s.width * 10 + (*f++ - '0');
+                }
+            }
+
+          // Precision.
+          if (*f == '.')
+            {
+              ++f;
+              s.precision = 0;
+              if (*f == '*')
+                {
+                  s.precision = va_arg(args, int);
+                  if (s.precision < 0)
+                    {
+                      s.precision = -1;
+                    }
+                  ++f;
+                }
+              else
+                {
+                  while (*f >= '0' && *f <= '9')
+                    {
+                      s.precision = s.precision * 10 + (*f++ - '0');
+                    }
+                }
+            }
+
+          // Length modifiers, reduced to the size of the argument.
+          std::size_t length = sizeof(int);
+          std::size_t narrow = 0; // hh or h
+          switch (*f)
+            {
+            case 'h':
+              ++f;
+              narrow = sizeof(short);
+              if (*f == 'h')
+                {
+                  ++f;
+                  narrow = sizeof(char);
+                }
+              break;
+            case 'l':
+              ++f;
+              length = sizeof(long);
+              if (*f == 'l')
+                {
+                  ++f;
+                  length = sizeof(long long);
+                }
+              break;
+            case 'j':
+              ++f;
+              length = sizeof(intmax_t);
+              break;
+            case 'z':
+              ++f;
+              length = sizeof(std::size_t);
+              break;
+            case 't':
+              ++f;
+              length = sizeof(std::ptrdiff_t);
+              break;
+            case 'L':
+              ++f;
+              break;
+            default:
+              break;
+            }
+
+          char c = *f;
+          if (c == '\0')
+            {
+              // Incomplete conversion, display it as it is.
+              out.put (conversion, static_cast<std::size_t> (f - conversion));
+              break;
+            }
+          ++f;
+
+          switch (c)
+            {
+            case 'd':
+            case 'i':
+              {
+                int64_t v;
+                if (length > sizeof(int))
+                  {
+                    v = va_arg(args, long long);
+                  }
+                else
+                  {
+                    v = va_arg(args, int);
+                    if (narrow == sizeof(char))
+                      {
+                        v = static_cast<signed char> (v);
+                      }
+                    else if (narrow == sizeof(short))
+                      {
+                        v = static_cast<short> (v);
+                      }
+                  }
+                bool negative = (v < 0);
+                uint64_t u =
+                    negative ?
+                        static_cast<uint64_t> (0) - static_cast<uint64_t> (v) :
+                        static_cast<uint64_t> (v);
+                put_integer (out, s, u, negative, 10, false);
+              }
+              break;
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+              {
+                uint64_t u;
+                if (length > sizeof(int))
+                  {
+                    u = va_arg(args, unsigned long long);
+                  }
+                else
+                  {
+                    u = va_arg(args, unsigned int);
+                    if (narrow == sizeof(char))
+                      {
+                        u = static_cast<unsigned char> (u);
+                      }
+                    else if (narrow == sizeof(short))
+                      {
+                        u = static_cast<unsigned short> (u);
+                      }
+                  }
+                unsigned int base = (c == 'u') ? 10 : ((c == 'o') ? 8 : 16);
+                // The '+' and ' ' flags apply only to signed conversions.
+                s.sign = '\0';
+                put_integer (out, s, u, false, base, c == 'X');
+              }
+              break;
+
+            case 'p':
+              {
+                s.alt = true;
+                uint64_t u = reinterpret_cast<uintptr_t> (va_arg(args, void*));
+                if (u == 0)
+                  {
+                    put_string (out, s, "0x0", 3);
+                  }
+                else
+                  {
+                    put_integer (out, s, u, false, 16, false);
+                  }
+              }
+              break;
+
+            case 'c':
+              {
+                char ch = static_cast<char> (va_arg(args, int));
+                put_string (out, s, &ch, 1);
+              }
+              break;
+
+            case 's':
+              {
+                const char* str = va_arg(args, const char*);
+                if (str == nullptr)
+                  {
+                    str = "(null)";
+                  }
+                std::size_t len;
+                if (s.precision >= 0)
+                  {
+                    const void* z = std::memchr (
+                        str, '\0', static_cast<std::size_t> (s.precision));
+                    len =
+                        (z != nullptr) ?
+                            static_cast<std::size_t> (static_cast<const char*> (z)
+                                - str) :
+                            static_cast<std::size_t> (s.precision);
+                  }
+                else
+                  {
+                    len = std::strlen (str);
+                  }
+                put_string (out, s, str, len);
+              }
+              break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+              put_double (out, s, va_arg(args, double));
+              break;
+
+            case '%':
+              out.put ('%');
+              break;
+
+            case 'n':
+              (void) va_arg(args, int*);
+              break;
+
+            default:
+              // Unknown conversion, display it as it is.
+              out.put (conversion, static_cast<std::size_t> (f - conversion));
+              break;
+            }
+        }
+
+      return out.finish ();
+    }
+
+    int
+    snprintf (char* buf, std::size_t size, const char* format, ...)
+    {
+      std::va_list args;
+      va_start(args, format);
+
+      int ret = vsnprintf (buf, size, format, args);
+
+      va_end(args);
+      return ret;
+    }
+
+  // --------------------------------------------------------------------------
+  } /* namespace diag */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
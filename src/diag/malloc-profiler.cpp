@@ -0,0 +1,345 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/os-app-config.h>
+
+#if defined(OS_INCLUDE_LIBC_MALLOC_PROFILER)
+
+#include <cmsis-plus/diag/malloc-profiler.h>
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::diag::malloc_profiler;
+
+namespace
+{
+  static_assert((OS_INTEGER_LIBC_MALLOC_PROFILER_SITES
+      & (OS_INTEGER_LIBC_MALLOC_PROFILER_SITES - 1)) == 0,
+      "OS_INTEGER_LIBC_MALLOC_PROFILER_SITES must be a power of 2");
+
+  constexpr std::size_t sites_count = OS_INTEGER_LIBC_MALLOC_PROFILER_SITES;
+
+  // The index of the entry used when the table is full.
+  constexpr uint16_t overflow_index = sites_count;
+
+  constexpr uint16_t header_magic = 0xA110;
+
+  // The last entry accounts allocations without a site slot.
+  site_statistics_t sites_[sites_count + 1];
+
+  site_statistics_t totals_;
+
+  uint32_t dropped_;
+
+  uint32_t invalid_frees_;
+
+  /**
+   * @brief Find or create the slot for the site.
+   * @details
+   * Open addressing with linear probing; the table is never
+   * shrunk, so the search stops at the first empty slot.
+   */
+  uint16_t
+  find_index (const void* site)
+  {
+    // Fibonacci hashing; ignore the lowest bit (Thumb).
+    uint32_t h = static_cast<uint32_t> (reinterpret_cast<uintptr_t> (site)
+        >> 1) * 2654435761u;
+    std::size_t i = (h >> 16) & (sites_count - 1);
+
+    for (std::size_t n = 0; n < sites_count; ++n)
+      {
+        if (sites_[i].site == site)
+          {
+            return static_cast<uint16_t> (i);
+          }
+        if (sites_[i].site == nullptr)
+          {
+            sites_[i].site = site;
+            return static_cast<uint16_t> (i);
+          }
+        i = (i + 1) & (sites_count - 1);
+      }
+
+    ++dropped_;
+    return overflow_index;
+  }
+
+  inline void
+  account_alloc (site_statistics_t& st, std::size_t size)
+  {
+    ++st.allocs;
+    st.live_bytes += size;
+    if (st.live_bytes > st.peak_bytes)
+      {
+        st.peak_bytes = st.live_bytes;
+      }
+  }
+
+  inline void
+  account_free (site_statistics_t& st, std::size_t size)
+  {
+    ++st.frees;
+    st.live_bytes -= size;
+  }
+}
+
+namespace os
+{
+  namespace diag
+  {
+    namespace malloc_profiler
+    {
+      /**
+       * @details
+       * Copy the used entries, including the overflow entry if used.
+       */
+      std::size_t
+      sites (site_statistics_t* buf, std::size_t count)
+      {
+        std::size_t n = 0;
+
+        // ----- Begin of critical section ------------------------------------
+        rtos::scheduler::critical_section cs;
+
+        for (std::size_t i = 0; i <= sites_count && n < count; ++i)
+          {
+            if (sites_[i].site != nullptr || sites_[i].allocs != 0)
+              {
+                buf[n++] = sites_[i];
+              }
+          }
+
+        return n;
+        // ----- End of critical section --------------------------------------
+      }
+
+      site_statistics_t
+      totals (void)
+      {
+        // ----- Begin of critical section ------------------------------------
+        rtos::scheduler::critical_section cs;
+
+        return totals_;
+        // ----- End of critical section --------------------------------------
+      }
+
+      uint32_t
+      dropped (void)
+      {
+        return dropped_;
+      }
+
+      uint32_t
+      invalid_frees (void)
+      {
+        return invalid_frees_;
+      }
+
+      void
+      reset (void)
+      {
+        // ----- Begin of critical section ------------------------------------
+        rtos::scheduler::critical_section cs;
+
+        for (std::size_t i = 0; i <= sites_count; ++i)
+          {
+            sites_[i].allocs = 0;
+            sites_[i].frees = 0;
+            sites_[i].peak_bytes = sites_[i].live_bytes;
+          }
+        totals_.allocs = 0;
+        totals_.frees = 0;
+        totals_.peak_bytes = totals_.live_bytes;
+        dropped_ = 0;
+        invalid_frees_ = 0;
+
+        // ----- End of critical section --------------------------------------
+      }
+
+      /**
+       * @details
+       * The lines have the format:
+       *
+       * @code{.unparsed}
+       * malloc-profiler begin
+       * site 0x08001234 allocs 12 frees 10 live 64 peak 256
+       * ...
+       * total allocs 120 frees 100 live 1024 peak 4096 dropped 0 invalid 0
+       * malloc-profiler end
+       * @endcode
+       *
+       * The overflow entry is displayed with site 0x00000000.
+       *
+       * A snapshot is taken before printing, so the trace
+       * device is not called with the scheduler locked.
+       */
+      void
+      dump (void)
+      {
+        site_statistics_t st;
+        site_statistics_t tot = totals ();
+
+        trace::printf ("malloc-profiler begin\n");
+
+        for (std::size_t i = 0; i <= sites_count; ++i)
+          {
+              {
+                // ----- Begin of critical section ----------------------------
+                rtos::scheduler::critical_section cs;
+
+                st = sites_[i];
+                // ----- End of critical section ------------------------------
+              }
+
+            if (st.site == nullptr && st.allocs == 0)
+              {
+                continue;
+              }
+            trace::printf ("site %p allocs %u frees %u live %u peak %u\n",
+                           st.site, static_cast<unsigned int> (st.allocs),
+                           static_cast<unsigned int> (st.frees),
+                           static_cast<unsigned int> (st.live_bytes),
+                           static_cast<unsigned int> (st.peak_bytes));
+          }
+
+        trace::printf (
+            "total allocs %u frees %u live %u peak %u dropped %u invalid %u\n",
+            static_cast<unsigned int> (tot.allocs),
+            static_cast<unsigned int> (tot.frees),
+            static_cast<unsigned int> (tot.live_bytes),
+            static_cast<unsigned int> (tot.peak_bytes),
+            static_cast<unsigned int> (dropped_),
+            static_cast<unsigned int> (invalid_frees_));
+        trace::printf ("malloc-profiler end\n");
+      }
+
+      /**
+       * @cond ignore
+       */
+
+      namespace internal
+      {
+        /**
+         * @details
+         * The C allocator is asked for a larger block; the user block
+         * follows a header, padded to keep the requested alignment.
+         */
+        void*
+        allocate (std::size_t size, std::size_t alignment, const void* site)
+        {
+          if (alignment < alignof(std::max_align_t))
+            {
+              alignment = alignof(std::max_align_t);
+            }
+          std::size_t offset = (sizeof(header_t) + alignment - 1)
+              & ~(alignment - 1);
+
+          void* block;
+          if (alignment == alignof(std::max_align_t))
+            {
+              block = ::malloc (offset + size);
+            }
+          else
+            {
+              block = ::memalign (alignment, offset + size);
+            }
+
+          if (block == nullptr)
+            {
+              return nullptr;
+            }
+
+          void* p = static_cast<char*> (block) + offset;
+          header_t* h = static_cast<header_t*> (p) - 1;
+
+          h->block = block;
+          h->size = static_cast<uint32_t> (size);
+          h->index = find_index (site);
+          h->magic = header_magic;
+
+          account_alloc (sites_[h->index], size);
+          account_alloc (totals_, size);
+
+          return p;
+        }
+
+        void
+        deallocate (void* ptr)
+        {
+          if (ptr == nullptr)
+            {
+              return;
+            }
+
+          header_t* h = static_cast<header_t*> (ptr) - 1;
+          if (h->magic != header_magic)
+            {
+              // Not allocated by the profiler; possibly allocated
+              // before the profiler was enabled, or a double free.
+              // The block is not released, since its start is unknown.
+              ++invalid_frees_;
+              return;
+            }
+          h->magic = 0;
+
+          account_free (sites_[h->index], h->size);
+          account_free (totals_, h->size);
+
+          ::free (h->block);
+        }
+
+        void
+        mark_freed (void* ptr, std::size_t size)
+        {
+          header_t* h = static_cast<header_t*> (ptr) - 1;
+
+          h->block = static_cast<char*> (ptr) - header_size;
+          h->size = static_cast<uint32_t> (size);
+          h->index = overflow_index;
+          h->magic = 0;
+        }
+      } /* namespace internal */
+
+    /**
+     * @endcond
+     */
+
+    } /* namespace malloc_profiler */
+  } /* namespace diag */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* defined(OS_INCLUDE_LIBC_MALLOC_PROFILER) */
@@ -0,0 +1,380 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if defined(TRACE)
+
+#include <cmsis-plus/os-app-config.h>
+
+#if defined(OS_USE_TRACE_ASYNC)
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <atomic>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+#ifndef OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES
+#define OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES (1024)
+#endif
+
+#ifndef OS_INTEGER_TRACE_ASYNC_STACK_SIZE_BYTES
+#define OS_INTEGER_TRACE_ASYNC_STACK_SIZE_BYTES (os::rtos::port::stack::default_size_bytes)
+#endif
+
+#ifndef OS_BOOL_TRACE_ASYNC_OVERWRITE
+#define OS_BOOL_TRACE_ASYNC_OVERWRITE (false)
+#endif
+
+static_assert((OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES
+    & (OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES - 1)) == 0
+    && OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES >= 16,
+    "OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES must be a power of 2.");
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::rtos;
+
+/**
+ * @cond ignore
+ */
+
+namespace
+{
+  // Each record starts with a 32-bit header, aligned to a word, with
+  // the payload length in the lower half and the state in the upper
+  // half; the payload follows, padded to a word, and may wrap
+  // around the end of the buffer. Since the buffer size is a
+  // power of 2, headers never wrap.
+  //
+  // Producers reserve space and the consumer claims records in very
+  // short critical sections (a few instructions, no loops over the
+  // payload); the payload is copied with interrupts enabled, and
+  // the record is published by a single store of the header.
+
+  constexpr uint32_t state_reserved = 0x00000000;
+  constexpr uint32_t state_committed = 0x00010000;
+  constexpr uint32_t state_flushing = 0x00020000;
+  constexpr uint32_t state_mask = 0xFFFF0000;
+  constexpr uint32_t length_mask = 0x0000FFFF;
+
+  constexpr uint32_t size = OS_INTEGER_TRACE_ASYNC_BUFFER_SIZE_BYTES;
+  constexpr uint32_t mask = size - 1;
+  constexpr uint32_t max_length =
+      (size - sizeof(uint32_t)) < length_mask ?
+          (size - sizeof(uint32_t)) : length_mask;
+
+  uint32_t buffer_[size / sizeof(uint32_t)];
+
+  // Free running byte counters; the records are between
+  // `tail_` and `head_`, modulo the buffer size.
+  uint32_t volatile head_;
+  uint32_t volatile tail_;
+
+  uint32_t volatile dropped_;
+
+  trace::async::overflow volatile policy_ =
+#if OS_BOOL_TRACE_ASYNC_OVERWRITE
+      trace::async::overflow::overwrite;
+#else
+      trace::async::overflow::drop;
+#endif
+
+  bool volatile flusher_ready_;
+
+  inline uint32_t volatile&
+  header (uint32_t pos)
+  {
+    return reinterpret_cast<uint32_t volatile&> (buffer_[(pos & mask)
+        / sizeof(uint32_t)]);
+  }
+
+  inline uint32_t
+  record_size (uint32_t length)
+  {
+    constexpr uint32_t word = static_cast<uint32_t> (sizeof(uint32_t));
+
+    return word + ((length + word - 1) & ~(word - 1));
+  }
+
+  // Copy into the ring, wrapping around the end of the buffer.
+  void
+  copy_in (uint32_t pos, const void* buf, std::size_t nbyte)
+  {
+    uint8_t* base = reinterpret_cast<uint8_t*> (buffer_);
+    std::size_t index = pos & mask;
+    std::size_t first = size - index;
+    if (first >= nbyte)
+      {
+        std::memcpy (base + index, buf, nbyte);
+      }
+    else
+      {
+        std::memcpy (base + index, buf, first);
+        std::memcpy (base, static_cast<const uint8_t*> (buf) + first,
+                     nbyte - first);
+      }
+  }
+
+  void*
+  flusher (void* args);
+
+#pragma GCC diagnostic push
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#endif
+  thread_static<OS_INTEGER_TRACE_ASYNC_STACK_SIZE_BYTES> flusher_thread
+    { "trace-flush", flusher, nullptr };
+#pragma GCC diagnostic pop
+
+  void*
+  flusher (void* args __attribute__((unused)))
+  {
+    // Run just above the idle thread, so the trace output
+    // does not disturb the application.
+    this_thread::thread ().priority (thread::priority::low);
+    flusher_ready_ = true;
+
+    while (true)
+      {
+        trace::async::flush ();
+#if defined(OS_USE_TRACE_BINARY)
+        trace::binary::drain ();
+#endif
+        // Woken up by the producers; the timeout also covers
+        // the records written before this thread was ready.
+        this_thread::flags_timed_wait (
+            1, clock_systick::frequency_hz / 10 + 1, nullptr,
+            flags::mode::any | flags::mode::clear);
+      }
+
+    return nullptr;
+  }
+}
+
+/**
+ * @endcond
+ */
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace trace
+  {
+    namespace async
+    {
+      // ======================================================================
+
+      /**
+       * @details
+       * The record is reserved in a short critical section,
+       * the bytes are copied with interrupts enabled, and the
+       * record is published by a single store of its header,
+       * so records written concurrently from different threads
+       * and interrupts never mix.
+       *
+       * When there is no room, depending on the overflow policy,
+       * either the new record or the oldest records not yet
+       * flushed are discarded, and the drop counter is incremented.
+       * A record is never discarded while it is written or flushed.
+       *
+       * @note Can be invoked from Interrupt Service Routines.
+       */
+      ssize_t
+      write (const void* buf, std::size_t nbyte, const void* suffix,
+             std::size_t suffix_nbyte)
+      {
+        if (nbyte > max_length)
+          {
+            nbyte = max_length;
+          }
+        if (suffix_nbyte > max_length - nbyte)
+          {
+            suffix_nbyte = max_length - nbyte;
+          }
+        uint32_t length = static_cast<uint32_t> (nbyte + suffix_nbyte);
+        if (length == 0)
+          {
+            return 0;
+          }
+        uint32_t need = record_size (length);
+
+        uint32_t pos;
+        bool was_empty;
+          {
+            // ----- Enter critical section -----------------------------------
+            interrupts::critical_section ics;
+
+            while (size - (head_ - tail_) < need)
+              {
+                uint32_t h = header (tail_);
+                if (policy_ == overflow::drop
+                    || (h & state_mask) != state_committed)
+                  {
+                    // Dropping the new record, or the oldest one is
+                    // still being written or flushed.
+                    ++dropped_;
+                    return -1;
+                  }
+                // Overwrite: discard the oldest record.
+                tail_ = tail_ + record_size (h & length_mask);
+                ++dropped_;
+              }
+            pos = head_;
+            was_empty = (pos == tail_);
+            header (pos) = state_reserved | length;
+            head_ = pos + need;
+            // ----- Exit critical section ------------------------------------
+          }
+
+        copy_in (pos + sizeof(uint32_t), buf, nbyte);
+        if (suffix_nbyte > 0)
+          {
+            copy_in (static_cast<uint32_t> (pos + sizeof(uint32_t) + nbyte),
+                     suffix, suffix_nbyte);
+          }
+
+        // Publish the record; the payload stores must not be moved
+        // after the header store.
+        std::atomic_signal_fence (std::memory_order_release);
+        header (pos) = state_committed | length;
+
+        if (was_empty && flusher_ready_)
+          {
+            flusher_thread.flags_raise (1);
+          }
+
+        return static_cast<ssize_t> (length);
+      }
+
+      /**
+       * @details
+       * Pass the committed records, in order, to the trace channel
+       * (`trace::write()`), stopping at the first record still
+       * being written.
+       *
+       * Normally called only by the flusher thread, but it is
+       * safe to call it from other threads too, for example before
+       * a reset; records are claimed one at a time, so each one is
+       * written only once.
+       *
+       * @warning Cannot be invoked from Interrupt Service Routines,
+       * the trace channel may block.
+       */
+      std::size_t
+      flush (void)
+      {
+        std::size_t total = 0;
+        while (true)
+          {
+            uint32_t pos;
+            uint32_t length;
+              {
+                // ----- Enter critical section -------------------------------
+                interrupts::critical_section ics;
+
+                pos = tail_;
+                if (pos == head_)
+                  {
+                    break;
+                  }
+                uint32_t h = header (pos);
+                if ((h & state_mask) != state_committed)
+                  {
+                    break;
+                  }
+                length = h & length_mask;
+                // Claim the record, so it is not overwritten.
+                header (pos) = state_flushing | length;
+                // ----- Exit critical section --------------------------------
+              }
+            // Pairs with the release fence in write(); the payload
+            // is read only after the committed header was seen.
+            std::atomic_signal_fence (std::memory_order_acquire);
+
+            const uint8_t* base = reinterpret_cast<const uint8_t*> (buffer_);
+            uint32_t index = (pos + sizeof(uint32_t)) & mask;
+            uint32_t first = size - index;
+            if (first >= length)
+              {
+                trace::write (base + index, length);
+              }
+            else
+              {
+                trace::write (base + index, first);
+                trace::write (base, length - first);
+              }
+            total += length;
+
+              {
+                // ----- Enter critical section -------------------------------
+                interrupts::critical_section ics;
+
+                tail_ = pos + record_size (length);
+                // ----- Exit critical section --------------------------------
+              }
+          }
+        return total;
+      }
+
+      uint32_t
+      dropped (void)
+      {
+        return dropped_;
+      }
+
+      overflow
+      policy (void)
+      {
+        return policy_;
+      }
+
+      /**
+       * @note Can be invoked from Interrupt Service Routines.
+       */
+      overflow
+      policy (overflow p)
+      {
+        overflow tmp = policy_;
+        policy_ = p;
+        return tmp;
+      }
+
+    } /* namespace async */
+  } /* namespace trace */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
+
+#endif /* defined(OS_USE_TRACE_ASYNC) */
+#endif /* defined(TRACE) */
+
+// ----------------------------------------------------------------------------
@@ -29,15 +29,76 @@
 
 #include <cmsis-plus/os-app-config.h>
 #include <cmsis-plus/diag/trace.h>
+#include <cmsis-plus/diag/trace-log.h>
+#if defined(OS_USE_TRACE_LIGHT_FORMAT)
+#include <cmsis-plus/diag/format.h>
+#endif
 
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 
+#if defined(OS_USE_TRACE_BINARY)
+#include <cmsis-plus/rtos/os.h>
+#endif
+
 #ifndef OS_INTEGER_TRACE_PRINTF_TMP_ARRAY_SIZE
 #define OS_INTEGER_TRACE_PRINTF_TMP_ARRAY_SIZE (200)
 #endif
 
+#ifndef OS_INTEGER_TRACE_LOG_MASK
+#define OS_INTEGER_TRACE_LOG_MASK \
+  (OS_LOG_LEVELS_UPTO(OS_INTEGER_TRACE_LOG_LEVEL) | OS_LOG_CATEGORY_ALL)
+#endif
+
+// ----------------------------------------------------------------------------
+
+uint32_t os_trace_log_mask = OS_INTEGER_TRACE_LOG_MASK;
+
+#if defined(OS_USE_TRACE_BINARY)
+
+#ifndef OS_INTEGER_TRACE_BINARY_RING_WORDS
+#define OS_INTEGER_TRACE_BINARY_RING_WORDS (256)
+#endif
+
+static_assert((OS_INTEGER_TRACE_BINARY_RING_WORDS
+    & (OS_INTEGER_TRACE_BINARY_RING_WORDS - 1)) == 0,
+    "OS_INTEGER_TRACE_BINARY_RING_WORDS must be a power of 2.");
+
+static_assert(OS_INTEGER_TRACE_BINARY_RECORD_WORDS >= 2
+    && OS_INTEGER_TRACE_BINARY_RECORD_WORDS <= OS_INTEGER_TRACE_BINARY_RING_WORDS,
+    "OS_INTEGER_TRACE_BINARY_RECORD_WORDS out of range.");
+
+// ----------------------------------------------------------------------------
+
+extern "C"
+{
+  /**
+   * @brief The binary trace ring buffer.
+   * @details
+   * A C structure with a fixed name and layout, so that the debugger
+   * (or a memory dump) can find the records without any help from the
+   * application. `head` and `tail` are free running word counters;
+   * the records are between `tail` and `head`, modulo `size`.
+   */
+  typedef struct os_trace_binary_ring_s
+  {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t volatile head;
+    uint32_t volatile tail;
+    uint32_t volatile dropped;
+    uint32_t buffer[OS_INTEGER_TRACE_BINARY_RING_WORDS];
+  } os_trace_binary_ring_t;
+
+  os_trace_binary_ring_t os_trace_binary_ring __attribute__((used)) =
+    { os::trace::binary::marker | 0x5247, // "RG"
+        OS_INTEGER_TRACE_BINARY_RING_WORDS, 0, 0, 0,
+          { 0 } };
+}
+
+#endif /* defined(OS_USE_TRACE_BINARY) */
+
 // ----------------------------------------------------------------------------
 
 namespace os
@@ -85,33 +146,60 @@ namespace os
     int __attribute__((weak))
     vprintf (const char* format, std::va_list args)
     {
+#if defined(OS_USE_TRACE_BINARY)
+
+      // No formatting on the target, only store the arguments.
+      return binary::vlog (format, args);
+
+#else
+
       // Caution: allocated on the stack!
       char buf[OS_INTEGER_TRACE_PRINTF_TMP_ARRAY_SIZE];
 
-      // TODO: possibly rewrite it to no longer use newlib,
-      // (although the nano version is no longer very heavy).
-
       // Print to the local buffer
+#if defined(OS_USE_TRACE_LIGHT_FORMAT)
+      // The in-tree formatter, without newlib.
+      int ret = diag::vsnprintf (buf, sizeof(buf), format, args);
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-nonliteral"
       int ret = ::vsnprintf (buf, sizeof(buf), format, args);
 #pragma GCC diagnostic pop
+#endif
       if (ret > 0)
         {
+          if (static_cast<size_t> (ret) >= sizeof(buf))
+            {
+              ret = static_cast<int> (sizeof(buf) - 1); // Truncated.
+            }
+#if defined(OS_USE_TRACE_ASYNC)
+          // Queue the whole line as a single record.
+          ret = static_cast<int> (async::write (buf, static_cast<size_t> (ret)));
+#else
           // Transfer the buffer to the device.
           ret = static_cast<int> (write (buf, static_cast<size_t> (ret)));
+#endif
         }
       return ret;
+
+#endif /* defined(OS_USE_TRACE_BINARY) */
     }
 
     int __attribute__((weak))
     puts (const char* s)
     {
+#if defined(OS_USE_TRACE_BINARY)
+      int ret = binary::log ("%s\n", s);
+#elif defined(OS_USE_TRACE_ASYNC)
+      // The line terminator goes in the same record.
+      int ret = static_cast<int> (async::write (s, strlen (s), "\n", 1));
+#else
       int ret = static_cast<int> (write (s, strlen (s)));
       if (ret > 0)
         {
           ret = static_cast<int> (write ("\n", 1)); // Add a line terminator
         }
+#endif /* defined(OS_USE_TRACE_BINARY) */
       if (ret > 0)
         {
           return ret;
@@ -125,7 +213,14 @@ namespace os
     int __attribute__((weak))
     putchar (int c)
     {
+#if defined(OS_USE_TRACE_BINARY)
+      int ret = binary::log ("%c", c);
+#elif defined(OS_USE_TRACE_ASYNC)
+      int ret = static_cast<int> (async::write (
+          reinterpret_cast<const char*> (&c), 1));
+#else
       int ret = static_cast<int> (write (reinterpret_cast<const char*> (&c), 1));
+#endif
       if (ret > 0)
         {
           return c;
@@ -151,6 +246,295 @@ namespace os
       printf ("]);\n");
     }
 
+#if defined(OS_USE_TRACE_BINARY)
+
+    namespace binary
+    {
+      // ======================================================================
+
+      void
+      packer::put (const char* str)
+      {
+        if (str == nullptr)
+          {
+            str = "(null)";
+          }
+        if (count_ >= OS_INTEGER_TRACE_BINARY_RECORD_WORDS)
+          {
+            return;
+          }
+
+        // The length word, then the characters, truncated
+        // to the space left in the record.
+        std::size_t len = std::strlen (str);
+        std::size_t room = (OS_INTEGER_TRACE_BINARY_RECORD_WORDS - count_ - 1)
+            * sizeof(uint32_t);
+        if (len > room)
+          {
+            len = room;
+          }
+        words_[count_++] = static_cast<uint32_t> (len);
+        if (len > 0)
+          {
+            // Clear the padding of the last word, to not leak
+            // stack content in the trace.
+            words_[count_ + (len - 1) / sizeof(uint32_t)] = 0;
+          }
+        std::memcpy (&words_[count_], str, len);
+        count_ += (len + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+      }
+
+      int
+      packer::commit (void)
+      {
+        std::size_t n = count_;
+        words_[0] = marker | static_cast<uint32_t> (n);
+
+        os_trace_binary_ring_t& ring = os_trace_binary_ring;
+        constexpr uint32_t mask = OS_INTEGER_TRACE_BINARY_RING_WORDS - 1;
+        {
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          uint32_t head = ring.head;
+          if (OS_INTEGER_TRACE_BINARY_RING_WORDS - (head - ring.tail) < n)
+            {
+              ++ring.dropped;
+              return -1;
+            }
+          for (std::size_t i = 0; i < n; ++i)
+            {
+              ring.buffer[(head + i) & mask] = words_[i];
+            }
+          ring.head = head + static_cast<uint32_t> (n);
+          // ----- Exit critical section --------------------------------------
+        }
+        return static_cast<int> (n * sizeof(uint32_t));
+      }
+
+      int
+      vlog (const char* format, std::va_list args)
+      {
+        packer p
+          { format };
+
+        for (const char* f = format; *f != '\0'; ++f)
+          {
+            if (*f != '%')
+              {
+                continue;
+              }
+            ++f;
+            if (*f == '%')
+              {
+                continue;
+              }
+
+            // Flags.
+            while (*f != '\0' && std::strchr ("-+ #0'", *f) != nullptr)
+              {
+                ++f;
+              }
+
+            // Field width and precision; `*` consumes an int.
+            for (int i = 0; i < 2; ++i)
+              {
+                if (i == 1)
+                  {
+                    if (*f != '.')
+                      {
+                        break;
+                      }
+                    ++f;
+                  }
+                if (*f == '*')
+                  {
+                    p.put (static_cast<uint32_t> (va_arg(args, int)));
+                    ++f;
+                  }
+                else
+                  {
+                    while (*f >= '0' && *f <= '9')
+                      {
+                        ++f;
+                      }
+                  }
+              }
+
+            // Length modifiers, reduced to the size of the argument.
+            std::size_t size = sizeof(int);
+            bool is_long_double = false;
+            switch (*f)
+              {
+              case 'h':
+                ++f;
+                if (*f == 'h')
+                  {
+                    ++f;
+                  }
+                break;
+              case 'l':
+                ++f;
+                size = sizeof(long);
+                if (*f == 'l')
+                  {
+                    ++f;
+                    size = sizeof(long long);
+                  }
+                break;
+              case 'j':
+                ++f;
+                size = sizeof(intmax_t);
+                break;
+              case 'z':
+                ++f;
+                size = sizeof(std::size_t);
+                break;
+              case 't':
+                ++f;
+                size = sizeof(std::ptrdiff_t);
+                break;
+              case 'L':
+                ++f;
+                is_long_double = true;
+                break;
+              default:
+                break;
+              }
+
+            switch (*f)
+              {
+              case 'd':
+              case 'i':
+              case 'u':
+              case 'o':
+              case 'x':
+              case 'X':
+                if (size > sizeof(uint32_t))
+                  {
+                    p.put (static_cast<uint64_t> (va_arg(args, long long)));
+                  }
+                else
+                  {
+                    p.put (static_cast<uint32_t> (va_arg(args, int)));
+                  }
+                break;
+
+              case 'c':
+                p.put (static_cast<uint32_t> (va_arg(args, int)));
+                break;
+
+              case 's':
+                p.put (va_arg(args, const char*));
+                break;
+
+              case 'p':
+              case 'n':
+                p.put (va_arg(args, const void*));
+                break;
+
+              case 'f':
+              case 'F':
+              case 'e':
+              case 'E':
+              case 'g':
+              case 'G':
+              case 'a':
+              case 'A':
+                if (is_long_double)
+                  {
+                    p.put (static_cast<double> (va_arg(args, long double)));
+                  }
+                else
+                  {
+                    p.put (va_arg(args, double));
+                  }
+                break;
+
+              case '\0':
+                // Incomplete conversion at the end of the format.
+                return p.commit ();
+
+              default:
+                break;
+              }
+          }
+
+        return p.commit ();
+      }
+
+      std::size_t
+      drain (void)
+      {
+        return drain (write);
+      }
+
+      namespace
+      {
+        // The bytes of the word at the tail already written, when
+        // the channel accepted only a part of it.
+        std::size_t drain_offset;
+      }
+
+      /**
+       * @details
+       * The tail is advanced only over the words written completely;
+       * if the writer accepts only a part of a word, the rest of it
+       * is written by the next call, so nothing is sent twice.
+       */
+      std::size_t
+      drain (writer_t writer)
+      {
+        os_trace_binary_ring_t& ring = os_trace_binary_ring;
+        constexpr uint32_t mask = OS_INTEGER_TRACE_BINARY_RING_WORDS - 1;
+
+        // There is a single consumer, so the tail can be updated
+        // without a critical section; the producers only read it.
+        std::size_t total = 0;
+        for (;;)
+          {
+            uint32_t tail = ring.tail;
+            uint32_t head = ring.head;
+            if (tail == head)
+              {
+                break;
+              }
+
+            // Write the contiguous part; a wrapped ring takes two turns.
+            uint32_t index = tail & mask;
+            uint32_t n = head - tail;
+            if (n > OS_INTEGER_TRACE_BINARY_RING_WORDS - index)
+              {
+                n = OS_INTEGER_TRACE_BINARY_RING_WORDS - index;
+              }
+            ssize_t const written = writer (
+                reinterpret_cast<const uint8_t*> (&ring.buffer[index])
+                    + drain_offset,
+                n * sizeof(uint32_t) - drain_offset);
+            if (written <= 0)
+              {
+                break;
+              }
+
+            std::size_t const done = drain_offset
+                + static_cast<std::size_t> (written);
+            ring.tail = tail + static_cast<uint32_t> (done / sizeof(uint32_t));
+            drain_offset = done % sizeof(uint32_t);
+            total += static_cast<std::size_t> (written);
+          }
+        return total;
+      }
+
+      uint32_t
+      dropped (void)
+      {
+        return os_trace_binary_ring.dropped;
+      }
+
+    } /* namespace binary */
+
+#endif /* defined(OS_USE_TRACE_BINARY) */
+
   } /* namespace trace */
 } /* namespace os */
 
@@ -0,0 +1,811 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/drivers/usb-cdc-acm.h>
+
+#include <cassert>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace device
+      {
+        // ------------------------------------------------------------------
+
+        Cdc_acm::Cdc_acm (Transfer_queues& queues, endpoint_t ep_in,
+                          endpoint_t ep_out, packet_size_t packet_size,
+                          rtos::memory_pool& pool, uint8_t* rx_buffer,
+                          std::size_t rx_size, uint8_t* tx_buffer,
+                          std::size_t tx_size) noexcept :
+            device_ (queues.get_device ()), //
+            in_queue_ (queues, ep_in, pool, packet_size), //
+            out_queue_ (queues, ep_out, pool, packet_size), //
+            capa_ (), //
+            packet_size_ (packet_size), //
+            rx_buffer_ (rx_buffer), //
+            rx_ring_ (rx_buffer + 2 * packet_size), //
+            rx_size_ (rx_size - 2 * packet_size), //
+            tx_ring_ (tx_buffer), //
+            tx_size_ (tx_size)
+        {
+          assert((ep_in & ENDPOINT_DIRECTION_MASK) != 0);
+          assert((ep_out & ENDPOINT_DIRECTION_MASK) == 0);
+          assert(packet_size > 0);
+          assert(rx_buffer != nullptr && rx_size > 2 * packet_size);
+          assert(tx_buffer != nullptr && tx_size > 0);
+
+          capa_.asynchronous = true;
+          capa_.event_tx_complete = true;
+          capa_.event_rx_timeout = true;
+          // The host DTR and RTS, as seen from the device side
+          // of a null modem.
+          capa_.dsr = true;
+          capa_.cts = true;
+          capa_.event_dsr = true;
+          capa_.event_cts = true;
+
+          line_coding_.dte_rate = 115200;
+          line_coding_.char_format = 0;
+          line_coding_.parity_type = 0;
+          line_coding_.data_bits = 8;
+        }
+
+        Cdc_acm::~Cdc_acm () noexcept
+        {
+          set_configured (false);
+        }
+
+        // ------------------------------------------------------------------
+
+        return_t
+        Cdc_acm::set_configured (bool configured) noexcept
+        {
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            // From now on the callbacks of the aborted
+            // transfers are ignored.
+            configured_ = false;
+            reset_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          in_queue_.abort ();
+          out_queue_.abort ();
+
+          if (!configured)
+            {
+              device_.unconfigure_endpoint (in_queue_.get_address ());
+              device_.unconfigure_endpoint (out_queue_.get_address ());
+
+              return RETURN_OK;
+            }
+
+          return_t result;
+          result = device_.configure_endpoint (in_queue_.get_address (),
+                                               Endpoint_type::bulk,
+                                               packet_size_);
+          if (result != RETURN_OK)
+            {
+              return result;
+            }
+          result = device_.configure_endpoint (out_queue_.get_address (),
+                                               Endpoint_type::bulk,
+                                               packet_size_);
+          if (result != RETURN_OK)
+            {
+              return result;
+            }
+
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            configured_ = true;
+
+            for (std::size_t i = 0; i < 2; ++i)
+              {
+                result = out_queue_.submit (out_packet_ (i), packet_size_,
+                                            signal_out, this);
+                if (result != RETURN_OK)
+                  {
+                    break;
+                  }
+              }
+
+            tx_fill_ ();
+            tx_start_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          flush_events_ ();
+          return result;
+        }
+
+        bool
+        Cdc_acm::control_request (const uint8_t* setup, uint8_t*& data,
+                                  std::size_t& length) noexcept
+        {
+          if ((setup[0] & 0x7F) != cdc::REQUEST_TYPE_CLASS_INTERFACE)
+            {
+              return false;
+            }
+
+          uint16_t const value = static_cast<uint16_t> (setup[2]
+              | (setup[3] << 8));
+          std::size_t const max_length = static_cast<std::size_t> (setup[6]
+              | (setup[7] << 8));
+
+          data = nullptr;
+          length = 0;
+
+          switch (setup[1])
+            {
+            case cdc::SET_LINE_CODING:
+              data = line_coding_buffer_;
+              length =
+                  (max_length < cdc::LINE_CODING_SIZE) ?
+                      max_length : cdc::LINE_CODING_SIZE;
+              return true;
+
+            case cdc::GET_LINE_CODING:
+              {
+                uint32_t const rate = line_coding_.dte_rate;
+                line_coding_buffer_[0] = static_cast<uint8_t> (rate);
+                line_coding_buffer_[1] = static_cast<uint8_t> (rate >> 8);
+                line_coding_buffer_[2] = static_cast<uint8_t> (rate >> 16);
+                line_coding_buffer_[3] = static_cast<uint8_t> (rate >> 24);
+                line_coding_buffer_[4] = line_coding_.char_format;
+                line_coding_buffer_[5] = line_coding_.parity_type;
+                line_coding_buffer_[6] = line_coding_.data_bits;
+              }
+              data = line_coding_buffer_;
+              length =
+                  (max_length < cdc::LINE_CODING_SIZE) ?
+                      max_length : cdc::LINE_CODING_SIZE;
+              return true;
+
+            case cdc::SET_CONTROL_LINE_STATE:
+              {
+                bool const dtr = (value & cdc::CONTROL_LINE_DTR) != 0;
+                bool const rts = (value & cdc::CONTROL_LINE_RTS) != 0;
+
+                {
+                  // ----- Enter critical section -----------------------------
+                  rtos::interrupts::critical_section ics;
+
+                  if (modem_status_.dsr != dtr)
+                    {
+                      modem_status_.dsr = dtr;
+                      events_ |= serial::Event::dsr;
+                    }
+                  if (modem_status_.cts != rts)
+                    {
+                      modem_status_.cts = rts;
+                      events_ |= serial::Event::cts;
+                    }
+                  // ----- Exit critical section ------------------------------
+                }
+              }
+              flush_events_ ();
+              return true;
+
+            case cdc::SEND_BREAK:
+              if (value != 0)
+                {
+                  {
+                    // ----- Enter critical section ---------------------------
+                    rtos::interrupts::critical_section ics;
+
+                    status_.rx_break = true;
+                    events_ |= serial::Event::rx_break;
+                    // ----- Exit critical section ----------------------------
+                  }
+                  flush_events_ ();
+                }
+              return true;
+
+            default:
+              return false;
+            }
+        }
+
+        void
+        Cdc_acm::control_data (const uint8_t* setup) noexcept
+        {
+          if ((setup[0] & 0x7F) != cdc::REQUEST_TYPE_CLASS_INTERFACE
+              || setup[1] != cdc::SET_LINE_CODING)
+            {
+              return;
+            }
+
+          line_coding_.dte_rate = static_cast<uint32_t> (line_coding_buffer_[0])
+              | (static_cast<uint32_t> (line_coding_buffer_[1]) << 8)
+              | (static_cast<uint32_t> (line_coding_buffer_[2]) << 16)
+              | (static_cast<uint32_t> (line_coding_buffer_[3]) << 24);
+          line_coding_.char_format = line_coding_buffer_[4];
+          line_coding_.parity_type = line_coding_buffer_[5];
+          line_coding_.data_bits = line_coding_buffer_[6];
+        }
+
+        // ------------------------------------------------------------------
+
+        const Version&
+        Cdc_acm::do_get_version (void) noexcept
+        {
+          // The CMSIS USART API version.
+          static const Version version
+            { 0x0202, 0x0100 };
+          return version;
+        }
+
+        const serial::Capabilities&
+        Cdc_acm::do_get_capabilities (void) noexcept
+        {
+          return capa_;
+        }
+
+        return_t
+        Cdc_acm::do_power (Power state) noexcept
+        {
+          switch (state)
+            {
+            case Power::full:
+              return RETURN_OK;
+
+            case Power::off:
+              {
+                // ----- Enter critical section -------------------------------
+                rtos::interrupts::critical_section ics;
+
+                tx_data_ = nullptr;
+                rx_data_ = nullptr;
+                tx_enabled_ = false;
+                rx_enabled_ = false;
+                // ----- Exit critical section --------------------------------
+              }
+              return RETURN_OK;
+
+            default:
+              return ERROR_UNSUPPORTED;
+            }
+        }
+
+        return_t
+        Cdc_acm::do_send (const void* data, std::size_t num) noexcept
+        {
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            if (!tx_enabled_)
+              {
+                return ERROR;
+              }
+            if (tx_data_ != nullptr)
+              {
+                return ERROR_BUSY;
+              }
+
+            tx_data_ = static_cast<const uint8_t*> (data);
+            tx_num_ = num;
+            tx_count_ = 0;
+
+            tx_fill_ ();
+            tx_start_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          // The bytes may already be in the ring.
+          flush_events_ ();
+          return RETURN_OK;
+        }
+
+        return_t
+        Cdc_acm::do_receive (void* data, std::size_t num) noexcept
+        {
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            if (!rx_enabled_)
+              {
+                return ERROR;
+              }
+            if (rx_data_ != nullptr)
+              {
+                return ERROR_BUSY;
+              }
+
+            rx_data_ = static_cast<uint8_t*> (data);
+            rx_num_ = num;
+            rx_count_ = 0;
+            status_.rx_break = false;
+
+            // First the bytes already in the ring.
+            std::size_t const count = (rx_level_ < num) ? rx_level_ : num;
+            std::size_t const first =
+                (count < rx_size_ - rx_tail_) ? count : rx_size_ - rx_tail_;
+            std::memcpy (rx_data_, rx_ring_ + rx_tail_, first);
+            std::memcpy (rx_data_ + first, rx_ring_, count - first);
+            rx_tail_ = (rx_tail_ + count) % rx_size_;
+            rx_level_ -= count;
+            rx_count_ = count;
+
+            if (rx_count_ == rx_num_)
+              {
+                rx_data_ = nullptr;
+                events_ |= serial::Event::receive_complete;
+              }
+            else if (rx_count_ > 0)
+              {
+                events_ |= serial::Event::rx_timeout;
+              }
+
+            // There may be room for the held packets.
+            rx_flush_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          flush_events_ ();
+          return RETURN_OK;
+        }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+        return_t
+        Cdc_acm::do_transfer (const void* data_out, void* data_in,
+                              std::size_t num) noexcept
+        {
+          // Only for the synchronous modes.
+          return ERROR_UNSUPPORTED;
+        }
+
+        return_t
+        Cdc_acm::do_control_modem_line (serial::Modem_control ctrl) noexcept
+        {
+          // The device side lines are reported by SERIAL_STATE
+          // notifications, not implemented.
+          return ERROR_UNSUPPORTED;
+        }
+
+#pragma GCC diagnostic pop
+
+        std::size_t
+        Cdc_acm::do_get_tx_count (void) noexcept
+        {
+          return tx_count_;
+        }
+
+        std::size_t
+        Cdc_acm::do_get_rx_count (void) noexcept
+        {
+          return rx_count_;
+        }
+
+        /**
+         * @details
+         * Only the asynchronous mode is accepted; the values are
+         * returned to the host by `GET_LINE_CODING`, until the host
+         * sets its own.
+         */
+        return_t
+        Cdc_acm::do_configure (serial::config_t cfg, serial::config_arg_t arg) noexcept
+        {
+          if ((cfg & serial::CONFIG_Msk) != serial::MODE_ASYNCHRONOUS)
+            {
+              return serial::ERROR_MODE;
+            }
+          if (arg == 0)
+            {
+              return serial::ERROR_BAUDRATE;
+            }
+
+          uint8_t data_bits;
+          switch (cfg & serial::DATA_BITS_Msk)
+            {
+            case serial::DATA_BITS_5:
+              data_bits = 5;
+              break;
+            case serial::DATA_BITS_6:
+              data_bits = 6;
+              break;
+            case serial::DATA_BITS_7:
+              data_bits = 7;
+              break;
+            case serial::DATA_BITS_8:
+              data_bits = 8;
+              break;
+            default:
+              return serial::ERROR_DATA_BITS;
+            }
+
+          uint8_t parity_type;
+          switch (cfg & serial::PARITY_Msk)
+            {
+            case serial::PARITY_NONE:
+              parity_type = 0;
+              break;
+            case serial::PARITY_ODD:
+              parity_type = 1;
+              break;
+            case serial::PARITY_EVEN:
+              parity_type = 2;
+              break;
+            default:
+              return serial::ERROR_PARITY;
+            }
+
+          uint8_t char_format;
+          switch (cfg & serial::STOP_BITS_Msk)
+            {
+            case serial::STOP_BITS_1:
+              char_format = 0;
+              break;
+            case serial::STOP_BITS_1_5:
+              char_format = 1;
+              break;
+            case serial::STOP_BITS_2:
+              char_format = 2;
+              break;
+            default:
+              return serial::ERROR_STOP_BITS;
+            }
+
+          line_coding_.dte_rate = arg;
+          line_coding_.char_format = char_format;
+          line_coding_.parity_type = parity_type;
+          line_coding_.data_bits = data_bits;
+
+          return RETURN_OK;
+        }
+
+        return_t
+        Cdc_acm::do_control (serial::control_t ctrl) noexcept
+        {
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          switch (ctrl)
+            {
+            case serial::Control::enable_tx:
+              tx_enabled_ = true;
+              return RETURN_OK;
+
+            case serial::Control::disable_tx:
+              tx_enabled_ = false;
+              return RETURN_OK;
+
+            case serial::Control::enable_rx:
+              rx_enabled_ = true;
+              return RETURN_OK;
+
+            case serial::Control::disable_rx:
+              rx_enabled_ = false;
+              return RETURN_OK;
+
+            case serial::Control::abort_send:
+              // The bytes already in the ring are still sent.
+              tx_data_ = nullptr;
+              return RETURN_OK;
+
+            case serial::Control::abort_receive:
+              rx_data_ = nullptr;
+              return RETURN_OK;
+
+            default:
+              return ERROR_UNSUPPORTED;
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+
+        serial::Status&
+        Cdc_acm::do_get_status (void) noexcept
+        {
+          status_.tx_busy = (tx_data_ != nullptr);
+          status_.rx_busy = (rx_data_ != nullptr);
+          return status_;
+        }
+
+        serial::Modem_status&
+        Cdc_acm::do_get_modem_status (void) noexcept
+        {
+          return modem_status_;
+        }
+
+        // ------------------------------------------------------------------
+
+        void
+        Cdc_acm::signal_out (const void* object,
+                             endpoint_t ep_addr __attribute__((unused)),
+                             std::size_t count, return_t status)
+        {
+          Cdc_acm* self = static_cast<Cdc_acm*> (const_cast<void*> (object));
+
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            if (!self->configured_)
+              {
+                // Aborted.
+                return;
+              }
+
+            // The OUT packets complete in the order they were submitted.
+            std::size_t const i = (self->out_first_ + self->out_held_) % 2;
+            self->out_length_[i] = (status == RETURN_OK) ? count : 0;
+            self->out_offset_[i] = 0;
+            ++self->out_held_;
+
+            self->rx_flush_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          self->flush_events_ ();
+        }
+
+        void
+        Cdc_acm::signal_in (const void* object,
+                            endpoint_t ep_addr __attribute__((unused)),
+                            std::size_t count __attribute__((unused)),
+                            return_t status __attribute__((unused)))
+        {
+          Cdc_acm* self = static_cast<Cdc_acm*> (const_cast<void*> (object));
+
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            if (!self->configured_ || self->in_flight_ == 0)
+              {
+                // Aborted.
+                return;
+              }
+
+            // On errors the bytes are dropped, as on a line.
+            std::size_t const length = self->in_length_[self->in_first_];
+            self->in_first_ ^= 1;
+            --self->in_flight_;
+
+            self->tx_tail_ = (self->tx_tail_ + length) % self->tx_size_;
+            self->tx_level_ -= length;
+            self->tx_queued_ -= length;
+
+            self->tx_fill_ ();
+            self->tx_start_ ();
+
+            if (self->in_flight_ == 0)
+              {
+                if ((length != 0) && (length % self->packet_size_) == 0)
+                  {
+                    // The host ends a transfer only on a short packet.
+                    self->tx_submit_ (self->tx_ring_, 0);
+                  }
+                else if (self->tx_level_ == 0)
+                  {
+                    self->events_ |= serial::Event::tx_complete;
+                  }
+              }
+            // ----- Exit critical section ------------------------------------
+          }
+
+          self->flush_events_ ();
+        }
+
+        // ------------------------------------------------------------------
+
+        // Must be called with interrupts disabled.
+        void
+        Cdc_acm::reset_ (void) noexcept
+        {
+          rx_head_ = 0;
+          rx_tail_ = 0;
+          rx_level_ = 0;
+
+          out_first_ = 0;
+          out_held_ = 0;
+
+          tx_tail_ = 0;
+          tx_level_ = 0;
+          tx_queued_ = 0;
+
+          in_first_ = 0;
+          in_flight_ = 0;
+        }
+
+        /*
+         * Store the received bytes, first in the user buffer,
+         * then in the ring. Return how many were stored.
+         * Must be called with interrupts disabled.
+         */
+        std::size_t
+        Cdc_acm::rx_deliver_ (const uint8_t* data, std::size_t num) noexcept
+        {
+          std::size_t done = 0;
+
+          // When a receive is active the ring is empty.
+          if (rx_data_ != nullptr)
+            {
+              std::size_t const count =
+                  (num < rx_num_ - rx_count_) ? num : rx_num_ - rx_count_;
+              std::memcpy (rx_data_ + rx_count_, data, count);
+              rx_count_ += count;
+              done = count;
+
+              if (rx_count_ == rx_num_)
+                {
+                  rx_data_ = nullptr;
+                  events_ |= serial::Event::receive_complete;
+                }
+              else if (count > 0)
+                {
+                  // The end of a packet is the end of a burst.
+                  events_ |= serial::Event::rx_timeout;
+                }
+            }
+
+          std::size_t const room = rx_size_ - rx_level_;
+          std::size_t const count = (num - done < room) ? num - done : room;
+          std::size_t const first =
+              (count < rx_size_ - rx_head_) ? count : rx_size_ - rx_head_;
+          std::memcpy (rx_ring_ + rx_head_, data + done, first);
+          std::memcpy (rx_ring_, data + done + first, count - first);
+          rx_head_ = (rx_head_ + count) % rx_size_;
+          rx_level_ += count;
+
+          return done + count;
+        }
+
+        /*
+         * Store the held packets, in order, and give the emptied
+         * OUT buffers back to the endpoint.
+         * Must be called with interrupts disabled.
+         */
+        void
+        Cdc_acm::rx_flush_ (void) noexcept
+        {
+          while (out_held_ > 0)
+            {
+              std::size_t const i = out_first_;
+              out_offset_[i] += rx_deliver_ (out_packet_ (i) + out_offset_[i],
+                                             out_length_[i] - out_offset_[i]);
+              if (out_offset_[i] < out_length_[i])
+                {
+                  // No more room; the host is NAKed meanwhile.
+                  break;
+                }
+
+              --out_held_;
+              out_first_ ^= 1;
+
+              if (configured_)
+                {
+                  out_queue_.submit (out_packet_ (i), packet_size_, signal_out,
+                                     this);
+                }
+            }
+        }
+
+        // Copy the user bytes into the ring.
+        // Must be called with interrupts disabled.
+        void
+        Cdc_acm::tx_fill_ (void) noexcept
+        {
+          if (tx_data_ == nullptr)
+            {
+              return;
+            }
+
+          std::size_t const head = (tx_tail_ + tx_level_) % tx_size_;
+          std::size_t const room = tx_size_ - tx_level_;
+          std::size_t const count =
+              (tx_num_ - tx_count_ < room) ? tx_num_ - tx_count_ : room;
+          std::size_t const first =
+              (count < tx_size_ - head) ? count : tx_size_ - head;
+          std::memcpy (tx_ring_ + head, tx_data_ + tx_count_, first);
+          std::memcpy (tx_ring_, tx_data_ + tx_count_ + first, count - first);
+          tx_count_ += count;
+          tx_level_ += count;
+
+          if (tx_count_ == tx_num_)
+            {
+              tx_data_ = nullptr;
+              events_ |= serial::Event::send_complete;
+            }
+        }
+
+        // Keep up to two IN transfers pending, directly from the ring.
+        // Must be called with interrupts disabled.
+        void
+        Cdc_acm::tx_start_ (void) noexcept
+        {
+          while (configured_ && in_flight_ < 2 && tx_level_ > tx_queued_)
+            {
+              std::size_t const pos = (tx_tail_ + tx_queued_) % tx_size_;
+              std::size_t const available = tx_level_ - tx_queued_;
+              std::size_t const count =
+                  (available < tx_size_ - pos) ? available : tx_size_ - pos;
+
+              if (tx_submit_ (tx_ring_ + pos, count) != RETURN_OK)
+                {
+                  break;
+                }
+              tx_queued_ += count;
+            }
+        }
+
+        // Must be called with interrupts disabled.
+        return_t
+        Cdc_acm::tx_submit_ (uint8_t* data, std::size_t num) noexcept
+        {
+          std::size_t const i = (in_first_ + in_flight_) % 2;
+          in_length_[i] = num;
+          ++in_flight_;
+
+          return_t const result = in_queue_.submit (data, num, signal_in,
+                                                    this);
+          if (result != RETURN_OK)
+            {
+              --in_flight_;
+            }
+          return result;
+        }
+
+        void
+        Cdc_acm::flush_events_ (void) noexcept
+        {
+          event_t events;
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            events = events_;
+            events_ = 0;
+            // ----- Exit critical section ------------------------------------
+          }
+
+          if (events != 0)
+            {
+              signal_event (events);
+            }
+        }
+
+      } /* namespace device */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,384 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/drivers/usb-device-queue.h>
+
+#include <cassert>
+#include <new>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace device
+      {
+        // ------------------------------------------------------------------
+
+        Transfer_queues::Transfer_queues (Device& device) noexcept :
+            device_ (device)
+        {
+          for (auto& dir : queues_)
+            {
+              for (auto& q : dir)
+                {
+                  q = nullptr;
+                }
+            }
+
+          cb_endpoint_func_ = nullptr;
+          cb_endpoint_object_ = nullptr;
+
+          device_.register_endpoint_callback (signal_endpoint_event, this);
+        }
+
+        Transfer_queues::~Transfer_queues () noexcept
+        {
+          device_.register_endpoint_callback (nullptr, nullptr);
+        }
+
+        void
+        Transfer_queues::register_endpoint_callback (
+            signal_endpoint_event_t cb_func, const void* cb_object) noexcept
+        {
+          cb_endpoint_func_ = cb_func;
+          cb_endpoint_object_ = cb_object;
+        }
+
+        void
+        Transfer_queues::signal_endpoint_event (const void* object,
+                                                endpoint_t ep_addr,
+                                                event_t event)
+        {
+          Transfer_queues* self =
+              static_cast<Transfer_queues*> (const_cast<void*> (object));
+
+          Endpoint_queue* q = self->slot (ep_addr);
+          if ((q != nullptr) && ((event & (in | out)) != 0))
+            {
+              q->signal_event ();
+              event &= static_cast<event_t> (~(in | out));
+            }
+
+          // SETUP packets and endpoints without a queue.
+          if ((event != 0) && (self->cb_endpoint_func_ != nullptr))
+            {
+              self->cb_endpoint_func_ (self->cb_endpoint_object_, ep_addr,
+                                       event);
+            }
+        }
+
+        // ------------------------------------------------------------------
+
+        Endpoint_queue::Endpoint_queue (Transfer_queues& queues,
+                                        endpoint_t ep_addr,
+                                        rtos::memory_pool& pool,
+                                        packet_size_t packet_size) noexcept :
+            queues_ (queues), //
+            pool_ (pool), //
+            ep_addr_ (ep_addr), //
+            packet_size_ (packet_size)
+        {
+          assert(pool_.block_size () >= sizeof(Transfer_request));
+          assert(queues_.slot (ep_addr_) == nullptr);
+
+          queues_.slot (ep_addr_) = this;
+        }
+
+        Endpoint_queue::~Endpoint_queue () noexcept
+        {
+          abort ();
+
+          queues_.slot (ep_addr_) = nullptr;
+        }
+
+        return_t
+        Endpoint_queue::submit (uint8_t* data, std::size_t num,
+                                signal_transfer_t cb_func,
+                                const void* cb_object) noexcept
+        {
+          void* block = pool_.try_alloc ();
+          if (block == nullptr)
+            {
+              return ERROR_BUSY;
+            }
+
+          Transfer_request* req = new (block) Transfer_request;
+          req->single.data = data;
+          req->single.num = num;
+          req->segments = &req->single;
+          req->segments_count = 1;
+          req->cb_func = cb_func;
+          req->cb_object = cb_object;
+
+          return enqueue (req);
+        }
+
+        return_t
+        Endpoint_queue::submit (const Segment* segments, std::size_t count,
+                                signal_transfer_t cb_func,
+                                const void* cb_object) noexcept
+        {
+          if ((segments == nullptr) || (count == 0))
+            {
+              return ERROR_PARAMETER;
+            }
+
+          // A short packet in the middle would end the transfer early.
+          if (packet_size_ != 0)
+            {
+              for (std::size_t i = 0; i + 1 < count; ++i)
+                {
+                  if ((segments[i].num % packet_size_) != 0)
+                    {
+                      return ERROR_PARAMETER;
+                    }
+                }
+            }
+
+          void* block = pool_.try_alloc ();
+          if (block == nullptr)
+            {
+              return ERROR_BUSY;
+            }
+
+          Transfer_request* req = new (block) Transfer_request;
+          req->segments = segments;
+          req->segments_count = count;
+          req->cb_func = cb_func;
+          req->cb_object = cb_object;
+
+          return enqueue (req);
+        }
+
+        void
+        Endpoint_queue::abort (void) noexcept
+        {
+          Transfer_request* list;
+            {
+              // ----- Enter critical section ---------------------------------
+              rtos::interrupts::critical_section ics;
+
+              if (active_)
+                {
+                  queues_.get_device ().abort_transfer (ep_addr_);
+                  active_ = false;
+                }
+
+              list = head_;
+              head_ = nullptr;
+              tail_ = nullptr;
+              pending_ = 0;
+              // ----- Exit critical section ----------------------------------
+            }
+
+          // Callbacks are invoked outside the critical section,
+          // and may submit new transfers.
+          while (list != nullptr)
+            {
+              Transfer_request* req = list;
+              list = list->next;
+              complete (req, ERROR);
+            }
+        }
+
+        // ------------------------------------------------------------------
+
+        return_t
+        Endpoint_queue::enqueue (Transfer_request* req) noexcept
+        {
+          req->index = 0;
+          req->count = 0;
+          req->next = nullptr;
+
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          if (tail_ == nullptr)
+            {
+              head_ = req;
+            }
+          else
+            {
+              tail_->next = req;
+            }
+          tail_ = req;
+          ++pending_;
+
+          if (!active_)
+            {
+              // The queue was empty; start this one now, and if this
+              // fails, report it to the caller, not via the callback.
+              return_t result = start ();
+              if (result != RETURN_OK)
+                {
+                  head_ = nullptr;
+                  tail_ = nullptr;
+                  pending_ = 0;
+
+                  pool_.free (req);
+                }
+              return result;
+            }
+
+          return RETURN_OK;
+          // ----- Exit critical section --------------------------------------
+        }
+
+        // Must be called with interrupts disabled.
+        return_t
+        Endpoint_queue::start (void) noexcept
+        {
+          // Each segment is a separate driver transfer; submit()
+          // checked that only the last one may end in a short packet.
+          const Segment& seg = head_->segments[head_->index];
+
+          return_t result;
+          if (seg.num == 0)
+            {
+              result = queues_.get_device ().transfer_zero_length (ep_addr_);
+            }
+          else
+            {
+              result = queues_.get_device ().transfer (ep_addr_, seg.data,
+                                                       seg.num);
+            }
+
+          active_ = (result == RETURN_OK);
+          return result;
+        }
+
+        // Must be called with interrupts disabled.
+        Transfer_request*
+        Endpoint_queue::fail_head (void) noexcept
+        {
+          Transfer_request* req = head_;
+
+          head_ = req->next;
+          if (head_ == nullptr)
+            {
+              tail_ = nullptr;
+            }
+          --pending_;
+
+          req->next = nullptr;
+          return req;
+        }
+
+        void
+        Endpoint_queue::complete (Transfer_request* req, return_t status) noexcept
+        {
+          // Release the descriptor before the callback,
+          // to make room for a new submit().
+          signal_transfer_t cb_func = req->cb_func;
+          const void* cb_object = req->cb_object;
+          std::size_t count = req->count;
+
+          req->~Transfer_request ();
+          pool_.free (req);
+
+          if (cb_func != nullptr)
+            {
+              cb_func (cb_object, ep_addr_, count, status);
+            }
+        }
+
+        void
+        Endpoint_queue::signal_event (void) noexcept
+        {
+          Transfer_request* done = nullptr;
+          return_t status = RETURN_OK;
+
+          // Requests that could not be started, in order.
+          Transfer_request* failed = nullptr;
+          Transfer_request** failed_tail = &failed;
+
+            {
+              // ----- Enter critical section ---------------------------------
+              rtos::interrupts::critical_section ics;
+
+              if (!active_ || (head_ == nullptr))
+                {
+                  // Spurious, or aborted.
+                  return;
+                }
+              active_ = false;
+
+              Transfer_request* req = head_;
+              std::size_t num = queues_.get_device ().get_transfer_count (
+                  ep_addr_);
+              req->count += num;
+
+              // On OUT endpoints a short packet ends the transfer.
+              bool is_short = ((ep_addr_ & ENDPOINT_DIRECTION_MASK) == 0)
+                  && (num < req->segments[req->index].num);
+
+              ++req->index;
+              if (!is_short && (req->index < req->segments_count))
+                {
+                  // Continue with the next segment.
+                  if (start () == RETURN_OK)
+                    {
+                      return;
+                    }
+                  status = ERROR;
+                }
+
+              done = fail_head ();
+
+              // Keep the endpoint busy with the next queued request.
+              while (head_ != nullptr)
+                {
+                  if (start () == RETURN_OK)
+                    {
+                      break;
+                    }
+                  *failed_tail = fail_head ();
+                  failed_tail = &(*failed_tail)->next;
+                }
+              // ----- Exit critical section ----------------------------------
+            }
+
+          complete (done, status);
+
+          while (failed != nullptr)
+            {
+              Transfer_request* req = failed;
+              failed = failed->next;
+              complete (req, ERROR);
+            }
+        }
+
+      } /* namespace device */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
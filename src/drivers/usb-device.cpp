@@ -92,6 +92,14 @@ namespace os
         return do_transfer (ep_addr, data, num);
       }
 
+      return_t
+      Device::transfer_zero_length (endpoint_t ep_addr) noexcept
+      {
+        // Drivers may not accept a null pointer, even with no data.
+        static uint8_t dummy;
+        return do_transfer (ep_addr, &dummy, 0);
+      }
+
       // ----------------------------------------------------------------------
 
       void
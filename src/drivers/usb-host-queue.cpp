@@ -0,0 +1,419 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/drivers/usb-host-queue.h>
+
+#include <cassert>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace driver
+  {
+    namespace usb
+    {
+      namespace host
+      {
+        // ------------------------------------------------------------------
+
+        Pipe_queues::Pipe_queues (Host& host) noexcept :
+            host_ (host)
+        {
+          host_.register_pipe_callback (signal_pipe_event, this);
+        }
+
+        Pipe_queues::~Pipe_queues () noexcept
+        {
+          assert(queues_ == nullptr);
+
+          host_.register_pipe_callback (nullptr, nullptr);
+        }
+
+        void
+        Pipe_queues::register_pipe_callback (signal_pipe_event_t cb_func,
+                                             const void* cb_object) noexcept
+        {
+          cb_pipe_func_ = cb_func;
+          cb_pipe_object_ = cb_object;
+        }
+
+        std::size_t
+        Pipe_queues::dispatch (void) noexcept
+        {
+          for (;;)
+            {
+              std::size_t const count = try_dispatch ();
+              if (count > 0)
+                {
+                  return count;
+                }
+              if (done_semaphore_.wait () != rtos::result::ok)
+                {
+                  return 0;
+                }
+            }
+        }
+
+        std::size_t
+        Pipe_queues::try_dispatch (void) noexcept
+        {
+          Urb* list;
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            list = done_head_;
+            done_head_ = nullptr;
+            done_tail_ = nullptr;
+            // ----- Exit critical section ------------------------------------
+          }
+
+          std::size_t count = 0;
+          while (list != nullptr)
+            {
+              Urb* urb = list;
+              list = urb->next_;
+
+              // From now on the request may be submitted again.
+              urb->next_ = nullptr;
+              urb->queue_ = nullptr;
+
+              if (urb->cb_func != nullptr)
+                {
+                  urb->cb_func (urb->cb_object, *urb);
+                }
+              ++count;
+            }
+
+          return count;
+        }
+
+        std::size_t
+        Pipe_queues::timed_dispatch (rtos::clock::duration_t timeout) noexcept
+        {
+          rtos::clock::timestamp_t const deadline = rtos::sysclock.now ()
+              + timeout;
+
+          for (;;)
+            {
+              // The semaphore may have been posted for requests
+              // already dispatched; then wait again, only for the
+              // rest of the timeout.
+              std::size_t const count = try_dispatch ();
+              if (count > 0)
+                {
+                  return count;
+                }
+
+              rtos::clock::timestamp_t const now = rtos::sysclock.now ();
+              if (now >= deadline)
+                {
+                  return 0;
+                }
+              if (done_semaphore_.timed_wait (
+                  static_cast<rtos::clock::duration_t> (deadline - now))
+                  != rtos::result::ok)
+                {
+                  return 0;
+                }
+            }
+        }
+
+        void
+        Pipe_queues::signal_pipe_event (const void* object, pipe_t pipe,
+                                        event_t event)
+        {
+          Pipe_queues* self =
+              static_cast<Pipe_queues*> (const_cast<void*> (object));
+
+          Pipe_queue* q;
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            // There are only a few pipes.
+            for (q = self->queues_; q != nullptr; q = q->next_)
+              {
+                if (q->pipe_ == pipe)
+                  {
+                    q->signal_event (event);
+                    return;
+                  }
+              }
+            // ----- Exit critical section ------------------------------------
+          }
+
+          if (self->cb_pipe_func_ != nullptr)
+            {
+              self->cb_pipe_func_ (self->cb_pipe_object_, pipe, event);
+            }
+        }
+
+        // Must be called with interrupts disabled.
+        void
+        Pipe_queues::done_ (Urb* urb) noexcept
+        {
+          urb->next_ = nullptr;
+          if (done_tail_ == nullptr)
+            {
+              done_head_ = urb;
+            }
+          else
+            {
+              done_tail_->next_ = urb;
+            }
+          done_tail_ = urb;
+
+          done_semaphore_.post ();
+        }
+
+        // ------------------------------------------------------------------
+
+        Pipe_queue::Pipe_queue (Pipe_queues& queues, pipe_t pipe) noexcept :
+            queues_ (queues), //
+            pipe_ (pipe)
+        {
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          next_ = queues_.queues_;
+          queues_.queues_ = this;
+          // ----- Exit critical section --------------------------------------
+        }
+
+        Pipe_queue::~Pipe_queue () noexcept
+        {
+          abort ();
+
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          for (Pipe_queue** p = &queues_.queues_; *p != nullptr;
+              p = &(*p)->next_)
+            {
+              if (*p == this)
+                {
+                  *p = next_;
+                  break;
+                }
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+
+        return_t
+        Pipe_queue::submit (Urb& urb) noexcept
+        {
+          assert(urb.num == 0 || urb.data != nullptr);
+
+          urb.count = 0;
+          urb.event = 0;
+          urb.status = RETURN_OK;
+          urb.next_ = nullptr;
+
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          assert(urb.queue_ == nullptr);
+          urb.queue_ = this;
+
+          if (tail_ == nullptr)
+            {
+              head_ = &urb;
+            }
+          else
+            {
+              tail_->next_ = &urb;
+            }
+          tail_ = &urb;
+          ++pending_;
+
+          if (!active_ && !halted_)
+            {
+              // The queue was empty; start this one now, and if this
+              // fails, report it to the caller, not via the callback.
+              return_t result = start_ ();
+              if (result != RETURN_OK)
+                {
+                  head_ = nullptr;
+                  tail_ = nullptr;
+                  pending_ = 0;
+
+                  urb.queue_ = nullptr;
+                }
+              return result;
+            }
+
+          return RETURN_OK;
+          // ----- Exit critical section --------------------------------------
+        }
+
+        void
+        Pipe_queue::abort (void) noexcept
+        {
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          if (active_)
+            {
+              queues_.host_.abort_transfer (pipe_);
+              active_ = false;
+            }
+          halted_ = false;
+
+          while (head_ != nullptr)
+            {
+              Urb* urb = pop_ ();
+              urb->status = ERROR;
+              queues_.done_ (urb);
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+
+        return_t
+        Pipe_queue::restart (void) noexcept
+        {
+          // ----- Enter critical section -------------------------------------
+          rtos::interrupts::critical_section ics;
+
+          halted_ = false;
+          if (active_ || head_ == nullptr)
+            {
+              return RETURN_OK;
+            }
+
+          return_t const result = start_ ();
+          if (result != RETURN_OK)
+            {
+              Urb* urb = pop_ ();
+              urb->status = ERROR;
+              queues_.done_ (urb);
+              halted_ = true;
+            }
+          return result;
+          // ----- Exit critical section --------------------------------------
+        }
+
+        // ------------------------------------------------------------------
+
+        // Called from the pipe interrupt, with interrupts disabled.
+        void
+        Pipe_queue::signal_event (event_t event) noexcept
+        {
+          if (!active_ || head_ == nullptr)
+            {
+              // Spurious, or aborted.
+              return;
+            }
+          active_ = false;
+
+          Urb* urb = head_;
+          urb->count += queues_.host_.get_transfer_count (pipe_);
+          urb->event = event;
+
+          if ((event & Pipe_event::transfer_complete) == 0)
+            {
+              if ((event
+                  & (Pipe_event::handshake_nak | Pipe_event::handshake_nyet))
+                  != 0)
+                {
+                  // Not ready yet; try again with the rest. The data
+                  // toggle is now kept by the driver.
+                  urb->packet &= ~PACKET_DATA_Msk;
+                  if (start_ () == RETURN_OK)
+                    {
+                      return;
+                    }
+                }
+
+              // Stall or errors; the next requests wait for restart().
+              pop_ ();
+              urb->status = ERROR;
+              queues_.done_ (urb);
+              halted_ = true;
+              return;
+            }
+
+          pop_ ();
+          queues_.done_ (urb);
+
+          // Keep the pipe busy with the next queued request; if it
+          // cannot start, the rest wait for restart().
+          if (head_ != nullptr && start_ () != RETURN_OK)
+            {
+              Urb* failed = pop_ ();
+              failed->status = ERROR;
+              queues_.done_ (failed);
+              halted_ = true;
+            }
+        }
+
+        // Must be called with interrupts disabled.
+        return_t
+        Pipe_queue::start_ (void) noexcept
+        {
+          Urb* urb = head_;
+
+          return_t result;
+          if (urb->num == 0)
+            {
+              result = queues_.host_.transfer_zero_length (pipe_, urb->packet);
+            }
+          else
+            {
+              result = queues_.host_.transfer (pipe_, urb->packet,
+                                               urb->data + urb->count,
+                                               urb->num - urb->count);
+            }
+
+          active_ = (result == RETURN_OK);
+          return result;
+        }
+
+        // Must be called with interrupts disabled.
+        Urb*
+        Pipe_queue::pop_ (void) noexcept
+        {
+          Urb* urb = head_;
+
+          head_ = urb->next_;
+          if (head_ == nullptr)
+            {
+              tail_ = nullptr;
+            }
+          --pending_;
+
+          urb->next_ = nullptr;
+          return urb;
+        }
+
+      } /* namespace host */
+    } /* namespace usb */
+  } /* namespace driver */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
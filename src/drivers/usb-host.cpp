@@ -86,6 +86,14 @@ namespace os
           return do_transfer (pipe, packet, data, num);
         }
 
+        return_t
+        Host::transfer_zero_length (pipe_t pipe, uint32_t packet) noexcept
+        {
+          // Drivers may not accept a null pointer, even with no data.
+          static uint8_t dummy;
+          return do_transfer (pipe, packet, &dummy, 0);
+        }
+
         // ----------------------------------------------------------------------
 
         void
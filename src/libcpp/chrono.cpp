@@ -28,6 +28,8 @@
 #include <cmsis-plus/iso/chrono>
 #include <cmsis-plus/rtos/port/os-inlines.h>
 
+#include <atomic>
+
 // ----------------------------------------------------------------------------
 
 namespace os
@@ -103,21 +105,69 @@ namespace os
 
       // ======================================================================
 
+      namespace
+      {
+        // Cycles to nanoseconds, recomputed when the input
+        // frequency changes.
+        uint32_t hr_frequency_hz;
+        ratio_converter hr_converter
+          { 1000000000ULL, 1 };
+
+        // Odd while the converter is being updated; readers copy
+        // it again if the number changed, as for the clock counters.
+        uint32_t volatile hr_converter_seq;
+      }
+
       high_resolution_clock::time_point
       high_resolution_clock::now () noexcept
       {
         auto cycles = rtos::hrclock.now ();
 
+        uint32_t frequency_hz = rtos::hrclock.input_clock_frequency_hz ();
+
+        // Work on a copy, so a concurrent update cannot be seen
+        // half written.
+        ratio_converter converter
+          { 1000000000ULL, 1 };
+        if (frequency_hz != hr_frequency_hz)
+          {
+            // Rare, only when the frequency changes.
+            converter = ratio_converter
+              { 1000000000ULL, frequency_hz };
+
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            hr_converter_seq = hr_converter_seq + 1;
+            std::atomic_signal_fence (std::memory_order_release);
+            hr_converter = converter;
+            hr_frequency_hz = frequency_hz;
+            std::atomic_signal_fence (std::memory_order_release);
+            hr_converter_seq = hr_converter_seq + 1;
+            // ----- Exit critical section ------------------------------------
+          }
+        else
+          {
+            // Without disabling interrupts.
+            uint32_t seq;
+            do
+              {
+                seq = hr_converter_seq;
+                std::atomic_signal_fence (std::memory_order_acquire);
+                converter = hr_converter;
+                std::atomic_signal_fence (std::memory_order_acquire);
+              }
+            while (((seq & 1) != 0) || (seq != hr_converter_seq));
+          }
+
         // The duration is the number of sum of SysTick ticks plus the current
-        // count of CPU cycles (computed from the SysTick counter).
-        // Notice: a more exact solution would be to compute
-        // ticks * divisor + cycles, but this severely reduces the
-        // range of ticks.
+        // count of CPU cycles (computed from the SysTick counter),
+        // converted without divisions and without overflowing the
+        // intermediate product.
         return time_point
           { duration
             { duration
-              { cycles * 1000000000ULL
-                  / rtos::hrclock.input_clock_frequency_hz () }
+              { static_cast<rep> (converter.floor (cycles)) }
                 + realtime_clock::startup_time_point.time_since_epoch () } //
           };
       }
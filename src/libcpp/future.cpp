@@ -0,0 +1,471 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cmsis-plus/iso/future>
+#include <cstdlib>
+#if defined(__EXCEPTIONS)
+#include <string>
+#include <system_error>
+#endif
+
+// ----------------------------------------------------------------------------
+
+#if !defined(OS_INTEGER_ESTD_FUTURE_STATE_POOL_SIZE)
+#define OS_INTEGER_ESTD_FUTURE_STATE_POOL_SIZE (8)
+#endif
+
+#if !defined(OS_INTEGER_ESTD_FUTURE_STATE_PAYLOAD_SIZE_BYTES)
+#define OS_INTEGER_ESTD_FUTURE_STATE_PAYLOAD_SIZE_BYTES (8 * sizeof(void*))
+#endif
+
+#if !defined(OS_INTEGER_ESTD_ASYNC_THREADS)
+#define OS_INTEGER_ESTD_ASYNC_THREADS (2)
+#endif
+
+#if !defined(OS_INTEGER_ESTD_ASYNC_QUEUE_SIZE)
+#define OS_INTEGER_ESTD_ASYNC_QUEUE_SIZE (8)
+#endif
+
+#if !defined(OS_INTEGER_ESTD_ASYNC_STACK_SIZE_BYTES)
+#define OS_INTEGER_ESTD_ASYNC_STACK_SIZE_BYTES (os::rtos::port::stack::default_size_bytes)
+#endif
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+  using namespace os;
+  using namespace os::estd;
+
+  // The pool blocks hold the common part of the state, plus
+  // space for the value and, for async(), the function object.
+  using state_block_t = std::aligned_storage<
+  sizeof(internal::shared_state_base)
+  + OS_INTEGER_ESTD_FUTURE_STATE_PAYLOAD_SIZE_BYTES,
+  alignof(std::max_align_t)>::type;
+
+#pragma GCC diagnostic push
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#endif
+
+  rtos::memory_pool_static<state_block_t,
+      OS_INTEGER_ESTD_FUTURE_STATE_POOL_SIZE> states_pool
+    { "futures" };
+
+  memory_pool_resource states_resource
+    { states_pool };
+
+  // Serialises the construction of the default pool.
+  rtos::mutex default_thread_pool_mutex
+    { "async-pool" };
+
+#pragma GCC diagnostic pop
+
+  using default_thread_pool_t = thread_pool_static<OS_INTEGER_ESTD_ASYNC_THREADS,
+  OS_INTEGER_ESTD_ASYNC_QUEUE_SIZE, OS_INTEGER_ESTD_ASYNC_STACK_SIZE_BYTES>;
+
+  // Constructed on first use, the threads are not needed
+  // by applications that do not call async().
+  std::aligned_storage<sizeof(default_thread_pool_t),
+      alignof(default_thread_pool_t)>::type default_thread_pool_storage;
+
+  thread_pool* default_thread_pool;
+
+  // The storage holds a constructed pool.
+  bool default_thread_pool_constructed;
+
+#if defined(__EXCEPTIONS)
+
+  struct future_error_category : public std::error_category
+  {
+    virtual const char*
+    name () const noexcept;
+
+    virtual std::string
+    message (int i) const;
+  };
+
+  const char*
+  future_error_category::name () const noexcept
+  {
+    return "future";
+  }
+
+  std::string
+  future_error_category::message (int i) const
+  {
+    switch (static_cast<future_errc> (i))
+      {
+      case future_errc::broken_promise:
+        return std::string ("broken promise");
+      case future_errc::future_already_retrieved:
+        return std::string ("future already retrieved");
+      case future_errc::promise_already_satisfied:
+        return std::string ("promise already satisfied");
+      case future_errc::no_state:
+        return std::string ("no state");
+      }
+    return std::string ("");
+  }
+
+#endif
+
+}
+
+namespace os
+{
+  namespace estd
+  {
+    // ========================================================================
+
+    void
+    __throw_future_error (future_errc ev, const char* what_arg)
+    {
+#if defined(__EXCEPTIONS)
+      static future_error_category category;
+
+      throw std::system_error (
+          std::error_code (static_cast<int> (ev), category), what_arg);
+#else
+      trace::printf ("future_error(%d, %s)\n", static_cast<int> (ev),
+                     what_arg);
+      std::abort ();
+#endif
+    }
+
+    namespace internal
+    {
+      // ======================================================================
+
+      void*
+      allocate_shared_state (memory_resource*& res, std::size_t bytes,
+                             std::size_t alignment)
+      {
+        if (res == nullptr)
+          {
+            if (bytes <= states_pool.block_size ()
+                && alignment <= memory_resource::max_align)
+              {
+                void* p = states_pool.try_alloc ();
+                if (p != nullptr)
+                  {
+                    res = &states_resource;
+                    return p;
+                  }
+              }
+
+            // Too large or the pool is exhausted.
+            res = get_default_resource ();
+          }
+
+        return res->allocate (bytes, alignment);
+      }
+
+      // ======================================================================
+
+      shared_state_base::shared_state_base (memory_resource* res,
+                                            std::size_t size_bytes,
+                                            bool deferred) noexcept :
+          res_ (res), //
+          size_bytes_ (size_bytes), //
+          deferred_ (deferred)
+      {
+        ;
+      }
+
+      shared_state_base::~shared_state_base ()
+      {
+        ;
+      }
+
+      void
+      shared_state_base::add_ref (void) noexcept
+      {
+        rtos::scheduler::critical_section scs;
+
+        ++refs_;
+      }
+
+      void
+      shared_state_base::release (void) noexcept
+      {
+        {
+          rtos::scheduler::critical_section scs;
+
+          if (--refs_ != 0)
+            {
+              return;
+            }
+        }
+
+        memory_resource* res = res_;
+        std::size_t size_bytes = size_bytes_;
+
+        // The state is always the first base of the allocated
+        // object, so its address is the address of the storage.
+        this->~shared_state_base ();
+        res->deallocate (this, size_bytes);
+      }
+
+      void
+      shared_state_base::attach_future (void)
+      {
+        lock_guard<mutex> lock
+          { mx_ };
+        if (retrieved_)
+          {
+            __throw_future_error (future_errc::future_already_retrieved,
+                                  "promise");
+          }
+        retrieved_ = true;
+      }
+
+      bool
+      shared_state_base::is_ready (void) noexcept
+      {
+        lock_guard<mutex> lock
+          { mx_ };
+        return ready_;
+      }
+
+      void
+      shared_state_base::wait (void)
+      {
+        unique_lock<mutex> lock
+          { mx_ };
+        if (deferred_)
+          {
+            // Run the function only once, in this thread.
+            deferred_ = false;
+            lock.unlock ();
+
+            run_deferred_ ();
+            return;
+          }
+
+        cv_.wait (lock, [this]
+          { return ready_;});
+      }
+
+      void
+      shared_state_base::break_promise (void) noexcept
+      {
+        unique_lock<mutex> lock
+          { mx_ };
+        if (!ready_)
+          {
+            broken_ = true;
+            make_ready_ (lock);
+          }
+      }
+
+#if defined(__EXCEPTIONS)
+
+      void
+      shared_state_base::set_exception (std::exception_ptr p)
+      {
+        unique_lock<mutex> lock
+          { mx_ };
+        check_not_satisfied_ ();
+
+        exception_ = p;
+        make_ready_ (lock);
+      }
+
+#endif
+
+      void
+      shared_state_base::check_not_satisfied_ (void)
+      {
+        if (ready_)
+          {
+            __throw_future_error (future_errc::promise_already_satisfied,
+                                  "promise");
+          }
+      }
+
+      void
+      shared_state_base::make_ready_ (unique_lock<mutex>& lock) noexcept
+      {
+        ready_ = true;
+        lock.unlock ();
+
+        cv_.notify_all ();
+      }
+
+      void
+      shared_state_base::check_result_ (void)
+      {
+#if defined(__EXCEPTIONS)
+        if (exception_ != nullptr)
+          {
+            std::rethrow_exception (exception_);
+          }
+#endif
+        if (broken_)
+          {
+            __throw_future_error (future_errc::broken_promise, "future");
+          }
+      }
+
+      void
+      shared_state_base::run_deferred_ (void)
+      {
+        ;
+      }
+
+    } /* namespace internal */
+
+    // ========================================================================
+
+    thread_pool::thread_pool (const char* name, rtos::message_queue& queue) noexcept :
+        name_ (name), //
+        queue_ (queue)
+    {
+      trace::printf ("%s() @%p %s\n", __func__, this, name_);
+    }
+
+    thread_pool::~thread_pool ()
+    {
+      trace::printf ("%s() @%p %s\n", __func__, this, name_);
+    }
+
+    /**
+     * @details
+     * If the queue is full, wait until one of the threads
+     * takes the next function.
+     */
+    void
+    thread_pool::submit (func_t function, void* args)
+    {
+      message msg
+        { function, args };
+
+      rtos::result_t res = queue_.send (&msg, sizeof(msg));
+      if (res != rtos::result::ok)
+        {
+          __throw_cmsis_error (static_cast<int> (res), "thread_pool::submit");
+        }
+    }
+
+    void*
+    thread_pool::worker_ (void* args)
+    {
+      thread_pool* self = static_cast<thread_pool*> (args);
+
+      for (;;)
+        {
+          message msg;
+          if (self->queue_.receive (&msg, sizeof(msg)) != rtos::result::ok)
+            {
+              continue;
+            }
+
+          if (msg.function == nullptr)
+            {
+              break;
+            }
+          msg.function (msg.args);
+        }
+
+      return nullptr;
+    }
+
+    void
+    thread_pool::stop_ (std::size_t threads)
+    {
+      for (std::size_t i = 0; i < threads; ++i)
+        {
+          submit (nullptr, nullptr);
+        }
+    }
+
+    // ========================================================================
+
+    thread_pool&
+    get_default_thread_pool (void)
+    {
+      thread_pool* pool;
+        {
+          rtos::scheduler::critical_section scs;
+
+          pool = default_thread_pool;
+        }
+      if (pool != nullptr)
+        {
+          return *pool;
+        }
+
+      // Creating the threads and the queue takes long, so it is
+      // done with the scheduler running; concurrent first calls
+      // wait on the mutex for a single construction. The guard
+      // unlocks the mutex even if the construction throws.
+      lock_guard<rtos::mutex> lock
+        { default_thread_pool_mutex };
+
+      if (!default_thread_pool_constructed)
+        {
+          new (&default_thread_pool_storage) default_thread_pool_t
+            { "async" };
+          default_thread_pool_constructed = true;
+        }
+
+        {
+          rtos::scheduler::critical_section scs;
+
+          // A pool may have been set in the meantime.
+          if (default_thread_pool == nullptr)
+            {
+              default_thread_pool =
+                  reinterpret_cast<default_thread_pool_t*> (&default_thread_pool_storage);
+            }
+          pool = default_thread_pool;
+        }
+
+      return *pool;
+    }
+
+    thread_pool*
+    set_default_thread_pool (thread_pool* pool) noexcept
+    {
+      rtos::scheduler::critical_section scs;
+
+      thread_pool* old = default_thread_pool;
+      default_thread_pool = pool;
+
+      return old;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace estd */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
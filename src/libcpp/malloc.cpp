@@ -36,8 +36,10 @@
 #include <cmsis-plus/iso/malloc.h>
 #include <cmsis-plus/rtos/os.h>
 #include <cmsis-plus/diag/trace.h>
+#include <cmsis-plus/diag/malloc-profiler.h>
 
 #include <cstdlib>
+#include <malloc.h>
 
 using namespace os::rtos;
 
@@ -51,25 +53,15 @@ namespace os
      * pointer to the allocated memory. Currently it calls
      * the C function.
      *
+     * When the allocation profiler is enabled, the allocation is
+     * accounted to the caller.
+     *
      * @note Synchronisation is provided by using a scheduler lock.
      */
     void*
     malloc (std::size_t size) noexcept
     {
-      void* p;
-        {
-          // ----- Begin of critical section ----------------------------------
-          scheduler::critical_section cs;
-
-          p = ::malloc (size);
-
-#if defined(OS_TRACE_LIBC_MALLOC)
-          trace::printf ("estd::%s(%d)=%p\n", __func__, size, p);
-#endif
-          // ----- End of critical section ------------------------------------
-        }
-
-      return p;
+      return internal::malloc (size, __builtin_return_address (0));
     }
 
     /**
@@ -94,9 +86,96 @@ namespace os
 #if defined(OS_TRACE_LIBC_MALLOC)
           trace::printf ("estd::%s(%p)\n", __func__, ptr);
 #endif
+#if defined(OS_INCLUDE_LIBC_MALLOC_PROFILER)
+          return diag::malloc_profiler::internal::deallocate (ptr);
+#else
           return ::free (ptr);
+#endif
           // ----- End of critical section ------------------------------------
         }
     }
+
+    /**
+     * @details
+     * The aligned_alloc() function allocates size bytes of memory
+     * whose address is a multiple of alignment, and returns a
+     * pointer to the allocated memory. Currently it calls
+     * the C `memalign()` function, so the memory can be released
+     * with the usual free().
+     *
+     * The alignment must be a power of two. Useful for DMA buffers
+     * and for objects that must not share cache lines.
+     *
+     * @note Synchronisation is provided by using a scheduler lock.
+     */
+    void*
+    aligned_alloc (std::size_t alignment, std::size_t size) noexcept
+    {
+      return internal::aligned_alloc (alignment, size,
+                                      __builtin_return_address (0));
+    }
+
+    /**
+     * @cond ignore
+     */
+
+    namespace internal
+    {
+      void*
+      malloc (std::size_t size, const void* site __attribute__((unused))) noexcept
+      {
+        void* p;
+          {
+            // ----- Begin of critical section --------------------------------
+            scheduler::critical_section cs;
+
+#if defined(OS_INCLUDE_LIBC_MALLOC_PROFILER)
+            p = diag::malloc_profiler::internal::allocate (size, 0, site);
+#else
+            p = ::malloc (size);
+#endif
+
+#if defined(OS_TRACE_LIBC_MALLOC)
+            trace::printf ("estd::%s(%d)=%p\n", __func__, size, p);
+#endif
+            // ----- End of critical section ----------------------------------
+          }
+
+        return p;
+      }
+
+      void*
+      aligned_alloc (std::size_t alignment, std::size_t size,
+                     const void* site __attribute__((unused))) noexcept
+      {
+        assert((alignment & (alignment - 1)) == 0);
+
+        void* p;
+          {
+            // ----- Begin of critical section --------------------------------
+            scheduler::critical_section cs;
+
+#if defined(OS_INCLUDE_LIBC_MALLOC_PROFILER)
+            p = diag::malloc_profiler::internal::allocate (size, alignment,
+                                                           site);
+#else
+            p = ::memalign (alignment, size);
+#endif
+
+#if defined(OS_TRACE_LIBC_MALLOC)
+            trace::printf ("estd::%s(%d,%d)=%p\n", __func__, alignment, size,
+                           p);
+#endif
+            // ----- End of critical section ----------------------------------
+          }
+
+        return p;
+      }
+    } /* namespace internal */
+
+  /**
+   * @endcond
+   */
+
   } /* namespace estd */
 } /* namespace os */
@@ -34,6 +34,7 @@
  */
 
 #include <cmsis-plus/iso/memory_resource>
+#include <cmsis-plus/rtos/os.h>
 #include <new>
 #include <cstdlib>
 
@@ -52,18 +53,30 @@ namespace
   protected:
 
     virtual void*
-    do_allocate (size_t bytes, size_t alignment __attribute__((unused)))
+    do_allocate (size_t bytes, size_t alignment)
     {
-      // Ignore alignment for now.
-      return ::operator new (bytes);
+      if (alignment <= max_align)
+        {
+          // The usual allocator already guarantees this alignment.
+          return ::operator new (bytes);
+        }
+
+      return os::rtos::memory::internal::allocate_aligned (bytes, alignment);
     }
 
     virtual void
     do_deallocate (void* p, size_t bytes __attribute__((unused)),
-                   size_t alignment __attribute__((unused)))
+                   size_t alignment)
     {
-      // Ignore size and alignment for now.
-      ::operator delete (p);
+      // Ignore size for now.
+      if (alignment <= max_align)
+        {
+          ::operator delete (p);
+        }
+      else
+        {
+          os::rtos::memory::internal::deallocate_aligned (p, alignment);
+        }
     }
 
     virtual bool
@@ -170,6 +183,48 @@ namespace os
       return default_resource;
     }
 
+    // ------------------------------------------------------------------------
+
+    memory_pool_resource::~memory_pool_resource ()
+    {
+      ;
+    }
+
+    void*
+    memory_pool_resource::do_allocate (std::size_t bytes, std::size_t alignment)
+    {
+      // Pool blocks are aligned to the pool allocation element, which
+      // is expected to match the platform maximum alignment.
+      if (bytes <= pool_.block_size () && alignment <= max_align)
+        {
+          void* p = pool_.try_alloc ();
+          if (p != nullptr)
+            {
+              return p;
+            }
+        }
+
+#if defined(__EXCEPTIONS)
+      throw std::bad_alloc ();
+#else
+      std::abort ();
+#endif
+    }
+
+    void
+    memory_pool_resource::do_deallocate (void* p,
+                                         std::size_t bytes __attribute__((unused)),
+                                         std::size_t alignment __attribute__((unused)))
+    {
+      pool_.free (p);
+    }
+
+    bool
+    memory_pool_resource::do_is_equal (memory_resource const & other) const noexcept
+    {
+      return &other == this;
+    }
+
   // ------------------------------------------------------------------------
 
   } /* namespace estd */
@@ -56,6 +56,49 @@ namespace
    * part of the .bss section.
    */
   std::new_handler __new_handler;
+
+  /**
+   * @brief Allocate storage, retrying via the new handler.
+   * @param [in] size Number of bytes.
+   * @param [in] alignment Extended alignment, or 0 for the default.
+   * @param [in] site Call site, used by the allocation profiler.
+   * @return Pointer to storage, or `nullptr` if exceptions are disabled
+   * and the allocation failed.
+   */
+  void*
+  allocate (std::size_t size, std::size_t alignment, const void* site)
+  {
+    if (size == 0)
+      {
+        size = 1;
+      }
+
+    void* p;
+
+    // Synchronisation primitives already used by estd::malloc,
+    // no need to use them again here.
+    while ((p =
+        (alignment == 0) ?
+            os::estd::internal::malloc (size, site) :
+            os::estd::internal::aligned_alloc (alignment, size, site)) == 0)
+      {
+        // If malloc() fails and there is a new_handler,
+        // call it to try free up memory.
+        if (__new_handler)
+          {
+            __new_handler ();
+          }
+        else
+          {
+#if defined(__EXCEPTIONS)
+            throw std::bad_alloc ();
+#else
+            break;
+#endif
+          }
+      }
+    return p;
+  }
 }
 
 namespace std
@@ -120,34 +163,8 @@ operator new (std::size_t size) noexcept(false)
 #else
 operator new (std::size_t size) noexcept
 #endif
-{    //
-  if (size == 0)
-    {
-      size = 1;
-    }
-
-  void* p;
-
-  // Synchronisation primitives already used by estd::malloc,
-  // no need to use them again here.
-  while ((p = os::estd::malloc (size)) == 0)
-    {
-      // If malloc() fails and there is a new_handler,
-      // call it to try free up memory.
-      if (__new_handler)
-        {
-          __new_handler ();
-        }
-      else
-        {
-#if defined(__EXCEPTIONS)
-          throw std::bad_alloc ();
-#else
-          break;
-#endif
-        }
-    }
-  return p;
+{
+  return allocate (size, 0, __builtin_return_address (0));
 }
 
 /**
@@ -173,13 +190,13 @@ operator new (std::size_t size, const std::nothrow_t&) noexcept
 #if defined(__EXCEPTIONS)
   try
     {
-      p = ::operator new (size);
+      p = allocate (size, 0, __builtin_return_address (0));
     }
   catch (...)
     {
     }
 #else
-  p = ::operator new (size);
+  p = allocate (size, 0, __builtin_return_address (0));
 #endif  // __EXCEPTIONS
   return p;
 }
@@ -201,7 +218,7 @@ operator new[] (std::size_t size) noexcept(false)
 operator new[] (std::size_t size) noexcept
 #endif
 {
-  return ::operator new (size);
+  return allocate (size, 0, __builtin_return_address (0));
 }
 
 /**
@@ -221,13 +238,13 @@ operator new[] (std::size_t size, const std::nothrow_t&) noexcept
 #if defined(__EXCEPTIONS)
   try
     {
-      p = ::operator new[] (size);
+      p = allocate (size, 0, __builtin_return_address (0));
     }
   catch (...)
     {
     }
 #else
-  p = ::operator new[] (size);
+  p = allocate (size, 0, __builtin_return_address (0));
 #endif  // __EXCEPTIONS
   return p;
 }
@@ -341,3 +358,160 @@ operator delete[] (void* ptr, const std::nothrow_t&) noexcept
 {
   ::operator delete[] (ptr);
 }
+
+// ----------------------------------------------------------------------------
+
+#if defined(__cpp_aligned_new) || defined(__DOXYGEN__)
+
+/**
+ * @details
+ * The allocation function (C++17 6.7.4.1) called by a new-expression
+ * for types with new-extended alignment (larger than
+ * `alignof(std::max_align_t)`), to allocate size bytes of storage
+ * aligned to the given alignment.
+ *
+ * Return a non-null pointer to suitably aligned storage,
+ * or else throw a bad-alloc exception.
+ *
+ * @note A C++ program may define a function with this function signature
+ * that displaces the default version defined by the C++ standard library.
+ */
+void *
+__attribute__((weak))
+#if defined(__EXCEPTIONS) || defined(__DOXYGEN__)
+operator new (std::size_t size, std::align_val_t alignment) noexcept(false)
+#else
+operator new (std::size_t size, std::align_val_t alignment) noexcept
+#endif
+{
+  return allocate (size, static_cast<std::size_t> (alignment),
+                   __builtin_return_address (0));
+}
+
+/**
+ * @details
+ * Same as new(size, alignment), except that it returns a null pointer
+ * instead of throwing a bad_alloc exception.
+ */
+void*
+__attribute__((weak))
+operator new (std::size_t size, std::align_val_t alignment,
+              const std::nothrow_t&) noexcept
+{
+  void* p = 0;
+#if defined(__EXCEPTIONS)
+  try
+    {
+      p = allocate (size, static_cast<std::size_t> (alignment),
+                    __builtin_return_address (0));
+    }
+  catch (...)
+    {
+    }
+#else
+  p = allocate (size, static_cast<std::size_t> (alignment),
+                __builtin_return_address (0));
+#endif  // __EXCEPTIONS
+  return p;
+}
+
+/**
+ * @details
+ * The array form of the aligned allocation function.
+ */
+void*
+__attribute__((weak))
+#if defined(__EXCEPTIONS) || defined(__DOXYGEN__)
+operator new[] (std::size_t size, std::align_val_t alignment) noexcept(false)
+#else
+operator new[] (std::size_t size, std::align_val_t alignment) noexcept
+#endif
+{
+  return allocate (size, static_cast<std::size_t> (alignment),
+                   __builtin_return_address (0));
+}
+
+/**
+ * @details
+ * The array form of the nothrow aligned allocation function.
+ */
+void*
+__attribute__((weak))
+operator new[] (std::size_t size, std::align_val_t alignment,
+                const std::nothrow_t&) noexcept
+{
+  void* p = 0;
+#if defined(__EXCEPTIONS)
+  try
+    {
+      p = allocate (size, static_cast<std::size_t> (alignment),
+                    __builtin_return_address (0));
+    }
+  catch (...)
+    {
+    }
+#else
+  p = allocate (size, static_cast<std::size_t> (alignment),
+                __builtin_return_address (0));
+#endif  // __EXCEPTIONS
+  return p;
+}
+
+/**
+ * @details
+ * The deallocation function matching the aligned allocation function.
+ *
+ * Since the aligned storage is obtained via `memalign()`, it
+ * can be released with the usual free().
+ */
+void
+__attribute__((weak))
+operator delete (void* ptr, std::align_val_t alignment __attribute__((unused))) noexcept
+{
+  if (ptr)
+    {
+      // Synchronisation primitives used by free()
+      os::estd::free (ptr);
+    }
+}
+
+void
+__attribute__((weak))
+operator delete (void* ptr, std::size_t size __attribute__((unused)),
+                 std::align_val_t alignment) noexcept
+{
+  ::operator delete (ptr, alignment);
+}
+
+void
+__attribute__((weak))
+operator delete (void* ptr, std::align_val_t alignment,
+                 const std::nothrow_t&) noexcept
+{
+  ::operator delete (ptr, alignment);
+}
+
+void
+__attribute__((weak))
+operator delete[] (void* ptr, std::align_val_t alignment) noexcept
+{
+  ::operator delete (ptr, alignment);
+}
+
+void
+__attribute__((weak))
+operator delete[] (void* ptr, std::size_t size __attribute__((unused)),
+                   std::align_val_t alignment) noexcept
+{
+  ::operator delete (ptr, alignment);
+}
+
+void
+__attribute__((weak))
+operator delete[] (void* ptr, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept
+{
+  ::operator delete[] (ptr, alignment);
+}
+
+#endif /* defined(__cpp_aligned_new) */
@@ -61,15 +61,21 @@ namespace os
     {
       if (id_ != id ())
         {
-          void* args = id_.native_thread_->function_args ();
+          os::rtos::thread* th = id_.native_thread_;
+          void* args = th->function_args ();
+
+          // Manually destruct the system thread; it was constructed
+          // in place, at the beginning of the storage block.
+          th->~thread ();
+
           if (args != nullptr && function_object_deleter_ != nullptr)
             {
               // Manually delete the function object used to store arguments.
-              function_object_deleter_ (args);
+              function_object_deleter_ (args, resource_);
             }
 
-          // Manually delete the system thread.
-          delete id_.native_thread_;
+          // The block also includes the function object and the stack.
+          resource_->deallocate (th, allocated_size_bytes_);
         }
     }
 
@@ -93,6 +99,8 @@ namespace os
     {
       std::swap (id_, t.id_);
       std::swap (function_object_deleter_, t.function_object_deleter_);
+      std::swap (resource_, t.resource_);
+      std::swap (allocated_size_bytes_, t.allocated_size_bytes_);
     }
 
     bool
@@ -106,6 +114,13 @@ namespace os
     {
       trace::printf ("%s() @%p\n", __func__, this);
 
+      if (id_ != id ())
+        {
+          // The stack is part of the storage block, so the system
+          // thread must be completely terminated before releasing it.
+          id_.native_thread_->join ();
+        }
+
       delete_system_thread ();
 
       id_ = id ();
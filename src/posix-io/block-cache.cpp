@@ -0,0 +1,330 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/block-cache.h>
+
+#include <cassert>
+#include <cerrno>
+#include <new>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    block_cache::block_cache (block_device& device, std::size_t lines,
+                              std::size_t read_ahead,
+                              rtos::memory::memory_resource* resource) :
+        device_ (device), //
+        resource_ (resource), //
+        lines_count_ (lines), //
+        read_ahead_count_ (read_ahead)
+    {
+      assert(lines_count_ > 0);
+
+      lines_ = static_cast<line*> (resource_->allocate (
+          lines_count_ * sizeof(line), alignof(line)));
+      buffers_ = static_cast<uint8_t*> (resource_->allocate (
+          lines_count_ * device_.block_size ()));
+
+      if (lines_ == nullptr || buffers_ == nullptr)
+        {
+          // Free the one that succeeded, with its real size; the
+          // cache is left without lines and all requests fail.
+          if (buffers_ != nullptr)
+            {
+              resource_->deallocate (buffers_,
+                                     lines_count_ * device_.block_size ());
+              buffers_ = nullptr;
+            }
+          if (lines_ != nullptr)
+            {
+              resource_->deallocate (lines_, lines_count_ * sizeof(line),
+                                     alignof(line));
+              lines_ = nullptr;
+            }
+          lines_count_ = 0;
+          return;
+        }
+
+      // Link all lines, in order, as empty.
+      for (std::size_t i = 0; i < lines_count_; ++i)
+        {
+          line* const ln = new (&lines_[i]) line;
+          ln->prev = (i > 0) ? &lines_[i - 1] : nullptr;
+          ln->next = (i + 1 < lines_count_) ? &lines_[i + 1] : nullptr;
+          ln->data = buffers_ + i * device_.block_size ();
+          ln->blknum = block_device::no_block;
+          ln->dirty = false;
+        }
+
+      mru_ = &lines_[0];
+      lru_ = &lines_[lines_count_ - 1];
+    }
+
+    block_cache::~block_cache () noexcept
+    {
+      sync ();
+
+      if (buffers_ != nullptr)
+        {
+          resource_->deallocate (buffers_,
+                                 lines_count_ * device_.block_size ());
+        }
+      if (lines_ != nullptr)
+        {
+          resource_->deallocate (lines_, lines_count_ * sizeof(line),
+                                 alignof(line));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    const void*
+    block_cache::read (blknum_t blknum)
+    {
+      line* const ln = get_ (blknum, true);
+      if (ln == nullptr)
+        {
+          return nullptr;
+        }
+
+      read_ahead_ (blknum);
+
+      return ln->data;
+    }
+
+    void*
+    block_cache::modify (blknum_t blknum, bool overwrite)
+    {
+      line* const ln = get_ (blknum, !overwrite);
+      if (ln == nullptr)
+        {
+          return nullptr;
+        }
+
+      ln->dirty = true;
+      return ln->data;
+    }
+
+    void
+    block_cache::invalidate (blknum_t blknum)
+    {
+      line* const ln = find_ (blknum);
+      if (ln != nullptr)
+        {
+          ln->blknum = block_device::no_block;
+          ln->dirty = false;
+        }
+    }
+
+    int
+    block_cache::sync (void)
+    {
+      int ret = 0;
+      for (line* ln = mru_; ln != nullptr; ln = ln->next)
+        {
+          if (ln->dirty && write_back_ (ln) < 0)
+            {
+              ret = -1;
+            }
+        }
+
+      if (device_.sync () < 0)
+        {
+          ret = -1;
+        }
+
+      return ret;
+    }
+
+    // ------------------------------------------------------------------------
+
+    block_cache::line*
+    block_cache::find_ (blknum_t blknum)
+    {
+      for (line* ln = mru_; ln != nullptr; ln = ln->next)
+        {
+          if (ln->blknum == blknum)
+            {
+              return ln;
+            }
+        }
+      return nullptr;
+    }
+
+    void
+    block_cache::touch_ (line* ln)
+    {
+      if (ln == mru_)
+        {
+          return;
+        }
+
+      // Unlink.
+      ln->prev->next = ln->next;
+      if (ln->next != nullptr)
+        {
+          ln->next->prev = ln->prev;
+        }
+      else
+        {
+          lru_ = ln->prev;
+        }
+
+      // Link in front.
+      ln->prev = nullptr;
+      ln->next = mru_;
+      mru_->prev = ln;
+      mru_ = ln;
+    }
+
+    int
+    block_cache::write_back_ (line* ln)
+    {
+      if (device_.write_block (ln->data, ln->blknum) < 0)
+        {
+          return -1;
+        }
+
+      ln->dirty = false;
+      return 0;
+    }
+
+    block_cache::line*
+    block_cache::get_ (blknum_t blknum, bool fill)
+    {
+      if (blknum >= device_.num_blocks ())
+        {
+          errno = EINVAL;
+          return nullptr;
+        }
+
+      line* ln = find_ (blknum);
+      if (ln != nullptr)
+        {
+          ++hits_;
+        }
+      else
+        {
+          ++misses_;
+
+          // Reuse the least recently used line.
+          ln = lru_;
+          if (ln == nullptr)
+            {
+              errno = ENOMEM;
+              return nullptr;
+            }
+          if (ln->dirty && write_back_ (ln) < 0)
+            {
+              return nullptr;
+            }
+
+          ln->blknum = block_device::no_block;
+          if (fill && device_.read_block (ln->data, blknum) < 0)
+            {
+              return nullptr;
+            }
+          ln->blknum = blknum;
+        }
+
+      touch_ (ln);
+      return ln;
+    }
+
+    void
+    block_cache::read_ahead_ (blknum_t blknum)
+    {
+      // No previous block is not a predecessor of block 0.
+      bool const sequential = (last_blknum_ != block_device::no_block)
+          && (blknum == last_blknum_ + 1);
+      last_blknum_ = blknum;
+
+      if (!sequential)
+        {
+          return;
+        }
+
+      // Fill only clean lines, which can be reused without writes;
+      // the prefetched blocks are placed, in order, behind the
+      // requested one, which remains the most recently used.
+      line* after = mru_;
+      for (std::size_t i = 1; i <= read_ahead_count_; ++i)
+        {
+          blknum_t const next = blknum + static_cast<blknum_t> (i);
+          if (next >= device_.num_blocks ())
+            {
+              break;
+            }
+
+          if (find_ (next) != nullptr)
+            {
+              continue;
+            }
+
+          line* const ln = lru_;
+          if (ln == mru_ || ln == after || ln->dirty)
+            {
+              break;
+            }
+
+          ln->blknum = block_device::no_block;
+          if (device_.read_block (ln->data, next) < 0)
+            {
+              break;
+            }
+          ln->blknum = next;
+
+          // Unlink from the end and link after the previous one.
+          lru_ = ln->prev;
+          lru_->next = nullptr;
+
+          ln->prev = after;
+          ln->next = after->next;
+          if (after->next != nullptr)
+            {
+              after->next->prev = ln;
+            }
+          else
+            {
+              lru_ = ln;
+            }
+          after->next = ln;
+          after = ln;
+        }
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
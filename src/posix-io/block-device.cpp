@@ -0,0 +1,151 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/block-device.h>
+
+#include <cerrno>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    block_device::block_device (std::size_t block_size_bytes,
+                                blknum_t num_blocks) :
+        block_size_ (block_size_bytes), //
+        num_blocks_ (num_blocks)
+    {
+      ;
+    }
+
+    block_device::~block_device () noexcept
+    {
+      ;
+    }
+
+    // ------------------------------------------------------------------------
+
+    int
+    block_device::read_block (void* buf, blknum_t blknum, std::size_t count)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      if (blknum >= num_blocks_ || count > num_blocks_ - blknum)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      return do_read_block (buf, blknum, count);
+    }
+
+    int
+    block_device::write_block (const void* buf, blknum_t blknum,
+                               std::size_t count)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      if (blknum >= num_blocks_ || count > num_blocks_ - blknum)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      return do_write_block (buf, blknum, count);
+    }
+
+    int
+    block_device::sync (void)
+    {
+      return do_sync ();
+    }
+
+    int
+    block_device::do_sync (void)
+    {
+      return 0;
+    }
+
+    // ========================================================================
+
+    block_device_ram::block_device_ram (
+        std::size_t block_size_bytes, blknum_t num_blocks,
+        rtos::memory::memory_resource* resource) :
+        block_device (block_size_bytes, num_blocks), //
+        resource_ (resource)
+    {
+      storage_ = static_cast<uint8_t*> (resource_->allocate (
+          block_size_ * num_blocks_));
+      if (storage_ == nullptr)
+        {
+          // Without storage, fail all accesses.
+          num_blocks_ = 0;
+        }
+    }
+
+    block_device_ram::~block_device_ram () noexcept
+    {
+      if (storage_ != nullptr)
+        {
+          resource_->deallocate (storage_, block_size_ * num_blocks_);
+        }
+    }
+
+    int
+    block_device_ram::do_read_block (void* buf, blknum_t blknum,
+                                     std::size_t count)
+    {
+      std::memcpy (buf, storage_ + blknum * block_size_, count * block_size_);
+      return 0;
+    }
+
+    int
+    block_device_ram::do_write_block (const void* buf, blknum_t blknum,
+                                      std::size_t count)
+    {
+      std::memcpy (storage_ + blknum * block_size_, buf, count * block_size_);
+      return 0;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
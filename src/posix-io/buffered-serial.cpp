@@ -0,0 +1,605 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/buffered-serial.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    buffered_serial::buffered_serial (const char* name,
+                                      driver::Serial& driver,
+                                      void* rx_buffer, std::size_t rx_size,
+                                      void* tx_buffer, std::size_t tx_size,
+                                      driver::serial::config_t config,
+                                      driver::serial::config_arg_t baudrate) :
+        device (name), //
+        driver_ (driver), //
+        config_ (config), //
+        baudrate_ (baudrate), //
+        rx_buffer_ (static_cast<uint8_t*> (rx_buffer)), //
+        rx_chunk_ (rx_size / 2), //
+        tx_buffer_ (static_cast<uint8_t*> (tx_buffer)), //
+        tx_size_ (tx_size)
+    {
+      assert(rx_buffer != nullptr && rx_chunk_ > 0);
+      assert(tx_buffer != nullptr && tx_size > 0);
+    }
+
+    buffered_serial::~buffered_serial () noexcept
+    {
+      ;
+    }
+
+    // ------------------------------------------------------------------------
+
+    ssize_t
+    buffered_serial::timed_read (void* buf, std::size_t nbyte,
+                                 rtos::clock::duration_t timeout)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return read_ (buf, nbyte, false, timeout);
+    }
+
+    ssize_t
+    buffered_serial::timed_write (const void* buf, std::size_t nbyte,
+                                  rtos::clock::duration_t timeout)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return write_ (buf, nbyte, false, timeout);
+    }
+
+    int
+    buffered_serial::drain (void)
+    {
+      for (;;)
+        {
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            if (tx_level_ == 0)
+              {
+                return 0;
+              }
+            if (tx_error_)
+              {
+                errno = EIO;
+                return -1;
+              }
+            // ----- Exit critical section ------------------------------------
+          }
+
+          if (tx_semaphore_.wait () == EINTR)
+            {
+              errno = EINTR;
+              return -1;
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    int
+    buffered_serial::do_vopen (const char* path, int oflag,
+                               std::va_list args)
+    {
+      oflag_ = oflag;
+
+      rx_head_ = 0;
+      rx_tail_ = 0;
+      rx_level_ = 0;
+      rx_taken_ = 0;
+      rx_active_ = false;
+      rx_error_ = false;
+
+      tx_head_ = 0;
+      tx_tail_ = 0;
+      tx_level_ = 0;
+      tx_sending_ = 0;
+      tx_error_ = false;
+
+      driver_.register_callback (signal_event, this);
+
+      if (driver_.power (driver::Power::full) != driver::RETURN_OK)
+        {
+          driver_.register_callback (nullptr, nullptr);
+          errno = EIO;
+          return -1;
+        }
+
+      if ((driver_.configure (config_, baudrate_) != driver::RETURN_OK)
+          || (driver_.control (driver::serial::Control::enable_tx)
+              != driver::RETURN_OK)
+          || (driver_.control (driver::serial::Control::enable_rx)
+              != driver::RETURN_OK))
+        {
+          driver_.power (driver::Power::off);
+          driver_.register_callback (nullptr, nullptr);
+          errno = EIO;
+          return -1;
+        }
+
+      rx_timeout_event_ = driver_.get_capabilities ().event_rx_timeout;
+
+      {
+        // ----- Enter critical section ---------------------------------------
+        rtos::interrupts::critical_section ics;
+
+        start_rx_ ();
+        // ----- Exit critical section ----------------------------------------
+      }
+
+      return 0;
+    }
+
+#pragma GCC diagnostic pop
+
+    /**
+     * @details
+     * Unless opened with `O_NONBLOCK`, wait for the queued bytes
+     * to be sent; the unread bytes are discarded.
+     */
+    int
+    buffered_serial::do_close (void)
+    {
+      int ret = 0;
+      if ((oflag_ & O_NONBLOCK) == 0)
+        {
+          ret = drain ();
+        }
+
+      driver_.register_callback (nullptr, nullptr);
+
+      driver_.control (driver::serial::Control::abort_send);
+      driver_.control (driver::serial::Control::abort_receive);
+      driver_.control (driver::serial::Control::disable_tx);
+      driver_.control (driver::serial::Control::disable_rx);
+      driver_.power (driver::Power::off);
+
+      {
+        // ----- Enter critical section ---------------------------------------
+        rtos::interrupts::critical_section ics;
+
+        rx_active_ = false;
+        tx_sending_ = 0;
+        // ----- Exit critical section ----------------------------------------
+      }
+
+      return ret;
+    }
+
+    ssize_t
+    buffered_serial::do_read (void* buf, std::size_t nbyte)
+    {
+      return read_ (buf, nbyte, true, 0);
+    }
+
+    ssize_t
+    buffered_serial::do_write (const void* buf, std::size_t nbyte)
+    {
+      return write_ (buf, nbyte, true, 0);
+    }
+
+    int
+    buffered_serial::do_vfcntl (int cmd, std::va_list args)
+    {
+      switch (cmd)
+        {
+        case F_GETFL:
+          return oflag_;
+
+        case F_SETFL:
+          // Only the non blocking mode can be changed.
+          oflag_ = (oflag_ & ~O_NONBLOCK) | (va_arg(args, int) & O_NONBLOCK);
+          return 0;
+
+        default:
+          return device::do_vfcntl (cmd, args);
+        }
+    }
+
+    int
+    buffered_serial::do_isatty (void)
+    {
+      return 1;
+    }
+
+    int
+    buffered_serial::do_poll (int events)
+    {
+      int revents = 0;
+
+      // ----- Enter critical section -----------------------------------------
+      rtos::interrupts::critical_section ics;
+
+      if (rx_available_ () > 0 || rx_error_)
+        {
+          revents |= POLLIN | POLLRDNORM;
+        }
+      if (tx_level_ < tx_size_ || tx_error_)
+        {
+          revents |= POLLOUT | POLLWRNORM;
+        }
+
+      return revents & events;
+      // ----- Exit critical section ------------------------------------------
+    }
+
+    // ------------------------------------------------------------------------
+
+    void
+    buffered_serial::signal_event (const void* object, driver::event_t event)
+    {
+      static_cast<buffered_serial*> (const_cast<void*> (object))->handle_event_ (
+          event);
+    }
+
+    /*
+     * Called from the driver interrupt handler. Account for the
+     * completed transfers, start the next ones and wake up
+     * the waiting threads.
+     */
+    void
+    buffered_serial::handle_event_ (driver::event_t event)
+    {
+      constexpr driver::event_t rx_events =
+          driver::serial::Event::receive_complete
+              | driver::serial::Event::rx_timeout
+              | driver::serial::Event::rx_overflow
+              | driver::serial::Event::rx_break
+              | driver::serial::Event::rx_framing_error
+              | driver::serial::Event::rx_parity_error;
+
+      {
+        // ----- Enter critical section ---------------------------------------
+        rtos::interrupts::critical_section ics;
+
+        if ((event & driver::serial::Event::receive_complete) != 0
+            && rx_active_)
+          {
+            // The bytes already read from this half are no longer
+            // counted as available.
+            rx_level_ += rx_chunk_ - rx_taken_;
+            rx_taken_ = 0;
+            rx_head_ = (rx_head_ + rx_chunk_) % (2 * rx_chunk_);
+            rx_active_ = false;
+
+            start_rx_ ();
+          }
+
+        if ((event & driver::serial::Event::send_complete) != 0
+            && tx_sending_ != 0)
+          {
+            tx_tail_ = (tx_tail_ + tx_sending_) % tx_size_;
+            tx_level_ -= tx_sending_;
+            tx_sending_ = 0;
+
+            start_tx_ ();
+          }
+        // ----- Exit critical section ----------------------------------------
+      }
+
+      if ((event & rx_events) != 0)
+        {
+          rx_semaphore_.post ();
+        }
+      if ((event & driver::serial::Event::send_complete) != 0)
+        {
+          tx_semaphore_.post ();
+        }
+
+      notify_poll ();
+    }
+
+    // ------------------------------------------------------------------------
+
+    ssize_t
+    buffered_serial::read_ (void* buf, std::size_t nbyte, bool forever,
+                            rtos::clock::duration_t timeout)
+    {
+      if (nbyte == 0)
+        {
+          return 0;
+        }
+
+      rtos::clock::timestamp_t const deadline = rtos::sysclock.now ()
+          + timeout;
+
+      for (;;)
+        {
+          std::size_t available;
+          bool error;
+          bool tick;
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            available = rx_available_ ();
+            error = rx_error_;
+            // Without the receive timeout event, the bytes arriving
+            // in the active half are not signalled.
+            tick = rx_active_ && !rx_timeout_event_;
+            // ----- Exit critical section ------------------------------------
+          }
+
+          if (available > 0)
+            {
+              std::size_t const count =
+                  (available < nbyte) ? available : nbyte;
+
+              // The bytes may wrap around the end of the buffer.
+              std::size_t const size = 2 * rx_chunk_;
+              std::size_t const first =
+                  (count < size - rx_tail_) ? count : size - rx_tail_;
+              std::memcpy (buf, rx_buffer_ + rx_tail_, first);
+              std::memcpy (static_cast<uint8_t*> (buf) + first, rx_buffer_,
+                           count - first);
+
+              {
+                // ----- Enter critical section -------------------------------
+                rtos::interrupts::critical_section ics;
+
+                rx_tail_ = (rx_tail_ + count) % size;
+
+                std::size_t const from_level =
+                    (count < rx_level_) ? count : rx_level_;
+                rx_level_ -= from_level;
+                rx_taken_ += count - from_level;
+
+                // A half may have become free.
+                start_rx_ ();
+                // ----- Exit critical section --------------------------------
+              }
+
+              return static_cast<ssize_t> (count);
+            }
+
+          if (error)
+            {
+              errno = EIO;
+              return -1;
+            }
+
+          if ((oflag_ & O_NONBLOCK) != 0)
+            {
+              errno = EAGAIN;
+              return -1;
+            }
+
+          rtos::result_t res;
+          if (forever && !tick)
+            {
+              res = rx_semaphore_.wait ();
+            }
+          else
+            {
+              rtos::clock::duration_t ticks = 1;
+              if (!forever)
+                {
+                  rtos::clock::timestamp_t const now = rtos::sysclock.now ();
+                  if (now >= deadline)
+                    {
+                      errno = ETIMEDOUT;
+                      return -1;
+                    }
+                  if (!tick)
+                    {
+                      ticks =
+                          static_cast<rtos::clock::duration_t> (deadline - now);
+                    }
+                }
+              res = rx_semaphore_.timed_wait (ticks);
+            }
+
+          if (res == EINTR)
+            {
+              errno = EINTR;
+              return -1;
+            }
+        }
+    }
+
+    ssize_t
+    buffered_serial::write_ (const void* buf, std::size_t nbyte, bool forever,
+                             rtos::clock::duration_t timeout)
+    {
+      rtos::clock::timestamp_t const deadline = rtos::sysclock.now ()
+          + timeout;
+
+      const uint8_t* const src = static_cast<const uint8_t*> (buf);
+
+      std::size_t done = 0;
+      while (done < nbyte)
+        {
+          std::size_t space;
+          bool error;
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            space = tx_size_ - tx_level_;
+            error = tx_error_;
+            // ----- Exit critical section ------------------------------------
+          }
+
+          if (error)
+            {
+              errno = EIO;
+              break;
+            }
+
+          if (space == 0)
+            {
+              if ((oflag_ & O_NONBLOCK) != 0)
+                {
+                  errno = EAGAIN;
+                  break;
+                }
+
+              rtos::result_t res;
+              if (forever)
+                {
+                  res = tx_semaphore_.wait ();
+                }
+              else
+                {
+                  rtos::clock::timestamp_t const now = rtos::sysclock.now ();
+                  if (now >= deadline)
+                    {
+                      errno = ETIMEDOUT;
+                      break;
+                    }
+                  res = tx_semaphore_.timed_wait (
+                      static_cast<rtos::clock::duration_t> (deadline - now));
+                }
+
+              if (res == EINTR)
+                {
+                  errno = EINTR;
+                  break;
+                }
+              continue;
+            }
+
+          // Only this thread moves the head, so the free space can
+          // be filled outside the critical section, while the
+          // driver sends the queued bytes.
+          std::size_t const count =
+              (space < nbyte - done) ? space : nbyte - done;
+          std::size_t const first =
+              (count < tx_size_ - tx_head_) ? count : tx_size_ - tx_head_;
+          std::memcpy (tx_buffer_ + tx_head_, src + done, first);
+          std::memcpy (tx_buffer_, src + done + first, count - first);
+
+          {
+            // ----- Enter critical section -----------------------------------
+            rtos::interrupts::critical_section ics;
+
+            tx_head_ = (tx_head_ + count) % tx_size_;
+            tx_level_ += count;
+
+            start_tx_ ();
+            // ----- Exit critical section ------------------------------------
+          }
+
+          done += count;
+        }
+
+      if (done == 0 && nbyte != 0)
+        {
+          return -1;
+        }
+
+      return static_cast<ssize_t> (done);
+    }
+
+    // ------------------------------------------------------------------------
+    // Must be called with interrupts disabled.
+
+    std::size_t
+    buffered_serial::rx_available_ (void)
+    {
+      std::size_t available = rx_level_;
+      if (rx_active_)
+        {
+          available += driver_.get_rx_count () - rx_taken_;
+        }
+      return available;
+    }
+
+    void
+    buffered_serial::start_rx_ (void)
+    {
+      // The next half must be completely read; the unread bytes
+      // end at the head, so they must fit in the other half.
+      if (rx_active_ || rx_error_ || rx_level_ > rx_chunk_)
+        {
+          return;
+        }
+
+      // Set before starting, in case the driver signals the
+      // completion from inside receive().
+      rx_active_ = true;
+      if (driver_.receive (rx_buffer_ + rx_head_, rx_chunk_)
+          != driver::RETURN_OK)
+        {
+          rx_active_ = false;
+          rx_error_ = true;
+        }
+    }
+
+    void
+    buffered_serial::start_tx_ (void)
+    {
+      if (tx_sending_ != 0 || tx_level_ == 0 || tx_error_)
+        {
+          return;
+        }
+
+      // Send the contiguous bytes; the rest, if any, is sent
+      // when this transfer completes.
+      std::size_t const count =
+          (tx_level_ < tx_size_ - tx_tail_) ? tx_level_ : tx_size_ - tx_tail_;
+
+      tx_sending_ = count;
+      if (driver_.send (tx_buffer_ + tx_tail_, count) != driver::RETURN_OK)
+        {
+          tx_sending_ = 0;
+          tx_error_ = true;
+        }
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,933 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/os-app-config.h>
+
+#if defined(OS_USE_POSIX_IO_SYSCALLS)
+
+#if defined(OS_USE_SEMIHOSTING_SYSCALLS)
+#error "OS_USE_POSIX_IO_SYSCALLS and OS_USE_SEMIHOSTING_SYSCALLS are exclusive"
+#endif
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix-io/io.h>
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/posix-io/file.h>
+#include <cmsis-plus/posix-io/socket.h>
+#include <cmsis-plus/posix-io/file-system.h>
+#include <cmsis-plus/posix-io/directory.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cmsis-plus/posix/dirent.h>
+#include <cmsis-plus/posix/sys/socket.h>
+#include <cmsis-plus/posix/sys/select.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/times.h>
+#include <time.h>
+
+// ----------------------------------------------------------------------------
+
+// Notes: Function prefix.
+//
+// As for the semihosting system calls, all function names are
+// prefixed with '__posix_'; the aliases to the standard names are
+// added at the end, for embedded platforms.
+//
+// The I/O functions translate the file descriptor (an index in
+// a static array) to the I/O object and call its member function;
+// there are no intermediate buffers, the data goes directly
+// between the user buffers and the device drivers.
+
+using namespace os;
+using namespace os::posix;
+
+// ----------------------------------------------------------------------------
+// ---- POSIX IO functions ----------------------------------------------------
+
+int
+__posix_open (const char* path, int oflag, ...)
+{
+  // Forward to the variadic version of the function.
+  std::va_list args;
+  va_start(args, oflag);
+  io* const pio = posix::vopen (path, oflag, args);
+  va_end(args);
+
+  if (pio == nullptr)
+    {
+      return -1;
+    }
+
+  return pio->file_descriptor ();
+}
+
+int
+__posix_close (int fildes)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->close ();
+}
+
+ssize_t
+__posix_read (int fildes, void* buf, size_t nbyte)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->read (buf, nbyte);
+}
+
+ssize_t
+__posix_write (int fildes, const void* buf, size_t nbyte)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->write (buf, nbyte);
+}
+
+ssize_t
+__posix_readv (int fildes, const struct iovec* iov, int iovcnt)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->readv (iov, iovcnt);
+}
+
+ssize_t
+__posix_writev (int fildes, const struct iovec* iov, int iovcnt)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->writev (iov, iovcnt);
+}
+
+int
+__posix_ioctl (int fildes, int request, ...)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  if (pio->get_type () != io::type::device)
+    {
+      errno = ENOTTY; // Not a device
+      return -1;
+    }
+
+  // Forward to the variadic version of the function.
+  std::va_list args;
+  va_start(args, request);
+  int const ret = static_cast<device*> (pio)->vioctl (request, args);
+  va_end(args);
+
+  return ret;
+}
+
+int
+__posix_fcntl (int fildes, int cmd, ...)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  // Forward to the variadic version of the function.
+  std::va_list args;
+  va_start(args, cmd);
+  int const ret = pio->vfcntl (cmd, args);
+  va_end(args);
+
+  return ret;
+}
+
+off_t
+__posix_lseek (int fildes, off_t offset, int whence)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  if (pio->get_type () != io::type::file)
+    {
+      errno = ESPIPE; // Not seekable
+      return -1;
+    }
+
+  return static_cast<file*> (pio)->lseek (offset, whence);
+}
+
+int
+__posix_isatty (int fildes)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return 0;
+    }
+
+  return pio->isatty ();
+}
+
+int
+__posix_fstat (int fildes, struct stat* buf)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return pio->fstat (buf);
+}
+
+int
+__posix_ftruncate (int fildes, off_t length)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  if (pio->get_type () != io::type::file)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return static_cast<file*> (pio)->ftruncate (length);
+}
+
+int
+__posix_fsync (int fildes)
+{
+  io* const pio = file_descriptors_manager::get_io (fildes);
+  if (pio == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  if (pio->get_type () != io::type::file)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  return static_cast<file*> (pio)->fsync ();
+}
+
+int
+__posix_select (int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds,
+                struct timeval* timeout)
+{
+  return posix::select (nfds, readfds, writefds, errorfds, timeout);
+}
+
+int
+__posix_poll (struct pollfd fds[], nfds_t nfds, int timeout)
+{
+  return posix::poll (fds, nfds, timeout);
+}
+
+// ----------------------------------------------------------------------------
+// Socket functions
+
+// socket() and socketpair() are the fuctions creating sockets;
+// they require a network stack, which is not available yet.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+int
+__posix_socket (int domain, int type, int protocol)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_socketpair (int domain, int type, int protocol, int socket_vector[2])
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+ssize_t
+__posix_recvmsg (int socket, struct msghdr* message, int flags)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+ssize_t
+__posix_sendmsg (int socket, const struct msghdr* message, int flags)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_sockatmark (int socket)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+#pragma GCC diagnostic pop
+
+int
+__posix_accept (int socket, struct sockaddr* address, socklen_t* address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  class socket* const new_socket = sock->accept (address, address_len);
+  if (new_socket == nullptr)
+    {
+      return -1;
+    }
+
+  return new_socket->file_descriptor ();
+}
+
+int
+__posix_bind (int socket, const struct sockaddr* address, socklen_t address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->bind (address, address_len);
+}
+
+int
+__posix_connect (int socket, const struct sockaddr* address,
+                 socklen_t address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->connect (address, address_len);
+}
+
+int
+__posix_getpeername (int socket, struct sockaddr* address,
+                     socklen_t* address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->getpeername (address, address_len);
+}
+
+int
+__posix_getsockname (int socket, struct sockaddr* address,
+                     socklen_t* address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->getsockname (address, address_len);
+}
+
+int
+__posix_getsockopt (int socket, int level, int option_name, void* option_value,
+                    socklen_t* option_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->getsockopt (level, option_name, option_value, option_len);
+}
+
+int
+__posix_listen (int socket, int backlog)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->listen (backlog);
+}
+
+ssize_t
+__posix_recv (int socket, void* buffer, size_t length, int flags)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->recv (buffer, length, flags);
+}
+
+ssize_t
+__posix_recvfrom (int socket, void* buffer, size_t length, int flags,
+                  struct sockaddr* address, socklen_t* address_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->recvfrom (buffer, length, flags, address, address_len);
+}
+
+ssize_t
+__posix_send (int socket, const void* buffer, size_t length, int flags)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->send (buffer, length, flags);
+}
+
+ssize_t
+__posix_sendto (int socket, const void* message, size_t length, int flags,
+                const struct sockaddr* dest_addr, socklen_t dest_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->sendto (message, length, flags, dest_addr, dest_len);
+}
+
+int
+__posix_setsockopt (int socket, int level, int option_name,
+                    const void* option_value, socklen_t option_len)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->setsockopt (level, option_name, option_value, option_len);
+}
+
+int
+__posix_shutdown (int socket, int how)
+{
+  class socket* const sock = file_descriptors_manager::get_socket (socket);
+  if (sock == nullptr)
+    {
+      errno = ENOTSOCK;
+      return -1;
+    }
+
+  return sock->shutdown (how);
+}
+
+// ----------------------------------------------------------------------------
+// ----- POSIX File & FileSystem functions -----
+
+// The paths are absolute; the file system is identified by the
+// longest mount path, and gets the path relative to it.
+
+namespace
+{
+  file_system*
+  find_file_system (const char** path)
+  {
+    if (*path == nullptr)
+      {
+        errno = EFAULT;
+        return nullptr;
+      }
+
+    file_system* const fs = file_system::identify_file_system (path);
+    if (fs == nullptr)
+      {
+        errno = ENOENT;
+      }
+    return fs;
+  }
+} /* namespace */
+
+int
+__posix_stat (const char* path, struct stat* buf)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->stat (path, buf);
+}
+
+int
+__posix_truncate (const char* path, off_t length)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->truncate (path, length);
+}
+
+int
+__posix_rename (const char* existing, const char* _new)
+{
+  file_system* const fs = find_file_system (&existing);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  file_system* const new_fs = find_file_system (&_new);
+  if (new_fs == nullptr)
+    {
+      return -1;
+    }
+
+  if (new_fs != fs)
+    {
+      // Moving between file systems requires copying.
+      errno = EXDEV;
+      return -1;
+    }
+
+  return fs->rename (existing, _new);
+}
+
+int
+__posix_unlink (const char* path)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->unlink (path);
+}
+
+int
+__posix_utime (const char* path, const struct utimbuf* times)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->utime (path, times);
+}
+
+int
+__posix_chmod (const char* path, mode_t mode)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->chmod (path, mode);
+}
+
+int
+__posix_mkdir (const char* path, mode_t mode)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->mkdir (path, mode);
+}
+
+int
+__posix_rmdir (const char* path)
+{
+  file_system* const fs = find_file_system (&path);
+  if (fs == nullptr)
+    {
+      return -1;
+    }
+
+  return fs->rmdir (path);
+}
+
+void
+__posix_sync (void)
+{
+  file_system::sync_all ();
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+int
+__posix_chdir (const char* path)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+#pragma GCC diagnostic pop
+
+char*
+__posix_getcwd (char* buf, size_t size)
+{
+  if (buf == nullptr || size < 2)
+    {
+      errno = (buf == nullptr) ? EINVAL : ERANGE;
+      return nullptr;
+    }
+
+  std::strcpy (buf, "/");
+  return buf;
+}
+
+// ----------------------------------------------------------------------------
+// ----- Directories functions -----
+
+// The DIR* returned to the application is the directory object.
+
+DIR*
+__posix_opendir (const char* dirpath)
+{
+  file_system* const fs = find_file_system (&dirpath);
+  if (fs == nullptr)
+    {
+      return nullptr;
+    }
+
+  return reinterpret_cast<DIR*> (fs->opendir (dirpath));
+}
+
+struct dirent*
+__posix_readdir (DIR* dirp)
+{
+  if (dirp == nullptr)
+    {
+      errno = EBADF;
+      return nullptr;
+    }
+
+  return reinterpret_cast<directory*> (dirp)->read ();
+}
+
+int
+__posix_readdir_r (DIR* dirp, struct dirent* entry, struct dirent** result)
+{
+  if (dirp == nullptr || entry == nullptr || result == nullptr)
+    {
+      return EBADF;
+    }
+
+  int const saved_errno = errno;
+  errno = 0;
+  struct dirent* const ent = reinterpret_cast<directory*> (dirp)->read ();
+  int const err = errno;
+  errno = saved_errno;
+
+  if (ent == nullptr)
+    {
+      *result = nullptr;
+      return err;
+    }
+
+  std::memcpy (entry, ent, sizeof(struct dirent));
+  *result = entry;
+  return 0;
+}
+
+void
+__posix_rewinddir (DIR* dirp)
+{
+  if (dirp != nullptr)
+    {
+      reinterpret_cast<directory*> (dirp)->rewind ();
+    }
+}
+
+int
+__posix_closedir (DIR* dirp)
+{
+  if (dirp == nullptr)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  return reinterpret_cast<directory*> (dirp)->close ();
+}
+
+// ----------------------------------------------------------------------------
+// ----- Time functions -----
+
+int
+__posix_gettimeofday (struct timeval* ptimeval, void* ptimezone)
+{
+  struct timezone* tzp = static_cast<struct timezone*> (ptimezone);
+  if (ptimeval)
+    {
+      // The real time clock counts seconds since the epoch.
+      ptimeval->tv_sec = static_cast<time_t> (rtos::rtclock.now ());
+      ptimeval->tv_usec = 0;
+    }
+
+  // Return fixed data for the time zone.
+  if (tzp)
+    {
+      tzp->tz_minuteswest = 0;
+      tzp->tz_dsttime = 0;
+    }
+
+  return 0;
+}
+
+clock_t
+__posix_clock (void)
+{
+  // Scale the system clock ticks to CLOCKS_PER_SEC.
+  return static_cast<clock_t> (rtos::sysclock.now () * CLOCKS_PER_SEC
+      / rtos::clock_systick::frequency_hz);
+}
+
+clock_t
+__posix_times (struct tms* buf)
+{
+  clock_t timeval = __posix_clock ();
+  if (buf)
+    {
+      buf->tms_utime = timeval; // user time
+      buf->tms_stime = 0; // system time
+      buf->tms_cutime = 0; // user time, children
+      buf->tms_cstime = 0; // system time, children
+    }
+
+  return timeval;
+}
+
+// ----------------------------------------------------------------------------
+// Unavailable in non-Unix embedded environments.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+int
+__posix_system (const char *command)
+{
+  if (command == nullptr)
+    {
+      return 0; // No shell available.
+    }
+
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_execve (const char* path, char* const argv[], char* const envp[])
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+pid_t
+__posix_fork (void)
+{
+  errno = ENOSYS; // Not implemented
+  return ((pid_t) -1);
+}
+
+pid_t
+__posix_getpid (void)
+{
+  return 1;
+}
+
+int
+__posix_kill (pid_t pid, int sig)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_raise (int sig)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+pid_t
+__posix_wait (int* stat_loc)
+{
+  errno = ENOSYS; // Not implemented
+  return ((pid_t) -1);
+}
+
+int
+__posix_chown (const char* path, uid_t owner, gid_t group)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_link (const char* existing, const char* _new)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+int
+__posix_symlink (const char* existing, const char* _new)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
+ssize_t
+__posix_readlink (const char* path, char* buf, size_t bufsize)
+{
+  errno = ENOSYS; // Not implemented
+  return ((ssize_t) -1);
+}
+
+#pragma GCC diagnostic pop
+
+// ----------------------------------------------------------------------------
+
+#if defined(__ARM_EABI__) && (__STDC_HOSTED__ != 0)
+
+// The aliases must be in the same compilation unit as the names
+// they alias.
+
+#if defined(OS_INCLUDE_NEWLIB_POSIX_FUNCTIONS)
+
+// For special embedded environment that use POSIX system calls
+// with the newlib reentrant code, redefine
+// some functions with _name(), others directly with name().
+
+#include <cmsis-plus/posix-io/newlib-aliases.h>
+
+#else
+
+// For regular embedded environment that use POSIX system calls,
+// redefine **all** functions without the '__posix_' prefix.
+
+#include <cmsis-plus/posix-io/standard-aliases.h>
+
+#endif
+
+#endif /* defined(__ARM_EABI__) && (__STDC_HOSTED__ != 0) */
+
+#endif /* defined(OS_USE_POSIX_IO_SYSCALLS) */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/device-registry.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    // Zero initialised, so devices can be linked by static constructors
+    // regardless of the initialisation order.
+    device* device_registry::head_;
+
+    // ------------------------------------------------------------------------
+
+    void
+    device_registry::link (device* dev)
+    {
+      rtos::scheduler::critical_section scs;
+
+      dev->next_ = head_;
+      head_ = dev;
+    }
+
+    void
+    device_registry::unlink (device* dev)
+    {
+      rtos::scheduler::critical_section scs;
+
+      for (device** p = &head_; *p != nullptr; p = &((*p)->next_))
+        {
+          if (*p == dev)
+            {
+              *p = dev->next_;
+              dev->next_ = nullptr;
+              break;
+            }
+        }
+    }
+
+    device*
+    device_registry::identify_device (const char* path)
+    {
+      const char* const prefix = device::device_prefix ();
+      std::size_t const len = std::strlen (prefix);
+
+      if (std::strncmp (path, prefix, len) != 0)
+        {
+          return nullptr;
+        }
+
+      const char* const name = path + len;
+
+      rtos::scheduler::critical_section scs;
+
+      for (device* p = head_; p != nullptr; p = p->next_)
+        {
+          if (p->match_name (name))
+            {
+              return p;
+            }
+        }
+
+      return nullptr;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/posix-io/device-registry.h>
+
+#include <cerrno>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    device::device (const char* name) :
+        io (type::device), //
+        name_ (name)
+    {
+      device_registry::link (this);
+    }
+
+    device::~device () noexcept
+    {
+      device_registry::unlink (this);
+    }
+
+    // ------------------------------------------------------------------------
+
+    int
+    device::open (const char* path, int oflag, ...)
+    {
+      // Forward to the variadic version of the function.
+      std::va_list args;
+      va_start(args, oflag);
+      int const ret = vopen (path, oflag, args);
+      va_end(args);
+
+      return ret;
+    }
+
+    int
+    device::vopen (const char* path, int oflag, std::va_list args)
+    {
+      if (is_opened_)
+        {
+          errno = EBUSY;
+          return -1;
+        }
+
+      int const ret = do_vopen (path, oflag, args);
+      if (ret >= 0)
+        {
+          is_opened_ = true;
+        }
+
+      return ret;
+    }
+
+    int
+    device::ioctl (int request, ...)
+    {
+      // Forward to the variadic version of the function.
+      std::va_list args;
+      va_start(args, request);
+      int const ret = vioctl (request, args);
+      va_end(args);
+
+      return ret;
+    }
+
+    int
+    device::vioctl (int request, std::va_list args)
+    {
+      return do_vioctl (request, args);
+    }
+
+    bool
+    device::match_name (const char* name) const
+    {
+      return (std::strcmp (name, name_) == 0);
+    }
+
+    // ------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    int
+    device::do_vioctl (int request, std::va_list args)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+#pragma GCC diagnostic pop
+
+    void
+    device::do_release (void)
+    {
+      is_opened_ = false;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
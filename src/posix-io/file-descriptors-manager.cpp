@@ -0,0 +1,130 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+#include <cmsis-plus/posix-io/socket.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cerrno>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    io* file_descriptors_manager::descriptors_array_[OS_INTEGER_POSIX_IO_MAX_OPEN_FILES];
+
+    // ------------------------------------------------------------------------
+
+    socket*
+    file_descriptors_manager::get_socket (int fildes)
+    {
+      io* const pio = get_io (fildes);
+      if (pio == nullptr || pio->get_type () != io::type::socket)
+        {
+          return nullptr;
+        }
+
+      return static_cast<socket*> (pio);
+    }
+
+    int
+    file_descriptors_manager::alloc (io* pio)
+    {
+      rtos::scheduler::critical_section scs;
+
+      for (std::size_t i = 0; i < size (); ++i)
+        {
+          if (descriptors_array_[i] == nullptr)
+            {
+              descriptors_array_[i] = pio;
+              pio->file_descriptor (static_cast<int> (i));
+
+              return static_cast<int> (i);
+            }
+        }
+
+      errno = EMFILE;
+      return -1;
+    }
+
+    int
+    file_descriptors_manager::assign (int fildes, io* pio)
+    {
+      if (!valid (fildes))
+        {
+          errno = EBADF;
+          return -1;
+        }
+
+      rtos::scheduler::critical_section scs;
+
+      if (descriptors_array_[fildes] != nullptr)
+        {
+          errno = EBADF;
+          return -1;
+        }
+
+      descriptors_array_[fildes] = pio;
+      pio->file_descriptor (fildes);
+
+      return fildes;
+    }
+
+    int
+    file_descriptors_manager::free (int fildes)
+    {
+      if (!valid (fildes))
+        {
+          errno = EBADF;
+          return -1;
+        }
+
+      rtos::scheduler::critical_section scs;
+
+      io* const pio = descriptors_array_[fildes];
+      if (pio == nullptr)
+        {
+          errno = EBADF;
+          return -1;
+        }
+
+      pio->clear_file_descriptor ();
+      descriptors_array_[fildes] = nullptr;
+
+      return 0;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,1262 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/file-system-ram.h>
+#include <cmsis-plus/posix-io/file.h>
+#include <cmsis-plus/posix-io/directory.h>
+#include <cmsis-plus/iso/mutex>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    namespace
+    {
+      using lock_guard = estd::lock_guard<rtos::mutex>;
+
+      // The longest name which fits in a directory entry.
+      constexpr std::size_t name_max = sizeof(((struct dirent*) 0)->d_name)
+          - 1;
+
+      inline time_t
+      now (void)
+      {
+        return static_cast<time_t> (rtos::rtclock.now ());
+      }
+    } /* namespace */
+
+    // ========================================================================
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+    struct file_system_ram::node
+    {
+      node* parent;
+      node* first_child;
+      node* next_sibling;
+
+      char* name;
+      std::size_t name_length;
+
+      // Map of file blocks to device blocks; no_block for holes.
+      blknum_t* blocks;
+      std::size_t blocks_capacity;
+
+      off_t size;
+      time_t mtime;
+      ino_t ino;
+      mode_t mode;
+
+      // Open files and directories; the node is freed after the last
+      // close if it was removed meanwhile.
+      unsigned int open_count;
+      bool removed;
+
+      bool
+      is_dir (void) const
+      {
+        return S_ISDIR(mode);
+      }
+    };
+
+    // ========================================================================
+
+    class file_system_ram::file_ram : public file
+    {
+    public:
+
+      file_ram (file_system_ram& fs, node* n, int oflag) :
+          file (fs), //
+          node_ (n), //
+          oflag_ (oflag)
+      {
+        ;
+      }
+
+    protected:
+
+      virtual ssize_t
+      do_read (void* buf, std::size_t nbyte) override
+      {
+        if ((oflag_ & O_ACCMODE) == O_WRONLY)
+          {
+            errno = EBADF;
+            return -1;
+          }
+
+        lock_guard lock
+          { fs ().mutex_ };
+
+        ssize_t const ret = fs ().read_ (node_, offset_, buf, nbyte);
+        if (ret > 0)
+          {
+            offset_ += ret;
+          }
+        return ret;
+      }
+
+      virtual ssize_t
+      do_write (const void* buf, std::size_t nbyte) override
+      {
+        if ((oflag_ & O_ACCMODE) == O_RDONLY)
+          {
+            errno = EBADF;
+            return -1;
+          }
+
+        lock_guard lock
+          { fs ().mutex_ };
+
+        if ((oflag_ & O_APPEND) != 0)
+          {
+            offset_ = node_->size;
+          }
+
+        ssize_t const ret = fs ().write_ (node_, offset_, buf, nbyte);
+        if (ret > 0)
+          {
+            offset_ += ret;
+          }
+        return ret;
+      }
+
+      virtual off_t
+      do_lseek (off_t offset, int whence) override
+      {
+        lock_guard lock
+          { fs ().mutex_ };
+
+        off_t base;
+        switch (whence)
+          {
+          case SEEK_SET:
+            base = 0;
+            break;
+          case SEEK_CUR:
+            base = offset_;
+            break;
+          case SEEK_END:
+            base = node_->size;
+            break;
+          default:
+            errno = EINVAL;
+            return -1;
+          }
+
+        if (base + offset < 0)
+          {
+            errno = EINVAL;
+            return -1;
+          }
+
+        offset_ = base + offset;
+        return offset_;
+      }
+
+      virtual int
+      do_ftruncate (off_t length) override
+      {
+        if ((oflag_ & O_ACCMODE) == O_RDONLY)
+          {
+            errno = EBADF;
+            return -1;
+          }
+
+        lock_guard lock
+          { fs ().mutex_ };
+
+        return fs ().resize_ (node_, length);
+      }
+
+      virtual int
+      do_fsync (void) override
+      {
+        lock_guard lock
+          { fs ().mutex_ };
+
+        return fs ().cache_.sync ();
+      }
+
+      virtual int
+      do_fstat (struct stat* buf) override
+      {
+        lock_guard lock
+          { fs ().mutex_ };
+
+        fs ().fill_stat_ (node_, buf);
+        return 0;
+      }
+
+      virtual int
+      do_vfcntl (int cmd, std::va_list args) override
+      {
+        switch (cmd)
+          {
+          case F_GETFL:
+            return oflag_;
+
+          case F_SETFL:
+            // Only the append mode can be changed.
+            oflag_ = (oflag_ & ~O_APPEND) | (va_arg(args, int) & O_APPEND);
+            return 0;
+
+          default:
+            errno = EINVAL;
+            return -1;
+          }
+      }
+
+      virtual void
+      do_release (void) override
+      {
+        file_system_ram& f = fs ();
+          {
+            lock_guard lock
+              { f.mutex_ };
+
+            f.release_node_ (node_);
+          }
+
+        this->~file_ram ();
+        f.resource_->deallocate (this, sizeof(file_ram), alignof(file_ram));
+      }
+
+    private:
+
+      file_system_ram&
+      fs (void)
+      {
+        return static_cast<file_system_ram&> (*file_system_);
+      }
+
+      node* node_;
+      off_t offset_ = 0;
+      int oflag_;
+    };
+
+    // ========================================================================
+
+    class file_system_ram::directory_ram : public directory
+    {
+    public:
+
+      directory_ram (file_system_ram& fs, node* n) :
+          directory (fs), //
+          node_ (n)
+      {
+        ;
+      }
+
+    protected:
+
+      virtual struct dirent*
+      do_read (void) override
+      {
+        lock_guard lock
+          { fs ().mutex_ };
+
+        // Count the entries, instead of keeping a pointer, which
+        // would become invalid if the entry were removed.
+        node* child = node_->first_child;
+        for (std::size_t i = 0; i < position_ && child != nullptr; ++i)
+          {
+            child = child->next_sibling;
+          }
+
+        if (child == nullptr)
+          {
+            return nullptr;
+          }
+        ++position_;
+
+        dir_entry_.d_ino = child->ino;
+        std::memcpy (dir_entry_.d_name, child->name, child->name_length + 1);
+
+        return &dir_entry_;
+      }
+
+      virtual void
+      do_rewind (void) override
+      {
+        position_ = 0;
+      }
+
+      virtual void
+      do_release (void) override
+      {
+        file_system_ram& f = fs ();
+          {
+            lock_guard lock
+              { f.mutex_ };
+
+            f.release_node_ (node_);
+          }
+
+        this->~directory_ram ();
+        f.resource_->deallocate (this, sizeof(directory_ram),
+                                 alignof(directory_ram));
+      }
+
+    private:
+
+      file_system_ram&
+      fs (void)
+      {
+        return static_cast<file_system_ram&> (*file_system_);
+      }
+
+      node* node_;
+      std::size_t position_ = 0;
+    };
+
+#pragma GCC diagnostic pop
+
+    // ========================================================================
+
+    file_system_ram::file_system_ram (block_cache& cache,
+                                      rtos::memory::memory_resource* resource) :
+        cache_ (cache), //
+        resource_ (resource)
+    {
+      std::size_t const words = (cache_.device ().num_blocks () + 31) / 32;
+      bitmap_ = static_cast<uint32_t*> (resource_->allocate (
+          words * sizeof(uint32_t), alignof(uint32_t)));
+      if (bitmap_ != nullptr)
+        {
+          std::memset (bitmap_, 0, words * sizeof(uint32_t));
+          free_blocks_ = cache_.device ().num_blocks ();
+        }
+
+      root_ = create_node_ (nullptr, "", 0, S_IFDIR | 0777);
+    }
+
+    file_system_ram::~file_system_ram () noexcept
+    {
+      umount ();
+
+      if (root_ != nullptr)
+        {
+          destroy_tree_ (root_);
+        }
+
+      if (bitmap_ != nullptr)
+        {
+          std::size_t const words = (cache_.device ().num_blocks () + 31) / 32;
+          resource_->deallocate (bitmap_, words * sizeof(uint32_t),
+                                 alignof(uint32_t));
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    file*
+    file_system_ram::do_vopen (const char* path, int oflag, std::va_list args)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      const char* name;
+      std::size_t name_length;
+      node* const parent = lookup_ (path, &name, &name_length);
+      if (parent == nullptr)
+        {
+          return nullptr;
+        }
+
+      node* n =
+          (name_length == 0) ?
+              parent : find_child_ (parent, name, name_length);
+      if (n != nullptr)
+        {
+          if ((oflag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+            {
+              errno = EEXIST;
+              return nullptr;
+            }
+          if (n->is_dir ())
+            {
+              errno = EISDIR;
+              return nullptr;
+            }
+        }
+      else
+        {
+          if ((oflag & O_CREAT) == 0)
+            {
+              errno = ENOENT;
+              return nullptr;
+            }
+
+          mode_t const mode = static_cast<mode_t> (va_arg(args, int));
+          n = create_node_ (parent, name, name_length,
+          S_IFREG | (mode & 0777));
+          if (n == nullptr)
+            {
+              return nullptr;
+            }
+        }
+
+      if ((oflag & O_TRUNC) != 0 && (oflag & O_ACCMODE) != O_RDONLY)
+        {
+          if (resize_ (n, 0) < 0)
+            {
+              return nullptr;
+            }
+        }
+
+      void* const p = resource_->allocate (sizeof(file_ram),
+                                           alignof(file_ram));
+      if (p == nullptr)
+        {
+          errno = ENOMEM;
+          return nullptr;
+        }
+
+      ++n->open_count;
+      return new (p) file_ram (*this, n, oflag);
+    }
+
+    directory*
+    file_system_ram::do_opendir (const char* path)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return nullptr;
+        }
+
+      if (!n->is_dir ())
+        {
+          errno = ENOTDIR;
+          return nullptr;
+        }
+
+      void* const p = resource_->allocate (sizeof(directory_ram),
+                                           alignof(directory_ram));
+      if (p == nullptr)
+        {
+          errno = ENOMEM;
+          return nullptr;
+        }
+
+      ++n->open_count;
+      return new (p) directory_ram (*this, n);
+    }
+
+    int
+    file_system_ram::do_mkdir (const char* path, mode_t mode)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      const char* name;
+      std::size_t name_length;
+      node* const parent = lookup_ (path, &name, &name_length);
+      if (parent == nullptr)
+        {
+          return -1;
+        }
+
+      if (name_length == 0 || find_child_ (parent, name, name_length))
+        {
+          errno = EEXIST;
+          return -1;
+        }
+
+      if (create_node_ (parent, name, name_length, S_IFDIR | (mode & 0777))
+          == nullptr)
+        {
+          return -1;
+        }
+
+      return 0;
+    }
+
+    int
+    file_system_ram::do_rmdir (const char* path)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      if (!n->is_dir ())
+        {
+          errno = ENOTDIR;
+          return -1;
+        }
+
+      if (n == root_)
+        {
+          errno = EBUSY;
+          return -1;
+        }
+
+      if (n->first_child != nullptr)
+        {
+          errno = ENOTEMPTY;
+          return -1;
+        }
+
+      return remove_ (n);
+    }
+
+    int
+    file_system_ram::do_unlink (const char* path)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      if (n->is_dir ())
+        {
+          errno = EISDIR;
+          return -1;
+        }
+
+      return remove_ (n);
+    }
+
+    int
+    file_system_ram::do_rename (const char* existing, const char* _new)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const src = lookup_ (existing);
+      if (src == nullptr)
+        {
+          return -1;
+        }
+
+      const char* name;
+      std::size_t name_length;
+      node* const parent = lookup_ (_new, &name, &name_length);
+      if (parent == nullptr)
+        {
+          return -1;
+        }
+
+      if (src == root_ || name_length == 0)
+        {
+          errno = EBUSY;
+          return -1;
+        }
+
+      // A directory cannot be moved below itself.
+      for (node* p = parent; p != root_; p = p->parent)
+        {
+          if (p == src)
+            {
+              errno = EINVAL;
+              return -1;
+            }
+        }
+
+      node* const dst = find_child_ (parent, name, name_length);
+      if (dst == src)
+        {
+          return 0;
+        }
+
+      if (dst != nullptr)
+        {
+          if (src->is_dir () && !dst->is_dir ())
+            {
+              errno = ENOTDIR;
+              return -1;
+            }
+          if (!src->is_dir () && dst->is_dir ())
+            {
+              errno = EISDIR;
+              return -1;
+            }
+          if (dst->first_child != nullptr)
+            {
+              errno = ENOTEMPTY;
+              return -1;
+            }
+        }
+
+      // Allocate the new name first, to leave the tree unchanged
+      // if there is no memory.
+      char* const new_name = static_cast<char*> (resource_->allocate (
+          name_length + 1, 1));
+      if (new_name == nullptr)
+        {
+          errno = ENOSPC;
+          return -1;
+        }
+      std::memcpy (new_name, name, name_length);
+      new_name[name_length] = '\0';
+
+      if (dst != nullptr)
+        {
+          remove_ (dst);
+        }
+
+      detach_node_ (src);
+
+      resource_->deallocate (src->name, src->name_length + 1, 1);
+      src->name = new_name;
+      src->name_length = name_length;
+
+      src->parent = parent;
+      src->next_sibling = parent->first_child;
+      parent->first_child = src;
+      parent->mtime = now ();
+
+      return 0;
+    }
+
+    int
+    file_system_ram::do_stat (const char* path, struct stat* buf)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      fill_stat_ (n, buf);
+      return 0;
+    }
+
+    int
+    file_system_ram::do_truncate (const char* path, off_t length)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      if (n->is_dir ())
+        {
+          errno = EISDIR;
+          return -1;
+        }
+
+      return resize_ (n, length);
+    }
+
+    int
+    file_system_ram::do_chmod (const char* path, mode_t mode)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      n->mode = (n->mode & S_IFMT) | (mode & 07777);
+      return 0;
+    }
+
+    int
+    file_system_ram::do_utime (const char* path, const struct utimbuf* times)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      node* const n = lookup_ (path);
+      if (n == nullptr)
+        {
+          return -1;
+        }
+
+      n->mtime = (times != nullptr) ? times->modtime : now ();
+      return 0;
+    }
+
+    int
+    file_system_ram::do_sync (void)
+    {
+      lock_guard lock
+        { mutex_ };
+
+      return cache_.sync ();
+    }
+
+    // ------------------------------------------------------------------------
+
+    /*
+     * Walk the path, from the root. If `name` is not null, stop
+     * before the last component, return its parent, and the
+     * component in `name`/`name_length`; for the root, the
+     * length is 0.
+     */
+    file_system_ram::node*
+    file_system_ram::lookup_ (const char* path, const char** name,
+                              std::size_t* name_length)
+    {
+      node* crt = root_;
+      const char* p = path;
+
+      for (;;)
+        {
+          while (*p == '/')
+            {
+              ++p;
+            }
+
+          if (*p == '\0')
+            {
+              if (name != nullptr)
+                {
+                  *name = p;
+                  *name_length = 0;
+                }
+              return crt;
+            }
+
+          const char* const begin = p;
+          while (*p != '\0' && *p != '/')
+            {
+              ++p;
+            }
+          std::size_t const len = static_cast<std::size_t> (p - begin);
+
+          if (!crt->is_dir ())
+            {
+              errno = ENOTDIR;
+              return nullptr;
+            }
+
+          bool const is_dot = (len == 1 && begin[0] == '.');
+          bool const is_dot_dot = (len == 2 && begin[0] == '.'
+              && begin[1] == '.');
+
+          if (name != nullptr)
+            {
+              const char* q = p;
+              while (*q == '/')
+                {
+                  ++q;
+                }
+              if (*q == '\0')
+                {
+                  // The last component.
+                  if (is_dot || is_dot_dot)
+                    {
+                      errno = EINVAL;
+                      return nullptr;
+                    }
+                  if (len > name_max)
+                    {
+                      errno = ENAMETOOLONG;
+                      return nullptr;
+                    }
+
+                  *name = begin;
+                  *name_length = len;
+                  return crt;
+                }
+            }
+
+          if (is_dot)
+            {
+              continue;
+            }
+          if (is_dot_dot)
+            {
+              crt = crt->parent;
+              continue;
+            }
+
+          crt = find_child_ (crt, begin, len);
+          if (crt == nullptr)
+            {
+              errno = ENOENT;
+              return nullptr;
+            }
+        }
+    }
+
+    file_system_ram::node*
+    file_system_ram::find_child_ (node* dir, const char* name,
+                                  std::size_t name_length)
+    {
+      for (node* n = dir->first_child; n != nullptr; n = n->next_sibling)
+        {
+          if (n->name_length == name_length
+              && std::memcmp (n->name, name, name_length) == 0)
+            {
+              return n;
+            }
+        }
+      return nullptr;
+    }
+
+    file_system_ram::node*
+    file_system_ram::create_node_ (node* parent, const char* name,
+                                   std::size_t name_length, mode_t mode)
+    {
+      void* const p = resource_->allocate (sizeof(node), alignof(node));
+      if (p == nullptr)
+        {
+          errno = ENOSPC;
+          return nullptr;
+        }
+
+      char* const n_name = static_cast<char*> (resource_->allocate (
+          name_length + 1, 1));
+      if (n_name == nullptr)
+        {
+          resource_->deallocate (p, sizeof(node), alignof(node));
+          errno = ENOSPC;
+          return nullptr;
+        }
+      std::memcpy (n_name, name, name_length);
+      n_name[name_length] = '\0';
+
+      node* const n = new (p) node
+        { };
+      n->name = n_name;
+      n->name_length = name_length;
+      n->mode = mode;
+      n->mtime = now ();
+      n->ino = next_ino_++;
+
+      if (parent != nullptr)
+        {
+          n->parent = parent;
+          n->next_sibling = parent->first_child;
+          parent->first_child = n;
+          parent->mtime = n->mtime;
+        }
+      else
+        {
+          // The root is its own parent.
+          n->parent = n;
+        }
+
+      return n;
+    }
+
+    void
+    file_system_ram::detach_node_ (node* n)
+    {
+      node* const parent = n->parent;
+      for (node** p = &parent->first_child; *p != nullptr;
+          p = &((*p)->next_sibling))
+        {
+          if (*p == n)
+            {
+              *p = n->next_sibling;
+              break;
+            }
+        }
+
+      n->next_sibling = nullptr;
+      parent->mtime = now ();
+    }
+
+    int
+    file_system_ram::remove_ (node* n)
+    {
+      detach_node_ (n);
+
+      if (n->open_count > 0)
+        {
+          // Still in use; freed by the last close.
+          n->removed = true;
+        }
+      else
+        {
+          destroy_node_ (n);
+        }
+
+      return 0;
+    }
+
+    void
+    file_system_ram::release_node_ (node* n)
+    {
+      --n->open_count;
+      if (n->open_count == 0 && n->removed)
+        {
+          destroy_node_ (n);
+        }
+    }
+
+    void
+    file_system_ram::destroy_node_ (node* n)
+    {
+      for (std::size_t i = 0; i < n->blocks_capacity; ++i)
+        {
+          if (n->blocks[i] != block_device::no_block)
+            {
+              free_block_ (n->blocks[i]);
+            }
+        }
+
+      if (n->blocks != nullptr)
+        {
+          resource_->deallocate (n->blocks,
+                                 n->blocks_capacity * sizeof(blknum_t),
+                                 alignof(blknum_t));
+        }
+      resource_->deallocate (n->name, n->name_length + 1, 1);
+
+      n->~node ();
+      resource_->deallocate (n, sizeof(node), alignof(node));
+    }
+
+    void
+    file_system_ram::destroy_tree_ (node* n)
+    {
+      node* child = n->first_child;
+      while (child != nullptr)
+        {
+          node* const next = child->next_sibling;
+          destroy_tree_ (child);
+          child = next;
+        }
+
+      destroy_node_ (n);
+    }
+
+    // ------------------------------------------------------------------------
+
+    int
+    file_system_ram::reserve_blocks_ (node* n, std::size_t count)
+    {
+      if (count <= n->blocks_capacity)
+        {
+          return 0;
+        }
+
+      // Grow geometrically, to limit the number of copies.
+      std::size_t capacity = (n->blocks_capacity != 0) ? n->blocks_capacity : 4;
+      while (capacity < count)
+        {
+          capacity *= 2;
+        }
+
+      blknum_t* const blocks = static_cast<blknum_t*> (resource_->allocate (
+          capacity * sizeof(blknum_t), alignof(blknum_t)));
+      if (blocks == nullptr)
+        {
+          errno = ENOSPC;
+          return -1;
+        }
+
+      for (std::size_t i = 0; i < capacity; ++i)
+        {
+          blocks[i] =
+              (i < n->blocks_capacity) ? n->blocks[i] : block_device::no_block;
+        }
+
+      if (n->blocks != nullptr)
+        {
+          resource_->deallocate (n->blocks,
+                                 n->blocks_capacity * sizeof(blknum_t),
+                                 alignof(blknum_t));
+        }
+
+      n->blocks = blocks;
+      n->blocks_capacity = capacity;
+
+      return 0;
+    }
+
+    /*
+     * The bytes after the end of the file, in its last block, are
+     * kept zero, so extending the file needs no writes.
+     */
+    int
+    file_system_ram::resize_ (node* n, off_t length)
+    {
+      std::size_t const bs = cache_.block_size ();
+
+      if (length < n->size)
+        {
+          // The callers already rejected negative lengths.
+          std::size_t const keep = (static_cast<std::size_t> (length) + bs
+              - 1) / bs;
+          for (std::size_t i = keep; i < n->blocks_capacity; ++i)
+            {
+              if (n->blocks[i] != block_device::no_block)
+                {
+                  free_block_ (n->blocks[i]);
+                  n->blocks[i] = block_device::no_block;
+                }
+            }
+
+          std::size_t const tail = static_cast<std::size_t> (length) % bs;
+          std::size_t const idx = static_cast<std::size_t> (length) / bs;
+          if (tail != 0 && idx < n->blocks_capacity
+              && n->blocks[idx] != block_device::no_block)
+            {
+              uint8_t* const data = static_cast<uint8_t*> (cache_.modify (
+                  n->blocks[idx]));
+              if (data == nullptr)
+                {
+                  return -1;
+                }
+              std::memset (data + tail, 0, bs - tail);
+            }
+        }
+
+      n->size = length;
+      n->mtime = now ();
+
+      return 0;
+    }
+
+    ssize_t
+    file_system_ram::read_ (node* n, off_t offset, void* buf,
+                            std::size_t nbyte)
+    {
+      if (offset >= n->size)
+        {
+          return 0;
+        }
+
+      if (static_cast<off_t> (nbyte) > n->size - offset)
+        {
+          nbyte = static_cast<std::size_t> (n->size - offset);
+        }
+
+      std::size_t const bs = cache_.block_size ();
+      uint8_t* const dst = static_cast<uint8_t*> (buf);
+
+      std::size_t done = 0;
+      while (done < nbyte)
+        {
+          std::size_t const pos = static_cast<std::size_t> (offset) + done;
+          std::size_t const idx = pos / bs;
+          std::size_t const in = pos % bs;
+          std::size_t const chunk =
+              (bs - in < nbyte - done) ? bs - in : nbyte - done;
+
+          if (idx >= n->blocks_capacity
+              || n->blocks[idx] == block_device::no_block)
+            {
+              // A hole.
+              std::memset (dst + done, 0, chunk);
+            }
+          else
+            {
+              const uint8_t* const data =
+                  static_cast<const uint8_t*> (cache_.read (n->blocks[idx]));
+              if (data == nullptr)
+                {
+                  return (done > 0) ? static_cast<ssize_t> (done) : -1;
+                }
+              std::memcpy (dst + done, data + in, chunk);
+            }
+
+          done += chunk;
+        }
+
+      return static_cast<ssize_t> (done);
+    }
+
+    ssize_t
+    file_system_ram::write_ (node* n, off_t offset, const void* buf,
+                             std::size_t nbyte)
+    {
+      if (nbyte == 0)
+        {
+          return 0;
+        }
+
+      std::size_t const bs = cache_.block_size ();
+      const uint8_t* const src = static_cast<const uint8_t*> (buf);
+
+      std::size_t done = 0;
+      while (done < nbyte)
+        {
+          std::size_t const pos = static_cast<std::size_t> (offset) + done;
+          std::size_t const idx = pos / bs;
+          std::size_t const in = pos % bs;
+          std::size_t const chunk =
+              (bs - in < nbyte - done) ? bs - in : nbyte - done;
+
+          if (reserve_blocks_ (n, idx + 1) < 0)
+            {
+              break;
+            }
+
+          uint8_t* data;
+          if (n->blocks[idx] == block_device::no_block)
+            {
+              blknum_t const blknum = alloc_block_ ();
+              if (blknum == block_device::no_block)
+                {
+                  errno = ENOSPC;
+                  break;
+                }
+
+              // A new block is not read from the device.
+              data = static_cast<uint8_t*> (cache_.modify (blknum, true));
+              if (data == nullptr)
+                {
+                  free_block_ (blknum);
+                  break;
+                }
+              n->blocks[idx] = blknum;
+
+              if (chunk != bs)
+                {
+                  std::memset (data, 0, bs);
+                }
+            }
+          else
+            {
+              data = static_cast<uint8_t*> (cache_.modify (n->blocks[idx],
+                                                           chunk == bs));
+              if (data == nullptr)
+                {
+                  break;
+                }
+            }
+
+          std::memcpy (data + in, src + done, chunk);
+          done += chunk;
+        }
+
+      if (done == 0)
+        {
+          return -1;
+        }
+
+      if (offset + static_cast<off_t> (done) > n->size)
+        {
+          n->size = offset + static_cast<off_t> (done);
+        }
+      n->mtime = now ();
+
+      return static_cast<ssize_t> (done);
+    }
+
+    // ------------------------------------------------------------------------
+
+    file_system_ram::blknum_t
+    file_system_ram::alloc_block_ (void)
+    {
+      if (free_blocks_ == 0)
+        {
+          return block_device::no_block;
+        }
+
+      // Search from the last allocated block, to spread the
+      // allocations and find free blocks faster.
+      blknum_t const num_blocks = cache_.device ().num_blocks ();
+      for (blknum_t i = 0; i < num_blocks; ++i)
+        {
+          blknum_t const blknum = (next_free_ + i) % num_blocks;
+          uint32_t const bit = 1u << (blknum % 32);
+          if ((bitmap_[blknum / 32] & bit) == 0)
+            {
+              bitmap_[blknum / 32] |= bit;
+              --free_blocks_;
+              next_free_ = blknum + 1;
+
+              return blknum;
+            }
+        }
+
+      return block_device::no_block;
+    }
+
+    void
+    file_system_ram::free_block_ (blknum_t blknum)
+    {
+      bitmap_[blknum / 32] &= ~(1u << (blknum % 32));
+      ++free_blocks_;
+
+      // The content is no longer needed, do not write it back.
+      cache_.invalidate (blknum);
+    }
+
+    void
+    file_system_ram::fill_stat_ (node* n, struct stat* buf)
+    {
+      std::size_t used = 0;
+      for (std::size_t i = 0; i < n->blocks_capacity; ++i)
+        {
+          if (n->blocks[i] != block_device::no_block)
+            {
+              ++used;
+            }
+        }
+
+      std::memset (buf, 0, sizeof(*buf));
+      buf->st_ino = n->ino;
+      buf->st_mode = n->mode;
+      buf->st_nlink = 1;
+      buf->st_size = n->size;
+      buf->st_blksize = static_cast<blksize_t> (cache_.block_size ());
+      // In 512 bytes units.
+      buf->st_blocks = static_cast<blkcnt_t> (used * cache_.block_size ()
+          / 512);
+      buf->st_atime = n->mtime;
+      buf->st_mtime = n->mtime;
+      buf->st_ctime = n->mtime;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
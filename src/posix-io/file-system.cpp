@@ -0,0 +1,417 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/file-system.h>
+#include <cmsis-plus/posix-io/file.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cerrno>
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    file_system* file_system::head_;
+
+    // ------------------------------------------------------------------------
+
+    file_system::file_system ()
+    {
+      ;
+    }
+
+    file_system::~file_system () noexcept
+    {
+      umount ();
+    }
+
+    // ------------------------------------------------------------------------
+
+    int
+    file_system::mount (const char* path)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      if (path[0] != '/')
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      // Ignore a trailing separator, the root excepted.
+      std::size_t len = std::strlen (path);
+      if (len > 1 && path[len - 1] == '/')
+        {
+          --len;
+        }
+
+      rtos::scheduler::critical_section scs;
+
+      if (mount_path_ != nullptr)
+        {
+          errno = EBUSY;
+          return -1;
+        }
+
+      for (file_system* p = head_; p != nullptr; p = p->next_)
+        {
+          if (p->mount_path_length_ == len
+              && std::strncmp (p->mount_path_, path, len) == 0)
+            {
+              errno = EBUSY;
+              return -1;
+            }
+        }
+
+      mount_path_ = path;
+      mount_path_length_ = len;
+
+      next_ = head_;
+      head_ = this;
+
+      return 0;
+    }
+
+    int
+    file_system::umount (void)
+    {
+      rtos::scheduler::critical_section scs;
+
+      if (mount_path_ == nullptr)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      for (file_system** p = &head_; *p != nullptr; p = &((*p)->next_))
+        {
+          if (*p == this)
+            {
+              *p = next_;
+              break;
+            }
+        }
+
+      next_ = nullptr;
+      mount_path_ = nullptr;
+      mount_path_length_ = 0;
+
+      return 0;
+    }
+
+    file_system*
+    file_system::identify_file_system (const char** path)
+    {
+      const char* const p = *path;
+      if (p == nullptr || p[0] != '/')
+        {
+          return nullptr;
+        }
+
+      file_system* found = nullptr;
+      std::size_t found_length = 0;
+
+      rtos::scheduler::critical_section scs;
+
+      for (file_system* fs = head_; fs != nullptr; fs = fs->next_)
+        {
+          std::size_t const len = fs->mount_path_length_;
+          if (std::strncmp (p, fs->mount_path_, len) != 0)
+            {
+              continue;
+            }
+
+          // The root matches all paths; the others must be followed
+          // by a separator or by the end of the path.
+          bool const matches = (len == 1) || (p[len] == '/')
+              || (p[len] == '\0');
+          if (matches && (found == nullptr || len > found_length))
+            {
+              found = fs;
+              found_length = len;
+            }
+        }
+
+      if (found != nullptr)
+        {
+          // The root file system gets the path as is; for the others,
+          // skip the mount point, but keep the separator.
+          const char* rel = p + ((found_length == 1) ? 0 : found_length);
+          *path = (*rel == '\0') ? "/" : rel;
+        }
+
+      return found;
+    }
+
+    void
+    file_system::sync_all (void)
+    {
+      // The list does not change often; do not keep the scheduler
+      // locked during the writes.
+      for (file_system* fs = head_; fs != nullptr; fs = fs->next_)
+        {
+          fs->sync ();
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    file*
+    file_system::open (const char* path, int oflag, ...)
+    {
+      // Forward to the variadic version of the function.
+      std::va_list args;
+      va_start(args, oflag);
+      file* const ret = vopen (path, oflag, args);
+      va_end(args);
+
+      return ret;
+    }
+
+    file*
+    file_system::vopen (const char* path, int oflag, std::va_list args)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return nullptr;
+        }
+
+      return do_vopen (path, oflag, args);
+    }
+
+    directory*
+    file_system::opendir (const char* path)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return nullptr;
+        }
+
+      return do_opendir (path);
+    }
+
+    int
+    file_system::mkdir (const char* path, mode_t mode)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_mkdir (path, mode);
+    }
+
+    int
+    file_system::rmdir (const char* path)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_rmdir (path);
+    }
+
+    int
+    file_system::unlink (const char* path)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_unlink (path);
+    }
+
+    int
+    file_system::rename (const char* existing, const char* _new)
+    {
+      if (existing == nullptr || _new == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_rename (existing, _new);
+    }
+
+    int
+    file_system::stat (const char* path, struct stat* buf)
+    {
+      if (path == nullptr || buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_stat (path, buf);
+    }
+
+    int
+    file_system::truncate (const char* path, off_t length)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      if (length < 0)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      return do_truncate (path, length);
+    }
+
+    int
+    file_system::chmod (const char* path, mode_t mode)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_chmod (path, mode);
+    }
+
+    int
+    file_system::utime (const char* path, const struct utimbuf* times)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_utime (path, times);
+    }
+
+    int
+    file_system::sync (void)
+    {
+      return do_sync ();
+    }
+
+    // ------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    directory*
+    file_system::do_opendir (const char* path)
+    {
+      errno = ENOSYS; // Not implemented
+      return nullptr;
+    }
+
+    int
+    file_system::do_mkdir (const char* path, mode_t mode)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_rmdir (const char* path)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_unlink (const char* path)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_rename (const char* existing, const char* _new)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_stat (const char* path, struct stat* buf)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_truncate (const char* path, off_t length)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_chmod (const char* path, mode_t mode)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file_system::do_utime (const char* path, const struct utimbuf* times)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+#pragma GCC diagnostic pop
+
+    int
+    file_system::do_sync (void)
+    {
+      return 0;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/file.h>
+
+#include <cerrno>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    file::file (class file_system& fs) :
+        io (type::file), //
+        file_system_ (&fs)
+    {
+      ;
+    }
+
+    file::~file () noexcept
+    {
+      ;
+    }
+
+    // ------------------------------------------------------------------------
+
+    off_t
+    file::lseek (off_t offset, int whence)
+    {
+      return do_lseek (offset, whence);
+    }
+
+    int
+    file::ftruncate (off_t length)
+    {
+      if (length < 0)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      return do_ftruncate (length);
+    }
+
+    int
+    file::fsync (void)
+    {
+      return do_fsync ();
+    }
+
+    // ------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    off_t
+    file::do_lseek (off_t offset, int whence)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file::do_ftruncate (off_t length)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    file::do_fsync (void)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+#pragma GCC diagnostic pop
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
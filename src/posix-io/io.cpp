@@ -0,0 +1,406 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/io.h>
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/posix-io/device-registry.h>
+#include <cmsis-plus/posix-io/file.h>
+#include <cmsis-plus/posix-io/file-system.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+
+#include <cerrno>
+#include <limits>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    io*
+    open (const char* path, int oflag, ...)
+    {
+      // Forward to the variadic version of the function.
+      std::va_list args;
+      va_start(args, oflag);
+      io* const ret = vopen (path, oflag, args);
+      va_end(args);
+
+      return ret;
+    }
+
+    io*
+    vopen (const char* path, int oflag, std::va_list args)
+    {
+      if (path == nullptr)
+        {
+          errno = EFAULT;
+          return nullptr;
+        }
+
+      if (*path == '\0')
+        {
+          errno = ENOENT;
+          return nullptr;
+        }
+
+      io* pio;
+
+      device* const dev = device_registry::identify_device (path);
+      if (dev != nullptr)
+        {
+          if (dev->vopen (path, oflag, args) < 0)
+            {
+              return nullptr;
+            }
+          pio = dev;
+        }
+      else
+        {
+          // The file system gets the path relative to its mount point.
+          const char* rel_path = path;
+          file_system* const fs = file_system::identify_file_system (
+              &rel_path);
+          if (fs == nullptr)
+            {
+              errno = ENOENT;
+              return nullptr;
+            }
+
+          pio = fs->vopen (rel_path, oflag, args);
+          if (pio == nullptr)
+            {
+              return nullptr;
+            }
+        }
+
+      if (file_descriptors_manager::alloc (pio) < 0)
+        {
+          // Preserve the EMFILE error.
+          int const err = errno;
+          pio->close ();
+          errno = err;
+
+          return nullptr;
+        }
+
+      return pio;
+    }
+
+    // ========================================================================
+
+    io::io (type_t t) noexcept :
+        type_ (t)
+    {
+      ;
+    }
+
+    io::~io () noexcept
+    {
+      ;
+    }
+
+    // ------------------------------------------------------------------------
+
+    int
+    io::close (void)
+    {
+      int const ret = do_close ();
+
+      if (file_descriptor_ != no_file_descriptor)
+        {
+          file_descriptors_manager::free (file_descriptor_);
+        }
+
+      // May destroy the object; do not use the members after it.
+      do_release ();
+
+      return ret;
+    }
+
+    ssize_t
+    io::read (void* buf, std::size_t nbyte)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_read (buf, nbyte);
+    }
+
+    ssize_t
+    io::write (const void* buf, std::size_t nbyte)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_write (buf, nbyte);
+    }
+
+    namespace
+    {
+      // Validate the vector before passing it to the implementation;
+      // the sum of the lengths must fit the return value.
+      bool
+      is_valid_iov (const struct iovec* iov, int iovcnt)
+      {
+        if (iov == nullptr)
+          {
+            errno = EFAULT;
+            return false;
+          }
+
+        if (iovcnt <= 0)
+          {
+            errno = EINVAL;
+            return false;
+          }
+
+        std::size_t total = 0;
+        for (int i = 0; i < iovcnt; ++i)
+          {
+            total += iov[i].iov_len;
+            if ((total < iov[i].iov_len)
+                || (total
+                    > static_cast<std::size_t> (std::numeric_limits<ssize_t>::max ())))
+              {
+                errno = EINVAL;
+                return false;
+              }
+          }
+
+        return true;
+      }
+    } /* namespace */
+
+    ssize_t
+    io::readv (const struct iovec* iov, int iovcnt)
+    {
+      if (!is_valid_iov (iov, iovcnt))
+        {
+          return -1;
+        }
+
+      return do_readv (iov, iovcnt);
+    }
+
+    ssize_t
+    io::writev (const struct iovec* iov, int iovcnt)
+    {
+      if (!is_valid_iov (iov, iovcnt))
+        {
+          return -1;
+        }
+
+      return do_writev (iov, iovcnt);
+    }
+
+    int
+    io::fcntl (int cmd, ...)
+    {
+      // Forward to the variadic version of the function.
+      std::va_list args;
+      va_start(args, cmd);
+      int const ret = vfcntl (cmd, args);
+      va_end(args);
+
+      return ret;
+    }
+
+    int
+    io::vfcntl (int cmd, std::va_list args)
+    {
+      return do_vfcntl (cmd, args);
+    }
+
+    int
+    io::isatty (void)
+    {
+      return do_isatty ();
+    }
+
+    int
+    io::fstat (struct stat* buf)
+    {
+      if (buf == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_fstat (buf);
+    }
+
+    int
+    io::poll (int events)
+    {
+      return do_poll (events);
+    }
+
+    // ------------------------------------------------------------------------
+    // Default implementations.
+
+    int
+    io::do_close (void)
+    {
+      return 0;
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    ssize_t
+    io::do_read (void* buf, std::size_t nbyte)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    ssize_t
+    io::do_write (const void* buf, std::size_t nbyte)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    io::do_vfcntl (int cmd, std::va_list args)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    io::do_fstat (struct stat* buf)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+#pragma GCC diagnostic pop
+
+    /**
+     * @details
+     * Read the segments one at a time, directly into the user
+     * buffers; stop at the first short read, which means there
+     * is no more data available.
+     *
+     * Drivers able to do scatter-gather transfers should override
+     * this function and pass the entire vector to the hardware.
+     */
+    ssize_t
+    io::do_readv (const struct iovec* iov, int iovcnt)
+    {
+      ssize_t total = 0;
+      for (int i = 0; i < iovcnt; ++i)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          ssize_t const ret = do_read (iov[i].iov_base, iov[i].iov_len);
+          if (ret < 0)
+            {
+              // Report the error only if nothing was transferred.
+              return (total > 0) ? total : ret;
+            }
+
+          total += ret;
+          if (static_cast<std::size_t> (ret) < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return total;
+    }
+
+    /**
+     * @details
+     * Write the segments one at a time, directly from the user
+     * buffers, without copying them into an intermediate buffer.
+     */
+    ssize_t
+    io::do_writev (const struct iovec* iov, int iovcnt)
+    {
+      ssize_t total = 0;
+      for (int i = 0; i < iovcnt; ++i)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          ssize_t const ret = do_write (iov[i].iov_base, iov[i].iov_len);
+          if (ret < 0)
+            {
+              return (total > 0) ? total : ret;
+            }
+
+          total += ret;
+          if (static_cast<std::size_t> (ret) < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return total;
+    }
+
+    int
+    io::do_poll (int events)
+    {
+      return events & (POLLIN | POLLRDNORM | POLLOUT | POLLWRNORM);
+    }
+
+    int
+    io::do_isatty (void)
+    {
+      errno = ENOTTY; // Not a terminal
+      return 0;
+    }
+
+    void
+    io::do_release (void)
+    {
+      ;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
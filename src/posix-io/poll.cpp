@@ -0,0 +1,436 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/io.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+#include <cmsis-plus/rtos/os.h>
+
+#include <cerrno>
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    namespace
+    {
+      constexpr std::size_t mask_words = (OS_INTEGER_POSIX_IO_MAX_OPEN_FILES
+          + 31) / 32;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+      /*
+       * One for each thread blocked in poll()/select(), allocated on
+       * its stack and linked into a list while the call is active.
+       *
+       * The thread waits on a single semaphore, regardless of the
+       * number of descriptors; io::notify_poll() posts it if the
+       * descriptor is in the mask. Since the waiter is linked
+       * before the first scan, a notification arriving between the
+       * scan and the wait is not lost, it just makes the wait
+       * return immediately.
+       */
+      class waiter
+      {
+      public:
+
+        waiter ();
+
+        waiter (const waiter&) = delete;
+        waiter (waiter&&) = delete;
+        waiter&
+        operator= (const waiter&) = delete;
+        waiter&
+        operator= (waiter&&) = delete;
+
+        ~waiter ();
+
+        void
+        watch (int fildes);
+
+        bool
+        is_watching (int fildes) const;
+
+        // Scan until the function reports events or the timeout expires.
+        template<typename F>
+          int
+          wait (bool forever, rtos::clock::duration_t ticks, F&& scan);
+
+        static void
+        notify (int fildes);
+
+      private:
+
+        rtos::semaphore_binary semaphore_
+          { "poll", 0 };
+
+        waiter* next_ = nullptr;
+
+        uint32_t mask_[mask_words] =
+          { };
+
+        static waiter* head_;
+      };
+
+#pragma GCC diagnostic pop
+
+      waiter* waiter::head_;
+
+      waiter::waiter ()
+      {
+        // ----- Enter critical section -----------------------------------
+        rtos::interrupts::critical_section ics;
+
+        next_ = head_;
+        head_ = this;
+        // ----- Exit critical section ------------------------------------
+      }
+
+      waiter::~waiter ()
+      {
+        // ----- Enter critical section -----------------------------------
+        rtos::interrupts::critical_section ics;
+
+        for (waiter** p = &head_; *p != nullptr; p = &((*p)->next_))
+          {
+            if (*p == this)
+              {
+                *p = next_;
+                break;
+              }
+          }
+        // ----- Exit critical section ------------------------------------
+      }
+
+      inline void
+      waiter::watch (int fildes)
+      {
+        mask_[fildes / 32] |= (1u << (fildes % 32));
+      }
+
+      inline bool
+      waiter::is_watching (int fildes) const
+      {
+        return (mask_[fildes / 32] & (1u << (fildes % 32))) != 0;
+      }
+
+      template<typename F>
+        int
+        waiter::wait (bool forever, rtos::clock::duration_t ticks, F&& scan)
+        {
+          rtos::clock::timestamp_t const begin = rtos::sysclock.now ();
+
+          for (;;)
+            {
+              int const count = scan ();
+              if (count != 0)
+                {
+                  return count;
+                }
+
+              rtos::result_t res;
+              if (forever)
+                {
+                  res = semaphore_.wait ();
+                }
+              else
+                {
+                  rtos::clock::duration_t const elapsed =
+                      static_cast<rtos::clock::duration_t> (rtos::sysclock.now ()
+                          - begin);
+                  if (elapsed >= ticks)
+                    {
+                      return 0;
+                    }
+                  res = semaphore_.timed_wait (ticks - elapsed);
+                }
+
+              if (res == EINTR)
+                {
+                  errno = EINTR;
+                  return -1;
+                }
+            }
+        }
+
+      void
+      waiter::notify (int fildes)
+      {
+        // ----- Enter critical section -----------------------------------
+        rtos::interrupts::critical_section ics;
+
+        for (waiter* p = head_; p != nullptr; p = p->next_)
+          {
+            if (p->is_watching (fildes))
+              {
+                p->semaphore_.post ();
+              }
+          }
+        // ----- Exit critical section ------------------------------------
+      }
+
+    } /* namespace */
+
+    // ------------------------------------------------------------------------
+
+    /**
+     * @details
+     * Only the threads waiting for this descriptor are woken up;
+     * they call `poll()` again on the object, so spurious
+     * notifications are harmless.
+     */
+    void
+    io::notify_poll (void)
+    {
+      int const fildes = file_descriptor_;
+      if (fildes != no_file_descriptor)
+        {
+          waiter::notify (fildes);
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    /**
+     * @details
+     * Negative descriptors are ignored; descriptors not opened
+     * are reported with `POLLNVAL`.
+     *
+     * The calling thread waits on a single semaphore, posted by the
+     * drivers via `io::notify_poll()`; there is no periodic polling.
+     *
+     * @warning Cannot be invoked from Interrupt Service Routines.
+     */
+    int
+    poll (struct pollfd fds[], nfds_t nfds, int timeout)
+    {
+      if (fds == nullptr && nfds != 0)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      if (rtos::interrupts::in_handler_mode ())
+        {
+          errno = EPERM;
+          return -1;
+        }
+
+      waiter w;
+
+      for (nfds_t i = 0; i < nfds; ++i)
+        {
+          if (file_descriptors_manager::valid (fds[i].fd))
+            {
+              w.watch (fds[i].fd);
+            }
+        }
+
+      auto scan = [fds, nfds]()
+        {
+          int count = 0;
+          for (nfds_t i = 0; i < nfds; ++i)
+            {
+              fds[i].revents = 0;
+              if (fds[i].fd < 0)
+                {
+                  continue;
+                }
+
+              io* const pio = file_descriptors_manager::get_io (fds[i].fd);
+              int revents;
+              if (pio == nullptr)
+                {
+                  revents = POLLNVAL;
+                }
+              else
+                {
+                  revents = pio->poll (fds[i].events)
+                  & (fds[i].events | POLLERR | POLLHUP);
+                }
+
+              if (revents != 0)
+                {
+                  fds[i].revents = static_cast<short> (revents);
+                  ++count;
+                }
+            }
+          return count;
+        };
+
+      return w.wait (
+          timeout < 0, //
+          rtos::clock_systick::ticks_cast (
+              static_cast<uint64_t> (timeout < 0 ? 0 : timeout) * 1000u),
+          scan);
+    }
+
+    /**
+     * @details
+     * Implemented with the same mechanism as `poll()`; errors
+     * and hang-ups are reported as readable and writable, so
+     * the next `read()`/`write()` returns the error.
+     *
+     * @warning Cannot be invoked from Interrupt Service Routines.
+     */
+    int
+    select (int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds,
+            struct timeval* timeout)
+    {
+      if (nfds < 0 || nfds > FD_SETSIZE)
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      if (timeout != nullptr
+          && (timeout->tv_sec < 0 || timeout->tv_usec < 0
+              || timeout->tv_usec >= 1000000))
+        {
+          errno = EINVAL;
+          return -1;
+        }
+
+      if (rtos::interrupts::in_handler_mode ())
+        {
+          errno = EPERM;
+          return -1;
+        }
+
+      waiter w;
+
+      for (int fd = 0; fd < nfds; ++fd)
+        {
+          if ((readfds != nullptr && FD_ISSET(fd, readfds))
+              || (writefds != nullptr && FD_ISSET(fd, writefds))
+              || (errorfds != nullptr && FD_ISSET(fd, errorfds)))
+            {
+              if (file_descriptors_manager::get_io (fd) == nullptr)
+                {
+                  errno = EBADF;
+                  return -1;
+                }
+              w.watch (fd);
+            }
+        }
+
+      fd_set rset;
+      fd_set wset;
+      fd_set eset;
+
+      auto scan = [&]()
+        {
+          FD_ZERO(&rset);
+          FD_ZERO(&wset);
+          FD_ZERO(&eset);
+
+          int count = 0;
+          for (int fd = 0; fd < nfds; ++fd)
+            {
+              bool const r = (readfds != nullptr && FD_ISSET(fd, readfds));
+              bool const wr = (writefds != nullptr && FD_ISSET(fd, writefds));
+              bool const e = (errorfds != nullptr && FD_ISSET(fd, errorfds));
+              if (!(r || wr || e))
+                {
+                  continue;
+                }
+
+              io* const pio = file_descriptors_manager::get_io (fd);
+              int revents;
+              if (pio == nullptr)
+                {
+                  // Closed meanwhile; let the next call report it.
+                  revents = POLLERR;
+                }
+              else
+                {
+                  revents = pio->poll ((r ? POLLIN : 0) | (wr ? POLLOUT : 0)
+                      | (e ? POLLPRI : 0));
+                }
+
+              if (r && (revents & (POLLIN | POLLRDNORM | POLLERR | POLLHUP)))
+                {
+                  FD_SET(fd, &rset);
+                  ++count;
+                }
+              if (wr && (revents & (POLLOUT | POLLWRNORM | POLLERR | POLLHUP)))
+                {
+                  FD_SET(fd, &wset);
+                  ++count;
+                }
+              if (e && (revents & POLLPRI))
+                {
+                  FD_SET(fd, &eset);
+                  ++count;
+                }
+            }
+          return count;
+        };
+
+      uint64_t usec = 0;
+      if (timeout != nullptr)
+        {
+          usec = static_cast<uint64_t> (timeout->tv_sec) * 1000000u
+              + static_cast<uint64_t> (timeout->tv_usec);
+        }
+
+      int const ret = w.wait (timeout == nullptr,
+                              rtos::clock_systick::ticks_cast (usec), scan);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      // The sets are updated only on success; after a timeout they
+      // are empty, as left by the last scan.
+      if (readfds != nullptr)
+        {
+          *readfds = rset;
+        }
+      if (writefds != nullptr)
+        {
+          *writefds = wset;
+        }
+      if (errorfds != nullptr)
+        {
+          *errorfds = eset;
+        }
+
+      return ret;
+    }
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,245 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/socket.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+
+#include <cerrno>
+
+// ----------------------------------------------------------------------------
+
+namespace os
+{
+  namespace posix
+  {
+    // ------------------------------------------------------------------------
+
+    socket::socket () :
+        io (type::socket)
+    {
+      ;
+    }
+
+    socket::~socket () noexcept
+    {
+      ;
+    }
+
+    // ------------------------------------------------------------------------
+
+    socket*
+    socket::accept (struct sockaddr* address, socklen_t* address_len)
+    {
+      socket* const new_socket = do_accept (address, address_len);
+      if (new_socket == nullptr)
+        {
+          return nullptr;
+        }
+
+      if (file_descriptors_manager::alloc (new_socket) < 0)
+        {
+          // Preserve the EMFILE error.
+          int const err = errno;
+          new_socket->close ();
+          errno = err;
+
+          return nullptr;
+        }
+
+      return new_socket;
+    }
+
+    int
+    socket::bind (const struct sockaddr* address, socklen_t address_len)
+    {
+      return do_bind (address, address_len);
+    }
+
+    int
+    socket::connect (const struct sockaddr* address, socklen_t address_len)
+    {
+      return do_connect (address, address_len);
+    }
+
+    int
+    socket::getpeername (struct sockaddr* address, socklen_t* address_len)
+    {
+      return do_getpeername (address, address_len);
+    }
+
+    int
+    socket::getsockname (struct sockaddr* address, socklen_t* address_len)
+    {
+      return do_getsockname (address, address_len);
+    }
+
+    int
+    socket::getsockopt (int level, int option_name, void* option_value,
+                        socklen_t* option_len)
+    {
+      return do_getsockopt (level, option_name, option_value, option_len);
+    }
+
+    int
+    socket::listen (int backlog)
+    {
+      return do_listen (backlog);
+    }
+
+    ssize_t
+    socket::recvfrom (void* buffer, std::size_t length, int flags,
+                      struct sockaddr* address, socklen_t* address_len)
+    {
+      if (buffer == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_recvfrom (buffer, length, flags, address, address_len);
+    }
+
+    ssize_t
+    socket::sendto (const void* message, std::size_t length, int flags,
+                    const struct sockaddr* dest_addr, socklen_t dest_len)
+    {
+      if (message == nullptr)
+        {
+          errno = EFAULT;
+          return -1;
+        }
+
+      return do_sendto (message, length, flags, dest_addr, dest_len);
+    }
+
+    int
+    socket::setsockopt (int level, int option_name, const void* option_value,
+                        socklen_t option_len)
+    {
+      return do_setsockopt (level, option_name, option_value, option_len);
+    }
+
+    int
+    socket::shutdown (int how)
+    {
+      return do_shutdown (how);
+    }
+
+    // ------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    socket*
+    socket::do_accept (struct sockaddr* address, socklen_t* address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return nullptr;
+    }
+
+    int
+    socket::do_bind (const struct sockaddr* address, socklen_t address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_connect (const struct sockaddr* address, socklen_t address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_getpeername (struct sockaddr* address, socklen_t* address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_getsockname (struct sockaddr* address, socklen_t* address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_getsockopt (int level, int option_name, void* option_value,
+                           socklen_t* option_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_listen (int backlog)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    ssize_t
+    socket::do_recvfrom (void* buffer, std::size_t length, int flags,
+                         struct sockaddr* address, socklen_t* address_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    ssize_t
+    socket::do_sendto (const void* message, std::size_t length, int flags,
+                       const struct sockaddr* dest_addr, socklen_t dest_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_setsockopt (int level, int option_name, const void* option_value,
+                           socklen_t option_len)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+    int
+    socket::do_shutdown (int how)
+    {
+      errno = ENOSYS; // Not implemented
+      return -1;
+    }
+
+#pragma GCC diagnostic pop
+
+  // --------------------------------------------------------------------------
+
+  } /* namespace posix */
+} /* namespace os */
+
+// ----------------------------------------------------------------------------
@@ -564,6 +564,44 @@ namespace os
         insert_after (node, after);
       }
 
+      /**
+       * @details
+       * The list is traversed from the beginning, until the first
+       * time stamp beyond the tolerance window.
+       */
+      clock::timestamp_t
+      clock_timestamps_list::coalesce (clock::timestamp_t timestamp,
+                                       clock::duration_t slack)
+      {
+        if (slack == 0 || empty ())
+          {
+            return timestamp;
+          }
+
+        clock::timestamp_t limit = timestamp + slack;
+
+        const static_double_list_links* node =
+            const_cast<const timestamp_node*> (head ());
+        while (node != &head_)
+          {
+            clock::timestamp_t ts =
+                static_cast<const timestamp_node*> (node)->timestamp;
+            if (ts > limit)
+              {
+                break;
+              }
+            if (ts >= timestamp)
+              {
+                // Share the wake-up of the existing node.
+                ++coalesced_count_;
+                return ts;
+              }
+            node = node->next ();
+          }
+
+        return timestamp;
+      }
+
       /**
        * @details
        * With the list ordered, check if the list head time stamp was
@@ -110,6 +110,9 @@ static_assert(alignof(os_timer_type_t) == alignof(timer::type_t), "adjust align
 static_assert(sizeof(os_timer_state_t) == sizeof(timer::state_t), "adjust size of os_timer_state_t");
 static_assert(alignof(os_timer_state_t) == alignof(timer::state_t), "adjust align of os_timer_state_t");
 
+static_assert(sizeof(os_timer_execution_t) == sizeof(timer::execution_t), "adjust size of os_timer_execution_t");
+static_assert(alignof(os_timer_execution_t) == alignof(timer::execution_t), "adjust align of os_timer_execution_t");
+
 static_assert(sizeof(os_mutex_count_t) == sizeof(mutex::count_t), "adjust size of os_mutex_count_t");
 static_assert(alignof(os_mutex_count_t) == alignof(mutex::count_t), "adjust align of os_mutex_count_t");
 
@@ -170,6 +173,9 @@ static_assert(os_thread_state_destroyed == thread::state::destroyed, "adjust os_
 static_assert(os_timer_once == timer::run::once, "adjust os_timer_once");
 static_assert(os_timer_periodic == timer::run::periodic, "adjust os_timer_periodic");
 
+static_assert(os_timer_execution_interrupt == timer::execution::interrupt, "adjust os_timer_execution_interrupt");
+static_assert(os_timer_execution_daemon == timer::execution::daemon, "adjust os_timer_execution_daemon");
+
 static_assert(os_mutex_protocol_none == mutex::protocol::none, "adjust os_mutex_protocol_none");
 static_assert(os_mutex_protocol_inherit == mutex::protocol::inherit, "adjust os_mutex_protocol_inherit");
 static_assert(os_mutex_protocol_protect == mutex::protocol::protect, "adjust os_mutex_protocol_protect");
@@ -203,6 +209,8 @@ static_assert(offsetof(rtos::thread::attributes, th_priority) == offsetof(os_thr
 static_assert(sizeof(rtos::timer) == sizeof(os_timer_t), "adjust size of os_timer_t");
 static_assert(sizeof(rtos::timer::attributes) == sizeof(os_timer_attr_t), "adjust size of os_timer_attr_t");
 static_assert(offsetof(rtos::timer::attributes, tm_type) == offsetof(os_timer_attr_t, tm_type), "adjust os_timer_attr_t members");
+static_assert(offsetof(rtos::timer::attributes, tm_execution) == offsetof(os_timer_attr_t, tm_execution), "adjust os_timer_attr_t members");
+static_assert(offsetof(rtos::timer::attributes, tm_slack) == offsetof(os_timer_attr_t, tm_slack), "adjust os_timer_attr_t members");
 
 static_assert(sizeof(rtos::mutex) == sizeof(os_mutex_t), "adjust size of os_mutex_t");
 static_assert(sizeof(rtos::mutex::attributes) == sizeof(os_mutex_attr_t), "adjust size of os_mutex_attr_t");
@@ -241,6 +249,10 @@ static_assert(sizeof(class thread::context) == sizeof(os_thread_context_t), "adj
 static_assert(sizeof(class thread::statistics) == sizeof(os_thread_statistics_t), "adjust size of os_thread_statistics_t");
 #endif
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+static_assert(sizeof(class thread::periodic) == sizeof(os_thread_periodic_t), "adjust size of os_thread_periodic_t");
+#endif
+
 static_assert(sizeof(internal::timer_node) == sizeof(os_internal_clock_timer_node_t), "adjust size of os_internal_clock_timer_node_t");
 
 #pragma GCC diagnostic pop
@@ -412,6 +424,34 @@ os_sched_stat_get_cpu_cycles (void)
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+/**
+ * @details
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::scheduler::statistics::cpu_load()
+ */
+uint32_t
+os_sched_stat_get_cpu_load (void)
+{
+  return scheduler::statistics::cpu_load ();
+}
+
+/**
+ * @details
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::scheduler::statistics::interrupts_load()
+ */
+uint32_t
+os_sched_stat_get_interrupts_load (void)
+{
+  return scheduler::statistics::interrupts_load ();
+}
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
 // ----------------------------------------------------------------------------
 
 /**
@@ -607,6 +647,38 @@ os_this_thread_flags_get (os_flags_mask_t mask, os_flags_mode_t mode)
   return (os_flags_mask_t) this_thread::flags_get (mask, mode);
 }
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+/**
+ * @details
+ *
+ * @warning Cannot be invoked from Interrupt Service Routines.
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::this_thread::set_period()
+ */
+os_result_t
+os_this_thread_set_period (os_clock_duration_t period, bool skip_overruns)
+{
+  return (os_result_t) this_thread::set_period (period, skip_overruns);
+}
+
+/**
+ * @details
+ *
+ * @warning Cannot be invoked from Interrupt Service Routines.
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::this_thread::wait_next_period()
+ */
+os_result_t
+os_this_thread_wait_next_period (void)
+{
+  return (os_result_t) this_thread::wait_next_period ();
+}
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
 // ----------------------------------------------------------------------------
 
 /**
@@ -988,6 +1060,53 @@ os_thread_stat_get_cpu_cycles (os_thread_t* thread)
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+/**
+ * @details
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::thread::statistics::cpu_load()
+ */
+uint32_t
+os_thread_stat_get_cpu_load (os_thread_t* thread)
+{
+  assert(thread != nullptr);
+  return (reinterpret_cast<rtos::thread&> (*thread)).statistics ().cpu_load ();
+}
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+/**
+ * @details
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::thread::periodic::overruns()
+ */
+os_statistics_counter_t
+os_thread_stat_get_overruns (os_thread_t* thread)
+{
+  assert(thread != nullptr);
+  return static_cast<os_statistics_counter_t> ((reinterpret_cast<rtos::thread&> (*thread)).periodic ().overruns ());
+}
+
+/**
+ * @details
+ *
+ * @par For the complete definition, see
+ *  @ref os::rtos::thread::periodic::jitter_max()
+ */
+os_clock_duration_t
+os_thread_stat_get_jitter_max (os_thread_t* thread)
+{
+  assert(thread != nullptr);
+  return static_cast<os_clock_duration_t> ((reinterpret_cast<rtos::thread&> (*thread)).periodic ().jitter_max ());
+}
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
 // ----------------------------------------------------------------------------
 
 /**
@@ -54,6 +54,10 @@ os_systick_handler (void)
     }
 #endif
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+  interrupts::accounted_section ias;
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
 #if defined(OS_TRACE_RTOS_SYSCLOCK_TICK)
   trace::putchar ('.');
 #endif
@@ -83,6 +87,19 @@ os_systick_handler (void)
 
 #endif /* !defined(OS_INCLUDE_RTOS_REALTIME_CLOCK_DRIVER) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+  static uint32_t load_ticks = OS_INTEGER_RTOS_STATISTICS_CPU_LOAD_WINDOW_TICKS;
+
+  if (--load_ticks == 0)
+    {
+      load_ticks = OS_INTEGER_RTOS_STATISTICS_CPU_LOAD_WINDOW_TICKS;
+
+      scheduler::statistics::internal_roll_window ();
+    }
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
 #if !defined(OS_USE_RTOS_PORT_SCHEDULER)
 
   port::scheduler::reschedule ();
@@ -125,6 +142,32 @@ os_rtc_handler (void)
   rtclock.internal_check_timestamps ();
 }
 
+#if defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE)
+
+/**
+ * @details
+ * Must be called from the physical compare match interrupt handler
+ * programmed by `port::clock_highres::compare()`.
+ *
+ * It processes the `hrclock` time stamps that are due, without
+ * waiting for the next SysTick.
+ */
+void
+os_hrclock_compare_handler (void)
+{
+  using namespace os::rtos;
+
+  hrclock.internal_check_compare ();
+
+#if !defined(OS_USE_RTOS_PORT_SCHEDULER)
+
+  port::scheduler::reschedule ();
+
+#endif /* !defined(OS_USE_RTOS_PORT_SCHEDULER) */
+}
+
+#endif /* defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE) */
+
 // ----------------------------------------------------------------------------
 
 namespace os
@@ -165,43 +208,58 @@ namespace os
 
     /**
      * @details
+     * The count is read without disabling interrupts; if a tick
+     * updated it meanwhile, it is read again.
      *
      * @note Can be invoked from Interrupt Service Routines.
      */
     clock::timestamp_t
     clock::now (void)
     {
-      // ----- Enter critical section -----------------------------------------
-      interrupts::critical_section ics;
+      timestamp_t ts;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ts = steady_count_;
+        }
+      while (internal_retry_read_ (seq));
 
-      // Prevent inconsistent values using the critical section.
-      return steady_count_;
-      // ----- Exit critical section ------------------------------------------
+      return ts;
     }
 
     /**
      * @details
+     * The count is read without disabling interrupts; if a tick
+     * updated it meanwhile, it is read again.
      *
      * @note Can be invoked from Interrupt Service Routines.
      */
     clock::timestamp_t
     clock::steady_now (void)
     {
-      // ----- Enter critical section -----------------------------------------
-      interrupts::critical_section ics;
+      timestamp_t ts;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ts = steady_count_;
+        }
+      while (internal_retry_read_ (seq));
 
-      // Prevent inconsistent values using the critical section.
-      return steady_count_;
-      // ----- Exit critical section ------------------------------------------
+      return ts;
     }
 
     /**
      * @details
+     * If the slack is not zero, the wake-up may be delayed up to
+     * _slack_ clock units, to match an already scheduled timeout,
+     * so that a single clock interrupt serves both.
      *
      * @warning Cannot be invoked from Interrupt Service Routines.
      */
     result_t
-    clock::sleep_for (duration_t duration)
+    clock::sleep_for (duration_t duration, duration_t slack)
     {
 #if defined(OS_TRACE_RTOS_CLOCKS)
       trace::printf ("%s(%u) %p %s\n", __func__,
@@ -213,10 +271,20 @@ namespace os
       os_assert_err(!scheduler::locked (), EPERM);
 
       clock::timestamp_t timestamp = steady_now () + duration;
+      clock::timestamp_t wakeup = timestamp;
+      if (slack != 0)
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          wakeup = steady_list_.coalesce (timestamp, slack);
+          // ----- Exit critical section --------------------------------------
+        }
+
       for (;;)
         {
           result_t res;
-          res = internal_wait_until_ (timestamp, steady_list_);
+          res = internal_wait_until_ (wakeup, steady_list_);
 
           timestamp_t n = steady_now ();
           if (n >= timestamp)
@@ -314,6 +382,12 @@ namespace os
      * @cond ignore
      */
 
+    void
+    clock::internal_schedule_next (void)
+    {
+      ;
+    }
+
     clock::offset_t
     clock::offset (void)
     {
@@ -347,6 +421,10 @@ namespace os
 
           // Add this thread to the clock waiting list.
           list.link (node);
+          if (&list == &steady_list_)
+            {
+              internal_schedule_next ();
+            }
           crt_thread.clock_node_ = &node;
           crt_thread.state_ = thread::state::suspended;
           // ----- Exit critical section --------------------------------------
@@ -385,21 +463,30 @@ namespace os
 
     /**
      * @details
+     * The count and the offset are read without disabling
+     * interrupts; if they were updated meanwhile, they are
+     * read again.
      *
      * @note Can be invoked from Interrupt Service Routines.
      */
     clock::timestamp_t
     adjustable_clock::now (void)
     {
-      // Prevent inconsistent values.
-      // ----- Enter critical section -----------------------------------------
-      interrupts::critical_section ics;
+      timestamp_t ts;
+      offset_t ofs;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ts = steady_count_;
+          ofs = offset_;
+        }
+      while (internal_retry_read_ (seq));
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
-      return steady_count_ + offset_;
+      return ts + ofs;
 #pragma GCC diagnostic pop
-      // ----- Exit critical section ------------------------------------------
     }
 
     /**
@@ -449,7 +536,16 @@ namespace os
     clock::offset_t
     adjustable_clock::offset (void)
     {
-      return offset_;
+      offset_t ofs;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ofs = offset_;
+        }
+      while (internal_retry_read_ (seq));
+
+      return ofs;
     }
 
     /**
@@ -465,7 +561,9 @@ namespace os
 
       offset_t tmp;
       tmp = offset_;
+      internal_begin_write_ ();
       offset_ = value;
+      internal_end_write_ ();
 
       return tmp;
       // ----- Exit critical section ------------------------------------------
@@ -729,13 +827,89 @@ namespace os
     clock::timestamp_t
     clock_highres::now (void)
     {
-      // ----- Enter critical section -----------------------------------------
-      interrupts::critical_section ics;
+      timestamp_t ts;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ts = steady_count_ + port::clock_highres::cycles_since_tick ();
+        }
+      while (internal_retry_read_ (seq));
 
-      return steady_count_ + port::clock_highres::cycles_since_tick ();
-      // ----- Exit critical section ------------------------------------------
+      return ts;
+    }
+
+#if defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE)
+
+    /**
+     * @details
+     * With the hardware compare, the steady time includes the
+     * cycles elapsed since the last tick, so sleeps and timers
+     * are computed from the actual moment and expire at the exact
+     * cycle, not at the beginning of the tick.
+     *
+     * @note Can be invoked from Interrupt Service Routines.
+     */
+    clock::timestamp_t
+    clock_highres::steady_now (void)
+    {
+      timestamp_t ts;
+      uint32_t seq;
+      do
+        {
+          seq = internal_begin_read_ ();
+          ts = steady_count_ + port::clock_highres::cycles_since_tick ();
+        }
+      while (internal_retry_read_ (seq));
+
+      return ts;
     }
 
+    /**
+     * @details
+     * Program the hardware compare for the earliest time stamp
+     * in the list, if any; otherwise the previous compare is
+     * left in place and the next interrupt will find nothing to do.
+     *
+     * Must be called in an interrupts critical section.
+     */
+    void
+    clock_highres::internal_schedule_next (void)
+    {
+      // When empty, head() is the list sentinel, not a node.
+      if (!steady_list_.empty ())
+        {
+          const internal::timestamp_node* head =
+              const_cast<const internal::timestamp_node*> (
+                  steady_list_.head ());
+          port::clock_highres::compare (head->timestamp);
+        }
+    }
+
+    /**
+     * @details
+     * Process all time stamps due at the current cycle count,
+     * then reprogram the compare for the next one.
+     *
+     * Periodic timers re-linked while processing are also
+     * covered, since the compare is reprogrammed at the end.
+     */
+    void
+    clock_highres::internal_check_compare (void)
+    {
+      steady_list_.check_timestamp (now ());
+
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          internal_schedule_next ();
+          // ----- Exit critical section --------------------------------------
+        }
+    }
+
+#endif /* defined(OS_USE_RTOS_PORT_CLOCK_HIGHRES_COMPARE) */
+
   // --------------------------------------------------------------------------
 
   } /* namespace rtos */
@@ -364,23 +364,44 @@ namespace os
       {
 #if defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES)
 
-        // Get the high resolution timestamp.
-        clock::timestamp_t now = hrclock.now ();
-
-        // Compute duration since previous context switch.
-        // Assume scheduler is not disabled for very long.
-        rtos::statistics::duration_t delta =
-            static_cast<rtos::statistics::duration_t> (now
-                - scheduler::statistics::switch_timestamp_);
-
-        // Accumulate durations to scheduler total.
-        scheduler::statistics::cpu_cycles_ += delta;
-
-        // Accumulate durations to old thread.
-        scheduler::current_thread_->statistics_.cpu_cycles_ += delta;
-
-        // Remember the timestamp for the next context switch.
-        scheduler::statistics::switch_timestamp_ = now;
+          {
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+            // ----- Enter critical section -----------------------------------
+            // The accounted interrupts also move the timestamp.
+            interrupts::critical_section ics;
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+            // Get the high resolution timestamp.
+            clock::timestamp_t now = hrclock.now ();
+
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+            if (scheduler::statistics::interrupts_nesting_ > 0)
+              {
+                // Switching from an accounted handler; the old thread
+                // ran only up to the handler entry.
+                now = scheduler::statistics::interrupts_timestamp_;
+              }
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+            // Compute duration since previous context switch.
+            // Assume scheduler is not disabled for very long.
+            rtos::statistics::duration_t delta =
+                static_cast<rtos::statistics::duration_t> (now
+                    - scheduler::statistics::switch_timestamp_);
+
+            // Accumulate durations to scheduler total.
+            scheduler::statistics::cpu_cycles_ += delta;
+
+            // Accumulate durations to old thread.
+            scheduler::current_thread_->statistics_.internal_add_cycles_ (
+                delta);
+
+            // Remember the timestamp for the next context switch.
+            scheduler::statistics::switch_timestamp_ = now;
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+            // ----- Exit critical section ------------------------------------
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+          }
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
@@ -427,6 +448,137 @@ namespace os
 
 #endif /* defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES) */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+        uint32_t volatile window_;
+        clock::timestamp_t window_start_;
+        rtos::statistics::duration_t window_cycles_;
+        rtos::statistics::duration_t interrupts_cycles_;
+        rtos::statistics::duration_t interrupts_last_cycles_;
+        clock::timestamp_t interrupts_timestamp_;
+        uint32_t interrupts_nesting_;
+
+        /**
+         * @details
+         * Convert a number of cycles from the last window to
+         * hundredths of percent.
+         */
+        uint32_t
+        internal_load (rtos::statistics::duration_t cycles)
+        {
+          if (window_cycles_ == 0)
+            {
+              return 0;
+            }
+          rtos::statistics::duration_t load = cycles * 10000 / window_cycles_;
+          return (load > 10000) ? 10000 : static_cast<uint32_t> (load);
+        }
+
+        /**
+         * @details
+         * Called from `os_systick_handler()` at the end of each window.
+         *
+         * The running thread and the active interrupts are charged
+         * up to the window end, so their previous window is
+         * complete; the other threads are updated lazily, when
+         * they run again.
+         *
+         * Called from an accounted handler, so the running thread
+         * is charged only up to the handler entry.
+         */
+        void
+        internal_roll_window (void)
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          clock::timestamp_t now = hrclock.now ();
+
+#if !defined(OS_USE_RTOS_PORT_SCHEDULER)
+          if (scheduler::started ())
+            {
+              clock::timestamp_t end =
+                  (interrupts_nesting_ > 0) ? interrupts_timestamp_ : now;
+              rtos::statistics::duration_t delta =
+                  static_cast<rtos::statistics::duration_t> (end
+                      - switch_timestamp_);
+              cpu_cycles_ += delta;
+              scheduler::current_thread_->statistics_.internal_add_cycles_ (
+                  delta);
+              // The rest of the handler is added on exit.
+              switch_timestamp_ = now;
+            }
+#endif /* !defined(OS_USE_RTOS_PORT_SCHEDULER) */
+
+          if (interrupts_nesting_ > 0)
+            {
+              interrupts_cycles_ += now - interrupts_timestamp_;
+              interrupts_timestamp_ = now;
+            }
+          interrupts_last_cycles_ = interrupts_cycles_;
+          interrupts_cycles_ = 0;
+
+          window_cycles_ = now - window_start_;
+          window_start_ = now;
+
+          ++window_;
+          // ----- Exit critical section --------------------------------------
+        }
+
+        /**
+         * @details
+         * Only the outermost handler is timed, so nested
+         * interrupts are not counted twice.
+         *
+         * The handler time is not charged to the interrupted thread
+         * (the thread switch timestamp is moved forward on exit), so
+         * the threads and the interrupts loads do not overlap.
+         */
+        void
+        internal_interrupt_enter (void)
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          if (interrupts_nesting_++ == 0)
+            {
+              interrupts_timestamp_ = hrclock.now ();
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+
+        void
+        internal_interrupt_exit (void)
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          if (--interrupts_nesting_ == 0)
+            {
+              rtos::statistics::duration_t cycles =
+                  static_cast<rtos::statistics::duration_t> (hrclock.now ()
+                      - interrupts_timestamp_);
+              interrupts_cycles_ += cycles;
+#if !defined(OS_USE_RTOS_PORT_SCHEDULER)
+              switch_timestamp_ += cycles;
+#endif /* !defined(OS_USE_RTOS_PORT_SCHEDULER) */
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+
+        /**
+         * @details
+         *
+         * @note Can be invoked from Interrupt Service Routines.
+         */
+        uint32_t
+        interrupts_load (void)
+        {
+          return internal_load (interrupts_last_cycles_);
+        }
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
       } /* namespace statistics */
 
     /**
@@ -435,6 +587,48 @@ namespace os
 
     } /* namespace scheduler */
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+    /**
+     * @details
+     * This value can be used together with the corresponding
+     * scheduler functions, to display a list of threads
+     * sorted by load.
+     *
+     * @note This function is available only when
+     * @ref OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD
+     * is defined.
+     *
+     * @note Can be invoked from Interrupt Service Routines.
+     */
+    uint32_t
+    thread::statistics::cpu_load (void)
+    {
+      rtos::statistics::duration_t cycles;
+        {
+          // ----- Enter critical section -------------------------------------
+          interrupts::critical_section ics;
+
+          uint32_t window = scheduler::statistics::window_;
+          if (window_ == window)
+            {
+              cycles = last_window_cycles_;
+            }
+          else if (window_ + 1 == window)
+            {
+              cycles = window_cycles_;
+            }
+          else
+            {
+              cycles = 0;
+            }
+          // ----- Exit critical section --------------------------------------
+        }
+      return scheduler::statistics::internal_load (cycles);
+    }
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
     /**
      * @details
      * The os::rtos::interrupts namespace groups interrupts related
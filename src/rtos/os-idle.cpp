@@ -97,3 +97,21 @@ os_idle (thread::func_args_t args __attribute__((unused)))
  */
 
 // ----------------------------------------------------------------------------
+
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+/**
+ * @details
+ * The idle thread is private to this file.
+ *
+ * @note Can be invoked from Interrupt Service Routines.
+ */
+uint32_t
+os::rtos::scheduler::statistics::idle_load (void)
+{
+  return os_idle_thread.statistics ().cpu_load ();
+}
+
+#endif /* defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD) */
+
+// ----------------------------------------------------------------------------
@@ -34,6 +34,7 @@
  */
 
 #include <cmsis-plus/rtos/os-memory.h>
+#include <cmsis-plus/iso/malloc.h>
 #include <new>
 #include <cstdlib>
 
@@ -55,19 +56,30 @@ namespace
   protected:
 
     virtual void*
-    do_allocate (std::size_t bytes,
-                 std::size_t alignment __attribute__((unused)))
+    do_allocate (std::size_t bytes, std::size_t alignment)
     {
-      // Ignore alignment for now.
-      return ::operator new (bytes);
+      if (alignment <= max_align)
+        {
+          // The usual allocator already guarantees this alignment.
+          return ::operator new (bytes);
+        }
+
+      return memory::internal::allocate_aligned (bytes, alignment);
     }
 
     virtual void
     do_deallocate (void * p, std::size_t bytes __attribute__((unused)),
-                   std::size_t alignment __attribute__((unused)))
+                   std::size_t alignment)
     {
-      // Ignore size and alignment for now.
-      ::operator delete (p);
+      // Ignore size for now.
+      if (alignment <= max_align)
+        {
+          ::operator delete (p);
+        }
+      else
+        {
+          memory::internal::deallocate_aligned (p, alignment);
+        }
     }
 
     virtual bool
@@ -138,6 +150,56 @@ namespace os
   {
     namespace memory
     {
+      namespace internal
+      {
+        /**
+         * @details
+         * Allocate storage with an extended alignment, larger than
+         * `alignof(std::max_align_t)`, like DMA buffers or cache line
+         * aligned objects.
+         *
+         * If C++17 aligned new is available, forward to it,
+         * otherwise use `estd::aligned_alloc()` directly.
+         */
+        void*
+        allocate_aligned (std::size_t bytes, std::size_t alignment)
+        {
+          assert((alignment & (alignment - 1)) == 0);
+
+#if defined(__cpp_aligned_new)
+          // Without exceptions, it returns `nullptr` on failure.
+          void* p = ::operator new (bytes,
+                                    static_cast<std::align_val_t> (alignment));
+#else
+          void* p = estd::aligned_alloc (alignment, bytes);
+#endif
+          if (p == nullptr)
+            {
+#if defined(__EXCEPTIONS)
+              throw std::bad_alloc ();
+#else
+              std::abort ();
+#endif
+            }
+          return p;
+        }
+
+        /**
+         * @details
+         * Release storage obtained from allocate_aligned().
+         */
+        void
+        deallocate_aligned (void* p,
+                            std::size_t alignment __attribute__((unused))) noexcept
+        {
+#if defined(__cpp_aligned_new)
+          ::operator delete (p, static_cast<std::align_val_t> (alignment));
+#else
+          estd::free (p);
+#endif
+        }
+      } /* namespace internal */
+
       // ----------------------------------------------------------------------
 
       memory_resource::~memory_resource ()
@@ -1439,6 +1439,103 @@ namespace os
       return res;
     }
 
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+    /**
+     * @details
+     * The release points are counted from the current time of the
+     * thread clock; all statistics are cleared.
+     *
+     * @warning Cannot be invoked from Interrupt Service Routines.
+     */
+    result_t
+    thread::internal_set_period_ (clock::duration_t period,
+                                  bool skip_overruns)
+    {
+#if defined(OS_TRACE_RTOS_THREAD)
+      trace::printf ("%s(%u) @%p %s\n", __func__,
+                     static_cast<unsigned int> (period), this, name ());
+#endif
+
+      os_assert_err(!interrupts::in_handler_mode (), EPERM);
+      os_assert_err(period != 0, EINVAL);
+
+      periodic_.period_ = period;
+      periodic_.skip_overruns_ = skip_overruns;
+      periodic_.next_release_ = clock_->now ();
+      periodic_.releases_ = 0;
+      periodic_.overruns_ = 0;
+      periodic_.jitter_total_ = 0;
+      periodic_.jitter_max_ = 0;
+
+      return result::ok;
+    }
+
+    /**
+     * @details
+     * The next release point is always the previous one plus the
+     * period, never computed from the current time, so there
+     * is no drift.
+     *
+     * @warning Cannot be invoked from Interrupt Service Routines.
+     */
+    result_t
+    thread::internal_wait_next_period_ (void)
+    {
+      os_assert_err(!interrupts::in_handler_mode (), EPERM);
+      os_assert_err(periodic_.period_ != 0, EINVAL);
+
+      result_t res = result::ok;
+
+      // Work on a local copy; the stored release point advances only
+      // after the sleep completes, so an interrupted wait can be retried
+      // without skipping a period.
+      clock::timestamp_t next = periodic_.next_release_ + periodic_.period_;
+      clock::timestamp_t missed = 0;
+
+      clock::timestamp_t nw = clock_->now ();
+      if (nw > next)
+        {
+          res = ETIMEDOUT;
+          if (!periodic_.skip_overruns_)
+            {
+              // Catch up, the release points keep their phase.
+              periodic_.next_release_ = next;
+              ++periodic_.overruns_;
+              ++periodic_.releases_;
+              return res;
+            }
+
+          // Skip all release points already passed.
+          missed = 1 + (nw - next) / periodic_.period_;
+          next += missed * periodic_.period_;
+        }
+
+      result_t sres = clock_->sleep_until (next);
+      if (sres != ETIMEDOUT)
+        {
+          // Interrupted or failed; the release point is kept.
+          return sres;
+        }
+
+      periodic_.next_release_ = next;
+      periodic_.overruns_ += missed;
+
+      clock::duration_t jitter =
+          static_cast<clock::duration_t> (clock_->now ()
+              - periodic_.next_release_);
+      periodic_.jitter_total_ += jitter;
+      if (jitter > periodic_.jitter_max_)
+        {
+          periodic_.jitter_max_ = jitter;
+        }
+      ++periodic_.releases_;
+
+      return res;
+    }
+
+#endif /* defined(OS_INCLUDE_RTOS_THREAD_PERIODIC) */
+
     /**
      * @endcond
      */
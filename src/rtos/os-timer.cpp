@@ -34,6 +34,90 @@
 
 // ----------------------------------------------------------------------------
 
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON) && !defined(OS_USE_RTOS_PORT_TIMER)
+
+/**
+ * @cond ignore
+ */
+
+namespace
+{
+  // The flag raised by the clock interrupt to wake up the daemon.
+  constexpr os::rtos::flags::mask_t daemon_flag = 1;
+
+#pragma GCC diagnostic push
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#endif
+
+  // Timers expired in the clock interrupt, waiting for the daemon.
+  os::rtos::internal::clock_timestamps_list daemon_pending_timers;
+
+  os::rtos::thread_static<OS_INTEGER_RTOS_TIMER_DAEMON_STACK_SIZE_BYTES> daemon_thread
+    { "timer", os_timer_daemon, nullptr };
+
+#pragma GCC diagnostic pop
+}
+
+/**
+ * @details
+ * Wait for the clock interrupt to signal expired timers, then
+ * call their functions in a batch, in thread context.
+ *
+ * Timers are taken one at a time from the pending list, so a
+ * timer stopped while pending is no longer called; a function
+ * already dequeued will still be called.
+ */
+void*
+os_timer_daemon (void* args __attribute__((unused)))
+{
+  using namespace os::rtos;
+
+  // The thread was created with the default priority.
+  this_thread::thread ().priority (OS_INTEGER_RTOS_TIMER_DAEMON_PRIORITY);
+
+  while (true)
+    {
+      this_thread::flags_wait (daemon_flag);
+
+      while (true)
+        {
+          timer* tm;
+            {
+              // ----- Enter critical section ---------------------------------
+              interrupts::critical_section ics;
+
+              if (daemon_pending_timers.empty ())
+                {
+                  break;
+                }
+
+              internal::timer_node* node =
+                  const_cast<internal::timer_node*> (static_cast<volatile internal::timer_node*> (daemon_pending_timers.head ()));
+              node->unlink ();
+
+              tm = &node->tmr;
+              tm->internal_rearm_ ();
+              // ----- Exit critical section ----------------------------------
+            }
+
+          // Call the user function, with interrupts enabled.
+          tm->func_ (tm->func_args_);
+        }
+    }
+
+  return nullptr;
+}
+
+/**
+ * @endcond
+ */
+
+#endif
+
+// ----------------------------------------------------------------------------
+
 namespace os
 {
   namespace rtos
@@ -183,11 +267,13 @@ namespace os
       os_assert_throw(function != nullptr, EINVAL);
 
       type_ = attr.tm_type;
+      execution_ = attr.tm_execution;
       func_ = function;
       func_args_ = args;
 
 #if !defined(OS_USE_RTOS_PORT_TIMER)
       clock_ = attr.clock != nullptr ? attr.clock : &sysclock;
+      slack_ = attr.tm_slack;
 #endif
 
 #if defined(OS_USE_RTOS_PORT_TIMER)
@@ -270,7 +356,7 @@ namespace os
 
       period_ = period;
 
-      timer_node_.timestamp = clock_->steady_now () + period;
+      expiry_ = clock_->steady_now () + period;
 
         {
           // ----- Enter critical section -------------------------------------
@@ -279,7 +365,10 @@ namespace os
           // If started, stop.
           timer_node_.unlink ();
 
+          timer_node_.timestamp = clock_->steady_list ().coalesce (expiry_,
+                                                                   slack_);
           clock_->steady_list ().link (timer_node_);
+          clock_->internal_schedule_next ();
           // ----- Exit critical section --------------------------------------
         }
       res = result::ok;
@@ -348,26 +437,48 @@ namespace os
     void
     timer::internal_interrupt_service_routine (void)
     {
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON)
+      if (execution_ == execution::daemon)
+        {
+          // The node was just removed from the clock list; move it
+          // to the daemon list. Re-arming is also done by the daemon.
+          daemon_pending_timers.link (timer_node_);
+          daemon_thread.flags_raise (daemon_flag);
+          return;
+        }
+#endif
+
+      internal_rearm_ ();
+
+#if defined(OS_USE_RTOS_PORT_TIMER)
+      trace::puts (name ());
+#endif
 
+      // Call the user function.
+      func_ (func_args_);
+    }
+
+    // Must be called in a critical section.
+    void
+    timer::internal_rearm_ (void)
+    {
       if (type_ == run::periodic)
         {
-          // Re-arm the timer for the next period.
-          timer_node_.timestamp += period_;
+          // Re-arm the timer for the next period; the period is
+          // counted from the nominal expiry, so the slack does
+          // not accumulate.
+          expiry_ += period_;
 
           // No need for critical section in ISR.
+          timer_node_.timestamp = clock_->steady_list ().coalesce (expiry_,
+                                                                   slack_);
           clock_->steady_list ().link (timer_node_);
+          clock_->internal_schedule_next ();
         }
       else
         {
           state_ = state::completed;
         }
-
-#if defined(OS_USE_RTOS_PORT_TIMER)
-      trace::puts (name ());
-#endif
-
-      // Call the user function.
-      func_ (func_args_);
     }
 
   /**
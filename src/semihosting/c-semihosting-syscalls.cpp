@@ -34,6 +34,10 @@
 #if defined(OS_USE_SEMIHOSTING_SYSCALLS)
 
 #include <cmsis-plus/arm/semihosting.h>
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+#include <cmsis-plus/arm/semihosting-buffer.h>
+#include <cmsis-plus/rtos/os.h>
+#endif
 #include <cmsis-plus/diag/trace.h>
 
 #include <cmsis-plus/posix-io/types.h>
@@ -86,6 +90,12 @@ struct fdent
 {
   int handle;
   int pos;
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  // Reduce the number of host calls; `pos` is the logical position.
+  // The buffer is not thread safe; it is used only with the
+  // scheduler locked.
+  os::semihosting::file_buffer buffer;
+#endif
 };
 
 /*
@@ -204,6 +214,16 @@ __semihosting_lseek (int fd, int ptr, int dir)
       return -1;
     }
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  os::rtos::scheduler::critical_section scs;
+
+  // Bring the host file to the logical position.
+  if (pfd->buffer.flush () != 0)
+    {
+      return -1;
+    }
+#endif
+
   /* Convert SEEK_CUR to SEEK_SET */
   if (dir == SEEK_CUR)
     {
@@ -244,6 +264,9 @@ __semihosting_lseek (int fd, int ptr, int dir)
   if (res >= 0)
     {
       pfd->pos = ptr;
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+      pfd->buffer.position (ptr);
+#endif
       return ptr;
     }
   else
@@ -268,6 +291,16 @@ __semihosting_stat (int fd, struct stat* st)
   st->st_mode |= S_IFCHR;
   st->st_blksize = 1024;
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  os::rtos::scheduler::critical_section scs;
+
+  // The length must include the pending writes.
+  if (pfd->buffer.flush () != 0)
+    {
+      return -1;
+    }
+#endif
+
   int res;
   res = __semihosting_checkerror (
       call_host (SEMIHOSTING_SYS_FLEN, &pfd->handle));
@@ -358,6 +391,9 @@ __posix_open (const char* path, int oflag, ...)
     {
       openfiles[fd].handle = fh;
       openfiles[fd].pos = 0;
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+      openfiles[fd].buffer.reset (fh, false);
+#endif
       return fd;
     }
   else
@@ -377,6 +413,14 @@ __posix_close (int fildes)
       return -1;
     }
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  os::rtos::scheduler::critical_section scs;
+
+  // Pass the pending writes to the host; the error, if any, is
+  // reported, but the file is closed anyway.
+  int err = pfd->buffer.flush ();
+#endif
+
   // Handle stderr == stdout.
   if ((fildes == 1 || fildes == 2)
       && (openfiles[1].handle == openfiles[2].handle))
@@ -398,6 +442,13 @@ __posix_close (int fildes)
       pfd->handle = -1;
     }
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  if (res == 0 && err != 0)
+    {
+      return -1;
+    }
+#endif
+
   return res;
 }
 
@@ -418,6 +469,22 @@ __posix_read (int fildes, void* buf, size_t nbyte)
       return -1;
     }
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+
+  // The buffer is shared by all threads using the descriptor.
+  // ----- Enter critical section -------------------------------------------
+  os::rtos::scheduler::critical_section scs;
+
+  ssize_t ret = pfd->buffer.read (buf, nbyte);
+  if (ret > 0)
+    {
+      pfd->pos += ret;
+    }
+  return ret;
+  // ----- Exit critical section --------------------------------------------
+
+#else
+
   int block[3];
   block[0] = pfd->handle;
   block[1] = (int) buf;
@@ -436,6 +503,8 @@ __posix_read (int fildes, void* buf, size_t nbyte)
   /* res == nbyte is not an error,
    at least if we want feof() to work.  */
   return nbyte - res;
+
+#endif /* defined(OS_USE_SEMIHOSTING_BUFFERS) */
 }
 
 ssize_t
@@ -449,6 +518,29 @@ __posix_write (int fildes, const void* buf, size_t nbyte)
       return -1;
     }
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+
+  // The buffer is shared by all threads using the descriptor.
+  // ----- Enter critical section -------------------------------------------
+  os::rtos::scheduler::critical_section scs;
+
+  // When stderr uses the same host handle as stdout, it also uses
+  // the same buffer, to keep the order of the messages.
+  if (fildes == 2 && openfiles[1].handle == openfiles[2].handle)
+    {
+      pfd = &openfiles[1];
+    }
+
+  ssize_t ret = pfd->buffer.write (buf, nbyte);
+  if (ret > 0)
+    {
+      pfd->pos += ret;
+    }
+  return ret;
+  // ----- Exit critical section --------------------------------------------
+
+#else
+
   int block[3];
 
   block[0] = pfd->handle;
@@ -474,6 +566,8 @@ __posix_write (int fildes, const void* buf, size_t nbyte)
     }
 
   return (nbyte - res);
+
+#endif /* defined(OS_USE_SEMIHOSTING_BUFFERS) */
 }
 
 off_t
@@ -913,6 +1007,13 @@ __posix_select (int nfds, fd_set* readfds, fd_set* writefds, fd_set* errorfds,
   return -1;
 }
 
+int
+__posix_poll (struct pollfd fds[], nfds_t nfds, int timeout)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
 int
 __posix_chdir (const char* path)
 {
@@ -923,6 +1024,13 @@ __posix_chdir (const char* path)
 // ----------------------------------------------------------------------------
 // Not available via semihosting.
 
+ssize_t
+__posix_readv (int fildes, const struct iovec* iov, int iovcnt)
+{
+  errno = ENOSYS; // Not implemented
+  return -1;
+}
+
 ssize_t
 __posix_writev (int fildes, const struct iovec* iov, int iovcnt)
 {
@@ -954,8 +1062,21 @@ __posix_ftruncate (int fildes, off_t length)
 int
 __posix_fsync (int fildes)
 {
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  struct fdent *pfd;
+  pfd = __semihosting_findslot (fildes);
+  if (pfd == NULL)
+    {
+      errno = EBADF;
+      return -1;
+    }
+
+  os::rtos::scheduler::critical_section scs;
+  return pfd->buffer.flush ();
+#else
   errno = ENOSYS; // Not implemented
   return -1;
+#endif
 }
 
 int
@@ -1062,6 +1183,17 @@ _Exit (int code)
 
   trace_flush ();
 
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  // Do not lose the buffered output.
+  for (int i = 0; i < OS_INTEGER_SEMIHOSTING_MAX_OPEN_FILES; i++)
+    {
+      if (openfiles[i].handle != -1)
+        {
+          openfiles[i].buffer.flush ();
+        }
+    }
+#endif
+
 #if defined(DEBUG)
 #if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
   if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0)
@@ -1254,6 +1386,12 @@ initialise_monitor_handles (void)
   openfiles[1].pos = 0;
   openfiles[2].handle = monitor_stderr;
   openfiles[2].pos = 0;
+
+#if defined(OS_USE_SEMIHOSTING_BUFFERS)
+  openfiles[0].buffer.reset (monitor_stdin, true);
+  openfiles[1].buffer.reset (monitor_stdout, true);
+  openfiles[2].buffer.reset (monitor_stderr, true);
+#endif
 }
 
 // ----------------------------------------------------------------------------
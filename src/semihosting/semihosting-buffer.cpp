@@ -0,0 +1,290 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/os-app-config.h>
+
+// Compiled also for host tests, with a mocked call_host().
+#if defined(OS_USE_SEMIHOSTING_SYSCALLS) && defined(OS_USE_SEMIHOSTING_BUFFERS)
+
+#include <cmsis-plus/arm/semihosting.h>
+#include <cmsis-plus/arm/semihosting-buffer.h>
+
+#include <cstring>
+#include <cerrno>
+
+// ----------------------------------------------------------------------------
+
+static_assert(OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES > 0
+    && OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES <= UINT16_MAX,
+    "OS_INTEGER_SEMIHOSTING_BUFFER_SIZE_BYTES out of range.");
+
+namespace os
+{
+  namespace semihosting
+  {
+    // ------------------------------------------------------------------------
+
+    void
+    file_buffer::reset (int handle, bool tty)
+    {
+      handle_ = handle;
+      host_pos_ = 0;
+      count_ = 0;
+      index_ = 0;
+      mode_ = mode::idle;
+      tty_ = tty;
+    }
+
+    /**
+     * @details
+     * Small writes are only copied to the buffer; writes larger than
+     * the buffer are passed to the host directly, after the
+     * pending bytes.
+     *
+     * If passing a full buffer to the host fails, the bytes already
+     * copied are counted as written, and the unwritten ones are
+     * kept, so the error is also reported by the next flush().
+     */
+    ssize_t
+    file_buffer::write (const void* buf, std::size_t nbyte)
+    {
+      if (mode_ == mode::reading)
+        {
+          if (flush () != 0)
+            {
+              return -1;
+            }
+        }
+      mode_ = mode::writing;
+
+      if (nbyte >= sizeof(data_))
+        {
+          if (flush () != 0)
+            {
+              return -1;
+            }
+          return host_write_ (buf, nbyte);
+        }
+
+      const uint8_t* p = static_cast<const uint8_t*> (buf);
+      std::size_t n = nbyte;
+      while (n > 0)
+        {
+          std::size_t chunk = sizeof(data_) - count_;
+          if (chunk > n)
+            {
+              chunk = n;
+            }
+          std::memcpy (&data_[count_], p, chunk);
+          count_ = static_cast<uint16_t> (count_ + chunk);
+          p += chunk;
+          n -= chunk;
+
+          if (count_ == sizeof(data_))
+            {
+              if (flush () != 0)
+                {
+                  std::size_t const done = nbyte - n;
+                  return (done > 0) ? static_cast<ssize_t> (done) : -1;
+                }
+            }
+        }
+
+#if OS_BOOL_SEMIHOSTING_BUFFER_FLUSH_ON_NEWLINE
+      if (tty_ && count_ > 0 && std::memchr (buf, '\n', nbyte) != nullptr)
+        {
+          // All bytes were accepted; an error is reported again
+          // by the next flush().
+          flush ();
+        }
+#endif
+
+      return static_cast<ssize_t> (nbyte);
+    }
+
+    /**
+     * @details
+     * Reads are served from the buffer; when it is empty, a full
+     * buffer is requested from the host (for terminals the host
+     * returns at the end of the line). Reads larger than the
+     * buffer go directly to the destination.
+     */
+    ssize_t
+    file_buffer::read (void* buf, std::size_t nbyte)
+    {
+      if (mode_ == mode::writing)
+        {
+          if (flush () != 0)
+            {
+              return -1;
+            }
+        }
+      mode_ = mode::reading;
+
+      uint8_t* p = static_cast<uint8_t*> (buf);
+      std::size_t done = 0;
+
+      // First what is already available.
+      std::size_t avail = static_cast<std::size_t> (count_ - index_);
+      if (avail > 0)
+        {
+          done = (avail < nbyte) ? avail : nbyte;
+          std::memcpy (p, &data_[index_], done);
+          index_ = static_cast<uint16_t> (index_ + done);
+          if (done == nbyte || tty_)
+            {
+              // For terminals do not wait for more lines.
+              return static_cast<ssize_t> (done);
+            }
+        }
+
+      std::size_t left = nbyte - done;
+      if (left >= sizeof(data_))
+        {
+          ssize_t res = host_read_ (p + done, left);
+          if (res < 0)
+            {
+              return (done > 0) ? static_cast<ssize_t> (done) : -1;
+            }
+          return static_cast<ssize_t> (done + static_cast<std::size_t> (res));
+        }
+
+      ssize_t res = host_read_ (data_, sizeof(data_));
+      if (res < 0)
+        {
+          return (done > 0) ? static_cast<ssize_t> (done) : -1;
+        }
+      count_ = static_cast<uint16_t> (res);
+      index_ = 0;
+
+      std::size_t n = (static_cast<std::size_t> (res) < left) ?
+          static_cast<std::size_t> (res) : left;
+      std::memcpy (p + done, data_, n);
+      index_ = static_cast<uint16_t> (n);
+
+      return static_cast<ssize_t> (done + n);
+    }
+
+    int
+    file_buffer::flush (void)
+    {
+      int ret = 0;
+      if (mode_ == mode::writing && count_ > 0)
+        {
+          ssize_t res = host_write_ (data_, count_);
+          if (res != static_cast<ssize_t> (count_))
+            {
+              if (res >= 0)
+                {
+                  // Keep the bytes not written, for a later retry.
+                  std::size_t const written = static_cast<std::size_t> (res);
+                  std::memmove (data_, &data_[written], count_ - written);
+                  count_ = static_cast<uint16_t> (count_ - written);
+                  errno = EIO;
+                }
+              return -1;
+            }
+        }
+      else if (mode_ == mode::reading && index_ < count_ && !tty_)
+        {
+          // Move the host position back to the first unread byte.
+          int pos = host_pos_ - (count_ - index_);
+          uintptr_t block[2];
+          block[0] = static_cast<uintptr_t> (handle_);
+          block[1] = static_cast<uintptr_t> (pos);
+          if (call_host (SEMIHOSTING_SYS_SEEK, block) < 0)
+            {
+              errno = call_host (SEMIHOSTING_SYS_ERRNO, nullptr);
+              ret = -1;
+            }
+          else
+            {
+              host_pos_ = pos;
+            }
+        }
+
+      count_ = 0;
+      index_ = 0;
+      mode_ = mode::idle;
+      return ret;
+    }
+
+    void
+    file_buffer::position (int pos)
+    {
+      host_pos_ = pos;
+    }
+
+    ssize_t
+    file_buffer::host_write_ (const void* buf, std::size_t nbyte)
+    {
+      uintptr_t block[3];
+      block[0] = static_cast<uintptr_t> (handle_);
+      block[1] = reinterpret_cast<uintptr_t> (buf);
+      block[2] = nbyte;
+
+      // Returns the number of bytes *not* written.
+      int res = call_host (SEMIHOSTING_SYS_WRITE, block);
+      if (res < 0)
+        {
+          errno = call_host (SEMIHOSTING_SYS_ERRNO, nullptr);
+          return -1;
+        }
+
+      std::size_t written = nbyte - static_cast<std::size_t> (res);
+      host_pos_ += static_cast<int> (written);
+      return static_cast<ssize_t> (written);
+    }
+
+    ssize_t
+    file_buffer::host_read_ (void* buf, std::size_t nbyte)
+    {
+      uintptr_t block[3];
+      block[0] = static_cast<uintptr_t> (handle_);
+      block[1] = reinterpret_cast<uintptr_t> (buf);
+      block[2] = nbyte;
+
+      // Returns the number of bytes *not* read.
+      int res = call_host (SEMIHOSTING_SYS_READ, block);
+      if (res < 0)
+        {
+          errno = call_host (SEMIHOSTING_SYS_ERRNO, nullptr);
+          return -1;
+        }
+
+      std::size_t got = nbyte - static_cast<std::size_t> (res);
+      host_pos_ += static_cast<int> (got);
+      return static_cast<ssize_t> (got);
+    }
+
+  // --------------------------------------------------------------------------
+  } /* namespace semihosting */
+} /* namespace os */
+
+#endif /* defined(OS_USE_SEMIHOSTING_SYSCALLS) && defined(OS_USE_SEMIHOSTING_BUFFERS) */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+
+#include <bench.h>
+
+using namespace os;
+using namespace os::rtos;
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+  constexpr uint32_t iterations = 100000;
+
+  clock::timestamp_t volatile sink;
+}
+
+/*
+ * Cost of reading the clocks. The steady counters are read
+ * without disabling interrupts; for reference, the cost of
+ * an empty interrupts critical section is also displayed.
+ */
+int
+bench_clocks (void)
+{
+  printf ("Clocks\n");
+
+  bench_run ("critical_section", iterations, []
+    {
+      interrupts::critical_section ics;
+    });
+
+  bench_run ("sysclock.now()", iterations, []
+    {
+      sink = sysclock.now ();
+    });
+
+  bench_run ("sysclock.steady_now()", iterations, []
+    {
+      sink = sysclock.steady_now ();
+    });
+
+  bench_run ("hrclock.now()", iterations, []
+    {
+      sink = hrclock.now ();
+    });
+
+  bench_run ("rtclock.now()", iterations, []
+    {
+      sink = rtclock.now ();
+    });
+
+  printf ("\n");
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
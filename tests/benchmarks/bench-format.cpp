@@ -0,0 +1,180 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/format.h>
+
+#include <climits>
+#include <cstdarg>
+#include <cstring>
+
+#include <bench.h>
+
+using namespace os;
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+  constexpr uint32_t iterations = 10000;
+
+  char buf[200];
+  int volatile sink;
+
+  const char* volatile name = "thread";
+  void* volatile ptr = buf;
+
+  // Compare the output and the return value of the two formatters,
+  // once, with the given buffer size; the bytes past the output
+  // must be left untouched.
+  int
+  vcheck (std::size_t size, const char* format, std::va_list args)
+  {
+    char expected[sizeof(buf)];
+    std::memset (expected, '#', sizeof(expected));
+    std::memset (buf, '#', sizeof(buf));
+
+    std::va_list args2;
+    va_copy(args2, args);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    int const expected_ret = ::vsnprintf (expected, size, format, args);
+#pragma GCC diagnostic pop
+    int const ret = diag::vsnprintf (buf, size, format, args2);
+    va_end(args2);
+
+    if (ret != expected_ret || std::memcmp (expected, buf, sizeof(buf)) != 0)
+      {
+        expected[sizeof(expected) - 1] = '\0';
+        buf[sizeof(buf) - 1] = '\0';
+        printf ("mismatch %u '%s' %d '%s' %d '%s'\n",
+                static_cast<unsigned int> (size), format, expected_ret,
+                expected, ret, buf);
+        return 1;
+      }
+    return 0;
+  }
+
+  int
+  check (const char* format, ...)
+  {
+    std::va_list args;
+    va_start(args, format);
+    int const ret = vcheck (sizeof(buf), format, args);
+    va_end(args);
+
+    return ret;
+  }
+
+  int
+  check_size (std::size_t size, const char* format, ...)
+  {
+    std::va_list args;
+    va_start(args, format);
+    int const ret = vcheck (size, format, args);
+    va_end(args);
+
+    return ret;
+  }
+}
+
+/*
+ * Compare the in-tree formatter with the library vsnprintf(),
+ * using formats typical for the system trace messages.
+ */
+int
+bench_format (void)
+{
+  printf ("Format\n");
+
+  int ret = 0;
+  ret |= check ("%s() @%p %s\n", __func__, ptr, name);
+  ret |= check ("%u.%03u %-8s|%5d|%08X\n", 12u, 7u, name, -42, 0xBEEFu);
+  ret |= check ("%lu %llu %zu\n", 123456789ul, 1234567890123ull,
+                sizeof(buf));
+  ret |= check ("%+d|% d|%+u|% u|%+5u|% hhu|%+lu|% llu\n", 42, 42, 42u, 42u,
+                7u, 200u, 42ul, 42ull);
+  ret |= check ("%+x|% X|%+o|% #x\n", 42u, 42u, 42u, 42u);
+
+  // Truncation, and the length returned even with no buffer.
+  ret |= check_size (8, "%s|%d", "truncated", 12345);
+  ret |= check_size (1, "%d", 42);
+  ret |= check_size (0, "%s %d", "nothing", 42);
+
+  // The most negative values, which cannot be negated.
+  ret |= check ("%d|%i|%ld\n", INT_MIN, INT_MIN, LONG_MIN);
+  ret |= check ("%lld|%llx\n", LLONG_MIN,
+                static_cast<unsigned long long> (LLONG_MIN));
+
+  // A zero precision with a zero value displays no digits,
+  // except for the octal prefix.
+  ret |= check ("[%.0d]|[%5.0d]|[%.0d]\n", 0, 0, 7);
+  ret |= check ("[%#o]|[%#o]|[%#.0o]|[%#x]\n", 0u, 8u, 0u, 0u);
+
+  // A negative `*` width means left alignment, a negative `*`
+  // precision is ignored.
+  ret |= check ("[%*d]|[%*s]\n", -5, 42, -4, "ab");
+  ret |= check ("[%.*s]|[%.*s]|[%.*s]\n", 2, "abcdef", 0, "abc", -1, "xyz");
+
+  bench_run ("snprintf(\"%s() @%p %s\")", iterations, []
+    {
+      sink = snprintf (buf, sizeof(buf), "%s() @%p %s\n", __func__, ptr, name);
+    });
+
+  bench_run ("diag::snprintf(\"%s() @%p %s\")", iterations, []
+    {
+      sink = diag::snprintf (buf, sizeof(buf), "%s() @%p %s\n", __func__, ptr,
+                             name);
+    });
+
+  bench_run ("snprintf(\"%u.%03u %d %08X\")", iterations, []
+    {
+      sink = snprintf (buf, sizeof(buf), "%u.%03u %d %08X\n", 12u, 7u, -42,
+                       0xBEEFu);
+    });
+
+  bench_run ("diag::snprintf(\"%u.%03u %d %08X\")", iterations, []
+    {
+      sink = diag::snprintf (buf, sizeof(buf), "%u.%03u %d %08X\n", 12u, 7u,
+                             -42, 0xBEEFu);
+    });
+
+  bench_run ("snprintf(\"%llu\")", iterations, []
+    {
+      sink = snprintf (buf, sizeof(buf), "%llu\n", 1234567890123ull);
+    });
+
+  bench_run ("diag::snprintf(\"%llu\")", iterations, []
+    {
+      sink = diag::snprintf (buf, sizeof(buf), "%llu\n", 1234567890123ull);
+    });
+
+  printf ("\n");
+  return ret;
+}
+
+// ----------------------------------------------------------------------------
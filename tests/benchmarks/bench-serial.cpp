@@ -0,0 +1,493 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/drivers/usart-wrapper.h>
+#include <cmsis-plus/posix-io/buffered-serial.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+
+#include <bench.h>
+#include <mock-usart.h>
+
+using namespace os;
+using namespace os::rtos;
+
+// ----------------------------------------------------------------------------
+
+extern "C" void
+mock_usart_cb (uint32_t event);
+
+namespace
+{
+  constexpr std::size_t total_bytes = 4096;
+
+  constexpr std::size_t sizes[] =
+    { 1, 16, 64, 256 };
+
+  constexpr driver::serial::config_arg_t baudrates[] =
+    { 115200, 921600 };
+
+  driver::Usart_wrapper usart
+    { &mock_usart, mock_usart_cb };
+
+  uint8_t out[total_bytes];
+  uint8_t in[total_bytes];
+
+  bool volatile running;
+
+  // Plays the role of the USART interrupt.
+  void*
+  irq_func (void* args __attribute__((unused)))
+  {
+    while (running)
+      {
+        mock_usart_poll ();
+        this_thread::yield ();
+      }
+    return nullptr;
+  }
+
+  // Without the thread statistics, only the callbacks are counted.
+  statistics::duration_t
+  cpu_cycles (thread& th __attribute__((unused)))
+  {
+#if defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES)
+    return th.statistics ().cpu_cycles ();
+#else
+    return 0;
+#endif
+  }
+
+  int
+  report (const char* name, driver::serial::config_arg_t baudrate,
+          std::size_t size, clock::timestamp_t cycles,
+          statistics::duration_t app_cycles)
+  {
+    if (std::memcmp (in, out, total_bytes) != 0)
+      {
+        printf ("%s %u %u data mismatch\n", name,
+                static_cast<unsigned int> (baudrate),
+                static_cast<unsigned int> (size));
+        return 1;
+      }
+
+    mock_usart_stats_t stats;
+    mock_usart_get_stats (&stats);
+
+    uint64_t const frequency = hrclock.input_clock_frequency_hz ();
+    uint64_t const latency =
+        (stats.events != 0) ? stats.latency_sum / stats.events : 0;
+
+    printf (
+        "%-9s %7u %4u %7u B/s %6u cycles/B, callback latency %6u (max %u)%s\n",
+        name, static_cast<unsigned int> (baudrate),
+        static_cast<unsigned int> (size),
+        static_cast<unsigned int> (total_bytes * frequency / cycles),
+        static_cast<unsigned int> ((app_cycles + stats.callback_cycles)
+            / total_bytes),
+        static_cast<unsigned int> (latency),
+        static_cast<unsigned int> (stats.latency_max),
+        (stats.rx_overflows != 0) ? " overflow" : "");
+
+    return 0;
+  }
+
+  // --------------------------------------------------------------------------
+
+  semaphore_binary raw_done
+    { "raw", 0 };
+
+  void
+  raw_cb (const void* object __attribute__((unused)), driver::event_t event)
+  {
+    if ((event & driver::serial::Event::receive_complete) != 0)
+      {
+        raw_done.post ();
+      }
+  }
+
+  /*
+   * The driver alone, one transfer at a time; the receive is
+   * started before the send, so no character is lost.
+   */
+  int
+  bench_raw (driver::serial::config_arg_t baudrate, std::size_t size)
+  {
+    usart.register_callback (raw_cb, nullptr);
+
+    if (usart.power (driver::Power::full) != driver::RETURN_OK
+        || usart.configure (posix::buffered_serial::default_config, baudrate)
+            != driver::RETURN_OK
+        || usart.control (driver::serial::Control::enable_tx)
+            != driver::RETURN_OK
+        || usart.control (driver::serial::Control::enable_rx)
+            != driver::RETURN_OK)
+      {
+        printf ("usart start failed\n");
+        return 1;
+      }
+
+    std::memset (in, 0, sizeof(in));
+    mock_usart_clear_stats ();
+
+    thread& self = this_thread::thread ();
+    statistics::duration_t const app_begin = cpu_cycles (self);
+    clock::timestamp_t const begin = hrclock.now ();
+
+    bool failed = false;
+    for (std::size_t done = 0; done < total_bytes; done += size)
+      {
+        // If a transfer does not start, there will be no
+        // completion event to wait for.
+        if (usart.receive (in + done, size) != driver::RETURN_OK)
+          {
+            failed = true;
+            break;
+          }
+        if (usart.send (out + done, size) != driver::RETURN_OK)
+          {
+            usart.control (driver::serial::Control::abort_receive);
+            failed = true;
+            break;
+          }
+        raw_done.wait ();
+      }
+
+    clock::timestamp_t const cycles = hrclock.now () - begin;
+    statistics::duration_t const app_cycles = cpu_cycles (self) - app_begin;
+
+    usart.power (driver::Power::off);
+    usart.register_callback (nullptr, nullptr);
+
+    if (failed)
+      {
+        printf ("usart transfer failed\n");
+        return 1;
+      }
+
+    return report ("raw", baudrate, size, cycles, app_cycles);
+  }
+
+  // --------------------------------------------------------------------------
+
+  struct writer_args
+  {
+    posix::buffered_serial* serial;
+    std::size_t size;
+  };
+
+  void*
+  writer_func (void* args)
+  {
+    writer_args* const wa = static_cast<writer_args*> (args);
+    for (std::size_t done = 0; done < total_bytes; done += wa->size)
+      {
+        wa->serial->write (out + done, wa->size);
+      }
+    return nullptr;
+  }
+
+  /*
+   * The buffered device, with a writer thread and the reader in
+   * the current thread, both using the given transfer size.
+   */
+  int
+  bench_buffered (driver::serial::config_arg_t baudrate, std::size_t size)
+  {
+    static uint8_t rx_buf[512];
+    static uint8_t tx_buf[512];
+
+    posix::buffered_serial tty
+      { "ttyMock", usart, rx_buf, sizeof(rx_buf), tx_buf, sizeof(tx_buf),
+          posix::buffered_serial::default_config, baudrate };
+
+    if (tty.open () < 0)
+      {
+        printf ("tty open failed\n");
+        return 1;
+      }
+
+    std::memset (in, 0, sizeof(in));
+    mock_usart_clear_stats ();
+
+    writer_args args
+      { &tty, size };
+
+    thread& self = this_thread::thread ();
+    statistics::duration_t const app_begin = cpu_cycles (self);
+    clock::timestamp_t const begin = hrclock.now ();
+
+    thread writer
+      { "writer", writer_func, &args };
+
+    std::size_t done = 0;
+    while (done < total_bytes)
+      {
+        ssize_t const n = tty.read (in + done, size);
+        if (n <= 0)
+          {
+            break;
+          }
+        done += static_cast<std::size_t> (n);
+      }
+    writer.join ();
+
+    clock::timestamp_t const cycles = hrclock.now () - begin;
+    statistics::duration_t const app_cycles = cpu_cycles (self) - app_begin
+        + cpu_cycles (writer);
+
+    tty.close ();
+
+    return report ("buffered", baudrate, size, cycles, app_cycles);
+  }
+
+  // --------------------------------------------------------------------------
+
+  int failed;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  // Without the interrupt thread, advance the mock until all
+  // the transfers started, and those started by the callbacks,
+  // are complete.
+  void
+  settle (void)
+  {
+    for (int i = 0; i < 4; ++i)
+      {
+        sysclock.sleep_for (1);
+        mock_usart_poll ();
+      }
+  }
+
+  /*
+   * The buffered device error paths and corner cases, with small
+   * buffers; the mock is advanced explicitly, so the buffers
+   * fill deterministically, except for the last case, which
+   * needs the interrupt thread.
+   */
+  int
+  check_serial (void)
+  {
+    failed = 0;
+
+    static uint8_t rx_buf[16];
+    static uint8_t tx_buf[8];
+
+    posix::buffered_serial tty
+      { "ttyCheck", usart, rx_buf, sizeof(rx_buf), tx_buf, sizeof(tx_buf) };
+
+    uint8_t buf[32];
+
+    expect (tty.open () == 0, "open");
+
+    // Nothing received; the timeout expires.
+    clock::timestamp_t const begin = sysclock.now ();
+    errno = 0;
+    expect (tty.timed_read (buf, 4, 3) == -1 && errno == ETIMEDOUT,
+            "timed_read() expires");
+    expect (sysclock.now () - begin >= 3, "timed_read() waits");
+    expect (tty.poll (POLLIN | POLLOUT) == POLLOUT, "poll() when empty");
+
+    // Reads return the bytes available, even if fewer than requested,
+    // before the receive half is complete.
+    expect (tty.write (out, 6) == 6, "write");
+    expect (tty.poll (POLLIN) == 0, "poll() before receive");
+    settle ();
+    expect (tty.poll (POLLIN) == POLLIN, "poll() after receive");
+    expect (tty.read (buf, 4) == 4 && std::memcmp (buf, out, 4) == 0,
+            "partial read");
+    expect (tty.read (buf, sizeof(buf)) == 2
+                && std::memcmp (buf, out + 4, 2) == 0,
+            "read of the rest");
+    expect (tty.drain () == 0, "drain()");
+
+    // Non blocking, nothing to read and no space to write.
+    expect (tty.fcntl (F_SETFL, O_NONBLOCK) == 0, "set O_NONBLOCK");
+    errno = 0;
+    expect (tty.read (buf, 1) == -1 && errno == EAGAIN, "read() EAGAIN");
+    expect (tty.write (out + 6, 8) == 8, "write filling the buffer");
+    errno = 0;
+    expect (tty.write (out + 14, 1) == -1 && errno == EAGAIN,
+            "write() EAGAIN");
+    expect (tty.poll (POLLIN | POLLOUT) == 0, "poll() when full");
+    expect (tty.fcntl (F_SETFL, 0) == 0, "clear O_NONBLOCK");
+
+    // The mock is not advanced, so the buffer stays full.
+    errno = 0;
+    expect (tty.timed_write (out + 14, 1, 2) == -1 && errno == ETIMEDOUT,
+            "timed_write() expires");
+
+    // The bytes are sent and received across both halves.
+    settle ();
+    expect (tty.poll (POLLOUT) == POLLOUT, "poll() after send");
+    expect (tty.read (buf, sizeof(buf)) == 8
+                && std::memcmp (buf, out + 6, 8) == 0,
+            "read across halves");
+    expect (tty.drain () == 0, "drain() after send");
+    expect (tty.close () == 0, "close");
+
+    // With both halves full, the reception stops and the next
+    // bytes are lost; reading restarts it.
+    expect (tty.open () == 0, "open again");
+    mock_usart_clear_stats ();
+    for (std::size_t i = 0; i < 3; ++i)
+      {
+        expect (tty.write (out + i * 8, 8) == 8, "write block");
+        settle ();
+        expect (tty.drain () == 0, "drain() block");
+      }
+    mock_usart_stats_t stats;
+    mock_usart_get_stats (&stats);
+    expect (stats.rx_overflows == 8, "overflow");
+    expect (tty.read (buf, sizeof(buf)) == 16
+                && std::memcmp (buf, out, 16) == 0,
+            "read after overflow");
+    expect (tty.write (out + 24, 4) == 4, "write after overflow");
+    settle ();
+    expect (tty.read (buf, sizeof(buf)) == 4
+                && std::memcmp (buf, out + 24, 4) == 0,
+            "receive restarted after overflow");
+    expect (tty.close () == 0, "close after overflow");
+
+    // Without the receive timeout event, a blocked reader checks
+    // the active half every tick.
+    mock_usart_set_rx_timeout_event (false);
+    expect (tty.open () == 0, "open without rx timeout");
+
+    running = true;
+    thread irq
+      { "usart-irq", irq_func, nullptr };
+
+    expect (tty.write (out, 3) == 3, "write without rx timeout");
+    std::size_t done = 0;
+    while (done < 3)
+      {
+        ssize_t const n = tty.read (buf + done, sizeof(buf) - done);
+        if (n <= 0)
+          {
+            expect (false, "read without rx timeout");
+            break;
+          }
+        done += static_cast<std::size_t> (n);
+      }
+    expect (done == 3 && std::memcmp (buf, out, 3) == 0,
+            "data without rx timeout");
+    expect (tty.close () == 0, "close without rx timeout");
+
+    running = false;
+    irq.join ();
+    mock_usart_set_rx_timeout_event (true);
+
+    if (failed != 0)
+      {
+        printf ("serial checks failed\n");
+      }
+    return failed;
+  }
+}
+
+/*
+ * The buffered serial device checks, then the serial
+ * throughput over the loopback mock USART, via the
+ * Usart_wrapper alone and via the buffered serial device.
+ * The cycles per byte count the application threads and the
+ * driver callbacks; the latency is from the moment a character
+ * was completely transferred to the callback, in hrclock cycles.
+ */
+int
+bench_serial (void)
+{
+  printf ("Serial (%u bytes, loopback)\n",
+          static_cast<unsigned int> (total_bytes));
+
+  for (std::size_t i = 0; i < total_bytes; ++i)
+    {
+      out[i] = static_cast<uint8_t> (i * 7 + 1);
+    }
+
+  mock_usart_set_clock_frequency (hrclock.input_clock_frequency_hz ());
+
+  if (check_serial () != 0)
+    {
+      return 1;
+    }
+
+  running = true;
+  thread irq
+    { "usart-irq", irq_func, nullptr };
+
+  int ret = 0;
+  for (auto baudrate : baudrates)
+    {
+      printf ("line rate %u B/s\n",
+              static_cast<unsigned int> (baudrate / 10));
+
+      for (auto size : sizes)
+        {
+          if (ret == 0)
+            {
+              ret = bench_raw (baudrate, size);
+            }
+        }
+      for (auto size : sizes)
+        {
+          if (ret == 0)
+            {
+              ret = bench_buffered (baudrate, size);
+            }
+        }
+    }
+
+  running = false;
+  irq.join ();
+
+  printf ("\n");
+  return ret;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+mock_usart_cb (uint32_t event)
+{
+  usart.signal_event (event);
+}
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,364 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <cstdarg>
+#include <cstring>
+
+#include <bench.h>
+
+using namespace os;
+using namespace os::rtos;
+
+// ----------------------------------------------------------------------------
+
+#if defined(TRACE) && defined(OS_USE_TRACE_BINARY)
+
+namespace
+{
+  constexpr uint32_t batches = 100;
+
+  // Records per batch; few enough to never fill the ring.
+  constexpr uint32_t batch_size = 16;
+
+  // The number of words used by the format address.
+  constexpr std::size_t format_words = (sizeof(const char*)
+      + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  int failed;
+
+  // The drained bytes, and the limits of the writer.
+  uint8_t captured[2048];
+  std::size_t captured_count;
+  std::size_t chunk;
+  std::size_t budget;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  // Accept at most `chunk` bytes per call and `budget` bytes in total.
+  ssize_t
+  capture (const void* buf, std::size_t nbyte)
+  {
+    if (chunk != 0 && nbyte > chunk)
+      {
+        nbyte = chunk;
+      }
+    if (nbyte > budget)
+      {
+        nbyte = budget;
+      }
+    if (nbyte > sizeof(captured) - captured_count)
+      {
+        nbyte = sizeof(captured) - captured_count;
+      }
+    std::memcpy (&captured[captured_count], buf, nbyte);
+    captured_count += nbyte;
+    budget -= nbyte;
+    return static_cast<ssize_t> (nbyte);
+  }
+
+  ssize_t
+  discard (const void* buf __attribute__((unused)), std::size_t nbyte)
+  {
+    return static_cast<ssize_t> (nbyte);
+  }
+
+  // Drain the ring at the end of the captured bytes.
+  std::size_t
+  collect (std::size_t max_chunk = 0, std::size_t max_total = sizeof(captured))
+  {
+    chunk = max_chunk;
+    budget = max_total;
+    return trace::binary::drain (capture);
+  }
+
+  uint32_t
+  word (std::size_t index)
+  {
+    uint32_t w;
+    std::memcpy (&w, &captured[index * sizeof(uint32_t)], sizeof(w));
+    return w;
+  }
+
+  int
+  vlog (const char* format, ...)
+  {
+    std::va_list args;
+    va_start(args, format);
+    int const ret = trace::binary::vlog (format, args);
+    va_end(args);
+
+    return ret;
+  }
+
+  // The record stored by vlog(), which parses the format, must be
+  // identical to the one stored by log(), which uses the types.
+  template<typename ... Args_T>
+    void
+    check_vlog (const char* format, Args_T ... args)
+    {
+      captured_count = 0;
+      trace::binary::log (format, args...);
+      collect ();
+      std::size_t const count = captured_count;
+
+      vlog (format, args...);
+      collect ();
+
+      expect (
+          captured_count == 2 * count
+              && std::memcmp (captured, &captured[count], count) == 0,
+          format);
+    }
+
+  // Measure in batches, draining the ring between them.
+  template<typename F>
+    void
+    measure (const char* name, F&& func)
+    {
+      clock::timestamp_t cycles = 0;
+      for (uint32_t b = 0; b < batches; ++b)
+        {
+          clock::timestamp_t const begin = hrclock.now ();
+          for (uint32_t i = 0; i < batch_size; ++i)
+            {
+              func ();
+            }
+          cycles += hrclock.now () - begin;
+
+          trace::binary::drain (discard);
+        }
+
+      printf ("%-32s %6u cycles\n", name,
+              static_cast<unsigned int> (cycles / (batches * batch_size)));
+    }
+
+  void
+  test_records (void)
+  {
+    const char* const format = "%d %s %llu";
+
+    captured_count = 0;
+    trace::binary::log (format, 42, "abc", 0x123456789ULL);
+    collect ();
+
+    std::size_t const n = 1 + format_words + 1 + 2 + 2;
+    expect (captured_count == n * sizeof(uint32_t), "record size");
+    expect (word (0) == (trace::binary::marker | n), "record header");
+
+    const char* stored;
+    std::memcpy (&stored, &captured[sizeof(uint32_t)], sizeof(stored));
+    expect (stored == format, "format address");
+
+    std::size_t i = 1 + format_words;
+    expect (word (i) == 42, "integer argument");
+    expect (word (i + 1) == 3, "string length");
+    expect (std::memcmp (&captured[(i + 2) * sizeof(uint32_t)], "abc\0", 4)
+                == 0,
+            "string characters");
+    uint64_t dword;
+    std::memcpy (&dword, &captured[(i + 3) * sizeof(uint32_t)],
+                 sizeof(dword));
+    expect (dword == 0x123456789ULL, "64-bit argument");
+
+    // A long string is truncated to the end of the record.
+    static const char long_string[] =
+        "0123456789012345678901234567890123456789"
+        "0123456789012345678901234567890123456789";
+    captured_count = 0;
+    trace::binary::log ("%s", long_string);
+    collect ();
+    std::size_t const room = (OS_INTEGER_TRACE_BINARY_RECORD_WORDS - 2
+        - format_words) * sizeof(uint32_t);
+    expect (
+        captured_count == OS_INTEGER_TRACE_BINARY_RECORD_WORDS
+            * sizeof(uint32_t),
+        "truncated record size");
+    expect (word (1 + format_words) == room, "truncated string length");
+    expect (
+        std::memcmp (&captured[(2 + format_words) * sizeof(uint32_t)],
+                     long_string, room) == 0,
+        "truncated string characters");
+  }
+
+  void
+  test_vlog (void)
+  {
+    check_vlog ("%d %u %x %c", -1, 2u, 0xABCDu, 'x');
+    check_vlog ("%hhd %hd %ld %lld %zu %jd", 1, 2, 3L, 4LL, sizeof(long),
+                static_cast<intmax_t> (5));
+    check_vlog ("%5.2f %-*d %+08.3e", 1.5, 7, 8, 2.5);
+    check_vlog ("%s|%-10s|%.2s", "a", "bcd", "efg");
+    check_vlog ("%p %% %#x", static_cast<void*> (captured), 9u);
+    check_vlog ("%*.*d", 5, 3, 10);
+
+    // A long double is stored as a double.
+    const char* const format = "%Lf";
+    captured_count = 0;
+    trace::binary::log (format, 1.25);
+    collect ();
+    std::size_t const count = captured_count;
+    vlog (format, 1.25L);
+    collect ();
+    expect (
+        captured_count == 2 * count
+            && std::memcmp (captured, &captured[count], count) == 0,
+        format);
+    // An incomplete conversion at the end.
+    check_vlog ("%d %", 1);
+  }
+
+  void
+  test_dropped (void)
+  {
+    uint32_t const dropped = trace::binary::dropped ();
+
+    // Fill the ring; the record that does not fit is dropped.
+    std::size_t count = 0;
+    while (trace::binary::log ("%u", static_cast<uint32_t> (count)) > 0)
+      {
+        ++count;
+      }
+    expect (trace::binary::dropped () == dropped + 1, "dropped() counter");
+
+    std::size_t const n = 1 + format_words + 1;
+    std::size_t total = 0;
+    for (;;)
+      {
+        captured_count = 0;
+        std::size_t const ret = collect ();
+        if (ret == 0)
+          {
+            break;
+          }
+        total += ret;
+      }
+    expect (total == count * n * sizeof(uint32_t), "all records drained");
+    expect (trace::binary::log ("%u", 0u) > 0, "log after drain");
+    trace::binary::drain (discard);
+  }
+
+  void
+  test_partial_writes (void)
+  {
+    auto store = []
+      {
+        trace::binary::log ("%d", 1);
+        trace::binary::log ("%s", "partial");
+        trace::binary::log ("%llu", 2ULL);
+      };
+
+    captured_count = 0;
+    store ();
+    collect ();
+    std::size_t const count = captured_count;
+
+    // At most 6 bytes per call, not a multiple of the word size.
+    store ();
+    collect (6);
+    expect (
+        captured_count == 2 * count
+            && std::memcmp (captured, &captured[count], count) == 0,
+        "drain with short writes");
+
+    // The channel accepts 10 bytes, then the rest later.
+    store ();
+    expect (collect (0, 10) == 10, "drain stops when the channel is full");
+    expect (collect () == count - 10, "drain continues");
+    expect (
+        captured_count == 3 * count
+            && std::memcmp (captured, &captured[2 * count], count) == 0,
+        "no bytes written twice");
+  }
+}
+
+/*
+ * Binary trace records: layout, format parsing by vlog(),
+ * truncation, dropped records and draining with short writes;
+ * then the cost of storing a record, where the goal is around
+ * 100 cycles.
+ */
+int
+bench_trace (void)
+{
+  printf ("Binary trace\n");
+
+  // Start with an empty ring.
+  trace::binary::drain (discard);
+  failed = 0;
+
+  test_records ();
+  test_vlog ();
+  test_dropped ();
+  test_partial_writes ();
+
+  measure ("binary::log(\"%u %u\")", []
+    {
+      trace::binary::log ("%u %u", 1u, 2u);
+    });
+
+  measure ("binary::vlog(\"%u %u\")", []
+    {
+      vlog ("%u %u", 1u, 2u);
+    });
+
+  measure ("binary::log(\"%s %d\")", []
+    {
+      trace::binary::log ("%s %d", "thread", -1);
+    });
+
+  measure ("binary::vlog(\"%s %d\")", []
+    {
+      vlog ("%s %d", "thread", -1);
+    });
+
+  printf ("\n");
+  return failed ? 1 : 0;
+}
+
+#else
+
+int
+bench_trace (void)
+{
+  printf ("Binary trace not enabled.\n\n");
+  return 0;
+}
+
+#endif /* defined(TRACE) && defined(OS_USE_TRACE_BINARY) */
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,686 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/drivers/usbd-wrapper.h>
+#include <cmsis-plus/drivers/usb-device-queue.h>
+#include <cmsis-plus/drivers/usb-cdc-acm.h>
+#include <cmsis-plus/posix-io/buffered-serial.h>
+
+#include <cstring>
+
+#include <bench.h>
+#include <mock-usbd.h>
+
+using namespace os;
+using namespace os::rtos;
+
+// ----------------------------------------------------------------------------
+
+extern "C" void
+mock_usbd_device_cb (uint32_t event);
+
+extern "C" void
+mock_usbd_endpoint_cb (uint8_t ep_addr, uint32_t event);
+
+namespace
+{
+  constexpr std::size_t total_bytes = 16384;
+
+  constexpr std::size_t sizes[] =
+    { 1, 16, 64, 256, 1024 };
+
+  constexpr driver::usb::endpoint_t ep_in = 0x81;
+  constexpr driver::usb::endpoint_t ep_out = 0x01;
+  constexpr driver::usb::packet_size_t packet_size = 64;
+
+  driver::Usbd_wrapper usbd
+    { &mock_usbd, mock_usbd_device_cb, mock_usbd_endpoint_cb };
+
+  uint8_t out[total_bytes];
+  uint8_t in[total_bytes];
+
+  bool volatile running;
+
+  /*
+   * Plays the role of the host and of the USB interrupt; the
+   * IN packets are sent back as OUT packets, as by a loopback
+   * application on the host.
+   */
+  void*
+  host_func (void* args __attribute__((unused)))
+  {
+    uint8_t fifo[4 * packet_size];
+    std::size_t level = 0;
+
+    while (running)
+      {
+        if (level + packet_size <= sizeof(fifo))
+          {
+            int32_t const n = mock_usbd_host_in (ep_in, fifo + level);
+            if (n > 0)
+              {
+                level += static_cast<std::size_t> (n);
+              }
+          }
+
+        if (level > 0)
+          {
+            std::size_t const count =
+                (level < packet_size) ? level : packet_size;
+            int32_t const n = mock_usbd_host_out (ep_out, fifo,
+                                                  static_cast<uint32_t> (count));
+            if (n >= 0)
+              {
+                level -= count;
+                std::memmove (fifo, fifo + count, level);
+              }
+          }
+
+        this_thread::yield ();
+      }
+    return nullptr;
+  }
+
+  statistics::duration_t
+  cpu_cycles (thread& th __attribute__((unused)))
+  {
+#if defined(OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES)
+    return th.statistics ().cpu_cycles ();
+#else
+    return 0;
+#endif
+  }
+
+  int
+  report (const char* name, std::size_t size, clock::timestamp_t cycles,
+          statistics::duration_t app_cycles)
+  {
+    if (std::memcmp (in, out, total_bytes) != 0)
+      {
+        printf ("%s %u data mismatch\n", name,
+                static_cast<unsigned int> (size));
+        return 1;
+      }
+
+    mock_usbd_stats_t stats;
+    mock_usbd_get_stats (&stats);
+
+    uint64_t const frequency = hrclock.input_clock_frequency_hz ();
+
+    printf ("%-9s %4u %8u B/s %6u cycles/B, %5u packets, %6u NAKs\n", name,
+            static_cast<unsigned int> (size),
+            static_cast<unsigned int> (total_bytes * frequency / cycles),
+            static_cast<unsigned int> ((app_cycles + stats.callback_cycles)
+                / total_bytes),
+            static_cast<unsigned int> (stats.packets),
+            static_cast<unsigned int> (stats.naks));
+
+    return 0;
+  }
+
+  // --------------------------------------------------------------------------
+
+  semaphore_binary cdc_done
+    { "cdc", 0 };
+
+  void
+  cdc_cb (const void* object __attribute__((unused)), driver::event_t event)
+  {
+    if ((event & driver::serial::Event::receive_complete) != 0)
+      {
+        cdc_done.post ();
+      }
+  }
+
+  /*
+   * The CDC function alone, via the Serial interface, one
+   * transfer at a time.
+   */
+  int
+  bench_cdc (driver::usb::device::Cdc_acm& cdc, std::size_t size)
+  {
+    cdc.register_callback (cdc_cb, nullptr);
+
+    if (cdc.power (driver::Power::full) != driver::RETURN_OK
+        || cdc.control (driver::serial::Control::enable_tx)
+            != driver::RETURN_OK
+        || cdc.control (driver::serial::Control::enable_rx)
+            != driver::RETURN_OK)
+      {
+        printf ("cdc start failed\n");
+        return 1;
+      }
+
+    std::memset (in, 0, sizeof(in));
+    mock_usbd_clear_stats ();
+
+    thread& self = this_thread::thread ();
+    statistics::duration_t const app_begin = cpu_cycles (self);
+    clock::timestamp_t const begin = hrclock.now ();
+
+    for (std::size_t done = 0; done < total_bytes; done += size)
+      {
+        cdc.receive (in + done, size);
+        cdc.send (out + done, size);
+        cdc_done.wait ();
+      }
+
+    clock::timestamp_t const cycles = hrclock.now () - begin;
+    statistics::duration_t const app_cycles = cpu_cycles (self) - app_begin;
+
+    cdc.power (driver::Power::off);
+    cdc.register_callback (nullptr, nullptr);
+
+    return report ("cdc", size, cycles, app_cycles);
+  }
+
+  // --------------------------------------------------------------------------
+
+  int failed;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  driver::event_t volatile check_events;
+
+  void
+  check_cb (const void* object __attribute__((unused)), driver::event_t event)
+  {
+    check_events |= event;
+  }
+
+  /*
+   * A minimal control pipe, as the device core would run it:
+   * the class requests are passed to the function, followed by
+   * the data stage, if any, and the status stage.
+   */
+  uint8_t control_setup[8];
+
+  void
+  control_cb (const void* object, driver::usb::endpoint_t ep_addr,
+              driver::event_t event)
+  {
+    driver::usb::device::Cdc_acm* cdc =
+        static_cast<driver::usb::device::Cdc_acm*> (const_cast<void*> (object));
+
+    if ((event & driver::usb::device::Endpoint_event::setup) != 0)
+      {
+        usbd.read_setup_packet (control_setup);
+
+        uint8_t* data;
+        std::size_t length;
+        if (!cdc->control_request (control_setup, data, length))
+          {
+            usbd.stall_endpoint (0x80, true);
+            usbd.stall_endpoint (0x00, true);
+          }
+        else if (length == 0)
+          {
+            usbd.transfer_zero_length (0x80);
+          }
+        else if ((control_setup[0] & 0x80) != 0)
+          {
+            usbd.transfer (0x80, data, length);
+          }
+        else
+          {
+            usbd.transfer (0x00, data, length);
+          }
+      }
+    else if ((event & driver::usb::device::Endpoint_event::out) != 0)
+      {
+        if ((control_setup[0] & 0x80) == 0)
+          {
+            // The data stage of a host to device request.
+            cdc->control_data (control_setup);
+            usbd.transfer_zero_length (0x80);
+          }
+      }
+    else if ((event & driver::usb::device::Endpoint_event::in) != 0)
+      {
+        if ((control_setup[0] & 0x80) != 0)
+          {
+            // The data stage of a device to host request;
+            // the status stage is a zero length OUT.
+            usbd.transfer_zero_length (0x00);
+          }
+      }
+  }
+
+  /*
+   * The class requests and the zero length packets, with the
+   * test playing the host, one packet at a time.
+   */
+  int
+  check_cdc (driver::usb::device::Cdc_acm& cdc,
+             driver::usb::device::Transfer_queues& queues)
+  {
+    failed = 0;
+
+    usbd.configure_endpoint (0x00, driver::usb::Endpoint_type::control,
+                             packet_size);
+    usbd.configure_endpoint (0x80, driver::usb::Endpoint_type::control,
+                             packet_size);
+    queues.register_endpoint_callback (control_cb, &cdc);
+
+    cdc.register_callback (check_cb, nullptr);
+    check_events = 0;
+
+    uint8_t buf[packet_size];
+
+    // SET_LINE_CODING, 57600 8O2, then GET_LINE_CODING.
+    static const uint8_t set_coding[] =
+      { 0x21, driver::usb::device::cdc::SET_LINE_CODING, 0, 0, 0, 0, 7, 0 };
+    static const uint8_t coding[] =
+      { 0x00, 0xE1, 0x00, 0x00, 2, 1, 8 };
+    constexpr int32_t coding_size = sizeof(coding);
+
+    expect (mock_usbd_host_setup (set_coding) == 0, "SET_LINE_CODING setup");
+    expect (mock_usbd_host_out (0, coding, sizeof(coding)) == coding_size,
+            "SET_LINE_CODING data");
+    expect (mock_usbd_host_in (0, buf) == 0, "SET_LINE_CODING status");
+
+    driver::usb::device::cdc::Line_coding const& lc = cdc.get_line_coding ();
+    expect (lc.dte_rate == 57600 && lc.char_format == 2 && lc.parity_type == 1
+                && lc.data_bits == 8,
+            "SET_LINE_CODING stored");
+
+    static const uint8_t get_coding[] =
+      { 0xA1, driver::usb::device::cdc::GET_LINE_CODING, 0, 0, 0, 0, 7, 0 };
+
+    expect (mock_usbd_host_setup (get_coding) == 0, "GET_LINE_CODING setup");
+    expect (mock_usbd_host_in (0, buf) == coding_size
+                && std::memcmp (buf, coding, sizeof(coding)) == 0,
+            "GET_LINE_CODING round trip");
+    expect (mock_usbd_host_out (0, buf, 0) == 0, "GET_LINE_CODING status");
+
+    // SET_CONTROL_LINE_STATE, DTR and RTS, seen as DSR and CTS.
+    static const uint8_t set_lines[] =
+      { 0x21, driver::usb::device::cdc::SET_CONTROL_LINE_STATE,
+          static_cast<uint8_t> (driver::usb::device::cdc::CONTROL_LINE_DTR
+              | driver::usb::device::cdc::CONTROL_LINE_RTS), 0, 0, 0, 0, 0 };
+
+    expect (mock_usbd_host_setup (set_lines) == 0,
+            "SET_CONTROL_LINE_STATE setup");
+    expect (mock_usbd_host_in (0, buf) == 0, "SET_CONTROL_LINE_STATE status");
+    expect ((check_events & driver::serial::Event::dsr) != 0
+                && (check_events & driver::serial::Event::cts) != 0,
+            "SET_CONTROL_LINE_STATE events");
+    expect (cdc.get_modem_status ().is_dsr_active ()
+                && cdc.get_modem_status ().is_cts_active (),
+            "SET_CONTROL_LINE_STATE modem status");
+
+    // A transfer of exactly one packet is followed by a ZLP,
+    // a transfer ending in a short packet is not.
+    if (cdc.power (driver::Power::full) != driver::RETURN_OK
+        || cdc.control (driver::serial::Control::enable_tx)
+            != driver::RETURN_OK)
+      {
+        expect (false, "cdc start");
+      }
+    else
+      {
+        check_events = 0;
+        cdc.send (out, packet_size);
+        expect (mock_usbd_host_in (ep_in, buf) == packet_size,
+                "full packet sent");
+        expect ((check_events & driver::serial::Event::tx_complete) == 0,
+                "not complete before the ZLP");
+        expect (mock_usbd_host_in (ep_in, buf) == 0, "ZLP after a full packet");
+        expect (mock_usbd_host_in (ep_in, buf) == MOCK_USBD_NAK,
+                "nothing after the ZLP");
+        expect ((check_events & driver::serial::Event::tx_complete) != 0,
+                "complete after the ZLP");
+
+        cdc.send (out, packet_size + 1);
+        expect (mock_usbd_host_in (ep_in, buf) == packet_size,
+                "first packet sent");
+        expect (mock_usbd_host_in (ep_in, buf) == 1, "short packet sent");
+        expect (mock_usbd_host_in (ep_in, buf) == MOCK_USBD_NAK,
+                "no ZLP after a short packet");
+
+        cdc.power (driver::Power::off);
+      }
+
+    cdc.register_callback (nullptr, nullptr);
+    queues.register_endpoint_callback (nullptr, nullptr);
+
+    if (failed != 0)
+      {
+        printf ("cdc checks failed\n");
+      }
+    return failed;
+  }
+
+  struct Transfer_record
+  {
+    std::size_t calls;
+    std::size_t count;
+    driver::return_t status;
+  };
+
+  void
+  record_cb (const void* object,
+             driver::usb::endpoint_t ep_addr __attribute__((unused)),
+             std::size_t count, driver::return_t status)
+  {
+    Transfer_record* rec =
+        static_cast<Transfer_record*> (const_cast<void*> (object));
+
+    ++rec->calls;
+    rec->count = count;
+    rec->status = status;
+  }
+
+  /*
+   * The endpoint queues alone, on a second pair of endpoints,
+   * with the test playing the host, one packet at a time.
+   */
+  int
+  check_queue (driver::usb::device::Transfer_queues& queues)
+  {
+    failed = 0;
+
+    constexpr driver::usb::endpoint_t q_ep_in = 0x82;
+    constexpr driver::usb::endpoint_t q_ep_out = 0x02;
+    // Never configured, so the transfers cannot start.
+    constexpr driver::usb::endpoint_t q_ep_bad = 0x83;
+
+    static memory_pool_static<driver::usb::device::Transfer_request, 2> pool
+      { "check" };
+
+    usbd.configure_endpoint (q_ep_in, driver::usb::Endpoint_type::bulk,
+                             packet_size);
+    usbd.configure_endpoint (q_ep_out, driver::usb::Endpoint_type::bulk,
+                             packet_size);
+
+    driver::usb::device::Endpoint_queue q_in
+      { queues, q_ep_in, pool, packet_size };
+    driver::usb::device::Endpoint_queue q_out
+      { queues, q_ep_out, pool, packet_size };
+    driver::usb::device::Endpoint_queue q_bad
+      { queues, q_ep_bad, pool, packet_size };
+
+    uint8_t buf[2 * packet_size];
+    Transfer_record rec;
+
+    // A short segment in the middle is rejected.
+    driver::usb::device::Segment bad_segs[] =
+      {
+        { out, packet_size - 1 },
+        { out + packet_size, 10 } };
+    expect (q_in.submit (bad_segs, 2) == driver::ERROR_PARAMETER,
+            "short middle segment rejected");
+    expect (pool.count () == 0, "no descriptor for a rejected transfer");
+
+    // The callback is invoked once, after the last segment.
+    driver::usb::device::Segment in_segs[] =
+      {
+        { out, packet_size },
+        { out + packet_size, 10 } };
+    rec = Transfer_record
+      { 0, 0, driver::RETURN_OK };
+    expect (q_in.submit (in_segs, 2, record_cb, &rec) == driver::RETURN_OK,
+            "multi-segment IN submit");
+    expect (mock_usbd_host_in (q_ep_in, buf) == packet_size
+                && std::memcmp (buf, out, packet_size) == 0,
+            "first IN segment");
+    expect (rec.calls == 0, "not complete after the first segment");
+    expect (mock_usbd_host_in (q_ep_in, buf) == 10
+                && std::memcmp (buf, out + packet_size, 10) == 0,
+            "last IN segment");
+    expect (rec.calls == 1 && rec.count == packet_size + 10
+                && rec.status == driver::RETURN_OK,
+            "multi-segment IN complete");
+
+    // On OUT endpoints, a short packet ends the transfer early.
+    std::memset (in, 0, 2 * packet_size);
+    driver::usb::device::Segment out_segs[] =
+      {
+        { in, packet_size },
+        { in + packet_size, packet_size } };
+    rec = Transfer_record
+      { 0, 0, driver::RETURN_OK };
+    expect (q_out.submit (out_segs, 2, record_cb, &rec) == driver::RETURN_OK,
+            "multi-segment OUT submit");
+    expect (mock_usbd_host_out (q_ep_out, out, packet_size) == packet_size,
+            "first OUT packet");
+    expect (mock_usbd_host_out (q_ep_out, out + packet_size, 10) == 10,
+            "short OUT packet");
+    expect (rec.calls == 1 && rec.count == packet_size + 10
+                && rec.status == driver::RETURN_OK
+                && std::memcmp (in, out, packet_size + 10) == 0,
+            "multi-segment OUT complete");
+    expect (pool.count () == 0, "descriptors released");
+
+    // A transfer that cannot start is reported to the caller,
+    // not via the callback.
+    rec = Transfer_record
+      { 0, 0, driver::RETURN_OK };
+    expect (q_bad.submit (out, 10, record_cb, &rec) == driver::ERROR,
+            "start failure");
+    expect (rec.calls == 0, "no callback on start failure");
+    expect (pool.count () == 0, "descriptor released on start failure");
+
+    // No more descriptors.
+    rec = Transfer_record
+      { 0, 0, driver::RETURN_OK };
+    expect (q_in.submit (out, 10, record_cb, &rec) == driver::RETURN_OK
+                && q_in.submit (out, 20, record_cb, &rec) == driver::RETURN_OK,
+            "submit up to the pool capacity");
+    expect (q_in.submit (out, 30, record_cb, &rec) == driver::ERROR_BUSY,
+            "pool exhausted");
+
+    // Aborting the active transfer completes all with ERROR.
+    q_in.abort ();
+    expect (rec.calls == 2 && rec.status == driver::ERROR,
+            "abort while active");
+    expect (pool.count () == 0, "descriptors released on abort");
+    expect (mock_usbd_host_in (q_ep_in, buf) == MOCK_USBD_NAK,
+            "nothing sent after abort");
+
+    usbd.unconfigure_endpoint (q_ep_in);
+    usbd.unconfigure_endpoint (q_ep_out);
+
+    if (failed != 0)
+      {
+        printf ("queue checks failed\n");
+      }
+    return failed;
+  }
+
+  // --------------------------------------------------------------------------
+
+  struct writer_args
+  {
+    posix::buffered_serial* serial;
+    std::size_t size;
+  };
+
+  void*
+  writer_func (void* args)
+  {
+    writer_args* const wa = static_cast<writer_args*> (args);
+    for (std::size_t done = 0; done < total_bytes; done += wa->size)
+      {
+        wa->serial->write (out + done, wa->size);
+      }
+    return nullptr;
+  }
+
+  /*
+   * The buffered device over the CDC function, with a writer
+   * thread and the reader in the current thread.
+   */
+  int
+  bench_buffered (driver::usb::device::Cdc_acm& cdc, std::size_t size)
+  {
+    static uint8_t rx_buf[512];
+    static uint8_t tx_buf[512];
+
+    posix::buffered_serial tty
+      { "ttyACM", cdc, rx_buf, sizeof(rx_buf), tx_buf, sizeof(tx_buf) };
+
+    if (tty.open () < 0)
+      {
+        printf ("tty open failed\n");
+        return 1;
+      }
+
+    std::memset (in, 0, sizeof(in));
+    mock_usbd_clear_stats ();
+
+    writer_args args
+      { &tty, size };
+
+    thread& self = this_thread::thread ();
+    statistics::duration_t const app_begin = cpu_cycles (self);
+    clock::timestamp_t const begin = hrclock.now ();
+
+    thread writer
+      { "writer", writer_func, &args };
+
+    std::size_t done = 0;
+    while (done < total_bytes)
+      {
+        ssize_t const n = tty.read (in + done, size);
+        if (n <= 0)
+          {
+            break;
+          }
+        done += static_cast<std::size_t> (n);
+      }
+    writer.join ();
+
+    clock::timestamp_t const cycles = hrclock.now () - begin;
+    statistics::duration_t const app_cycles = cpu_cycles (self) - app_begin
+        + cpu_cycles (writer);
+
+    tty.close ();
+
+    return report ("buffered", size, cycles, app_cycles);
+  }
+}
+
+/*
+ * CDC-ACM throughput over the mock USB device controller, with
+ * the host looping the data back, via the Serial interface and
+ * via the buffered serial device. The bus is not timed, so the
+ * rates show the software cost of the whole path.
+ * The class requests, the zero length packets and the endpoint
+ * queues are checked first.
+ */
+int
+bench_usb_cdc (void)
+{
+  printf ("USB CDC-ACM (%u bytes, loopback, %u bytes packets)\n",
+          static_cast<unsigned int> (total_bytes),
+          static_cast<unsigned int> (packet_size));
+
+  for (std::size_t i = 0; i < total_bytes; ++i)
+    {
+      out[i] = static_cast<uint8_t> (i * 7 + 1);
+    }
+
+  static memory_pool_static<driver::usb::device::Transfer_request, 4> pool
+    { "cdc" };
+  static uint8_t rx_buf[2 * packet_size + 512];
+  static uint8_t tx_buf[512];
+
+  driver::usb::device::Transfer_queues queues
+    { usbd };
+  driver::usb::device::Cdc_acm cdc
+    { queues, ep_in, ep_out, packet_size, pool, rx_buf, sizeof(rx_buf), tx_buf,
+        sizeof(tx_buf) };
+
+  if (usbd.power (driver::Power::full) != driver::RETURN_OK
+      || usbd.connect () != driver::RETURN_OK
+      || cdc.set_configured (true) != driver::RETURN_OK)
+    {
+      printf ("usbd start failed\n");
+      return 1;
+    }
+
+  int ret = check_cdc (cdc, queues);
+  if (ret == 0)
+    {
+      ret = check_queue (queues);
+    }
+
+  running = true;
+  thread host
+    { "usb-host", host_func, nullptr };
+
+  for (auto size : sizes)
+    {
+      if (ret == 0)
+        {
+          ret = bench_cdc (cdc, size);
+        }
+    }
+  for (auto size : sizes)
+    {
+      if (ret == 0)
+        {
+          ret = bench_buffered (cdc, size);
+        }
+    }
+
+  running = false;
+  host.join ();
+
+  cdc.set_configured (false);
+  usbd.disconnect ();
+  usbd.power (driver::Power::off);
+
+  printf ("\n");
+  return ret;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+mock_usbd_device_cb (uint32_t event)
+{
+  usbd.signal_device_event (event);
+}
+
+void
+mock_usbd_endpoint_cb (uint8_t ep_addr, uint32_t event)
+{
+  usbd.signal_endpoint_event (ep_addr, event);
+}
+
+// ----------------------------------------------------------------------------
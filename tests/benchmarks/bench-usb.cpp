@@ -0,0 +1,671 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/drivers/usbd-wrapper.h>
+#include <cmsis-plus/drivers/usbh-wrapper.h>
+#include <cmsis-plus/drivers/usb-device-queue.h>
+#include <cmsis-plus/drivers/usb-host-queue.h>
+
+#include <cstring>
+
+#include <bench.h>
+#include <mock-usbd.h>
+#include <mock-usbh.h>
+
+using namespace os;
+using namespace os::rtos;
+
+// ----------------------------------------------------------------------------
+
+extern "C" void
+bench_usbd_device_cb (uint32_t event);
+
+extern "C" void
+bench_usbd_endpoint_cb (uint8_t ep_addr, uint32_t event);
+
+extern "C" void
+bench_usbh_port_cb (uint8_t port, uint32_t event);
+
+extern "C" void
+bench_usbh_pipe_cb (ARM_USBH_PIPE_HANDLE pipe, uint32_t event);
+
+namespace
+{
+  namespace usb = driver::usb;
+
+  constexpr std::size_t total_bytes = 65536;
+
+  constexpr usb::endpoint_t ep_in = 0x81;
+  constexpr usb::endpoint_t ep_out = 0x01;
+  constexpr usb::packet_size_t packet_size = 64;
+
+  // Transfers kept in flight, on each side.
+  constexpr std::size_t max_requests = 2;
+
+  struct Bulk_config
+  {
+    std::size_t size;
+    std::size_t requests;
+  };
+
+  constexpr Bulk_config bulk_configs[] =
+    {
+      { 64, 1 },
+      { 64, 2 },
+      { 512, 1 },
+      { 512, 2 },
+      { 4096, 1 },
+      { 4096, 2 } };
+
+  constexpr std::size_t echo_sizes[] =
+    { 1, 16, 64 };
+
+  constexpr std::size_t echo_rounds = 200;
+
+  driver::Usbd_wrapper usbd
+    { &mock_usbd, bench_usbd_device_cb, bench_usbd_endpoint_cb };
+
+  driver::Usbh_wrapper usbh
+    { &mock_usbh, bench_usbh_port_cb, bench_usbh_pipe_cb };
+
+  usb::pipe_t pipe_in;
+  usb::pipe_t pipe_out;
+
+  uint8_t out[total_bytes];
+  uint8_t in[total_bytes];
+
+  bool volatile running;
+
+  // Plays the role of the USB interrupts, of both controllers.
+  void*
+  irq_func (void* args __attribute__((unused)))
+  {
+    while (running)
+      {
+        mock_usbh_poll ();
+        this_thread::yield ();
+      }
+    return nullptr;
+  }
+
+  // --------------------------------------------------------------------------
+
+  semaphore_binary port_semaphore
+    { "usb-port", 0 };
+
+  driver::event_t volatile port_events;
+
+  void
+  port_cb (const void* object __attribute__((unused)),
+           usb::port_t port __attribute__((unused)), driver::event_t event)
+  {
+    port_events = port_events | event;
+    port_semaphore.post ();
+  }
+
+  // Wait, for at most 100 ms, for one of the port events.
+  bool
+  wait_port (driver::event_t event)
+  {
+    while ((port_events & event) == 0)
+      {
+        if (port_semaphore.timed_wait (clock_systick::ticks_cast (100000u))
+            != result::ok)
+          {
+            return false;
+          }
+      }
+    return true;
+  }
+
+  /*
+   * Bring up the bus as an USB stack would, up to the enumeration,
+   * which is skipped; the device endpoints are configured and the
+   * host pipes are created directly.
+   */
+  int
+  start (void)
+  {
+    usbh.register_port_callback (port_cb, nullptr);
+    port_events = 0;
+
+    if (usbd.power (driver::Power::full) != driver::RETURN_OK
+        || usbd.connect () != driver::RETURN_OK
+        || usbh.power (driver::Power::full) != driver::RETURN_OK
+        || usbh.power_port_vbus (0, true) != driver::RETURN_OK
+        || !wait_port (usb::host::Port_event::connect)
+        || usbh.reset_port (0) != driver::RETURN_OK
+        || !wait_port (usb::host::Port_event::reset))
+      {
+        printf ("usb bus start failed\n");
+        return 1;
+      }
+
+    if (usbd.configure_endpoint (ep_in, usb::Endpoint_type::bulk, packet_size)
+        != driver::RETURN_OK
+        || usbd.configure_endpoint (ep_out, usb::Endpoint_type::bulk,
+                                    packet_size) != driver::RETURN_OK)
+      {
+        printf ("usbd configure failed\n");
+        return 1;
+      }
+
+    pipe_in = usbh.create_pipe (
+        0, static_cast<usb::speed_t> (usb::Speed::full), 0, 0, ep_in,
+        static_cast<usb::endpoint_type_t> (usb::Endpoint_type::bulk),
+        packet_size, 0);
+    pipe_out = usbh.create_pipe (
+        0, static_cast<usb::speed_t> (usb::Speed::full), 0, 0, ep_out,
+        static_cast<usb::endpoint_type_t> (usb::Endpoint_type::bulk),
+        packet_size, 0);
+    if (pipe_in == 0 || pipe_out == 0)
+      {
+        printf ("usbh create pipe failed\n");
+        return 1;
+      }
+
+    return 0;
+  }
+
+  void
+  stop (void)
+  {
+    if (pipe_in != 0)
+      {
+        usbh.delete_pipe (pipe_in);
+      }
+    if (pipe_out != 0)
+      {
+        usbh.delete_pipe (pipe_out);
+      }
+    usbh.power_port_vbus (0, false);
+    usbh.power (driver::Power::off);
+    usbh.register_port_callback (nullptr, nullptr);
+
+    usbd.unconfigure_endpoint (ep_in);
+    usbd.unconfigure_endpoint (ep_out);
+    usbd.disconnect ();
+    usbd.power (driver::Power::off);
+  }
+
+  // --------------------------------------------------------------------------
+
+  // The part of the data moved by one side.
+  struct Stream
+  {
+    uint8_t* buffer;
+    std::size_t size;
+    // Bytes in the queued and in the completed transfers.
+    std::size_t submitted;
+    std::size_t done;
+    bool failed;
+  };
+
+  // The device endpoint side, sourcing or sinking the data.
+  struct Device_stream : Stream
+  {
+    usb::device::Endpoint_queue* queue;
+  };
+
+  // The host pipe side.
+  struct Host_stream : Stream
+  {
+    usb::host::Pipe_queue* queue;
+    uint32_t packet;
+  };
+
+  void
+  device_submit (Device_stream& ds);
+
+  // Called from the interrupt.
+  void
+  device_cb (const void* object,
+             usb::endpoint_t ep_addr __attribute__((unused)), std::size_t count,
+             driver::return_t status)
+  {
+    Device_stream& ds =
+        *static_cast<Device_stream*> (const_cast<void*> (object));
+
+    ds.done += count;
+    if (status != driver::RETURN_OK)
+      {
+        ds.failed = true;
+        return;
+      }
+    device_submit (ds);
+  }
+
+  void
+  device_submit (Device_stream& ds)
+  {
+    if (ds.submitted < total_bytes)
+      {
+        if (ds.queue->submit (ds.buffer + ds.submitted, ds.size, device_cb,
+                              &ds) != driver::RETURN_OK)
+          {
+            ds.failed = true;
+            return;
+          }
+        ds.submitted += ds.size;
+      }
+  }
+
+  void
+  host_submit (Host_stream& hs, usb::host::Urb& urb);
+
+  // Called from the dispatcher, in the benchmark thread.
+  void
+  host_cb (const void* object, usb::host::Urb& urb)
+  {
+    Host_stream& hs = *static_cast<Host_stream*> (const_cast<void*> (object));
+
+    hs.done += urb.count;
+    if (urb.status != driver::RETURN_OK)
+      {
+        hs.failed = true;
+        return;
+      }
+    host_submit (hs, urb);
+  }
+
+  void
+  host_submit (Host_stream& hs, usb::host::Urb& urb)
+  {
+    if (hs.submitted < total_bytes)
+      {
+        urb.packet = hs.packet;
+        urb.data = hs.buffer + hs.submitted;
+        urb.num = hs.size;
+        urb.cb_func = host_cb;
+        urb.cb_object = &hs;
+        if (hs.queue->submit (urb) != driver::RETURN_OK)
+          {
+            hs.failed = true;
+            return;
+          }
+        hs.submitted += hs.size;
+      }
+  }
+
+  /*
+   * Move total_bytes through one bulk endpoint, with the same
+   * transfer size and number of requests in flight on both sides.
+   */
+  int
+  bench_bulk (usb::host::Pipe_queues& queues, Device_stream& ds,
+              Host_stream& hs, const char* name, const Bulk_config& config)
+  {
+    std::memset (in, 0, sizeof(in));
+
+    ds.size = hs.size = config.size;
+    ds.submitted = hs.submitted = 0;
+    ds.done = hs.done = 0;
+    ds.failed = hs.failed = false;
+
+    usb::host::Urb urbs[max_requests] {};
+
+    mock_usbd_clear_stats ();
+    mock_usbh_clear_stats ();
+
+    clock::timestamp_t const begin = hrclock.now ();
+
+    for (std::size_t i = 0; i < config.requests; ++i)
+      {
+        {
+          // ----- Enter critical section -----------------------------------
+          interrupts::critical_section ics;
+
+          device_submit (ds);
+          // ----- Exit critical section ------------------------------------
+        }
+        host_submit (hs, urbs[i]);
+      }
+
+    while (hs.done < total_bytes && !hs.failed)
+      {
+        if (queues.timed_dispatch (clock_systick::ticks_cast (100000u)) == 0)
+          {
+            break;
+          }
+      }
+
+    clock::timestamp_t const cycles = hrclock.now () - begin;
+
+    // A failure aborts the requests still queued.
+    hs.queue->abort ();
+    ds.queue->abort ();
+    queues.try_dispatch ();
+
+    if (hs.done != total_bytes || ds.done != total_bytes
+        || std::memcmp (in, out, total_bytes) != 0)
+      {
+        printf ("%s %u x%u failed\n", name,
+                static_cast<unsigned int> (config.size),
+                static_cast<unsigned int> (config.requests));
+        return 1;
+      }
+
+    mock_usbh_stats_t host_stats;
+    mock_usbh_get_stats (&host_stats);
+    mock_usbd_stats_t device_stats;
+    mock_usbd_get_stats (&device_stats);
+
+    uint64_t const frequency = hrclock.input_clock_frequency_hz ();
+    // Per elapsed millisecond, since the first and the last frames
+    // are partial.
+    uint32_t const per_100_frames =
+        static_cast<uint32_t> ((uint64_t) host_stats.packets * 100
+            * (frequency / 1000) / cycles);
+
+    printf ("%-4s %4u x%u %8u B/s %2u.%02u packets/frame %6u NAKs"
+            " %5u cycles/packet\n",
+            name, static_cast<unsigned int> (config.size),
+            static_cast<unsigned int> (config.requests),
+            static_cast<unsigned int> (total_bytes * frequency / cycles),
+            static_cast<unsigned int> (per_100_frames / 100),
+            static_cast<unsigned int> (per_100_frames % 100),
+            static_cast<unsigned int> (host_stats.naks),
+            static_cast<unsigned int> ((host_stats.callback_cycles
+                + device_stats.callback_cycles) / host_stats.packets));
+
+    return 0;
+  }
+
+  // --------------------------------------------------------------------------
+
+  uint8_t echo_buffer[packet_size];
+  usb::device::Endpoint_queue* echo_in;
+
+  // The device sends back each OUT transfer; called from the interrupt.
+  void
+  echo_cb (const void* object, usb::endpoint_t ep_addr __attribute__((unused)),
+           std::size_t count, driver::return_t status)
+  {
+    if (status != driver::RETURN_OK)
+      {
+        return;
+      }
+
+    usb::device::Endpoint_queue* const echo_out =
+        static_cast<usb::device::Endpoint_queue*> (const_cast<void*> (object));
+
+    echo_in->submit (echo_buffer, count);
+    echo_out->submit (echo_buffer, packet_size, echo_cb, echo_out);
+  }
+
+  bool volatile echo_done;
+
+  void
+  echo_done_cb (const void* object __attribute__((unused)),
+                usb::host::Urb& urb __attribute__((unused)))
+  {
+    echo_done = true;
+  }
+
+  /*
+   * Round trip latency of the whole path: the host writes a
+   * transfer, the device echoes it and the host reads it back.
+   */
+  int
+  bench_echo (usb::host::Pipe_queues& queues,
+              usb::device::Endpoint_queue& dev_in,
+              usb::device::Endpoint_queue& dev_out,
+              usb::host::Pipe_queue& host_in, usb::host::Pipe_queue& host_out,
+              std::size_t size)
+  {
+    echo_in = &dev_in;
+    if (dev_out.submit (echo_buffer, packet_size, echo_cb, &dev_out)
+        != driver::RETURN_OK)
+      {
+        printf ("echo start failed\n");
+        return 1;
+      }
+
+    mock_usbd_clear_stats ();
+    mock_usbh_clear_stats ();
+
+    usb::host::Urb urb_out {};
+    usb::host::Urb urb_in {};
+
+    clock::timestamp_t sum = 0;
+    clock::timestamp_t max = 0;
+    int ret = 0;
+
+    for (std::size_t i = 0; i < echo_rounds && ret == 0; ++i)
+      {
+        uint8_t* const data = out + i * size;
+        std::memset (in, 0, size);
+
+        urb_in.packet = usb::host::PACKET_IN;
+        urb_in.data = in;
+        urb_in.num = size;
+        urb_in.cb_func = echo_done_cb;
+        urb_in.cb_object = nullptr;
+
+        urb_out.packet = usb::host::PACKET_OUT;
+        urb_out.data = data;
+        urb_out.num = size;
+        urb_out.cb_func = nullptr;
+        urb_out.cb_object = nullptr;
+
+        echo_done = false;
+        clock::timestamp_t const begin = hrclock.now ();
+
+        if (host_in.submit (urb_in) != driver::RETURN_OK
+            || host_out.submit (urb_out) != driver::RETURN_OK)
+          {
+            ret = 1;
+            break;
+          }
+
+        while (!echo_done)
+          {
+            if (queues.timed_dispatch (clock_systick::ticks_cast (100000u))
+                == 0)
+              {
+                break;
+              }
+          }
+
+        clock::timestamp_t const cycles = hrclock.now () - begin;
+        sum += cycles;
+        if (cycles > max)
+          {
+            max = cycles;
+          }
+
+        if (!echo_done || urb_in.status != driver::RETURN_OK
+            || urb_in.count != size || std::memcmp (in, data, size) != 0)
+          {
+            ret = 1;
+          }
+      }
+
+    host_in.abort ();
+    host_out.abort ();
+    dev_out.abort ();
+    dev_in.abort ();
+    queues.try_dispatch ();
+
+    if (ret != 0)
+      {
+        printf ("echo %u failed\n", static_cast<unsigned int> (size));
+        return ret;
+      }
+
+    mock_usbh_stats_t stats;
+    mock_usbh_get_stats (&stats);
+
+    uint64_t const frequency = hrclock.input_clock_frequency_hz ();
+
+    printf ("echo %4u %6u us avg %6u us max, %3u frames, %6u NAKs\n",
+            static_cast<unsigned int> (size),
+            static_cast<unsigned int> (sum * 1000000 / echo_rounds / frequency),
+            static_cast<unsigned int> (max * 1000000 / frequency),
+            static_cast<unsigned int> (stats.frames),
+            static_cast<unsigned int> (stats.naks));
+
+    return 0;
+  }
+
+  // --------------------------------------------------------------------------
+
+  int
+  run (void)
+  {
+    static memory_pool_static<usb::device::Transfer_request,
+        2 * max_requests> pool
+      { "usbd" };
+
+    usb::device::Transfer_queues device_queues
+      { usbd };
+    usb::device::Endpoint_queue dev_in
+      { device_queues, ep_in, pool };
+    usb::device::Endpoint_queue dev_out
+      { device_queues, ep_out, pool };
+
+    usb::host::Pipe_queues host_queues
+      { usbh };
+    usb::host::Pipe_queue host_in
+      { host_queues, pipe_in };
+    usb::host::Pipe_queue host_out
+      { host_queues, pipe_out };
+
+    int ret = 0;
+
+    Device_stream ds;
+    Host_stream hs;
+
+    // Device to host.
+    ds.queue = &dev_in;
+    ds.buffer = out;
+    hs.queue = &host_in;
+    hs.packet = usb::host::PACKET_IN;
+    hs.buffer = in;
+    for (auto& config : bulk_configs)
+      {
+        if (ret == 0)
+          {
+            ret = bench_bulk (host_queues, ds, hs, "in", config);
+          }
+      }
+
+    // Host to device.
+    ds.queue = &dev_out;
+    ds.buffer = in;
+    hs.queue = &host_out;
+    hs.packet = usb::host::PACKET_OUT;
+    hs.buffer = out;
+    for (auto& config : bulk_configs)
+      {
+        if (ret == 0)
+          {
+            ret = bench_bulk (host_queues, ds, hs, "out", config);
+          }
+      }
+
+    for (auto size : echo_sizes)
+      {
+        if (ret == 0)
+          {
+            ret = bench_echo (host_queues, dev_in, dev_out, host_in, host_out,
+                              size);
+          }
+      }
+
+    return ret;
+  }
+}
+
+/*
+ * Bulk throughput and round trip latency between the host and
+ * the device request queues, over the mock host and device
+ * controllers connected back-to-back. The bus is timed as full
+ * speed, so the bulk rates cannot exceed 19 packets per frame
+ * (1216000 B/s); the latencies include the dispatch of the host
+ * completions.
+ */
+int
+bench_usb (void)
+{
+  printf ("USB bulk (%u bytes, full speed, %u bytes packets)\n",
+          static_cast<unsigned int> (total_bytes),
+          static_cast<unsigned int> (packet_size));
+
+  for (std::size_t i = 0; i < total_bytes; ++i)
+    {
+      out[i] = static_cast<uint8_t> (i * 7 + 1);
+    }
+
+  mock_usbh_set_clock_frequency (hrclock.input_clock_frequency_hz ());
+
+  running = true;
+  thread irq
+    { "usb-irq", irq_func, nullptr };
+
+  int ret = start ();
+  if (ret == 0)
+    {
+      ret = run ();
+    }
+  stop ();
+
+  running = false;
+  irq.join ();
+
+  printf ("\n");
+  return ret;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+bench_usbd_device_cb (uint32_t event)
+{
+  usbd.signal_device_event (event);
+}
+
+void
+bench_usbd_endpoint_cb (uint8_t ep_addr, uint32_t event)
+{
+  usbd.signal_endpoint_event (ep_addr, event);
+}
+
+void
+bench_usbh_port_cb (uint8_t port, uint32_t event)
+{
+  usbh.signal_port_event (port, event);
+}
+
+void
+bench_usbh_pipe_cb (ARM_USBH_PIPE_HANDLE pipe, uint32_t event)
+{
+  usbh.signal_pipe_event (pipe, event);
+}
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <cmsis-plus/rtos/os.h>
+
+#include <cstdio>
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Measure the average cost of a function, in hrclock cycles.
+ * @param [in] name The name displayed with the result.
+ * @param [in] iterations How many times to call the function.
+ * @param [in] func The function object to measure.
+ * @return The average number of cycles per call.
+ * @details
+ * The loop overhead is not subtracted, so results are slightly
+ * pessimistic, but comparable between runs.
+ */
+template<typename F>
+  os::rtos::clock::timestamp_t
+  bench_run (const char* name, uint32_t iterations, F&& func)
+  {
+    using namespace os::rtos;
+
+    clock::timestamp_t begin = hrclock.now ();
+    for (uint32_t i = 0; i < iterations; ++i)
+      {
+        func ();
+      }
+    clock::timestamp_t cycles = (hrclock.now () - begin) / iterations;
+
+    printf ("%-32s %6u cycles\n", name, static_cast<unsigned int> (cycles));
+    return cycles;
+  }
+
+// ----------------------------------------------------------------------------
+
+int
+bench_clocks (void);
+
+int
+bench_format (void);
+
+int
+bench_trace (void);
+
+int
+bench_serial (void);
+
+int
+bench_usb_cdc (void);
+
+int
+bench_usb (void);
+
+#endif /* BENCH_H_ */
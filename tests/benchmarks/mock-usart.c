@@ -0,0 +1,490 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <mock-usart.h>
+
+#include <cmsis-plus/rtos/os-c-api.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+#define MOCK_USART_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)
+
+// Idle characters after which the receive timeout event is signalled.
+#define MOCK_USART_RX_TIMEOUT_CHARS (2)
+
+typedef struct mock_usart_s
+{
+  ARM_USART_SignalEvent_t cb_event;
+
+  uint32_t clock_frequency_hz;
+  uint64_t char_cycles;
+
+  const uint8_t* tx_data;
+  uint32_t tx_num;
+  uint32_t tx_count;
+  uint64_t tx_start;
+
+  uint8_t* rx_data;
+  uint32_t rx_num;
+  uint32_t rx_count;
+  uint64_t rx_last;
+
+  mock_usart_stats_t stats;
+
+  bool powered;
+  bool tx_enabled;
+  bool rx_enabled;
+  bool tx_busy;
+  bool rx_busy;
+  bool rx_overflow;
+  bool rx_timeout_signalled;
+  bool rx_timeout_disabled;
+} mock_usart_t;
+
+static mock_usart_t mock;
+
+// ----------------------------------------------------------------------------
+
+static uint64_t
+mock_now (void)
+{
+  return os_clock_now (os_clock_get_hrclock ());
+}
+
+static void
+mock_signal (uint32_t event, uint64_t due)
+{
+  uint64_t const begin = mock_now ();
+  uint32_t const latency = (uint32_t) (begin - due);
+
+  mock.stats.events++;
+  mock.stats.latency_sum += latency;
+  if (latency > mock.stats.latency_max)
+    {
+      mock.stats.latency_max = latency;
+    }
+
+  if (mock.cb_event != NULL)
+    {
+      mock.cb_event (event);
+    }
+
+  mock.stats.callback_cycles += mock_now () - begin;
+}
+
+// Receive the looped back character; called when it was completely sent.
+static void
+mock_receive_char (uint8_t c, uint64_t due)
+{
+  if (!mock.rx_busy || !mock.rx_enabled)
+    {
+      mock.stats.rx_overflows++;
+      mock.rx_overflow = true;
+      mock_signal (ARM_USART_EVENT_RX_OVERFLOW, due);
+      return;
+    }
+
+  mock.rx_data[mock.rx_count++] = c;
+  mock.rx_last = due;
+
+  if (mock.rx_count == mock.rx_num)
+    {
+      mock.rx_busy = false;
+      mock_signal (ARM_USART_EVENT_RECEIVE_COMPLETE, due);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+mock_usart_set_clock_frequency (uint32_t frequency_hz)
+{
+  mock.clock_frequency_hz = frequency_hz;
+}
+
+/*
+ * Process, in time order, all the characters sent and the receive
+ * timeouts due until now. The callbacks may start new transfers;
+ * they begin at the current time, as on a real device.
+ */
+void
+mock_usart_poll (void)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  uint64_t const now = mock_now ();
+  for (;;)
+    {
+      uint64_t tx_due = UINT64_MAX;
+      if (mock.tx_busy)
+        {
+          tx_due = mock.tx_start + (mock.tx_count + 1) * mock.char_cycles;
+        }
+
+      uint64_t timeout_due = UINT64_MAX;
+      if (mock.rx_busy && mock.rx_count > 0 && !mock.rx_timeout_signalled
+          && !mock.rx_timeout_disabled)
+        {
+          timeout_due = mock.rx_last
+              + MOCK_USART_RX_TIMEOUT_CHARS * mock.char_cycles;
+        }
+
+      if (tx_due <= timeout_due && tx_due <= now)
+        {
+          uint8_t const c = mock.tx_data[mock.tx_count++];
+          if (mock.tx_count == mock.tx_num)
+            {
+              // Signal before receiving the character, since the
+              // callback may start a new send.
+              mock.tx_busy = false;
+              mock_signal (
+                  ARM_USART_EVENT_SEND_COMPLETE | ARM_USART_EVENT_TX_COMPLETE,
+                  tx_due);
+            }
+
+          // Loopback.
+          mock.rx_timeout_signalled = false;
+          mock_receive_char (c, tx_due);
+        }
+      else if (timeout_due < tx_due && timeout_due <= now)
+        {
+          mock.rx_timeout_signalled = true;
+          mock_signal (ARM_USART_EVENT_RX_TIMEOUT, timeout_due);
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usart_set_rx_timeout_event (bool enabled)
+{
+  mock.rx_timeout_disabled = !enabled;
+}
+
+void
+mock_usart_get_stats (mock_usart_stats_t* stats)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  *stats = mock.stats;
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usart_clear_stats (void)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  memset (&mock.stats, 0, sizeof(mock.stats));
+  os_irq_critical_exit (state);
+}
+
+// ----------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+static ARM_DRIVER_VERSION
+Mock_GetVersion (void)
+{
+  ARM_DRIVER_VERSION const version =
+    { ARM_USART_API_VERSION, MOCK_USART_DRV_VERSION };
+  return version;
+}
+
+static ARM_USART_CAPABILITIES
+Mock_GetCapabilities (void)
+{
+  ARM_USART_CAPABILITIES capa;
+  memset (&capa, 0, sizeof(capa));
+
+  capa.asynchronous = 1;
+  capa.event_tx_complete = 1;
+  capa.event_rx_timeout = mock.rx_timeout_disabled ? 0 : 1;
+
+  return capa;
+}
+
+static ARM_USART_STATUS
+Mock_GetStatus (void)
+{
+  ARM_USART_STATUS status;
+  memset (&status, 0, sizeof(status));
+
+  status.tx_busy = mock.tx_busy;
+  status.rx_busy = mock.rx_busy;
+  status.rx_overflow = mock.rx_overflow;
+
+  return status;
+}
+
+static ARM_USART_MODEM_STATUS
+Mock_GetModemStatus (void)
+{
+  ARM_USART_MODEM_STATUS modem_status;
+  memset (&modem_status, 0, sizeof(modem_status));
+
+  return modem_status;
+}
+
+#pragma GCC diagnostic pop
+
+static int32_t
+Mock_Initialize (ARM_USART_SignalEvent_t cb_event)
+{
+  mock.cb_event = cb_event;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_Uninitialize (void)
+{
+  mock.cb_event = NULL;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PowerControl (ARM_POWER_STATE state)
+{
+  switch (state)
+    {
+    case ARM_POWER_FULL:
+      mock.powered = true;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_OFF:
+      {
+        os_irq_state_t const irq_state = os_irq_critical_enter ();
+
+        mock.powered = false;
+        mock.tx_enabled = false;
+        mock.rx_enabled = false;
+        mock.tx_busy = false;
+        mock.rx_busy = false;
+
+        os_irq_critical_exit (irq_state);
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+}
+
+static int32_t
+Mock_Send (const void* data, uint32_t num)
+{
+  if (data == NULL || num == 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.powered || !mock.tx_enabled || mock.char_cycles == 0)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  int32_t ret = ARM_DRIVER_OK;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (mock.tx_busy)
+    {
+      ret = ARM_DRIVER_ERROR_BUSY;
+    }
+  else
+    {
+      mock.tx_data = (const uint8_t*) data;
+      mock.tx_num = num;
+      mock.tx_count = 0;
+      mock.tx_start = mock_now ();
+      mock.tx_busy = true;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+static int32_t
+Mock_Receive (void* data, uint32_t num)
+{
+  if (data == NULL || num == 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.powered || !mock.rx_enabled)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  int32_t ret = ARM_DRIVER_OK;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (mock.rx_busy)
+    {
+      ret = ARM_DRIVER_ERROR_BUSY;
+    }
+  else
+    {
+      mock.rx_data = (uint8_t*) data;
+      mock.rx_num = num;
+      mock.rx_count = 0;
+      mock.rx_overflow = false;
+      mock.rx_timeout_signalled = false;
+      mock.rx_busy = true;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+static int32_t
+Mock_Transfer (const void* data_out, void* data_in, uint32_t num)
+{
+  // Only for the synchronous modes.
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t
+Mock_SetModemControl (ARM_USART_MODEM_CONTROL control)
+{
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+#pragma GCC diagnostic pop
+
+static uint32_t
+Mock_GetTxCount (void)
+{
+  return mock.tx_count;
+}
+
+static uint32_t
+Mock_GetRxCount (void)
+{
+  return mock.rx_count;
+}
+
+static int32_t
+Mock_Control (uint32_t control, uint32_t arg)
+{
+  switch (control & ARM_USART_CONTROL_Msk)
+    {
+    case ARM_USART_MODE_ASYNCHRONOUS:
+      {
+        if (arg == 0 || mock.clock_frequency_hz == 0)
+          {
+            return ARM_USART_ERROR_BAUDRATE;
+          }
+
+        uint32_t bits;
+        switch (control & ARM_USART_DATA_BITS_Msk)
+          {
+          case ARM_USART_DATA_BITS_5:
+            bits = 5;
+            break;
+          case ARM_USART_DATA_BITS_6:
+            bits = 6;
+            break;
+          case ARM_USART_DATA_BITS_7:
+            bits = 7;
+            break;
+          case ARM_USART_DATA_BITS_9:
+            bits = 9;
+            break;
+          default:
+            bits = 8;
+            break;
+          }
+
+        if ((control & ARM_USART_PARITY_Msk) != ARM_USART_PARITY_NONE)
+          {
+            bits += 1;
+          }
+
+        // Round 1.5 stop bits up, and 0.5 down.
+        switch (control & ARM_USART_STOP_BITS_Msk)
+          {
+          case ARM_USART_STOP_BITS_2:
+          case ARM_USART_STOP_BITS_1_5:
+            bits += 2;
+            break;
+          default:
+            bits += 1;
+            break;
+          }
+
+        // Plus the start bit.
+        bits += 1;
+
+        uint64_t cycles = ((uint64_t) mock.clock_frequency_hz * bits) / arg;
+        mock.char_cycles = (cycles != 0) ? cycles : 1;
+      }
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_CONTROL_TX:
+      mock.tx_enabled = (arg != 0);
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_CONTROL_RX:
+      mock.rx_enabled = (arg != 0);
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_ABORT_SEND:
+      mock.tx_busy = false;
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_ABORT_RECEIVE:
+      mock.rx_busy = false;
+      return ARM_DRIVER_OK;
+
+    case ARM_USART_ABORT_TRANSFER:
+      mock.tx_busy = false;
+      mock.rx_busy = false;
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+ARM_DRIVER_USART mock_usart =
+  { Mock_GetVersion, Mock_GetCapabilities, Mock_Initialize, Mock_Uninitialize,
+      Mock_PowerControl, Mock_Send, Mock_Receive, Mock_Transfer,
+      Mock_GetTxCount, Mock_GetRxCount, Mock_Control, Mock_GetStatus,
+      Mock_SetModemControl, Mock_GetModemStatus, };
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MOCK_USART_H_
+#define MOCK_USART_H_
+
+#include <Driver_USART.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Loopback USART driver, with the CMSIS ARM_DRIVER_USART interface,
+ * for running serial benchmarks without hardware.
+ *
+ * The transmitted characters are received back, one character
+ * time after the previous one, as computed from the configured
+ * baud rate and frame format. The model is advanced by
+ * mock_usart_poll(), which plays the role of the interrupt
+ * handler and must be called often, usually from a dedicated
+ * thread; the driver callback is invoked from there.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct mock_usart_stats_s
+  {
+    // Number of callbacks.
+    uint32_t events;
+    // Overflows, when no receive was active.
+    uint32_t rx_overflows;
+    // Clock cycles from the moment an event was due to the callback.
+    uint64_t latency_sum;
+    uint32_t latency_max;
+    // Clock cycles spent in the callbacks.
+    uint64_t callback_cycles;
+  } mock_usart_stats_t;
+
+  extern ARM_DRIVER_USART mock_usart;
+
+  /**
+   * @brief Set the frequency of the timing clock (the hrclock).
+   */
+  void
+  mock_usart_set_clock_frequency (uint32_t frequency_hz);
+
+  /**
+   * @brief Advance the model up to the current time.
+   */
+  void
+  mock_usart_poll (void);
+
+  /**
+   * @brief Enable or disable the receive timeout event (enabled
+   * by default); the capabilities read after are updated.
+   */
+  void
+  mock_usart_set_rx_timeout_event (bool enabled);
+
+  void
+  mock_usart_get_stats (mock_usart_stats_t* stats);
+
+  void
+  mock_usart_clear_stats (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ----------------------------------------------------------------------------
+
+#endif /* MOCK_USART_H_ */
@@ -0,0 +1,509 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <mock-usbd.h>
+
+#include <cmsis-plus/rtos/os-c-api.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+#define MOCK_USBD_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)
+
+#define MOCK_USBD_ENDPOINTS (16)
+
+typedef struct mock_usbd_endpoint_s
+{
+  uint8_t* data;
+  uint32_t num;
+  uint32_t count;
+
+  uint16_t max_packet_size;
+  uint8_t type;
+
+  bool configured;
+  bool busy;
+  bool stalled;
+} mock_usbd_endpoint_t;
+
+typedef struct mock_usbd_s
+{
+  ARM_USBD_SignalDeviceEvent_t cb_device_event;
+  ARM_USBD_SignalEndpointEvent_t cb_endpoint_event;
+
+  // Indexed by direction (0 = OUT, 1 = IN) and number.
+  mock_usbd_endpoint_t endpoints[2][MOCK_USBD_ENDPOINTS];
+
+  uint8_t setup[8];
+
+  mock_usbd_stats_t stats;
+
+  uint16_t frame_number;
+  uint8_t address;
+
+  bool powered;
+  bool connected;
+} mock_usbd_t;
+
+static mock_usbd_t mock;
+
+// ----------------------------------------------------------------------------
+
+static uint64_t
+mock_now (void)
+{
+  return os_clock_now (os_clock_get_hrclock ());
+}
+
+static mock_usbd_endpoint_t*
+mock_endpoint (uint8_t ep_addr)
+{
+  return &mock.endpoints[(ep_addr & USB_ENDPOINT_DIRECTION_MASK) ? 1 : 0][ep_addr
+      & USB_ENDPOINT_NUMBER_MASK];
+}
+
+static void
+mock_signal_endpoint (uint8_t ep_addr, uint32_t event)
+{
+  uint64_t const begin = mock_now ();
+
+  mock.stats.events++;
+  if (mock.cb_endpoint_event != NULL)
+    {
+      mock.cb_endpoint_event (ep_addr, event);
+    }
+
+  mock.stats.callback_cycles += mock_now () - begin;
+}
+
+// ----------------------------------------------------------------------------
+
+void
+mock_usbd_host_event (uint32_t event)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (event & ARM_USBD_EVENT_RESET)
+    {
+      // Only the control endpoint survives a bus reset.
+      for (uint32_t i = 1; i < MOCK_USBD_ENDPOINTS; ++i)
+        {
+          mock.endpoints[0][i].busy = false;
+          mock.endpoints[1][i].busy = false;
+        }
+      mock.address = 0;
+    }
+
+  mock.stats.events++;
+  if (mock.cb_device_event != NULL)
+    {
+      mock.cb_device_event (event);
+    }
+
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usbd_host_sof (uint16_t frame_number)
+{
+  mock.frame_number = frame_number;
+}
+
+bool
+mock_usbd_host_connected (void)
+{
+  return mock.powered && mock.connected;
+}
+
+int32_t
+mock_usbd_host_setup (const uint8_t* setup)
+{
+  if (!mock.connected)
+    {
+      return MOCK_USBD_NO_RESPONSE;
+    }
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  // A SETUP packet cancels the pending control transfers.
+  mock.endpoints[0][0].busy = false;
+  mock.endpoints[1][0].busy = false;
+  mock.endpoints[0][0].stalled = false;
+  mock.endpoints[1][0].stalled = false;
+
+  memcpy (mock.setup, setup, sizeof(mock.setup));
+  mock.stats.packets++;
+  mock_signal_endpoint (0x00, ARM_USBD_EVENT_SETUP);
+
+  os_irq_critical_exit (state);
+  return 0;
+}
+
+int32_t
+mock_usbd_host_out (uint8_t ep_num, const uint8_t* data, uint32_t num)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_num & USB_ENDPOINT_NUMBER_MASK);
+
+  int32_t ret;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (!mock.connected || !ep->configured || num > ep->max_packet_size)
+    {
+      ret = MOCK_USBD_NO_RESPONSE;
+    }
+  else if (ep->stalled)
+    {
+      ret = MOCK_USBD_STALL;
+    }
+  else if (ep->busy)
+    {
+      // Bytes past the end of the transfer are lost (babble).
+      uint32_t const count =
+          (num < ep->num - ep->count) ? num : ep->num - ep->count;
+      if (count != 0)
+        {
+          memcpy (ep->data + ep->count, data, count);
+          ep->count += count;
+        }
+      mock.stats.packets++;
+
+      if (ep->count == ep->num || num < ep->max_packet_size)
+        {
+          ep->busy = false;
+          mock_signal_endpoint (ep_num & USB_ENDPOINT_NUMBER_MASK,
+                                ARM_USBD_EVENT_OUT);
+        }
+      ret = (int32_t) num;
+    }
+  else
+    {
+      mock.stats.naks++;
+      ret = MOCK_USBD_NAK;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+int32_t
+mock_usbd_host_in (uint8_t ep_num, uint8_t* buf)
+{
+  uint8_t const ep_addr = (ep_num & USB_ENDPOINT_NUMBER_MASK)
+      | USB_ENDPOINT_DIRECTION_MASK;
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+
+  int32_t ret;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (!mock.connected || !ep->configured)
+    {
+      ret = MOCK_USBD_NO_RESPONSE;
+    }
+  else if (ep->stalled)
+    {
+      ret = MOCK_USBD_STALL;
+    }
+  else if (ep->busy)
+    {
+      uint32_t const left = ep->num - ep->count;
+      uint32_t const count =
+          (left < ep->max_packet_size) ? left : ep->max_packet_size;
+      if (count != 0)
+        {
+          memcpy (buf, ep->data + ep->count, count);
+          ep->count += count;
+        }
+      mock.stats.packets++;
+
+      // A zero length transfer sends a zero length packet.
+      if (ep->count == ep->num)
+        {
+          ep->busy = false;
+          mock_signal_endpoint (ep_addr, ARM_USBD_EVENT_IN);
+        }
+      ret = (int32_t) count;
+    }
+  else
+    {
+      mock.stats.naks++;
+      ret = MOCK_USBD_NAK;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+uint16_t
+mock_usbd_packet_size (uint8_t ep_addr)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+  return ep->configured ? ep->max_packet_size : 0;
+}
+
+void
+mock_usbd_get_stats (mock_usbd_stats_t* stats)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  *stats = mock.stats;
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usbd_clear_stats (void)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  memset (&mock.stats, 0, sizeof(mock.stats));
+  os_irq_critical_exit (state);
+}
+
+// ----------------------------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+static ARM_DRIVER_VERSION
+Mock_GetVersion (void)
+{
+  ARM_DRIVER_VERSION const version =
+    { ARM_USBD_API_VERSION, MOCK_USBD_DRV_VERSION };
+  return version;
+}
+
+static ARM_USBD_CAPABILITIES
+Mock_GetCapabilities (void)
+{
+  ARM_USBD_CAPABILITIES capa;
+  memset (&capa, 0, sizeof(capa));
+
+  return capa;
+}
+
+static ARM_USBD_STATE
+Mock_DeviceGetState (void)
+{
+  ARM_USBD_STATE device_state;
+  memset (&device_state, 0, sizeof(device_state));
+
+  device_state.vbus = mock.powered;
+  device_state.speed = ARM_USB_SPEED_FULL;
+  device_state.active = mock.connected;
+
+  return device_state;
+}
+
+#pragma GCC diagnostic pop
+
+static int32_t
+Mock_Initialize (ARM_USBD_SignalDeviceEvent_t cb_device_event,
+                 ARM_USBD_SignalEndpointEvent_t cb_endpoint_event)
+{
+  mock.cb_device_event = cb_device_event;
+  mock.cb_endpoint_event = cb_endpoint_event;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_Uninitialize (void)
+{
+  mock.cb_device_event = NULL;
+  mock.cb_endpoint_event = NULL;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PowerControl (ARM_POWER_STATE state)
+{
+  switch (state)
+    {
+    case ARM_POWER_FULL:
+      mock.powered = true;
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_OFF:
+      {
+        os_irq_state_t const irq_state = os_irq_critical_enter ();
+
+        mock.powered = false;
+        mock.connected = false;
+        memset (mock.endpoints, 0, sizeof(mock.endpoints));
+
+        os_irq_critical_exit (irq_state);
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+}
+
+static int32_t
+Mock_DeviceConnect (void)
+{
+  if (!mock.powered)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+  mock.connected = true;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_DeviceDisconnect (void)
+{
+  mock.connected = false;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_DeviceRemoteWakeup (void)
+{
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t
+Mock_DeviceSetAddress (uint8_t dev_addr)
+{
+  mock.address = dev_addr;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_ReadSetupPacket (uint8_t* setup)
+{
+  memcpy (setup, mock.setup, sizeof(mock.setup));
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_EndpointConfigure (uint8_t ep_addr, uint8_t ep_type,
+                        uint16_t ep_max_packet_size)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  ep->type = ep_type;
+  ep->max_packet_size = ep_max_packet_size & USB_ENDPOINT_MAX_PACKET_SIZE_MASK;
+  ep->configured = true;
+  ep->busy = false;
+  ep->stalled = false;
+
+  os_irq_critical_exit (state);
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_EndpointUnconfigure (uint8_t ep_addr)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  ep->configured = false;
+  ep->busy = false;
+
+  os_irq_critical_exit (state);
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_EndpointStall (uint8_t ep_addr, bool stall)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+  if (!ep->configured)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  ep->stalled = stall;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_EndpointTransfer (uint8_t ep_addr, uint8_t* data, uint32_t num)
+{
+  mock_usbd_endpoint_t* const ep = mock_endpoint (ep_addr);
+  if (data == NULL && num != 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!ep->configured)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  int32_t ret = ARM_DRIVER_OK;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (ep->busy)
+    {
+      ret = ARM_DRIVER_ERROR_BUSY;
+    }
+  else
+    {
+      ep->data = data;
+      ep->num = num;
+      ep->count = 0;
+      ep->busy = true;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+static uint32_t
+Mock_EndpointTransferGetResult (uint8_t ep_addr)
+{
+  return mock_endpoint (ep_addr)->count;
+}
+
+static int32_t
+Mock_EndpointTransferAbort (uint8_t ep_addr)
+{
+  mock_endpoint (ep_addr)->busy = false;
+  return ARM_DRIVER_OK;
+}
+
+static uint16_t
+Mock_GetFrameNumber (void)
+{
+  return mock.frame_number;
+}
+
+// ----------------------------------------------------------------------------
+
+ARM_DRIVER_USBD mock_usbd =
+  { Mock_GetVersion, Mock_GetCapabilities, Mock_Initialize, Mock_Uninitialize,
+      Mock_PowerControl, Mock_DeviceConnect, Mock_DeviceDisconnect,
+      Mock_DeviceGetState, Mock_DeviceRemoteWakeup, Mock_DeviceSetAddress,
+      Mock_ReadSetupPacket, Mock_EndpointConfigure, Mock_EndpointUnconfigure,
+      Mock_EndpointStall, Mock_EndpointTransfer, Mock_EndpointTransferGetResult,
+      Mock_EndpointTransferAbort, Mock_GetFrameNumber };
+
+// ----------------------------------------------------------------------------
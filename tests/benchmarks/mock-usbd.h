@@ -0,0 +1,142 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MOCK_USBD_H_
+#define MOCK_USBD_H_
+
+#include <Driver_USBD.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------
+
+/*
+ * USB device controller driver, with the CMSIS ARM_DRIVER_USBD
+ * interface, for running the device stack without hardware.
+ *
+ * The host side is played by the test, or by the mock host
+ * controller (mock-usbh.h), one packet at a time:
+ * SETUP packets are stored and signalled on the control endpoint,
+ * OUT packets are copied into the pending endpoint transfer, and
+ * IN packets are taken from it, with the configured maximum
+ * packet size. Without a pending transfer the packet is NAKed,
+ * on a halted endpoint it is STALLed. A transfer completes when
+ * all its bytes were transferred, or on a short packet; the
+ * endpoint callback is invoked from the host side functions,
+ * which play the role of the interrupt.
+ * The device is not timed by itself; the frame number is the one
+ * of the last SOF.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Returned when the endpoint is not ready.
+#define MOCK_USBD_NAK (-1)
+// Returned when the endpoint is halted.
+#define MOCK_USBD_STALL (-2)
+// Returned when the device or the endpoint is not there.
+#define MOCK_USBD_NO_RESPONSE (-3)
+
+  typedef struct mock_usbd_stats_s
+  {
+    // Number of callbacks.
+    uint32_t events;
+    // Packets transferred and NAKed.
+    uint32_t packets;
+    uint32_t naks;
+    // Clock cycles spent in the callbacks.
+    uint64_t callback_cycles;
+  } mock_usbd_stats_t;
+
+  extern ARM_DRIVER_USBD mock_usbd;
+
+  /**
+   * @brief Signal a device event (reset, suspend...).
+   */
+  void
+  mock_usbd_host_event (uint32_t event);
+
+  /**
+   * @brief Start a new frame.
+   */
+  void
+  mock_usbd_host_sof (uint16_t frame_number);
+
+  /**
+   * @brief Check if the device is connected (pull-up enabled).
+   */
+  bool
+  mock_usbd_host_connected (void);
+
+  /**
+   * @brief Send a SETUP packet to the control endpoint.
+   * @return 0, or MOCK_USBD_NO_RESPONSE when not connected.
+   */
+  int32_t
+  mock_usbd_host_setup (const uint8_t* setup);
+
+  /**
+   * @brief Send one OUT packet.
+   * @return The number of bytes, or MOCK_USBD_NAK, MOCK_USBD_STALL,
+   *  MOCK_USBD_NO_RESPONSE.
+   */
+  int32_t
+  mock_usbd_host_out (uint8_t ep_num, const uint8_t* data, uint32_t num);
+
+  /**
+   * @brief Receive one IN packet.
+   * @param [in] ep_num The endpoint number, without the direction bit.
+   * @param [out] buf Buffer of at least the maximum packet size.
+   * @return The number of bytes, or MOCK_USBD_NAK, MOCK_USBD_STALL,
+   *  MOCK_USBD_NO_RESPONSE.
+   */
+  int32_t
+  mock_usbd_host_in (uint8_t ep_num, uint8_t* buf);
+
+  /**
+   * @brief Get the maximum packet size of an endpoint, or 0 if
+   *  not configured.
+   */
+  uint16_t
+  mock_usbd_packet_size (uint8_t ep_addr);
+
+  void
+  mock_usbd_get_stats (mock_usbd_stats_t* stats);
+
+  void
+  mock_usbd_clear_stats (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ----------------------------------------------------------------------------
+
+#endif /* MOCK_USBD_H_ */
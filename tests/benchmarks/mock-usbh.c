@@ -0,0 +1,855 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <mock-usbh.h>
+#include <mock-usbd.h>
+
+#include <cmsis-plus/rtos/os-c-api.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+#define MOCK_USBH_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)
+
+#define MOCK_USBH_PIPES (16)
+
+// Full speed timing, in bit times.
+#define MOCK_USBH_BIT_RATE (12000000UL)
+#define MOCK_USBH_FRAME_BITS (12000U)
+// The SOF packet.
+#define MOCK_USBH_SOF_BITS (8U * 8)
+// Token, data and handshake packets, with the inter-packet delays.
+#define MOCK_USBH_TRANSACTION_BITS (13U * 8)
+// Token and handshake, for NAK and STALL, or token and timeout.
+#define MOCK_USBH_NAK_BITS (8U * 8)
+
+// Largest full speed packet (isochronous).
+#define MOCK_USBH_MAX_PACKET_SIZE (1023)
+
+typedef struct mock_usbh_pipe_s
+{
+  uint8_t* data;
+  uint32_t num;
+  uint32_t count;
+  uint32_t packet;
+  // When the transfer was started.
+  uint64_t start;
+
+  uint16_t max_packet_size;
+  uint16_t last_frame;
+
+  uint8_t ep_addr;
+  uint8_t type;
+  uint8_t interval;
+
+  bool created;
+  bool busy;
+} mock_usbh_pipe_t;
+
+typedef struct mock_usbh_s
+{
+  ARM_USBH_SignalPortEvent_t cb_port_event;
+  ARM_USBH_SignalPipeEvent_t cb_pipe_event;
+
+  uint32_t clock_frequency_hz;
+
+  mock_usbh_pipe_t pipes[MOCK_USBH_PIPES];
+  // Where the round robin search for control and bulk pipes starts.
+  uint32_t next_pipe;
+
+  uint64_t frame_start;
+  uint32_t frame_bits;
+  uint16_t frame_number;
+
+  // Accumulated until the next frame.
+  uint32_t port_events;
+
+  // The transfer ended by the current transaction, signalled
+  // when the transaction ends.
+  mock_usbh_pipe_t* done_pipe;
+  uint32_t done_event;
+  uint64_t done_due;
+
+  mock_usbh_stats_t stats;
+
+  bool powered;
+  bool vbus;
+  bool connected;
+  bool suspended;
+} mock_usbh_t;
+
+static mock_usbh_t mock;
+
+static uint8_t mock_buffer[MOCK_USBH_MAX_PACKET_SIZE];
+
+// ----------------------------------------------------------------------------
+
+static uint64_t
+mock_now (void)
+{
+  return os_clock_now (os_clock_get_hrclock ());
+}
+
+static uint64_t
+mock_bits_cycles (uint32_t bits)
+{
+  return ((uint64_t) bits * mock.clock_frequency_hz) / MOCK_USBH_BIT_RATE;
+}
+
+// The bit time in the current frame corresponding to a clock value.
+static uint32_t
+mock_frame_position (uint64_t time)
+{
+  if (time <= mock.frame_start)
+    {
+      return 0;
+    }
+
+  uint64_t const bits = ((time - mock.frame_start) * MOCK_USBH_BIT_RATE)
+      / mock.clock_frequency_hz;
+  return (bits < MOCK_USBH_FRAME_BITS) ? (uint32_t) bits : MOCK_USBH_FRAME_BITS;
+}
+
+static bool
+mock_is_periodic (const mock_usbh_pipe_t* pipe)
+{
+  return pipe->type == ARM_USB_ENDPOINT_INTERRUPT
+      || pipe->type == ARM_USB_ENDPOINT_ISOCHRONOUS;
+}
+
+static void
+mock_signal_port (uint32_t event, uint64_t due)
+{
+  uint64_t const begin = mock_now ();
+  uint32_t const latency = (uint32_t) (begin - due);
+
+  mock.stats.events++;
+  mock.stats.latency_sum += latency;
+  if (latency > mock.stats.latency_max)
+    {
+      mock.stats.latency_max = latency;
+    }
+
+  if (mock.cb_port_event != NULL)
+    {
+      mock.cb_port_event (0, event);
+    }
+
+  mock.stats.callback_cycles += mock_now () - begin;
+}
+
+static void
+mock_signal_pipe (mock_usbh_pipe_t* pipe, uint32_t event, uint64_t due)
+{
+  uint64_t const begin = mock_now ();
+  uint32_t const latency = (uint32_t) (begin - due);
+
+  mock.stats.events++;
+  mock.stats.latency_sum += latency;
+  if (latency > mock.stats.latency_max)
+    {
+      mock.stats.latency_max = latency;
+    }
+
+  // Done before the callback, which may start a new transfer.
+  pipe->busy = false;
+  if (mock.cb_pipe_event != NULL)
+    {
+      mock.cb_pipe_event ((ARM_USBH_PIPE_HANDLE) (pipe - mock.pipes) + 1,
+                          event);
+    }
+
+  mock.stats.callback_cycles += mock_now () - begin;
+}
+
+static void
+mock_complete (mock_usbh_pipe_t* pipe, uint32_t event)
+{
+  mock.done_pipe = pipe;
+  mock.done_event = event;
+  mock.done_due = mock.frame_start + mock_bits_cycles (mock.frame_bits);
+}
+
+// ----------------------------------------------------------------------------
+
+// Select the pipe for the next transaction in the current frame.
+static mock_usbh_pipe_t*
+mock_next_pipe (void)
+{
+  for (uint32_t i = 0; i < MOCK_USBH_PIPES; ++i)
+    {
+      mock_usbh_pipe_t* const pipe = &mock.pipes[i];
+      if (pipe->busy && mock_is_periodic (pipe)
+          && (uint16_t) ((mock.frame_number - pipe->last_frame) & 0x7FF)
+              >= pipe->interval)
+        {
+          return pipe;
+        }
+    }
+
+  for (uint32_t i = 0; i < MOCK_USBH_PIPES; ++i)
+    {
+      uint32_t const n = (mock.next_pipe + i) % MOCK_USBH_PIPES;
+      mock_usbh_pipe_t* const pipe = &mock.pipes[n];
+      if (pipe->busy && !mock_is_periodic (pipe))
+        {
+          return pipe;
+        }
+    }
+
+  return NULL;
+}
+
+// The longest the next transaction of the pipe may take.
+static uint32_t
+mock_transaction_bits (const mock_usbh_pipe_t* pipe)
+{
+  uint32_t payload;
+  switch (pipe->packet & ARM_USBH_PACKET_TOKEN_Msk)
+    {
+    case ARM_USBH_PACKET_SETUP:
+      payload = 8;
+      break;
+
+    case ARM_USBH_PACKET_OUT:
+      payload = pipe->num - pipe->count;
+      if (payload > pipe->max_packet_size)
+        {
+          payload = pipe->max_packet_size;
+        }
+      break;
+
+    default:
+      payload = pipe->max_packet_size;
+      break;
+    }
+
+  return MOCK_USBH_TRANSACTION_BITS + payload * 8;
+}
+
+/*
+ * Perform one transaction, which starts at the given bit time;
+ * the device sees the packets at once, but the frame bit count
+ * and the completion are those at the end of the transaction.
+ */
+static void
+mock_transaction (mock_usbh_pipe_t* pipe, uint32_t start_bits)
+{
+  uint8_t const ep_num = pipe->ep_addr & USB_ENDPOINT_NUMBER_MASK;
+  uint32_t left = pipe->num - pipe->count;
+  int32_t ret;
+
+  pipe->last_frame = mock.frame_number;
+  if (!mock_is_periodic (pipe))
+    {
+      mock.next_pipe = (uint32_t) (pipe - mock.pipes) + 1;
+    }
+
+  switch (pipe->packet & ARM_USBH_PACKET_TOKEN_Msk)
+    {
+    case ARM_USBH_PACKET_SETUP:
+      ret = mock_usbd_host_setup (pipe->data);
+      if (ret == 0)
+        {
+          ret = 8;
+          pipe->count = 8;
+        }
+      break;
+
+    case ARM_USBH_PACKET_OUT:
+      if (left > pipe->max_packet_size)
+        {
+          left = pipe->max_packet_size;
+        }
+      ret = mock_usbd_host_out (ep_num, pipe->data + pipe->count, left);
+      if (ret >= 0)
+        {
+          pipe->count += (uint32_t) ret;
+        }
+      break;
+
+    default:
+      ret = mock_usbd_host_in (ep_num, mock_buffer);
+      if (ret >= 0)
+        {
+          // Bytes past the end of the transfer are lost (babble).
+          if ((uint32_t) ret < left)
+            {
+              left = (uint32_t) ret;
+            }
+          if (left != 0)
+            {
+              memcpy (pipe->data + pipe->count, mock_buffer, left);
+              pipe->count += left;
+            }
+        }
+      break;
+    }
+
+  if (ret >= 0)
+    {
+      mock.frame_bits = start_bits + MOCK_USBH_TRANSACTION_BITS
+          + (uint32_t) ret * 8;
+      mock.stats.packets++;
+      mock.stats.bytes += (uint32_t) ret;
+
+      // Short packets end the transfer; so does a zero length OUT.
+      if (pipe->count == pipe->num
+          || ((pipe->packet & ARM_USBH_PACKET_TOKEN_Msk)
+              == ARM_USBH_PACKET_IN && (uint32_t) ret < pipe->max_packet_size))
+        {
+          mock_complete (pipe, ARM_USBH_EVENT_TRANSFER_COMPLETE);
+        }
+      return;
+    }
+
+  mock.frame_bits = start_bits + MOCK_USBH_NAK_BITS;
+
+  switch (ret)
+    {
+    case MOCK_USBD_NAK:
+      mock.stats.naks++;
+      break;
+
+    case MOCK_USBD_STALL:
+      mock_complete (pipe, ARM_USBH_EVENT_HANDSHAKE_STALL);
+      break;
+
+    default:
+      mock_complete (pipe, ARM_USBH_EVENT_HANDSHAKE_ERR);
+      break;
+    }
+}
+
+static void
+mock_start_frame (uint64_t frame_start)
+{
+  mock.frame_start = frame_start;
+  mock.frame_bits = MOCK_USBH_SOF_BITS;
+  mock.frame_number = (mock.frame_number + 1) & 0x7FF;
+  mock.stats.frames++;
+
+  bool const connected = mock.vbus && mock_usbd_host_connected ();
+  if (connected != mock.connected)
+    {
+      mock.connected = connected;
+      mock.suspended = false;
+      mock.port_events |=
+          connected ? ARM_USBH_EVENT_CONNECT : ARM_USBH_EVENT_DISCONNECT;
+    }
+
+  if (mock.connected && !mock.suspended)
+    {
+      mock_usbd_host_sof (mock.frame_number);
+    }
+
+  if (mock.port_events != 0)
+    {
+      uint32_t const events = mock.port_events;
+      mock.port_events = 0;
+      mock_signal_port (events, frame_start);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+mock_usbh_set_clock_frequency (uint32_t frequency_hz)
+{
+  mock.clock_frequency_hz = frequency_hz;
+}
+
+/*
+ * Process, in time order, the frames and the transactions started
+ * until now, and signal the transfers which ended until now. The
+ * callbacks may start new transfers; they begin at the current
+ * time, or later if the bus is busy.
+ */
+void
+mock_usbh_poll (void)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (mock.powered && mock.clock_frequency_hz != 0)
+    {
+      uint64_t const now = mock_now ();
+      for (;;)
+        {
+          if (mock.done_pipe != NULL)
+            {
+              if (mock.done_due > now)
+                {
+                  break;
+                }
+
+              mock_usbh_pipe_t* const done = mock.done_pipe;
+              mock.done_pipe = NULL;
+              mock_signal_pipe (done, mock.done_event, mock.done_due);
+              continue;
+            }
+
+          mock_usbh_pipe_t* pipe = NULL;
+          if (mock.connected && !mock.suspended)
+            {
+              pipe = mock_next_pipe ();
+            }
+
+          if (pipe != NULL)
+            {
+              uint32_t start_bits = mock_frame_position (pipe->start);
+              if (start_bits < mock.frame_bits)
+                {
+                  start_bits = mock.frame_bits;
+                }
+
+              // Only transactions which surely fit are started.
+              if (start_bits + mock_transaction_bits (pipe)
+                  <= MOCK_USBH_FRAME_BITS)
+                {
+                  if (mock.frame_start + mock_bits_cycles (start_bits) > now)
+                    {
+                      break;
+                    }
+
+                  mock_transaction (pipe, start_bits);
+                  continue;
+                }
+            }
+
+          // Nothing more fits in this frame.
+          uint64_t const next = mock.frame_start
+              + mock_bits_cycles (MOCK_USBH_FRAME_BITS);
+          if (next > now)
+            {
+              break;
+            }
+          mock_start_frame (next);
+        }
+    }
+
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usbh_get_stats (mock_usbh_stats_t* stats)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  *stats = mock.stats;
+  os_irq_critical_exit (state);
+}
+
+void
+mock_usbh_clear_stats (void)
+{
+  os_irq_state_t const state = os_irq_critical_enter ();
+  memset (&mock.stats, 0, sizeof(mock.stats));
+  os_irq_critical_exit (state);
+}
+
+// ----------------------------------------------------------------------------
+
+static mock_usbh_pipe_t*
+mock_pipe (ARM_USBH_PIPE_HANDLE pipe_hndl)
+{
+  if (pipe_hndl == 0 || pipe_hndl > MOCK_USBH_PIPES
+      || !mock.pipes[pipe_hndl - 1].created)
+    {
+      return NULL;
+    }
+  return &mock.pipes[pipe_hndl - 1];
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+static ARM_DRIVER_VERSION
+Mock_GetVersion (void)
+{
+  ARM_DRIVER_VERSION const version =
+    { ARM_USBH_API_VERSION, MOCK_USBH_DRV_VERSION };
+  return version;
+}
+
+static ARM_USBH_CAPABILITIES
+Mock_GetCapabilities (void)
+{
+  ARM_USBH_CAPABILITIES capa;
+  memset (&capa, 0, sizeof(capa));
+
+  capa.port_mask = 1;
+  capa.event_connect = 1;
+  capa.event_disconnect = 1;
+
+  return capa;
+}
+
+static ARM_USBH_PORT_STATE
+Mock_PortGetState (uint8_t port)
+{
+  ARM_USBH_PORT_STATE port_state;
+  memset (&port_state, 0, sizeof(port_state));
+
+  if (port == 0)
+    {
+      port_state.connected = mock.connected;
+      port_state.speed = ARM_USB_SPEED_FULL;
+    }
+
+  return port_state;
+}
+
+#pragma GCC diagnostic pop
+
+static int32_t
+Mock_Initialize (ARM_USBH_SignalPortEvent_t cb_port_event,
+                 ARM_USBH_SignalPipeEvent_t cb_pipe_event)
+{
+  mock.cb_port_event = cb_port_event;
+  mock.cb_pipe_event = cb_pipe_event;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_Uninitialize (void)
+{
+  mock.cb_port_event = NULL;
+  mock.cb_pipe_event = NULL;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PowerControl (ARM_POWER_STATE state)
+{
+  switch (state)
+    {
+    case ARM_POWER_FULL:
+      if (!mock.powered)
+        {
+          mock.frame_start = mock_now ();
+          mock.frame_bits = MOCK_USBH_SOF_BITS;
+          mock.powered = true;
+        }
+      return ARM_DRIVER_OK;
+
+    case ARM_POWER_OFF:
+      {
+        os_irq_state_t const irq_state = os_irq_critical_enter ();
+
+        mock.powered = false;
+        mock.vbus = false;
+        mock.connected = false;
+        mock.suspended = false;
+        mock.port_events = 0;
+        mock.done_pipe = NULL;
+        memset (mock.pipes, 0, sizeof(mock.pipes));
+
+        os_irq_critical_exit (irq_state);
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+}
+
+static int32_t
+Mock_PortVbusOnOff (uint8_t port, bool vbus)
+{
+  if (port != 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.powered)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  if (vbus != mock.vbus)
+    {
+      mock.vbus = vbus;
+      mock_usbd_host_event (vbus ? ARM_USBD_EVENT_VBUS_ON :
+                                   ARM_USBD_EVENT_VBUS_OFF);
+    }
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PortReset (uint8_t port)
+{
+  if (port != 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.connected)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  mock_usbd_host_event (ARM_USBD_EVENT_RESET);
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+  mock.suspended = false;
+  mock.port_events |= ARM_USBH_EVENT_RESET;
+  os_irq_critical_exit (state);
+
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PortSuspend (uint8_t port)
+{
+  if (port != 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.connected)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  mock_usbd_host_event (ARM_USBD_EVENT_SUSPEND);
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+  mock.suspended = true;
+  mock.port_events |= ARM_USBH_EVENT_SUSPEND;
+  os_irq_critical_exit (state);
+
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PortResume (uint8_t port)
+{
+  if (port != 0)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.connected)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  mock_usbd_host_event (ARM_USBD_EVENT_RESUME);
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+  mock.suspended = false;
+  mock.port_events |= ARM_USBH_EVENT_RESUME;
+  os_irq_critical_exit (state);
+
+  return ARM_DRIVER_OK;
+}
+
+static ARM_USBH_PIPE_HANDLE
+Mock_PipeCreate (uint8_t dev_addr, uint8_t dev_speed, uint8_t hub_addr,
+                 uint8_t hub_port, uint8_t ep_addr, uint8_t ep_type,
+                 uint16_t ep_max_packet_size, uint8_t ep_interval)
+{
+  (void) dev_addr;
+  (void) dev_speed;
+  (void) hub_addr;
+  (void) hub_port;
+
+  uint16_t const max_packet_size = ep_max_packet_size
+      & USB_ENDPOINT_MAX_PACKET_SIZE_MASK;
+  if (max_packet_size == 0 || max_packet_size > MOCK_USBH_MAX_PACKET_SIZE)
+    {
+      return 0;
+    }
+
+  ARM_USBH_PIPE_HANDLE ret = 0;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  for (uint32_t i = 0; i < MOCK_USBH_PIPES; ++i)
+    {
+      mock_usbh_pipe_t* const pipe = &mock.pipes[i];
+      if (!pipe->created)
+        {
+          memset (pipe, 0, sizeof(*pipe));
+          pipe->ep_addr = ep_addr;
+          pipe->type = ep_type;
+          pipe->max_packet_size = max_packet_size;
+          pipe->interval = (ep_interval != 0) ? ep_interval : 1;
+          pipe->last_frame = (mock.frame_number - pipe->interval) & 0x7FF;
+          pipe->created = true;
+
+          ret = i + 1;
+          break;
+        }
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+static int32_t
+Mock_PipeModify (ARM_USBH_PIPE_HANDLE pipe_hndl, uint8_t dev_addr,
+                 uint8_t dev_speed, uint8_t hub_addr, uint8_t hub_port,
+                 uint16_t ep_max_packet_size)
+{
+  (void) dev_addr;
+  (void) dev_speed;
+  (void) hub_addr;
+  (void) hub_port;
+
+  mock_usbh_pipe_t* const pipe = mock_pipe (pipe_hndl);
+  uint16_t const max_packet_size = ep_max_packet_size
+      & USB_ENDPOINT_MAX_PACKET_SIZE_MASK;
+  if (pipe == NULL || max_packet_size == 0
+      || max_packet_size > MOCK_USBH_MAX_PACKET_SIZE)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (pipe->busy)
+    {
+      return ARM_DRIVER_ERROR_BUSY;
+    }
+
+  pipe->max_packet_size = max_packet_size;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PipeDelete (ARM_USBH_PIPE_HANDLE pipe_hndl)
+{
+  mock_usbh_pipe_t* const pipe = mock_pipe (pipe_hndl);
+  if (pipe == NULL)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+  pipe->busy = false;
+  pipe->created = false;
+  if (mock.done_pipe == pipe)
+    {
+      mock.done_pipe = NULL;
+    }
+  os_irq_critical_exit (state);
+
+  return ARM_DRIVER_OK;
+}
+
+static int32_t
+Mock_PipeReset (ARM_USBH_PIPE_HANDLE pipe_hndl)
+{
+  // There are no data toggles to clear.
+  return (mock_pipe (pipe_hndl) != NULL) ?
+      ARM_DRIVER_OK : ARM_DRIVER_ERROR_PARAMETER;
+}
+
+static int32_t
+Mock_PipeTransfer (ARM_USBH_PIPE_HANDLE pipe_hndl, uint32_t packet,
+                   uint8_t* data, uint32_t num)
+{
+  mock_usbh_pipe_t* const pipe = mock_pipe (pipe_hndl);
+  if (pipe == NULL || (data == NULL && num != 0))
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+  uint32_t const token = packet & ARM_USBH_PACKET_TOKEN_Msk;
+  if (token == ARM_USBH_PACKET_PING)
+    {
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+  if ((token == ARM_USBH_PACKET_SETUP && num != 8)
+      || (token != ARM_USBH_PACKET_SETUP && token != ARM_USBH_PACKET_OUT
+          && token != ARM_USBH_PACKET_IN))
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  if (!mock.connected)
+    {
+      return ARM_DRIVER_ERROR;
+    }
+
+  int32_t ret = ARM_DRIVER_OK;
+  os_irq_state_t const state = os_irq_critical_enter ();
+
+  if (pipe->busy)
+    {
+      ret = ARM_DRIVER_ERROR_BUSY;
+    }
+  else
+    {
+      pipe->packet = packet;
+      pipe->data = data;
+      pipe->num = num;
+      pipe->count = 0;
+      pipe->start = mock_now ();
+      pipe->busy = true;
+    }
+
+  os_irq_critical_exit (state);
+  return ret;
+}
+
+static uint32_t
+Mock_PipeTransferGetResult (ARM_USBH_PIPE_HANDLE pipe_hndl)
+{
+  mock_usbh_pipe_t* const pipe = mock_pipe (pipe_hndl);
+  return (pipe != NULL) ? pipe->count : 0;
+}
+
+static int32_t
+Mock_PipeTransferAbort (ARM_USBH_PIPE_HANDLE pipe_hndl)
+{
+  mock_usbh_pipe_t* const pipe = mock_pipe (pipe_hndl);
+  if (pipe == NULL)
+    {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+
+  os_irq_state_t const state = os_irq_critical_enter ();
+  pipe->busy = false;
+  if (mock.done_pipe == pipe)
+    {
+      mock.done_pipe = NULL;
+    }
+  os_irq_critical_exit (state);
+
+  return ARM_DRIVER_OK;
+}
+
+static uint16_t
+Mock_GetFrameNumber (void)
+{
+  return mock.frame_number;
+}
+
+// ----------------------------------------------------------------------------
+
+ARM_DRIVER_USBH mock_usbh =
+  { Mock_GetVersion, Mock_GetCapabilities, Mock_Initialize, Mock_Uninitialize,
+      Mock_PowerControl, Mock_PortVbusOnOff, Mock_PortReset, Mock_PortSuspend,
+      Mock_PortResume, Mock_PortGetState, Mock_PipeCreate, Mock_PipeModify,
+      Mock_PipeDelete, Mock_PipeReset, Mock_PipeTransfer,
+      Mock_PipeTransferGetResult, Mock_PipeTransferAbort, Mock_GetFrameNumber };
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MOCK_USBH_H_
+#define MOCK_USBH_H_
+
+#include <Driver_USBH.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Full speed USB host controller, with the CMSIS ARM_DRIVER_USBH
+ * interface, connected back-to-back to the mock device controller
+ * (mock-usbd.h), for running the host and the device stacks
+ * in the same process.
+ *
+ * The single root port sees the device when both the port VBUS
+ * is on and the device is connected. The bus is divided into 1 ms
+ * frames of 12000 bit times; each frame starts with a SOF, which
+ * also updates the device frame number, followed by as many
+ * transactions as fit in the frame. A data transaction takes the
+ * payload plus 13 bytes of protocol overhead, a NAKed one 8 bytes,
+ * so bulk transfers peak at 19 packets of 64 bytes per frame.
+ *
+ * Interrupt and isochronous pipes get one transaction every
+ * interval frames and are serviced first; control and bulk pipes
+ * share the rest of the frame in round robin order. NAKed control
+ * and bulk transactions are retried during the same frame,
+ * interrupt ones at the next interval, without signalling them.
+ * STALL ends the transfer with ARM_USBH_EVENT_HANDSHAKE_STALL, no
+ * response with ARM_USBH_EVENT_HANDSHAKE_ERR. Data toggles and
+ * device addresses are not checked.
+ *
+ * The device sees the packets when the transaction starts; the
+ * host completion is signalled when it ends. The model is advanced
+ * by mock_usbh_poll(), which plays the role of the interrupt
+ * handler and must be called often, usually from a dedicated
+ * thread; both the host and the device callbacks are invoked from
+ * there. Port events are signalled at the beginning of the next
+ * frame.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct mock_usbh_stats_s
+  {
+    // Number of frames.
+    uint32_t frames;
+    // Transactions which moved data, and the payload bytes.
+    uint32_t packets;
+    uint64_t bytes;
+    // Transactions answered with NAK.
+    uint32_t naks;
+    // Number of callbacks.
+    uint32_t events;
+    // Clock cycles from the end of the transaction to the callback.
+    uint64_t latency_sum;
+    uint32_t latency_max;
+    // Clock cycles spent in the callbacks.
+    uint64_t callback_cycles;
+  } mock_usbh_stats_t;
+
+  extern ARM_DRIVER_USBH mock_usbh;
+
+  /**
+   * @brief Set the frequency of the timing clock (the hrclock).
+   */
+  void
+  mock_usbh_set_clock_frequency (uint32_t frequency_hz);
+
+  /**
+   * @brief Advance the model up to the current time.
+   */
+  void
+  mock_usbh_poll (void);
+
+  void
+  mock_usbh_get_stats (mock_usbh_stats_t* stats);
+
+  void
+  mock_usbh_clear_stats (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ----------------------------------------------------------------------------
+
+#endif /* MOCK_USBH_H_ */
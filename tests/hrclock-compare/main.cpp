@@ -0,0 +1,272 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/rtos/os-c-api.h>
+#include <cmsis-plus/diag/trace.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::rtos;
+
+namespace
+{
+  int failed;
+
+  // The last value programmed by compare().
+  clock::timestamp_t volatile compare_timestamp;
+  bool volatile compare_armed;
+
+  uint32_t volatile compare_calls;
+  uint32_t volatile compare_matches;
+
+  // The time stamps of an expiry, in cycles and in ticks.
+  clock::timestamp_t volatile expired_cycles;
+  clock::timestamp_t volatile expired_ticks;
+  uint32_t volatile expired_count;
+
+  // The compare() calls when the last expiry was recorded.
+  uint32_t volatile expired_compare_calls;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        trace::printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  // The number of hrclock cycles in a tick.
+  clock::duration_t
+  cycles_per_tick (void)
+  {
+    return hrclock.input_clock_frequency_hz () / clock_systick::frequency_hz;
+  }
+
+  // Start just after a tick.
+  void
+  wait_tick (void)
+  {
+    sysclock.sleep_for (1);
+  }
+
+  void
+  record_expiry (void)
+  {
+    expired_cycles = hrclock.steady_now ();
+    expired_ticks = sysclock.now ();
+    expired_compare_calls = compare_calls;
+    ++expired_count;
+  }
+
+  /*
+   * Emulate the compare match interrupt: poll the counter and,
+   * when it reaches the programmed value, call the handler with
+   * the interrupts disabled, as from a real handler.
+   */
+  void
+  poll_compare (uint32_t count)
+  {
+    while (expired_count < count)
+      {
+        // ----- Enter critical section ---------------------------------------
+        interrupts::critical_section ics;
+
+        if (compare_armed && hrclock.steady_now () >= compare_timestamp)
+          {
+            compare_armed = false;
+            ++compare_matches;
+
+            os_hrclock_compare_handler ();
+          }
+        // ----- Exit critical section ----------------------------------------
+      }
+  }
+
+  void*
+  sleeper (void* args)
+  {
+    clock::duration_t const duration =
+        *static_cast<clock::duration_t*> (args);
+
+    hrclock.sleep_for (duration);
+    record_expiry ();
+
+    return nullptr;
+  }
+
+  void
+  timer_callback (void* args __attribute__((unused)))
+  {
+    record_expiry ();
+  }
+
+  void
+  test_sleep_for (void)
+  {
+    clock::duration_t duration = cycles_per_tick () / 4;
+
+    // Higher priority, to run as soon as it is resumed.
+    thread::attributes attr;
+    attr.th_priority = thread::priority::above_normal;
+
+    expired_count = 0;
+    wait_tick ();
+
+    clock::timestamp_t const ticks = sysclock.now ();
+    clock::timestamp_t const begin = hrclock.steady_now ();
+    uint32_t const matches = compare_matches;
+
+    thread th
+      { "sleeper", sleeper, &duration, attr };
+    poll_compare (1);
+    th.join ();
+
+    expect (compare_matches > matches, "sleep_for() compare match");
+    expect (expired_ticks == ticks, "sleep_for() between ticks");
+    expect (expired_cycles >= begin + duration, "sleep_for() not early");
+    expect (expired_cycles < begin + duration + cycles_per_tick () / 4,
+            "sleep_for() on time");
+  }
+
+  void
+  test_timer (void)
+  {
+    clock::duration_t duration = cycles_per_tick () / 4;
+
+    timer::attributes attr;
+    attr.clock = &hrclock;
+    timer tm
+      { "once", timer_callback, nullptr, attr };
+
+    expired_count = 0;
+    wait_tick ();
+
+    clock::timestamp_t const ticks = sysclock.now ();
+    clock::timestamp_t const begin = hrclock.steady_now ();
+    uint32_t const calls = compare_calls;
+
+    tm.start (duration);
+    expect (compare_calls > calls, "timer start() programs the compare");
+    poll_compare (1);
+
+    expect (expired_ticks == ticks, "timer between ticks");
+    expect (expired_cycles >= begin + duration, "timer not early");
+
+    // The callback is called from the handler; after it the list
+    // is empty, so there is nothing to program.
+    expect (hrclock.steady_list ().empty (), "timer list drained");
+    expect (compare_calls == expired_compare_calls,
+            "no compare after the last timer");
+  }
+
+  void
+  test_periodic_timer (void)
+  {
+    clock::duration_t period = cycles_per_tick () / 8;
+
+    timer::attributes_periodic attr;
+    attr.clock = &hrclock;
+    timer tm
+      { "periodic", timer_callback, nullptr, attr };
+
+    expired_count = 0;
+    wait_tick ();
+
+    clock::timestamp_t const ticks = sysclock.now ();
+    clock::timestamp_t const begin = hrclock.steady_now ();
+
+    // The compare is reprogrammed after each period.
+    tm.start (period);
+    poll_compare (4);
+    tm.stop ();
+
+    expect (expired_ticks == ticks, "periodic timer between ticks");
+    expect (expired_cycles >= begin + 4 * period, "periodic timer not early");
+  }
+
+  void
+  test_empty_list (void)
+  {
+    expect (hrclock.steady_list ().empty (), "list drained");
+
+    uint32_t const calls = compare_calls;
+      {
+        // ----- Enter critical section ---------------------------------------
+        interrupts::critical_section ics;
+
+        // A late or spurious compare match.
+        os_hrclock_compare_handler ();
+        // ----- Exit critical section ----------------------------------------
+      }
+    expect (compare_calls == calls, "no compare with an empty list");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+/*
+ * Stub for the port function; it only remembers the value,
+ * the match is detected by poll_compare().
+ */
+void
+os::rtos::port::clock_highres::compare (clock::timestamp_t timestamp)
+{
+  compare_timestamp = timestamp;
+  compare_armed = true;
+  ++compare_calls;
+}
+
+int
+os_main (int argc __attribute__((unused)), char* argv[] __attribute__((unused)))
+{
+  trace::printf ("\nhrclock compare test.\n");
+#if defined(__clang__)
+  trace::printf ("Built with clang " __VERSION__ ".\n");
+#else
+  trace::printf ("Built with GCC " __VERSION__ ".\n");
+#endif
+
+  test_sleep_for ();
+  test_timer ();
+  test_periodic_timer ();
+  test_empty_list ();
+
+  if (failed != 0)
+    {
+      trace::printf ("\n%d failed.\n", failed);
+      return 1;
+    }
+
+  trace::printf ("\nPassed.\n");
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,341 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+#include <cmsis-plus/diag/malloc-profiler.h>
+#include <cmsis-plus/iso/malloc.h>
+
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+
+using site_statistics_t = diag::malloc_profiler::site_statistics_t;
+
+namespace
+{
+  constexpr std::size_t sites_count = OS_INTEGER_LIBC_MALLOC_PROFILER_SITES;
+
+  int failed;
+
+  // All sites, plus the overflow entry.
+  site_statistics_t table[sites_count + 1];
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        trace::printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  // The statistics of a site; all zero if not used.
+  site_statistics_t
+  find_site (const void* site)
+  {
+    std::size_t n = diag::malloc_profiler::sites (
+        table, sizeof(table) / sizeof(table[0]));
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        if (table[i].site == site)
+          {
+            return table[i];
+          }
+      }
+    return site_statistics_t
+      { };
+  }
+
+  // The only site with allocations since the last reset().
+  site_statistics_t
+  active_site (void)
+  {
+    site_statistics_t found
+      { };
+    std::size_t count = 0;
+
+    std::size_t n = diag::malloc_profiler::sites (
+        table, sizeof(table) / sizeof(table[0]));
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        if (table[i].allocs != 0)
+          {
+            found = table[i];
+            ++count;
+          }
+      }
+    expect (count == 1, "a single active site");
+    return found;
+  }
+
+  // Each helper is a single call site; the result is stored after
+  // the call, so it is not a tail call from the test.
+  void __attribute__((noinline))
+  malloc_into (void** p, std::size_t size)
+  {
+    *p = estd::malloc (size);
+  }
+
+  void __attribute__((noinline))
+  new_into (uint8_t** p, std::size_t size)
+  {
+    *p = new uint8_t[size];
+  }
+
+  void
+  test_tags (void)
+  {
+    static const char tag_a[] = "test-a";
+    static const char tag_b[] = "test-b";
+
+    diag::malloc_profiler::reset ();
+    std::size_t const live = diag::malloc_profiler::totals ().live_bytes;
+
+    void* a1 = diag::malloc_profiler::malloc (100, tag_a);
+    void* a2 = diag::malloc_profiler::malloc (50, tag_a);
+    estd::free (a1);
+    void* b1 = diag::malloc_profiler::malloc (10, tag_b);
+
+    site_statistics_t st = find_site (tag_a);
+    expect (st.allocs == 2 && st.frees == 1, "tag counts");
+    expect (st.live_bytes == 50 && st.peak_bytes == 150, "tag bytes");
+
+    st = find_site (tag_b);
+    expect (st.allocs == 1 && st.frees == 0, "other tag counts");
+    expect (st.live_bytes == 10 && st.peak_bytes == 10, "other tag bytes");
+
+    st = diag::malloc_profiler::totals ();
+    expect (st.allocs == 3 && st.frees == 1, "total counts");
+    expect (st.live_bytes == live + 60, "total live bytes");
+    expect (st.peak_bytes >= live + 150, "total peak bytes");
+
+    estd::free (a2);
+    estd::free (b1);
+
+    st = find_site (tag_a);
+    expect (st.frees == 2 && st.live_bytes == 0 && st.peak_bytes == 150,
+            "tag after free");
+    expect (diag::malloc_profiler::totals ().live_bytes == live,
+            "total live bytes after free");
+  }
+
+  void
+  test_malloc (void)
+  {
+    static const std::size_t sizes[] =
+      { 8, 24, 40 };
+    void* p[3];
+
+    diag::malloc_profiler::reset ();
+
+    for (std::size_t i = 0; i < 3; ++i)
+      {
+        malloc_into (&p[i], sizes[i]);
+      }
+
+    site_statistics_t st = active_site ();
+    expect (st.site != nullptr, "malloc() site");
+    expect (st.allocs == 3 && st.live_bytes == 72 && st.peak_bytes == 72,
+            "malloc() statistics");
+
+    estd::free (p[1]);
+    site_statistics_t after = find_site (st.site);
+    expect (after.frees == 1 && after.live_bytes == 48,
+            "free() accounted to the malloc() site");
+
+    estd::free (p[0]);
+    estd::free (p[2]);
+    after = find_site (st.site);
+    expect (after.frees == 3 && after.live_bytes == 0
+                && after.peak_bytes == 72,
+            "malloc() site after free()");
+
+    diag::malloc_profiler::reset ();
+
+    void* q = estd::aligned_alloc (64, 10);
+    expect ((reinterpret_cast<uintptr_t> (q) & (64 - 1)) == 0,
+            "aligned_alloc() alignment");
+    st = active_site ();
+    expect (st.allocs == 1 && st.live_bytes == 10, "aligned_alloc() bytes");
+    estd::free (q);
+    expect (find_site (st.site).live_bytes == 0, "aligned_alloc() freed");
+  }
+
+  void
+  test_new_delete (void)
+  {
+    static const std::size_t sizes[] =
+      { 16, 32 };
+    uint8_t* p[2];
+
+    diag::malloc_profiler::reset ();
+
+    for (std::size_t i = 0; i < 2; ++i)
+      {
+        new_into (&p[i], sizes[i]);
+      }
+
+    site_statistics_t st = active_site ();
+    expect (st.allocs == 2 && st.live_bytes == 48 && st.peak_bytes == 48,
+            "new[] statistics");
+
+    delete[] p[0];
+    delete[] p[1];
+    st = find_site (st.site);
+    expect (st.frees == 2 && st.live_bytes == 0 && st.peak_bytes == 48,
+            "delete[] statistics");
+
+    diag::malloc_profiler::reset ();
+
+    uint32_t* q = new uint32_t (7);
+    st = active_site ();
+    expect (st.allocs == 1 && st.live_bytes == sizeof(uint32_t),
+            "new statistics");
+    delete q;
+    expect (find_site (st.site).live_bytes == 0, "delete statistics");
+  }
+
+  void
+  test_invalid_free (void)
+  {
+    static const char tag[] = "test-invalid";
+
+    // A zero header, as for a block not allocated by the profiler.
+    alignas(16) static uint8_t fake[64];
+
+    constexpr std::size_t header_size =
+        diag::malloc_profiler::internal::header_size;
+
+    // A block as left by free(), with the header magic cleared.
+    alignas(std::max_align_t) static uint8_t freed[header_size + 16];
+
+    diag::malloc_profiler::reset ();
+
+    estd::free (&fake[32]);
+    expect (diag::malloc_profiler::invalid_frees () == 1,
+            "free() of a foreign block");
+    expect (diag::malloc_profiler::totals ().frees == 0,
+            "foreign block not accounted");
+
+    void* p = diag::malloc_profiler::malloc (16, tag);
+    estd::free (p);
+    expect (find_site (tag).frees == 1, "free() accounted");
+
+    // Freeing the real block again would read released memory,
+    // so the second free() is tried on a fabricated header.
+    diag::malloc_profiler::internal::mark_freed (&freed[header_size], 16);
+    estd::free (&freed[header_size]);
+    expect (diag::malloc_profiler::invalid_frees () == 2, "double free()");
+    expect (diag::malloc_profiler::totals ().frees == 1,
+            "double free() not accounted");
+
+    diag::malloc_profiler::reset ();
+    expect (diag::malloc_profiler::invalid_frees () == 0,
+            "invalid frees reset");
+  }
+
+  // Must be the last one; the table is never shrunk.
+  void
+  test_overflow (void)
+  {
+    constexpr std::size_t count = 2 * sites_count;
+    constexpr std::size_t size = 8;
+
+    // Distinct addresses, used as tags.
+    static const char tags[count] =
+      { };
+    void* p[count];
+
+    diag::malloc_profiler::reset ();
+
+    for (std::size_t i = 0; i < count; ++i)
+      {
+        p[i] = diag::malloc_profiler::malloc (size, &tags[i]);
+      }
+
+    uint32_t const dropped = diag::malloc_profiler::dropped ();
+    expect (dropped >= count - sites_count, "dropped sites");
+
+    site_statistics_t st = find_site (nullptr);
+    expect (st.allocs == dropped && st.live_bytes == dropped * size,
+            "overflow entry");
+
+    // Each allocation is accounted once.
+    std::size_t n = diag::malloc_profiler::sites (
+        table, sizeof(table) / sizeof(table[0]));
+    uint32_t allocs = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        allocs += table[i].allocs;
+      }
+    expect (allocs == count && diag::malloc_profiler::totals ().allocs == count,
+            "all allocations accounted");
+
+    for (std::size_t i = 0; i < count; ++i)
+      {
+        estd::free (p[i]);
+      }
+
+    st = find_site (nullptr);
+    expect (st.frees == dropped && st.live_bytes == 0,
+            "overflow entry after free()");
+  }
+}
+
+int
+os_main (int argc __attribute__((unused)), char* argv[] __attribute__((unused)))
+{
+  trace::printf ("\nMalloc profiler test.\n");
+#if defined(__clang__)
+  trace::printf ("Built with clang " __VERSION__ ".\n");
+#else
+  trace::printf ("Built with GCC " __VERSION__ ".\n");
+#endif
+
+  test_tags ();
+  test_malloc ();
+  test_new_delete ();
+  test_invalid_free ();
+  test_overflow ();
+
+  diag::malloc_profiler::dump ();
+
+  if (failed != 0)
+    {
+      trace::printf ("\n%d failed.\n", failed);
+      return 1;
+    }
+
+  trace::printf ("\nPassed.\n");
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <test-posix-io.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+
+namespace
+{
+  int failed;
+}
+
+void
+expect (bool condition, const char* what)
+{
+  if (!condition)
+    {
+      trace::printf ("FAILED: %s\n", what);
+      ++failed;
+    }
+}
+
+int
+failed_count (void)
+{
+  return failed;
+}
+
+int
+os_main (int argc __attribute__((unused)), char* argv[] __attribute__((unused)))
+{
+  // The standard output goes through the POSIX I/O layer, which
+  // has no console device here; use the trace channel.
+  trace::printf ("\nPOSIX I/O test.\n");
+#if defined(__clang__)
+  trace::printf ("Built with clang " __VERSION__ ".\n");
+#else
+  trace::printf ("Built with GCC " __VERSION__ ".\n");
+#endif
+
+  test_io ();
+  test_poll ();
+  test_file_system ();
+
+  if (failed_count () != 0)
+    {
+      trace::printf ("\n%d failed.\n", failed_count ());
+      return 1;
+    }
+
+  trace::printf ("\nPassed.\n");
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
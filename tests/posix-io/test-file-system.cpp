@@ -0,0 +1,417 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix-io/block-device.h>
+#include <cmsis-plus/posix-io/block-cache.h>
+#include <cmsis-plus/posix-io/file-system.h>
+#include <cmsis-plus/posix-io/file-system-ram.h>
+#include <cmsis-plus/posix/dirent.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <test-posix-io.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::posix;
+
+namespace
+{
+  constexpr std::size_t bytes_per_block = 64;
+  constexpr block_device::blknum_t device_blocks = 32;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+  // A RAM block device counting the transferred blocks.
+  class counting_device : public block_device_ram
+  {
+  public:
+
+    counting_device () :
+        block_device_ram (bytes_per_block, device_blocks)
+    {
+      ;
+    }
+
+    std::size_t reads = 0;
+    std::size_t writes = 0;
+
+  protected:
+
+    virtual int
+    do_read_block (void* buf, blknum_t blknum, std::size_t count) override
+    {
+      reads += count;
+      return block_device_ram::do_read_block (buf, blknum, count);
+    }
+
+    virtual int
+    do_write_block (const void* buf, blknum_t blknum, std::size_t count)
+        override
+    {
+      writes += count;
+      return block_device_ram::do_write_block (buf, blknum, count);
+    }
+  };
+
+#pragma GCC diagnostic pop
+
+  void
+  test_block_cache (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    uint8_t pattern[bytes_per_block];
+    for (std::size_t i = 0; i < bytes_per_block; ++i)
+      {
+        pattern[i] = static_cast<uint8_t> (i);
+      }
+
+      {
+        counting_device dev;
+        block_cache cache
+          { dev, 4, 0 };
+
+        // LRU eviction.
+        cache.read (0);
+        cache.read (2);
+        cache.read (4);
+        cache.read (6);
+        expect (cache.misses () == 4 && dev.reads == 4, "cache filled");
+        cache.read (0);
+        expect (cache.hits () == 1, "hit on a cached block");
+        cache.read (8); // Evicts 2, the least recently used.
+        cache.read (0);
+        expect (cache.hits () == 2, "recently used block kept");
+        cache.read (2);
+        expect (cache.misses () == 6 && dev.reads == 6,
+                "least recently used block evicted");
+
+        // Dirty blocks are written only when evicted or synced.
+        void* p = cache.modify (1, true);
+        expect (p != nullptr, "modify");
+        std::memcpy (p, pattern, bytes_per_block);
+        expect (dev.reads == 6, "overwritten block not read");
+        cache.read (3);
+        cache.read (5);
+        cache.read (7);
+        expect (dev.writes == 0, "dirty block not written yet");
+        cache.read (9); // Evicts 1.
+        expect (dev.writes == 1, "dirty block written when evicted");
+
+        const void* q = cache.read (1);
+        expect (q != nullptr && std::memcmp (q, pattern, bytes_per_block) == 0,
+                "written back content");
+
+        cache.modify (1);
+        cache.modify (3);
+        expect (cache.sync () == 0, "sync");
+        expect (dev.writes == 3, "dirty blocks written by sync");
+        expect (cache.sync () == 0, "sync again");
+        expect (dev.writes == 3, "clean blocks not written");
+
+        errno = 0;
+        expect (cache.read (device_blocks) == nullptr && errno == EINVAL,
+                "read past the device is EINVAL");
+      }
+
+      {
+        counting_device dev;
+        block_cache cache
+          { dev, 4, 2 };
+
+        // Sequential reads; the first two are misses, the next ones
+        // were read in advance.
+        for (block_device::blknum_t b = 10; b < 15; ++b)
+          {
+            cache.read (b);
+          }
+        expect (cache.misses () == 2, "sequential read misses");
+        expect (cache.hits () == 3, "sequential read hits");
+        expect (dev.reads == 7, "blocks read in advance, up to 16");
+
+        // Random reads are not followed by read ahead.
+        std::size_t const reads = dev.reads;
+        cache.read (20);
+        cache.read (25);
+        expect (dev.reads == reads + 2, "no read ahead for random reads");
+      }
+
+      {
+        counting_device dev;
+        block_cache cache
+          { dev, 4, 2 };
+
+        // Block 0 does not follow the initial "no block".
+        cache.read (0);
+        expect (dev.reads == 1, "no read ahead for the first read of 0");
+      }
+  }
+
+  void
+  test_mount (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    counting_device dev1;
+    block_cache cache1
+      { dev1, 4 };
+    file_system_ram fs1
+      { cache1 };
+
+    counting_device dev2;
+    block_cache cache2
+      { dev2, 4 };
+    file_system_ram fs2
+      { cache2 };
+
+    expect (fs1.mount ("/ram") == 0, "mount /ram");
+    expect (fs2.mount ("/ramdisk/") == 0, "mount /ramdisk");
+    errno = 0;
+    expect (fs1.mount ("/other") == -1 && errno == EBUSY,
+            "second mount is EBUSY");
+
+    // The longest matching mount point wins, at a separator.
+    const char* path = "/ramdisk/a";
+    expect (file_system::identify_file_system (&path) == &fs2,
+            "/ramdisk/a on /ramdisk");
+    expect (std::strcmp (path, "/a") == 0, "path relative to /ramdisk");
+    path = "/ram/a";
+    expect (file_system::identify_file_system (&path) == &fs1,
+            "/ram/a on /ram");
+    path = "/ramdisk";
+    expect (file_system::identify_file_system (&path) == &fs2,
+            "/ramdisk on /ramdisk");
+    expect (std::strcmp (path, "/") == 0, "mount point is the root");
+    path = "/ramd/a";
+    expect (file_system::identify_file_system (&path) == nullptr,
+            "/ramd/a not mounted");
+
+    int fd = __posix_open ("/ramdisk/a", O_CREAT | O_WRONLY, 0644);
+    expect (fd >= 0, "create /ramdisk/a");
+    expect (__posix_close (fd) == 0, "close /ramdisk/a");
+
+    struct stat st;
+    expect (__posix_stat ("/ramdisk/a", &st) == 0 && S_ISREG(st.st_mode),
+            "/ramdisk/a is a file");
+    errno = 0;
+    expect (__posix_stat ("/ram/a", &st) == -1 && errno == ENOENT,
+            "/ram/a does not exist");
+    expect (__posix_stat ("/ram", &st) == 0 && S_ISDIR(st.st_mode),
+            "/ram is a folder");
+
+    // Moving between file systems needs a copy.
+    errno = 0;
+    expect (__posix_rename ("/ramdisk/a", "/ram/a") == -1 && errno == EXDEV,
+            "rename across file systems is EXDEV");
+    expect (__posix_rename ("/ramdisk/a", "/ramdisk/b") == 0,
+            "rename on the same file system");
+
+    expect (fs2.umount () == 0, "umount /ramdisk");
+    errno = 0;
+    expect (__posix_stat ("/ramdisk/b", &st) == -1 && errno == ENOENT,
+            "/ramdisk/b after umount");
+    expect (fs1.umount () == 0, "umount /ram");
+  }
+
+  void
+  test_files (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    counting_device dev;
+    block_cache cache
+      { dev, 4 };
+    file_system_ram fs
+      { cache };
+
+    expect (fs.mount ("/ram") == 0, "mount /ram");
+    std::size_t const free_blocks = fs.free_blocks ();
+
+    uint8_t buf[5 * bytes_per_block];
+    for (std::size_t i = 0; i < sizeof(buf); ++i)
+      {
+        buf[i] = static_cast<uint8_t> (i | 1);
+      }
+    uint8_t rbuf[sizeof(buf)];
+
+    int fd = __posix_open ("/ram/f", O_CREAT | O_RDWR, 0644);
+    expect (fd >= 0, "create /ram/f");
+
+    // Sparse write; the hole reads as zeros and takes no space.
+    off_t const hole = 8 * bytes_per_block;
+    expect (__posix_lseek (fd, hole, SEEK_SET) == hole, "seek past the end");
+    expect (__posix_write (fd, buf, 1) == 1, "write after the hole");
+    expect (fs.free_blocks () == free_blocks - 1, "hole takes no space");
+
+    struct stat st;
+    expect (__posix_fstat (fd, &st) == 0 && st.st_size == hole + 1,
+            "size includes the hole");
+    expect (__posix_lseek (fd, bytes_per_block / 2, SEEK_SET) == bytes_per_block / 2,
+            "seek in the hole");
+    std::memset (rbuf, 0xFF, sizeof(rbuf));
+    expect (__posix_read (fd, rbuf, 2 * bytes_per_block) == 2 * bytes_per_block,
+            "read the hole");
+    bool zeros = true;
+    for (std::size_t i = 0; i < 2 * bytes_per_block; ++i)
+      {
+        zeros = zeros && (rbuf[i] == 0);
+      }
+    expect (zeros, "the hole reads as zeros");
+
+    // Shrink and grow.
+    expect (__posix_ftruncate (fd, 0) == 0, "truncate to 0");
+    expect (fs.free_blocks () == free_blocks, "blocks freed");
+    expect (__posix_lseek (fd, 0, SEEK_SET) == 0, "rewind");
+    expect (__posix_write (fd, buf, sizeof(buf)) == sizeof(buf),
+            "write 5 blocks");
+    expect (fs.free_blocks () == free_blocks - 5, "5 blocks used");
+
+    off_t const shrunk = bytes_per_block + 10;
+    expect (__posix_ftruncate (fd, shrunk) == 0, "shrink");
+    expect (fs.free_blocks () == free_blocks - 2, "3 blocks freed");
+    expect (__posix_ftruncate (fd, 3 * bytes_per_block) == 0, "grow");
+    expect (__posix_fstat (fd, &st) == 0 && st.st_size == 3 * bytes_per_block,
+            "grown size");
+
+    expect (__posix_lseek (fd, 0, SEEK_SET) == 0, "rewind");
+    expect (__posix_read (fd, rbuf, sizeof(rbuf)) == 3 * bytes_per_block,
+            "read up to the end");
+    expect (std::memcmp (rbuf, buf, static_cast<std::size_t> (shrunk)) == 0,
+            "content kept");
+    zeros = true;
+    for (std::size_t i = static_cast<std::size_t> (shrunk);
+        i < 3 * bytes_per_block; ++i)
+      {
+        zeros = zeros && (rbuf[i] == 0);
+      }
+    expect (zeros, "the grown part reads as zeros");
+
+    // Unlink while open; the content is available until closed.
+    expect (__posix_unlink ("/ram/f") == 0, "unlink while open");
+    errno = 0;
+    expect (__posix_stat ("/ram/f", &st) == -1 && errno == ENOENT,
+            "unlinked name is gone");
+    expect (__posix_lseek (fd, 0, SEEK_SET) == 0, "rewind unlinked");
+    expect (__posix_read (fd, rbuf, 10) == 10, "read unlinked");
+    expect (std::memcmp (rbuf, buf, 10) == 0, "unlinked content");
+    expect (fs.free_blocks () < free_blocks, "blocks still used");
+    expect (__posix_close (fd) == 0, "close unlinked");
+    expect (fs.free_blocks () == free_blocks, "blocks freed on close");
+
+    expect (fs.umount () == 0, "umount /ram");
+  }
+
+  void
+  test_directories (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    counting_device dev;
+    block_cache cache
+      { dev, 4 };
+    file_system_ram fs
+      { cache };
+
+    expect (fs.mount ("/ram") == 0, "mount /ram");
+
+    expect (__posix_mkdir ("/ram/d", 0755) == 0, "mkdir");
+    static const char* const names[] =
+      { "a", "b", "c" };
+    char path[16];
+    for (const char* name : names)
+      {
+        std::strcpy (path, "/ram/d/");
+        std::strcat (path, name);
+        int fd = __posix_open (path, O_CREAT | O_WRONLY, 0644);
+        expect (fd >= 0, "create file");
+        expect (__posix_close (fd) == 0, "close file");
+      }
+
+    DIR* dirp = __posix_opendir ("/ram/d");
+    expect (dirp != nullptr, "opendir");
+    if (dirp != nullptr)
+      {
+        for (int pass = 0; pass < 2; ++pass)
+          {
+            unsigned int found = 0;
+            struct dirent* de;
+            while ((de = __posix_readdir (dirp)) != nullptr)
+              {
+                for (unsigned int i = 0; i < 3; ++i)
+                  {
+                    if (std::strcmp (de->d_name, names[i]) == 0)
+                      {
+                        expect ((found & (1u << i)) == 0,
+                                "entry reported once");
+                        found |= (1u << i);
+                      }
+                  }
+              }
+            expect (found == 7, "all entries read");
+            expect (__posix_readdir (dirp) == nullptr,
+                    "no entries after the end");
+
+            __posix_rewinddir (dirp);
+          }
+        expect (__posix_closedir (dirp) == 0, "closedir");
+      }
+
+    errno = 0;
+    expect (__posix_opendir ("/ram/d/a") == nullptr && errno == ENOTDIR,
+            "opendir on a file is ENOTDIR");
+    errno = 0;
+    expect (__posix_rmdir ("/ram/d") == -1 && errno == ENOTEMPTY,
+            "rmdir on a non empty folder is ENOTEMPTY");
+
+    expect (fs.umount () == 0, "umount /ram");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+test_file_system (void)
+{
+  trace::printf ("\n%s\n", __func__);
+
+  test_block_cache ();
+  test_mount ();
+  test_files ();
+  test_directories ();
+}
+
+// ----------------------------------------------------------------------------
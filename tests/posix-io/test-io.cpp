@@ -0,0 +1,375 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/posix-io/socket.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+#include <cmsis-plus/posix/sys/uio.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+
+#include <test-posix-io.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::posix;
+
+namespace
+{
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+  // A device keeping the written bytes in a small buffer; the
+  // transfers are short when the buffer is full, or empty.
+  class loopback_device : public device
+  {
+  public:
+
+    loopback_device (const char* name) :
+        device (name)
+    {
+      ;
+    }
+
+    std::size_t
+    count (void) const
+    {
+      return count_;
+    }
+
+    static constexpr std::size_t capacity = 10;
+
+  protected:
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    virtual int
+    do_vopen (const char* path, int oflag, std::va_list args) override
+    {
+      count_ = 0;
+      offset_ = 0;
+      return 0;
+    }
+
+#pragma GCC diagnostic pop
+
+    virtual ssize_t
+    do_read (void* buf, std::size_t nbyte) override
+    {
+      std::size_t n = count_ - offset_;
+      if (n > nbyte)
+        {
+          n = nbyte;
+        }
+      std::memcpy (buf, &buffer_[offset_], n);
+      offset_ += n;
+      return static_cast<ssize_t> (n);
+    }
+
+    virtual ssize_t
+    do_write (const void* buf, std::size_t nbyte) override
+    {
+      std::size_t n = capacity - count_;
+      if (n > nbyte)
+        {
+          n = nbyte;
+        }
+      std::memcpy (&buffer_[count_], buf, n);
+      count_ += n;
+      return static_cast<ssize_t> (n);
+    }
+
+  private:
+
+    uint8_t buffer_[capacity];
+    std::size_t count_ = 0;
+    std::size_t offset_ = 0;
+  };
+
+#pragma GCC diagnostic pop
+
+  // A socket with the default implementations, all failing.
+  class null_socket : public socket
+  {
+  };
+
+  void
+  test_descriptors (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    loopback_device dev1
+      { "loop1" };
+    loopback_device dev2
+      { "loop2" };
+
+    // Some descriptors may already be in use, like the standard ones.
+    std::size_t used = 0;
+    for (int i = 0; i < static_cast<int> (file_descriptors_manager::size ());
+        ++i)
+      {
+        if (file_descriptors_manager::get_io (i) != nullptr)
+          {
+            ++used;
+          }
+      }
+
+    int fd1 = __posix_open ("/dev/loop1", O_RDWR);
+    expect (fd1 >= 0, "open /dev/loop1");
+    expect (dev1.is_opened (), "loop1 opened");
+    expect (file_descriptors_manager::get_io (fd1) == &dev1,
+            "fd1 is loop1");
+
+    errno = 0;
+    expect (__posix_open ("/dev/loop1", O_RDWR) == -1 && errno == EBUSY,
+            "second open of loop1 is EBUSY");
+
+    errno = 0;
+    expect (__posix_open ("/dev/loop3", O_RDWR) == -1 && errno == ENOENT,
+            "open of a missing device is ENOENT");
+
+    // Fill the table.
+    null_socket sockets[OS_INTEGER_POSIX_IO_MAX_OPEN_FILES];
+    int fds[OS_INTEGER_POSIX_IO_MAX_OPEN_FILES];
+    std::size_t n = 0;
+    errno = 0;
+    for (;;)
+      {
+        int fd = file_descriptors_manager::alloc (&sockets[n]);
+        if (fd < 0)
+          {
+            break;
+          }
+        fds[n++] = fd;
+      }
+    expect (errno == EMFILE, "alloc on a full table is EMFILE");
+    expect (n == file_descriptors_manager::size () - used - 1,
+            "all descriptors allocated");
+
+    // Opening a device must fail, and leave it closed.
+    errno = 0;
+    expect (__posix_open ("/dev/loop2", O_RDWR) == -1 && errno == EMFILE,
+            "open on a full table is EMFILE");
+    expect (!dev2.is_opened (), "loop2 closed after EMFILE");
+
+    // Close one, reuse it, and check it is no longer valid after close.
+    int fd = fds[n / 2];
+    expect (__posix_close (fd) == 0, "close socket");
+    expect (sockets[n / 2].file_descriptor () == no_file_descriptor,
+            "descriptor cleared");
+
+    char c;
+    errno = 0;
+    expect (__posix_close (fd) == -1 && errno == EBADF,
+            "second close is EBADF");
+    errno = 0;
+    expect (__posix_read (fd, &c, 1) == -1 && errno == EBADF,
+            "read after close is EBADF");
+    errno = 0;
+    expect (__posix_write (fd, &c, 1) == -1 && errno == EBADF,
+            "write after close is EBADF");
+
+    int fd2 = __posix_open ("/dev/loop2", O_RDWR);
+    expect (fd2 == fd, "the freed descriptor is reused");
+    expect (__posix_close (fd2) == 0, "close loop2");
+    expect (!dev2.is_opened (), "loop2 closed");
+
+    errno = 0;
+    expect (__posix_read (-1, &c, 1) == -1 && errno == EBADF,
+            "read on -1 is EBADF");
+    errno = 0;
+    expect (
+        __posix_read (static_cast<int> (file_descriptors_manager::size ()),
+                      &c, 1) == -1 && errno == EBADF,
+        "read past the table is EBADF");
+
+    for (std::size_t i = 0; i < n; ++i)
+      {
+        if (i != n / 2)
+          {
+            expect (__posix_close (fds[i]) == 0, "close socket");
+          }
+      }
+
+    expect (__posix_close (fd1) == 0, "close loop1");
+    expect (!dev1.is_opened (), "loop1 closed");
+
+    // Can be opened again.
+    fd1 = __posix_open ("/dev/loop1", O_RDWR);
+    expect (fd1 >= 0, "open /dev/loop1 again");
+    expect (__posix_close (fd1) == 0, "close loop1 again");
+  }
+
+  void
+  test_vectors (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    loopback_device dev
+      { "loop" };
+
+    int fd = __posix_open ("/dev/loop", O_RDWR);
+    expect (fd >= 0, "open /dev/loop");
+
+    char a[] = "0123";
+    char b[] = "456789ab";
+
+    // The second segment is short; the device is full.
+    struct iovec wv[3];
+    wv[0].iov_base = a;
+    wv[0].iov_len = 4;
+    wv[1].iov_base = b;
+    wv[1].iov_len = 8;
+    wv[2].iov_base = a;
+    wv[2].iov_len = 4;
+    expect (
+        __posix_writev (fd, wv, 3)
+            == static_cast<ssize_t> (loopback_device::capacity),
+        "writev stops at the short segment");
+    expect (dev.count () == loopback_device::capacity, "device full");
+    expect (__posix_write (fd, a, 1) == 0, "write on a full device");
+
+    // An empty segment is skipped, the third one is short and
+    // the last one is not touched.
+    char r1[3];
+    char r3[20];
+    char r4[4];
+    std::memset (r4, 'x', sizeof(r4));
+    struct iovec rv[4];
+    rv[0].iov_base = r1;
+    rv[0].iov_len = sizeof(r1);
+    rv[1].iov_base = r3;
+    rv[1].iov_len = 0;
+    rv[2].iov_base = r3;
+    rv[2].iov_len = sizeof(r3);
+    rv[3].iov_base = r4;
+    rv[3].iov_len = sizeof(r4);
+    expect (
+        __posix_readv (fd, rv, 4)
+            == static_cast<ssize_t> (loopback_device::capacity),
+        "readv stops at the short segment");
+    expect (std::memcmp (r1, "012", 3) == 0, "first segment");
+    expect (std::memcmp (r3, "3456789", 7) == 0, "third segment");
+    expect (r4[0] == 'x', "last segment untouched");
+
+    // Lengths whose sum overflows, or does not fit the result.
+    rv[0].iov_len = std::numeric_limits<std::size_t>::max ();
+    rv[1].iov_len = 2;
+    errno = 0;
+    expect (__posix_readv (fd, rv, 2) == -1 && errno == EINVAL,
+            "readv with overflowing lengths is EINVAL");
+    errno = 0;
+    expect (__posix_writev (fd, rv, 2) == -1 && errno == EINVAL,
+            "writev with overflowing lengths is EINVAL");
+
+    rv[0].iov_len =
+        static_cast<std::size_t> (std::numeric_limits<ssize_t>::max ());
+    rv[1].iov_len = 1;
+    errno = 0;
+    expect (__posix_writev (fd, rv, 2) == -1 && errno == EINVAL,
+            "writev with more than SSIZE_MAX bytes is EINVAL");
+
+    errno = 0;
+    expect (__posix_writev (fd, wv, 0) == -1 && errno == EINVAL,
+            "writev with no segments is EINVAL");
+    errno = 0;
+    expect (__posix_readv (fd, nullptr, 1) == -1 && errno == EFAULT,
+            "readv with no vector is EFAULT");
+
+    expect (__posix_close (fd) == 0, "close loop");
+  }
+
+  void
+  test_types (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    loopback_device dev
+      { "loop" };
+    null_socket sock;
+
+    int fd = __posix_open ("/dev/loop", O_RDWR);
+    expect (fd >= 0, "open /dev/loop");
+    int sd = file_descriptors_manager::alloc (&sock);
+    expect (sd >= 0, "alloc socket");
+
+    errno = 0;
+    expect (__posix_lseek (fd, 0, SEEK_SET) == -1 && errno == ESPIPE,
+            "lseek on a device is ESPIPE");
+    errno = 0;
+    expect (__posix_lseek (sd, 0, SEEK_SET) == -1 && errno == ESPIPE,
+            "lseek on a socket is ESPIPE");
+
+    errno = 0;
+    expect (__posix_ioctl (sd, 0) == -1 && errno == ENOTTY,
+            "ioctl on a socket is ENOTTY");
+    errno = 0;
+    expect (__posix_ioctl (fd, 0) == -1 && errno == ENOSYS,
+            "ioctl not implemented by the device");
+
+    errno = 0;
+    expect (__posix_isatty (fd) == 0 && errno == ENOTTY,
+            "isatty on a device is ENOTTY");
+
+    char c;
+    errno = 0;
+    expect (__posix_recv (fd, &c, 1, 0) == -1 && errno == ENOTSOCK,
+            "recv on a device is ENOTSOCK");
+    errno = 0;
+    expect (__posix_ftruncate (fd, 0) == -1 && errno == EINVAL,
+            "ftruncate on a device is EINVAL");
+    errno = 0;
+    expect (__posix_fsync (sd) == -1 && errno == EINVAL,
+            "fsync on a socket is EINVAL");
+
+    expect (__posix_close (sd) == 0, "close socket");
+    expect (__posix_close (fd) == 0, "close loop");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+test_io (void)
+{
+  trace::printf ("\n%s\n", __func__);
+
+  test_descriptors ();
+  test_vectors ();
+  test_types ();
+}
+
+// ----------------------------------------------------------------------------
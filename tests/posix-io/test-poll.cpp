@@ -0,0 +1,291 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmsis-plus/posix-io/types.h>
+#include <cmsis-plus/posix-io/device.h>
+#include <cmsis-plus/posix-io/file-descriptors-manager.h>
+#include <cmsis-plus/posix/poll.h>
+#include <cmsis-plus/posix/sys/select.h>
+#include <cmsis-plus/rtos/os.h>
+#include <cmsis-plus/diag/trace.h>
+
+#include <cerrno>
+
+#include <fcntl.h>
+
+#include <test-posix-io.h>
+
+// ----------------------------------------------------------------------------
+
+using namespace os;
+using namespace os::posix;
+
+namespace
+{
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+  // A device always writable and readable only after post(),
+  // which notifies the threads waiting in poll()/select().
+  class event_device : public device
+  {
+  public:
+
+    event_device (const char* name) :
+        device (name)
+    {
+      ;
+    }
+
+    void
+    post (void)
+    {
+      ready_ = true;
+      notify_poll ();
+    }
+
+  protected:
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+    virtual int
+    do_vopen (const char* path, int oflag, std::va_list args) override
+    {
+      ready_ = false;
+      return 0;
+    }
+
+#pragma GCC diagnostic pop
+
+    virtual int
+    do_poll (int events) override
+    {
+      return events & (ready_ ? (POLLIN | POLLOUT) : POLLOUT);
+    }
+
+  private:
+
+    volatile bool ready_ = false;
+  };
+
+#pragma GCC diagnostic pop
+
+  rtos::clock::timestamp_t
+  ticks_since (rtos::clock::timestamp_t begin)
+  {
+    return rtos::sysclock.now () - begin;
+  }
+
+  void*
+  post_from_thread (void* args)
+  {
+    rtos::sysclock.sleep_for (10);
+
+    static_cast<event_device*> (args)->post ();
+    return nullptr;
+  }
+
+  // Without the timer daemon, this runs in the SysTick interrupt.
+  void
+  post_from_timer (void* args)
+  {
+    static_cast<event_device*> (args)->post ();
+  }
+
+  void
+  test_poll_timeouts (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    event_device dev
+      { "event" };
+
+    int fd = __posix_open ("/dev/event", O_RDWR);
+    expect (fd >= 0, "open /dev/event");
+
+    struct pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[0].revents = POLLIN;
+    // Negative descriptors are ignored.
+    fds[1].fd = -1;
+    fds[1].events = POLLIN;
+    fds[1].revents = POLLIN;
+
+    rtos::clock::timestamp_t begin = rtos::sysclock.now ();
+    expect (__posix_poll (fds, 2, 0) == 0, "poll(0) times out");
+    expect (ticks_since (begin) <= 1, "poll(0) does not wait");
+    expect (fds[0].revents == 0 && fds[1].revents == 0,
+            "poll(0) clears revents");
+
+    begin = rtos::sysclock.now ();
+    expect (__posix_poll (fds, 2, 20) == 0, "poll(20) times out");
+    rtos::clock::timestamp_t elapsed = ticks_since (begin);
+    expect (elapsed >= 20, "poll(20) waits at least 20 ms");
+    expect (elapsed < 30, "poll(20) does not wait much longer");
+
+    // Only the requested events are reported.
+    fds[0].events = POLLIN | POLLOUT;
+    expect (__posix_poll (fds, 1, 20) == 1, "poll on a writable device");
+    expect (fds[0].revents == POLLOUT, "only POLLOUT reported");
+
+    expect (__posix_close (fd) == 0, "close event");
+  }
+
+  void
+  test_poll_wakeup (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    event_device dev
+      { "event" };
+
+    int fd = __posix_open ("/dev/event", O_RDWR);
+    expect (fd >= 0, "open /dev/event");
+
+    struct pollfd fds[1];
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+
+    // Woken up by another thread.
+    rtos::clock::timestamp_t begin = rtos::sysclock.now ();
+      {
+        rtos::thread th
+          { "poster", post_from_thread, &dev };
+
+        expect (__posix_poll (fds, 1, 1000) == 1, "poll woken by a thread");
+        expect (fds[0].revents == POLLIN, "POLLIN from the thread");
+
+        th.join ();
+      }
+    expect (ticks_since (begin) < 100, "no wait for the timeout");
+
+    // Woken up by an interrupt.
+    expect (__posix_close (fd) == 0, "close event");
+    fd = __posix_open ("/dev/event", O_RDWR);
+    fds[0].fd = fd;
+
+    begin = rtos::sysclock.now ();
+      {
+        rtos::timer tm
+          { "poster", post_from_timer, &dev };
+        tm.start (10);
+
+        expect (__posix_poll (fds, 1, 1000) == 1, "poll woken by a timer");
+        expect (fds[0].revents == POLLIN, "POLLIN from the timer");
+      }
+    expect (ticks_since (begin) < 100, "no wait for the timeout");
+
+    // A closed descriptor is invalid.
+    expect (__posix_close (fd) == 0, "close event");
+    fds[0].revents = 0;
+    expect (__posix_poll (fds, 1, 1000) == 1, "poll on a closed fd");
+    expect (fds[0].revents == POLLNVAL, "POLLNVAL for a closed fd");
+  }
+
+  void
+  test_select (void)
+  {
+    trace::printf ("%s()\n", __func__);
+
+    event_device dev
+      { "event" };
+
+    int fd = __posix_open ("/dev/event", O_RDWR);
+    expect (fd >= 0, "open /dev/event");
+
+    fd_set rset;
+    fd_set wset;
+    struct timeval tv;
+
+    // Timeout; the sets are cleared.
+    FD_ZERO(&rset);
+    FD_SET(fd, &rset);
+    tv.tv_sec = 0;
+    tv.tv_usec = 20000;
+    rtos::clock::timestamp_t begin = rtos::sysclock.now ();
+    expect (__posix_select (fd + 1, &rset, nullptr, nullptr, &tv) == 0,
+            "select times out");
+    expect (ticks_since (begin) >= 20, "select waits at least 20 ms");
+    expect (!FD_ISSET(fd, &rset), "read set cleared after the timeout");
+
+    // Only the ready descriptors are left in the sets.
+    FD_ZERO(&rset);
+    FD_SET(fd, &rset);
+    FD_ZERO(&wset);
+    FD_SET(fd, &wset);
+    expect (__posix_select (fd + 1, &rset, &wset, nullptr, &tv) == 1,
+            "select on a writable device");
+    expect (!FD_ISSET(fd, &rset), "not readable");
+    expect (FD_ISSET(fd, &wset), "writable");
+
+    dev.post ();
+    FD_ZERO(&rset);
+    FD_SET(fd, &rset);
+    FD_ZERO(&wset);
+    FD_SET(fd, &wset);
+    expect (__posix_select (fd + 1, &rset, &wset, nullptr, &tv) == 2,
+            "select on a ready device");
+    expect (FD_ISSET(fd, &rset) && FD_ISSET(fd, &wset),
+            "readable and writable");
+
+    errno = 0;
+    tv.tv_usec = 1000000;
+    expect (
+        __posix_select (fd + 1, &rset, nullptr, nullptr, &tv) == -1
+            && errno == EINVAL,
+        "select with an invalid timeout is EINVAL");
+
+    // A closed descriptor is an error, and the sets are unchanged.
+    expect (__posix_close (fd) == 0, "close event");
+
+    FD_ZERO(&rset);
+    FD_SET(fd, &rset);
+    tv.tv_usec = 0;
+    errno = 0;
+    expect (
+        __posix_select (fd + 1, &rset, nullptr, nullptr, &tv) == -1
+            && errno == EBADF,
+        "select on a closed fd is EBADF");
+    expect (FD_ISSET(fd, &rset), "read set unchanged after EBADF");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void
+test_poll (void)
+{
+  trace::printf ("\n%s\n", __func__);
+
+  test_poll_timeouts ();
+  test_poll_wakeup ();
+  test_select ();
+}
+
+// ----------------------------------------------------------------------------
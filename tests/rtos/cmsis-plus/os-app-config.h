@@ -57,6 +57,10 @@
 
 #define OS_INCLUDE_RTOS_STATISTICS_THREAD_CONTEXT_SWITCHES  (1)
 #define OS_INCLUDE_RTOS_STATISTICS_THREAD_CPU_CYCLES        (1)
+#define OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD                 (1)
+
+#define OS_INCLUDE_RTOS_TIMER_DAEMON                        (1)
+#define OS_INCLUDE_RTOS_THREAD_PERIODIC                     (1)
 
 // ----------------------------------------------------------------------------
 
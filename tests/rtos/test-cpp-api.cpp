@@ -19,6 +19,7 @@
 #include <cmsis-plus/rtos/os.h>
 
 #include <cstdio>
+#include <cassert>
 #include <algorithm>
 
 #include <test-cpp-api.h>
@@ -67,6 +68,104 @@ tmfunc (void* args __attribute__((unused)))
   printf ("%s\n", __func__);
 }
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+typedef struct expiry_record_s
+{
+  clock::timestamp_t at;
+  uint32_t count;
+} expiry_record_t;
+
+#pragma GCC diagnostic pop
+
+void
+tm_expiry_func (void* args);
+
+void
+tm_expiry_func (void* args)
+{
+  expiry_record_t* r = static_cast<expiry_record_t*> (args);
+  r->at = sysclock.steady_now ();
+  ++r->count;
+}
+
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+typedef struct periodic_record_s
+{
+  clock::timestamp_t begin;
+  clock::timestamp_t released;
+  result_t interrupted_res;
+  result_t res;
+  statistics::counter_t releases;
+} periodic_record_t;
+
+#pragma GCC diagnostic pop
+
+void*
+periodic_func (void* args);
+
+void*
+periodic_func (void* args)
+{
+  periodic_record_t* r = static_cast<periodic_record_t*> (args);
+
+  this_thread::set_period (4);
+  r->begin = sysclock.now ();
+
+  // Interrupted by the main thread.
+  r->interrupted_res = this_thread::wait_next_period ();
+  this_thread::thread ().interrupt (false);
+  r->releases = this_thread::thread ().periodic ().releases ();
+
+  // The same release point is waited for again, not the next one.
+  r->res = this_thread::wait_next_period ();
+  r->released = sysclock.now ();
+
+  return nullptr;
+}
+
+#endif
+
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+typedef struct daemon_record_s
+{
+  timer* tm;
+  uint32_t count;
+  bool in_handler;
+} daemon_record_t;
+
+#pragma GCC diagnostic pop
+
+void
+tm_daemon_func (void* args);
+
+void
+tm_daemon_func (void* args)
+{
+  daemon_record_t* r = static_cast<daemon_record_t*> (args);
+  if (interrupts::in_handler_mode ())
+    {
+      r->in_handler = true;
+    }
+
+  // In thread context, the timer can be stopped from its own function.
+  if (++r->count == 3)
+    {
+      r->tm->stop ();
+    }
+}
+
+#endif
+
 #if !defined(OS_USE_RTOS_PORT_SCHEDULER)
 
 void
@@ -97,10 +196,35 @@ iterate_threads (thread* th, unsigned int depth)
               static_cast<unsigned int> (thread_switches),
               static_cast<unsigned int> (thread_cpu_cycles));
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+      uint32_t load = p.statistics ().cpu_load ();
+      assert(load <= 10000);
+      printf ("  load %u.%02u%%\n", static_cast<unsigned int> (load / 100),
+              static_cast<unsigned int> (load % 100));
+#endif
+
       iterate_threads (&p, depth + 1);
     }
 }
 
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+
+uint32_t
+sum_threads_loads (thread* th = nullptr);
+
+uint32_t
+sum_threads_loads (thread* th)
+{
+  uint32_t sum = 0;
+  for (auto&& p : scheduler::children_threads (th))
+    {
+      sum += p.statistics ().cpu_load () + sum_threads_loads (&p);
+    }
+  return sum;
+}
+
+#endif
+
 #endif
 
 int
@@ -121,6 +245,27 @@ test_cpp_api (void)
   sysclock.sleep_for (5);
   printf ("\nThreads:\n");
   iterate_threads ();
+#if defined(OS_INCLUDE_RTOS_STATISTICS_CPU_LOAD)
+  printf ("CPU load %u, interrupts %u (x0.01%%)\n",
+          static_cast<unsigned int> (scheduler::statistics::cpu_load ()),
+          static_cast<unsigned int> (scheduler::statistics::interrupts_load ()));
+
+    {
+      // ----- Enter critical section -----------------------------------------
+      // All loads from the same window.
+      interrupts::critical_section ics;
+
+      uint32_t cpu = scheduler::statistics::cpu_load ();
+      uint32_t idle = scheduler::statistics::idle_load ();
+      uint32_t irq = scheduler::statistics::interrupts_load ();
+      assert(cpu <= 10000 && idle <= 10000 && irq <= 10000);
+      assert(cpu + idle == 10000);
+
+      // The interrupts time is not charged to the threads too.
+      assert(sum_threads_loads () + irq <= 10000);
+      // ----- Exit critical section ------------------------------------------
+    }
+#endif
 #endif
 #endif
 
@@ -391,6 +536,27 @@ test_cpp_api (void)
 
     }
 
+  // --------------------------------------------------------------------------
+
+  // Aligned usage; an allocator with an extended alignment
+  // (for example for DMA or cache lines) aligns all blocks.
+  using My_aligned_pool = memory_pool_allocated<memory::new_delete_allocator<std::aligned_storage<32, 32>::type>>;
+
+    {
+      My_aligned_pool ap1
+        { "ap1", 3, 20 };
+
+      void* ablk = ap1.alloc ();
+      assert((reinterpret_cast<uintptr_t> (ablk) & (32 - 1)) == 0);
+      ap1.free (ablk);
+
+      ablk = ap1.alloc ();
+      void* ablk2 = ap1.alloc ();
+      assert((reinterpret_cast<uintptr_t> (ablk2) & (32 - 1)) == 0);
+      ap1.free (ablk2);
+      ap1.free (ablk);
+    }
+
   // ==========================================================================
 
   printf ("\n%s - Condition variables.\n", test_name);
@@ -530,6 +696,120 @@ test_cpp_api (void)
       tm3.stop ();
     }
 
+    {
+      // A timer with slack sharing the wake-up of another one;
+      // tm6 is due at +3, but may wait until +6, so it is
+      // aligned to tm5, due at +5.
+      timer::attributes attr;
+      attr.tm_slack = 3;
+
+      expiry_record_t rec5
+        { 0, 0 };
+      expiry_record_t rec6
+        { 0, 0 };
+      timer tm5
+        { "tm5", tm_expiry_func, &rec5 };
+      timer tm6
+        { "tm6", tm_expiry_func, &rec6, attr };
+
+      uint32_t const coalesced = sysclock.coalesced_count ();
+      clock::timestamp_t begin;
+      sysclock.sleep_for (1); // Sync
+        {
+          // ----- Enter critical section -------------------------------------
+          // Both started in the same tick.
+          interrupts::critical_section ics;
+
+          begin = sysclock.steady_now ();
+          tm5.start (5);
+          tm6.start (3);
+          // ----- Exit critical section --------------------------------------
+        }
+
+      sysclock.sleep_for (8);
+
+      printf ("coalesced %u\n",
+              static_cast<unsigned int> (sysclock.coalesced_count ()));
+      assert(sysclock.coalesced_count () > coalesced);
+      assert(rec5.count == 1 && rec6.count == 1);
+      // Never before the nominal time.
+      assert(rec5.at >= begin + 5);
+      assert(rec6.at >= begin + 3);
+    }
+
+#if defined(OS_INCLUDE_RTOS_TIMER_DAEMON)
+    {
+      // Named periodic timer, called by the timer daemon,
+      // which stops it after the third call.
+      timer::attributes_periodic attr;
+      attr.tm_execution = timer::execution::daemon;
+
+      daemon_record_t rec
+        { nullptr, 0, false };
+      timer tm4
+        { "tm4", tm_daemon_func, &rec, attr };
+      rec.tm = &tm4;
+
+      sysclock.sleep_for (1); // Sync
+      tm4.start (1);
+
+      sysclock.sleep_for (6);
+      assert(rec.count == 3);
+      assert(!rec.in_handler);
+      tm4.stop ();
+    }
+#endif
+
+#if defined(OS_INCLUDE_RTOS_THREAD_PERIODIC)
+    {
+      // Periodic releases of the current thread.
+      this_thread::set_period (2);
+      for (int i = 0; i < 3; ++i)
+        {
+          this_thread::wait_next_period ();
+        }
+
+      class thread::periodic& pr = this_thread::thread ().periodic ();
+      printf ("releases %u, overruns %u, jitter max %u\n",
+              static_cast<unsigned int> (pr.releases ()),
+              static_cast<unsigned int> (pr.overruns ()),
+              static_cast<unsigned int> (pr.jitter_max ()));
+      assert(pr.releases () == 3);
+      assert(pr.overruns () == 0);
+
+      // A forced overrun; the first release point passed while
+      // sleeping, and the thread catches up immediately.
+      this_thread::set_period (2);
+      sysclock.sleep_for (3);
+      assert(this_thread::wait_next_period () == ETIMEDOUT);
+      assert(pr.overruns () == 1);
+      assert(pr.releases () == 1);
+
+      // Back in phase with the next release point; reaching it
+      // exactly on time is not an overrun.
+      assert(this_thread::wait_next_period () == result::ok);
+      assert(pr.overruns () == 1);
+      assert(pr.releases () == 2);
+    }
+
+    {
+      // An interrupted wait keeps the release point.
+      periodic_record_t rec
+        { 0, 0, result::ok, result::ok, 0 };
+      thread th
+        { "periodic", periodic_func, &rec };
+
+      sysclock.sleep_for (2);
+      th.interrupt ();
+      th.join ();
+
+      assert(rec.interrupted_res == EINTR);
+      assert(rec.releases == 0);
+      assert(rec.res == result::ok);
+      assert(rec.released >= rec.begin + 4 && rec.released < rec.begin + 8);
+    }
+#endif
+
   // ==========================================================================
 
   printf ("\n%s - Done.\n", test_name);
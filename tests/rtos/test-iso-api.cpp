@@ -27,11 +27,17 @@
 
 #include <cstdio>
 #include <cstdint>
+#include <cassert>
+#include <cstring>
+#include <system_error>
+#include <ratio>
 
 #include <cmsis-plus/iso/chrono>
 #include <cmsis-plus/iso/condition_variable>
 #include <cmsis-plus/iso/mutex>
 #include <cmsis-plus/iso/thread>
+#include <cmsis-plus/iso/memory_resource>
+#include <cmsis-plus/iso/future>
 //#include <atomic>
 
 #include <test-iso-api.h>
@@ -95,6 +101,105 @@ is_ready (void)
   return true;
 }
 
+// The calls of the deferred function, and the thread running it.
+static int deferred_calls;
+static const void* deferred_thread;
+
+static int
+deferred_func (int n)
+{
+  ++deferred_calls;
+  deferred_thread = &os::rtos::this_thread::thread ();
+  return n * 2;
+}
+
+#if defined(__EXCEPTIONS)
+
+// Check that the function throws the given future error.
+template<typename F_T>
+  static void
+  check_future_error (F_T&& func, os::estd::future_errc ev)
+  {
+    bool thrown = false;
+    try
+      {
+        func ();
+      }
+    catch (std::system_error& e)
+      {
+        thrown = true;
+        assert(e.code ().value () == static_cast<int> (ev));
+        assert(std::strcmp (e.code ().category ().name (), "future") == 0);
+      }
+    assert(thrown);
+  }
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+// Compare the division free conversion with the one computed
+// with integer divisions, for a value whose result fits in 64 bits.
+static void
+check_ratio_value (const os::estd::chrono::ratio_converter& conv,
+                   uint64_t value)
+{
+  uint64_t num = conv.num ();
+  uint64_t den = conv.den ();
+
+  // The partial products do not overflow as long as
+  // (den - 1) * num fits in 64 bits.
+  uint64_t quot = (value / den) * num + ((value % den) * num) / den;
+  uint64_t rem = ((value % den) * num) % den;
+
+  assert(conv.floor (value) == quot);
+  assert(conv.ceil (value) == ((rem != 0) ? (quot + 1) : quot));
+}
+
+static void
+check_ratio_converter (const os::estd::chrono::ratio_converter& conv)
+{
+  uint64_t num = conv.num ();
+  uint64_t den = conv.den ();
+
+  // The largest value whose result still fits in 64 bits.
+  uint64_t max = (num <= den) ? UINT64_MAX : (UINT64_MAX / num) * den;
+
+  static const uint64_t values[] =
+    { 0, 1, 2, 3, //
+      0xFFFFFFFEULL, 0xFFFFFFFFULL, 0x100000000ULL, 0x100000001ULL };
+
+  for (uint64_t value : values)
+    {
+      if (value <= max)
+        {
+          check_ratio_value (conv, value);
+        }
+    }
+
+  for (uint64_t i = 0; i < 4; ++i)
+    {
+      check_ratio_value (conv, max - i);
+    }
+
+  // Values around the multiples of the denominator, where
+  // the rounding changes.
+  for (uint64_t k = 1; k <= max / den && k < 1000; ++k)
+    {
+      check_ratio_value (conv, k * den - 1);
+      check_ratio_value (conv, k * den);
+      check_ratio_value (conv, k * den + 1);
+    }
+
+  // A pseudo random sweep over the whole range.
+  uint64_t x = 0x0123456789ABCDEFULL;
+  for (int i = 0; i < 1000; ++i)
+    {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+      check_ratio_value (conv, (max == UINT64_MAX) ? x : (x % (max + 1)));
+    }
+}
+
 // ----------------------------------------------------------------------------
 
 #if 0
@@ -130,6 +235,29 @@ test_iso_api (bool extra)
           th11.join ();
         }
 
+        {
+          // Threads allocated from a pool, without using the heap.
+          static constexpr std::size_t stack_size_bytes = 2048;
+          using thread_storage_t = std::aligned_storage<
+          thread::compute_allocated_size_bytes (stack_size_bytes)>::type;
+
+          static rtos::memory_pool_static<thread_storage_t, 2> pool1
+            { "pool1" };
+          memory_pool_resource res1
+            { pool1 };
+
+          rtos::thread::attributes attr;
+          attr.th_stack_size_bytes = stack_size_bytes;
+
+          thread th12
+            { std::allocator_arg, &res1, attr, task4, 7, "xyz" };
+          thread th13
+            { std::allocator_arg, &res1, attr, task1 };
+
+          th12.join ();
+          th13.join ();
+        }
+
 #if 0
         // Sometimes triggers a user fault, thread termination should be fixed
         {
@@ -286,8 +414,139 @@ test_iso_api (bool extra)
 
   // ==========================================================================
 
+  printf ("\n%s - Futures.\n", test_name);
+    {
+        {
+          promise<int> p1;
+          future<int> f1 = p1.get_future ();
+
+          p1.set_value (7);
+          int v1 = f1.get ();
+          printf ("p1 %d\n", v1);
+          assert(v1 == 7);
+        }
+
+        {
+          // Waiting for a value not set yet times out.
+          promise<int> p;
+          future<int> f = p.get_future ();
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+          assert(f.wait_for (2ms) == future_status::timeout);
+
+#pragma GCC diagnostic pop
+
+          p.set_value (3);
+          assert(f.get () == 3);
+        }
+
+#if defined(__EXCEPTIONS)
+        {
+          // A promise destroyed without a value.
+          future<int> f;
+            {
+              promise<int> p;
+              f = p.get_future ();
+            }
+          check_future_error ([&f]
+            { f.get ();},
+                              future_errc::broken_promise);
+        }
+
+        {
+          // A second future from the same promise.
+          promise<int> p;
+          future<int> f = p.get_future ();
+          check_future_error ([&p]
+            { p.get_future ();},
+                              future_errc::future_already_retrieved);
+          p.set_value (1);
+          assert(f.get () == 1);
+        }
+#endif
+
+        {
+          future<int> f2 = async ([](int a, int b)
+            { return a + b;},
+                                  3, 4);
+          shared_future<int> sf2 = f2.share ();
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+          sf2.wait_for (10ms);
+
+#pragma GCC diagnostic pop
+
+          printf ("async %d\n", sf2.get ());
+          assert(sf2.get () == 7);
+        }
+
+        {
+          future<void> f3 = async (launch::deferred, task4, 7, "xyz");
+          f3.get ();
+        }
+
+        {
+          // A deferred function runs only when the result is
+          // requested, in the requesting thread.
+          deferred_calls = 0;
+          future<int> f4 = async (launch::deferred, deferred_func, 21);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+          assert(f4.wait_for (1ms) == future_status::deferred);
+
+#pragma GCC diagnostic pop
+
+          assert(deferred_calls == 0);
+          assert(f4.get () == 42);
+          assert(deferred_calls == 1);
+          assert(deferred_thread == &os::rtos::this_thread::thread ());
+        }
+    }
+
+  // ==========================================================================
+
   printf ("\n%s - Chrono.\n", test_name);
 
+    {
+      // Nanoseconds per cycle, and back, for typical clocks.
+      check_ratio_converter (ratio_converter
+        { 1000000000ULL, 168000000ULL });
+      check_ratio_converter (ratio_converter
+        { 168000000ULL, 1000000000ULL });
+      check_ratio_converter (ratio_converter
+        { 1000000000ULL, 32768ULL });
+      check_ratio_converter (ratio_converter
+        { 32768ULL, 1000000000ULL });
+      check_ratio_converter (ratio_converter
+        { 1000000000ULL, 1ULL });
+      check_ratio_converter (ratio_converter
+        { 1ULL, 1000ULL });
+
+      // The compile time constants used by ceil().
+      check_ratio_converter (ratio_constants<std::milli>::converter);
+      check_ratio_converter (ratio_constants<std::micro>::converter);
+      check_ratio_converter (
+          ratio_constants<std::ratio<1000, 32768>>::converter);
+
+      static_assert(ratio_constants<std::micro>::converter.num () == 1, "");
+      static_assert(ratio_constants<std::micro>::converter.den () == 1000000, "");
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+
+      assert(chrono::ceil<milliseconds> (1001us).count () == 2);
+      assert(chrono::ceil<milliseconds> (1000us).count () == 1);
+      assert(chrono::ceil<seconds> (1ns).count () == 1);
+
+#pragma GCC diagnostic pop
+    }
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Waggregate-return"
 
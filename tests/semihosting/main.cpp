@@ -0,0 +1,272 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Host test for os::semihosting::file_buffer; build with
+// src/semihosting/semihosting-buffer.cpp and this folder in the
+// include path, before the main include folder.
+
+// The configuration selects the mocked call_host(), declared
+// by <cmsis-plus/arm/semihosting.h>.
+#include <cmsis-plus/os-app-config.h>
+#include <cmsis-plus/arm/semihosting.h>
+#include <cmsis-plus/arm/semihosting-buffer.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+  // A single host file, in memory.
+  uint8_t file[4096];
+  std::size_t file_size;
+  std::size_t file_pos;
+
+  unsigned int traps;
+
+  // The host fails all writes, or accepts only this many bytes.
+  bool write_fails;
+  std::size_t write_room = sizeof(file);
+
+  // Like a terminal, the host returns reads at the end of the line.
+  bool line_mode;
+
+  int failed;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  void
+  rewind (void)
+  {
+    file_pos = 0;
+  }
+}
+
+extern "C" int
+os_semihosting_call_host (int reason, void* arg)
+{
+  ++traps;
+
+  uintptr_t* block = static_cast<uintptr_t*> (arg);
+  switch (reason)
+    {
+    case SEMIHOSTING_SYS_WRITE:
+      {
+        if (write_fails)
+          {
+            return -1;
+          }
+        std::size_t n = block[2];
+        if (file_pos + n > sizeof(file))
+          {
+            n = sizeof(file) - file_pos;
+          }
+        if (n > write_room)
+          {
+            n = write_room;
+          }
+        write_room -= n;
+        std::memcpy (&file[file_pos], reinterpret_cast<void*> (block[1]), n);
+        file_pos += n;
+        if (file_pos > file_size)
+          {
+            file_size = file_pos;
+          }
+        return static_cast<int> (block[2] - n); // Not written.
+      }
+
+    case SEMIHOSTING_SYS_READ:
+      {
+        std::size_t n = block[2];
+        if (file_pos + n > file_size)
+          {
+            n = file_size - file_pos;
+          }
+        if (line_mode)
+          {
+            void* nl = std::memchr (&file[file_pos], '\n', n);
+            if (nl != nullptr)
+              {
+                n = static_cast<std::size_t> (static_cast<uint8_t*> (nl)
+                    - &file[file_pos]) + 1;
+              }
+          }
+        std::memcpy (reinterpret_cast<void*> (block[1]), &file[file_pos], n);
+        file_pos += n;
+        return static_cast<int> (block[2] - n); // Not read.
+      }
+
+    case SEMIHOSTING_SYS_SEEK:
+      file_pos = block[1];
+      return 0;
+
+    case SEMIHOSTING_SYS_ERRNO:
+      return 0;
+
+    default:
+      return -1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+int
+main (int argc __attribute__((unused)), char* argv[])
+{
+  static os::semihosting::file_buffer buffer;
+  buffer.reset (3, false);
+
+  // Write 1000 bytes, one at a time, as stdio does for unbuffered files.
+  traps = 0;
+  for (int i = 0; i < 1000; ++i)
+    {
+      uint8_t c = static_cast<uint8_t> (i);
+      expect (buffer.write (&c, 1) == 1, "write");
+    }
+  expect (buffer.flush () == 0, "flush");
+  printf ("1000 single byte writes: %u traps\n", traps);
+  expect (traps == (1000 + 127) / 128, "write traps");
+  expect (file_size == 1000, "file size");
+
+  // Read them back, also one at a time, after a seek.
+  rewind ();
+  buffer.position (0);
+  traps = 0;
+  bool same = true;
+  for (int i = 0; i < 1000; ++i)
+    {
+      uint8_t c;
+      expect (buffer.read (&c, 1) == 1, "read");
+      same = same && (c == static_cast<uint8_t> (i));
+    }
+  printf ("1000 single byte reads: %u traps\n", traps);
+  expect (same, "read data");
+  expect (traps == (1000 + 127) / 128, "read traps");
+
+  // Changing direction after a partial read must continue
+  // at the logical position.
+  rewind ();
+  buffer.position (0);
+  uint8_t tmp[10];
+  expect (buffer.read (tmp, sizeof(tmp)) == sizeof(tmp), "partial read");
+  expect (buffer.write ("xy", 2) == 2, "write after read");
+  expect (buffer.flush () == 0, "flush after write");
+  expect (file[10] == 'x' && file[11] == 'y' && file[12] == 12,
+          "write position");
+
+  // A failing host; the bytes accepted into the buffer are counted
+  // as written and are not lost.
+  rewind ();
+  file_size = 0;
+  buffer.reset (3, false);
+  uint8_t data[200];
+  for (std::size_t i = 0; i < sizeof(data); ++i)
+    {
+      data[i] = static_cast<uint8_t> (i);
+    }
+  write_fails = true;
+  expect (buffer.write (data, 100) == 100, "write before failure");
+  expect (buffer.write (&data[100], 100) == 28, "write up to the failure");
+  expect (buffer.write (&data[128], 10) == -1, "write with full buffer");
+  expect (buffer.flush () == -1, "flush reports the failure");
+  write_fails = false;
+  expect (buffer.flush () == 0, "flush after recovery");
+  expect (file_size == 128 && std::memcmp (file, data, 128) == 0,
+          "no bytes lost");
+
+  // A host accepting only a part; the rest is written later.
+  rewind ();
+  file_size = 0;
+  buffer.reset (3, false);
+  write_room = 20;
+  expect (buffer.write (data, 60) == 60, "write before partial flush");
+  expect (buffer.flush () == -1, "partial flush");
+  expect (file_size == 20, "partial flush size");
+  write_room = sizeof(file);
+  expect (buffer.flush () == 0, "flush of the rest");
+  expect (file_size == 60 && std::memcmp (file, data, 60) == 0,
+          "partial flush data");
+
+  // On a terminal, a write with a newline passes the line
+  // to the host; without one, the bytes stay buffered.
+  rewind ();
+  file_size = 0;
+  buffer.reset (1, true);
+  traps = 0;
+  expect (buffer.write ("abc", 3) == 3, "tty write");
+  expect (traps == 0, "tty write buffered");
+  expect (buffer.write ("de\nf", 4) == 4, "tty write with newline");
+  expect (traps == 1, "tty newline flush");
+  expect (file_size == 7 && std::memcmp (file, "abcde\nf", 7) == 0,
+          "tty newline data");
+  expect (buffer.write ("gh", 2) == 2, "tty write after newline");
+  expect (traps == 1, "tty write after newline buffered");
+  expect (buffer.flush () == 0, "tty flush");
+
+  // Not on a regular file.
+  rewind ();
+  file_size = 0;
+  buffer.reset (3, false);
+  traps = 0;
+  expect (buffer.write ("ab\ncd\n", 6) == 6, "file write with newline");
+  expect (traps == 0, "file newline buffered");
+  expect (buffer.flush () == 0, "file flush");
+
+  // A terminal read returns the line available, without waiting
+  // to fill the request with the next one.
+  std::memcpy (file, "ab\ncd\n", 6);
+  file_size = 6;
+  rewind ();
+  line_mode = true;
+  buffer.reset (0, true);
+  traps = 0;
+  char line[10];
+  expect (buffer.read (line, sizeof(line)) == 3, "tty read line");
+  expect (std::memcmp (line, "ab\n", 3) == 0, "tty read line data");
+  expect (traps == 1, "tty read line traps");
+  expect (buffer.read (line, 1) == 1 && line[0] == 'c', "tty read next line");
+  expect (traps == 2, "tty read next line traps");
+  expect (buffer.read (line, sizeof(line)) == 2, "tty read rest of line");
+  expect (std::memcmp (line, "d\n", 2) == 0, "tty read rest of line data");
+  expect (traps == 2, "tty read rest of line traps");
+  line_mode = false;
+
+  printf ("%s %s.\n", argv[0], failed ? "failed" : "passed");
+  return failed ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------
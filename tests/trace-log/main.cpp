@@ -0,0 +1,148 @@
+/*
+ * This file is part of the µOS++ distribution.
+ *   (https://github.com/micro-os-plus)
+ * Copyright (c) 2016 Liviu Ionescu.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Host test for the <cmsis-plus/diag/trace-log.h> macros; build
+// with -DTRACE and this folder in the include path, before the main
+// include folder. trace_printf() and the run time mask are defined
+// here, so no other source is needed.
+
+#include <cmsis-plus/os-app-config.h>
+#include <cmsis-plus/diag/trace-log.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdarg>
+
+#if !defined(TRACE)
+#error "Build with -DTRACE."
+#endif
+
+// ----------------------------------------------------------------------------
+
+uint32_t os_trace_log_mask = OS_LOG_LEVELS_UPTO(
+    OS_INTEGER_TRACE_LOG_LEVEL) | OS_LOG_CATEGORY_ALL;
+
+namespace
+{
+  // The last message and the number of messages.
+  char last[80];
+  unsigned int calls;
+
+  // Incremented by the arguments, to check they are not evaluated.
+  int evaluated;
+
+  int failed;
+
+  void
+  expect (bool condition, const char* what)
+  {
+    if (!condition)
+      {
+        printf ("FAILED: %s\n", what);
+        ++failed;
+      }
+  }
+
+  bool
+  printed (const char* s)
+  {
+    return std::strcmp (last, s) == 0;
+  }
+}
+
+int
+trace_printf (const char* format, ...)
+{
+  ++calls;
+
+  std::va_list args;
+  va_start(args, format);
+  int ret = std::vsnprintf (last, sizeof(last), format, args);
+  va_end(args);
+
+  return ret;
+}
+
+// ----------------------------------------------------------------------------
+
+int
+main (int argc __attribute__((unused)), char* argv[])
+{
+  // All run time bits set; only the compile time filters remain.
+  os::trace::log::mask (0xFFFFFFFF);
+
+  // Levels above OS_INTEGER_TRACE_LOG_LEVEL expand to nothing; the
+  // arguments are not even compiled, so an undeclared name is fine.
+  OS_LOG_DEBUG(OS_LOG_CATEGORY_APP, "%d", not_declared_anywhere);
+  OS_LOG_VERBOSE(OS_LOG_CATEGORY_APP, "%d", ++evaluated);
+  expect (calls == 0 && evaluated == 0, "levels compiled out");
+
+  // Categories excluded at compile time are dead code.
+  OS_LOG_ERROR(OS_LOG_CATEGORY_USB, "%d", ++evaluated);
+  expect (calls == 0 && evaluated == 0, "category compiled out");
+
+  OS_LOG_INFO(OS_LOG_CATEGORY_APP, "info %d\n", 1);
+  expect (calls == 1 && printed ("I/info 1\n"), "info displayed");
+  OS_LOG_ERROR(OS_LOG_CATEGORY_RTOS, "error %d\n", 2);
+  expect (calls == 2 && printed ("E/error 2\n"), "error displayed");
+
+  // The run time level.
+  expect (os::trace::log::level (OS_LOG_LEVEL_WARNING) == 0xFFFFFFFF,
+          "level() returns the previous mask");
+  expect (os::trace::log::mask ()
+              == (OS_LOG_LEVELS_UPTO(OS_LOG_LEVEL_WARNING)
+                  | OS_LOG_CATEGORY_ALL),
+          "level() keeps the categories");
+  OS_LOG_INFO(OS_LOG_CATEGORY_APP, "info %d\n", ++evaluated);
+  expect (calls == 2 && evaluated == 0, "info filtered at run time");
+  OS_LOG_WARNING(OS_LOG_CATEGORY_APP, "warning %d\n", 3);
+  expect (calls == 3 && printed ("W/warning 3\n"), "warning displayed");
+
+  // The run time categories.
+  os::trace::log::disable (OS_LOG_CATEGORY_RTOS);
+  OS_LOG_ERROR(OS_LOG_CATEGORY_RTOS, "error %d\n", 4);
+  expect (calls == 3, "disabled category filtered");
+  OS_LOG_ERROR(OS_LOG_CATEGORY_APP, "error %d\n", 5);
+  expect (calls == 4 && printed ("E/error 5\n"), "other category displayed");
+  os::trace::log::enable (OS_LOG_CATEGORY_RTOS);
+  OS_LOG_ERROR(OS_LOG_CATEGORY_RTOS, "error %d\n", 6);
+  expect (calls == 5 && printed ("E/error 6\n"),
+          "enabled category displayed");
+
+  // User categories.
+  os::trace::log::mask (
+      OS_LOG_LEVELS_UPTO(OS_LOG_LEVEL_INFO) | OS_LOG_CATEGORY_USER(3));
+  OS_LOG_INFO(OS_LOG_CATEGORY_USER(3), "user %d\n", 7);
+  expect (calls == 6 && printed ("I/user 7\n"), "user category displayed");
+  OS_LOG_INFO(OS_LOG_CATEGORY_USER(4), "user %d\n", 8);
+  expect (calls == 6, "other user category filtered");
+
+  printf ("%s %s.\n", argv[0], failed ? "failed" : "passed");
+  return failed ? 1 : 0;
+}
+
+// ----------------------------------------------------------------------------